@@ -0,0 +1,214 @@
+#include "checkpoint.h"
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+// CheckpointWriter implementation
+
+CheckpointWriter::CheckpointWriter(uint32_t flags)
+    : flags_(flags), section_length_pos_(0), in_section_(false) {
+    write_fixed32(checkpoint::MAGIC);
+    write_fixed32(checkpoint::VERSION);
+    write_fixed32(flags_);
+}
+
+void CheckpointWriter::write_u8(uint8_t value) {
+    buffer_.push_back(value);
+}
+
+void CheckpointWriter::write_varint(uint64_t value) {
+    while (value >= 0x80) {
+        buffer_.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    buffer_.push_back(static_cast<uint8_t>(value));
+}
+
+void CheckpointWriter::write_u64(uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        buffer_.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void CheckpointWriter::write_double(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    write_u64(bits);
+}
+
+void CheckpointWriter::write_bytes(const uint8_t* data, uint64_t size) {
+    buffer_.insert(buffer_.end(), data, data + size);
+}
+
+void CheckpointWriter::write_byte_vector(const std::vector<uint8_t>& data) {
+    write_varint(data.size());
+    write_bytes(data.data(), data.size());
+}
+
+void CheckpointWriter::write_string(const std::string& value) {
+    write_varint(value.size());
+    write_bytes(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+}
+
+void CheckpointWriter::begin_section(checkpoint::SectionTag tag) {
+    if (in_section_) {
+        throw std::logic_error("Checkpoint sections cannot be nested");
+    }
+    write_fixed32(static_cast<uint32_t>(tag));
+    section_length_pos_ = buffer_.size();
+    write_u64(0);  // Patched in end_section()
+    in_section_ = true;
+}
+
+void CheckpointWriter::end_section() {
+    if (!in_section_) {
+        throw std::logic_error("end_section() without begin_section()");
+    }
+    patch_fixed64(section_length_pos_, buffer_.size() - section_length_pos_ - 8);
+    in_section_ = false;
+}
+
+void CheckpointWriter::save_to_file(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open checkpoint file for writing: " + path);
+    }
+    out.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size());
+    if (!out) {
+        throw std::runtime_error("Failed to write checkpoint file: " + path);
+    }
+}
+
+void CheckpointWriter::write_fixed32(uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        buffer_.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+void CheckpointWriter::patch_fixed64(size_t pos, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        buffer_[pos + i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+}
+
+// CheckpointReader implementation
+
+CheckpointReader::CheckpointReader(const std::vector<uint8_t>& buffer)
+    : buffer_(buffer), pos_(0), flags_(0), section_end_(0), in_section_(false) {
+    if (read_fixed32() != checkpoint::MAGIC) {
+        throw std::runtime_error("Not a shader core checkpoint (bad magic)");
+    }
+    uint32_t version = read_fixed32();
+    if (version != checkpoint::VERSION) {
+        throw std::runtime_error("Unsupported checkpoint version " + std::to_string(version));
+    }
+    flags_ = read_fixed32();
+}
+
+CheckpointReader CheckpointReader::load_from_file(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open checkpoint file: " + path);
+    }
+    std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(in)),
+                                std::istreambuf_iterator<char>());
+    return CheckpointReader(buffer);
+}
+
+uint8_t CheckpointReader::read_u8() {
+    require(1);
+    return buffer_[pos_++];
+}
+
+uint64_t CheckpointReader::read_varint() {
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        uint8_t byte = read_u8();
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("Malformed varint in checkpoint");
+}
+
+uint64_t CheckpointReader::read_u64() {
+    require(8);
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= static_cast<uint64_t>(buffer_[pos_++]) << (8 * i);
+    }
+    return value;
+}
+
+double CheckpointReader::read_double() {
+    uint64_t bits = read_u64();
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void CheckpointReader::read_bytes(uint8_t* data, uint64_t size) {
+    require(size);
+    std::memcpy(data, buffer_.data() + pos_, size);
+    pos_ += size;
+}
+
+std::vector<uint8_t> CheckpointReader::read_byte_vector() {
+    uint64_t size = read_varint();
+    require(size);
+    std::vector<uint8_t> data(buffer_.begin() + pos_, buffer_.begin() + pos_ + size);
+    pos_ += size;
+    return data;
+}
+
+std::string CheckpointReader::read_string() {
+    uint64_t size = read_varint();
+    require(size);
+    std::string value(reinterpret_cast<const char*>(buffer_.data() + pos_), size);
+    pos_ += size;
+    return value;
+}
+
+void CheckpointReader::begin_section(checkpoint::SectionTag tag) {
+    if (in_section_) {
+        throw std::logic_error("Checkpoint sections cannot be nested");
+    }
+    uint32_t found = read_fixed32();
+    if (found != static_cast<uint32_t>(tag)) {
+        throw std::runtime_error("Checkpoint section mismatch: expected tag " +
+                                 std::to_string(static_cast<uint32_t>(tag)) +
+                                 ", found " + std::to_string(found));
+    }
+    uint64_t length = read_u64();
+    require(length);
+    section_end_ = pos_ + length;
+    in_section_ = true;
+}
+
+void CheckpointReader::end_section() {
+    if (!in_section_) {
+        throw std::logic_error("end_section() without begin_section()");
+    }
+    if (pos_ != section_end_) {
+        throw std::runtime_error("Checkpoint section length mismatch");
+    }
+    in_section_ = false;
+}
+
+void CheckpointReader::require(uint64_t bytes) const {
+    if (bytes > buffer_.size() - pos_) {
+        throw std::runtime_error("Truncated checkpoint");
+    }
+}
+
+uint32_t CheckpointReader::read_fixed32() {
+    require(4);
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(buffer_[pos_++]) << (8 * i);
+    }
+    return value;
+}
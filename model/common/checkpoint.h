@@ -0,0 +1,116 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Binary checkpoint format
+//
+// A checkpoint is a header (magic, version, flags) followed by a sequence of
+// tagged sections. Each section records its tag and payload length so that a
+// reader can validate that components are restored in the order they were
+// saved. Integers are stored as LEB128 varints to keep checkpoints compact.
+namespace checkpoint {
+
+static const uint32_t MAGIC = 0x4B435347;  // "GSCK"
+static const uint32_t VERSION = 1;
+
+// Header flags
+static const uint32_t FLAG_INCREMENTAL = 0x1;
+
+// Section tags, one per checkpointed component
+enum class SectionTag : uint32_t {
+    SHADER_CORE = 1,
+    SHADER_REGISTER_FILE,
+    INSTRUCTION_BUFFER,
+    EXECUTION_UNIT,
+    TENSOR_UNIT,
+    MEMORY_SUBSYSTEM,
+    MEMORY_REGISTER_FILE,
+    SHARED_MEMORY,
+    CACHE_L1,
+    CACHE_L2,
+    GLOBAL_MEMORY,
+    MEMORY_STATE,
+    TRANSACTION_QUEUE
+};
+
+}  // namespace checkpoint
+
+// Serializes model state into an in-memory buffer
+class CheckpointWriter {
+public:
+    // Constructor
+    explicit CheckpointWriter(uint32_t flags = 0);
+
+    // Primitive encoders
+    void write_u8(uint8_t value);
+    void write_bool(bool value) { write_u8(value ? 1 : 0); }
+    void write_varint(uint64_t value);
+    void write_u64(uint64_t value);
+    void write_double(double value);
+    void write_bytes(const uint8_t* data, uint64_t size);
+    void write_byte_vector(const std::vector<uint8_t>& data);
+    void write_string(const std::string& value);
+
+    // Section framing (sections may not be nested)
+    void begin_section(checkpoint::SectionTag tag);
+    void end_section();
+
+    // Header flags
+    uint32_t flags() const { return flags_; }
+    bool is_incremental() const { return (flags_ & checkpoint::FLAG_INCREMENTAL) != 0; }
+
+    // Output
+    const std::vector<uint8_t>& buffer() const { return buffer_; }
+    void save_to_file(const std::string& path) const;
+
+private:
+    std::vector<uint8_t> buffer_;
+    uint32_t flags_;
+    size_t section_length_pos_;
+    bool in_section_;
+
+    void write_fixed32(uint32_t value);
+    void patch_fixed64(size_t pos, uint64_t value);
+};
+
+// Deserializes model state produced by CheckpointWriter
+class CheckpointReader {
+public:
+    // Constructors (throw std::runtime_error on malformed input)
+    explicit CheckpointReader(const std::vector<uint8_t>& buffer);
+    static CheckpointReader load_from_file(const std::string& path);
+
+    // Primitive decoders
+    uint8_t read_u8();
+    bool read_bool() { return read_u8() != 0; }
+    uint64_t read_varint();
+    uint64_t read_u64();
+    double read_double();
+    void read_bytes(uint8_t* data, uint64_t size);
+    std::vector<uint8_t> read_byte_vector();
+    std::string read_string();
+
+    // Section framing
+    void begin_section(checkpoint::SectionTag tag);
+    void end_section();
+
+    // Header flags
+    uint32_t flags() const { return flags_; }
+    bool is_incremental() const { return (flags_ & checkpoint::FLAG_INCREMENTAL) != 0; }
+    bool at_end() const { return pos_ >= buffer_.size(); }
+
+private:
+    std::vector<uint8_t> buffer_;
+    size_t pos_;
+    uint32_t flags_;
+    size_t section_end_;
+    bool in_section_;
+
+    void require(uint64_t bytes) const;
+    uint32_t read_fixed32();
+};
+
+#endif // CHECKPOINT_H
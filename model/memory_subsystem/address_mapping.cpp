@@ -0,0 +1,176 @@
+#include "address_mapping.h"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+const uint32_t MAX_INDEX_BITS = 31;
+
+std::vector<uint64_t> split_numbers(const std::string& text, char separator) {
+    std::vector<uint64_t> values;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, separator)) {
+        size_t consumed = 0;
+        uint64_t value = std::stoull(item, &consumed, 0);
+        if (consumed != item.size()) {
+            throw std::invalid_argument("Invalid number '" + item + "' in address mapping");
+        }
+        values.push_back(value);
+    }
+    return values;
+}
+
+}  // namespace
+
+AddressMapping::AddressMapping()
+    : scheme_(Scheme::BIT_SLICE),
+      low_bit_(0),
+      count_(1) {
+}
+
+AddressMapping AddressMapping::bit_slice(uint32_t low_bit, uint32_t num_bits) {
+    if (num_bits > MAX_INDEX_BITS || low_bit + num_bits > 64) {
+        throw std::invalid_argument("Bit slice address mapping out of range");
+    }
+    AddressMapping mapping;
+    mapping.low_bit_ = low_bit;
+    mapping.count_ = 1u << num_bits;
+    for (uint32_t bit = 0; bit < num_bits; bit++) {
+        mapping.bit_masks_.push_back(1ULL << (low_bit + bit));
+    }
+    return mapping;
+}
+
+AddressMapping AddressMapping::permutation(const std::vector<uint32_t>& bits) {
+    if (bits.size() > MAX_INDEX_BITS) {
+        throw std::invalid_argument("Permutation address mapping has too many bits");
+    }
+    AddressMapping mapping;
+    mapping.scheme_ = Scheme::PERMUTATION;
+    mapping.count_ = 1u << bits.size();
+    for (uint32_t bit : bits) {
+        if (bit >= 64) {
+            throw std::invalid_argument("Permutation address bit out of range");
+        }
+        mapping.bit_masks_.push_back(1ULL << bit);
+    }
+    return mapping;
+}
+
+AddressMapping AddressMapping::xor_fold(uint32_t low_bit, uint32_t num_bits, uint32_t high_bit) {
+    if (num_bits == 0 || num_bits > MAX_INDEX_BITS || high_bit > 64 || low_bit + num_bits > high_bit) {
+        throw std::invalid_argument("XOR-fold address mapping out of range");
+    }
+    AddressMapping mapping = bit_slice(low_bit, num_bits);
+    mapping.scheme_ = Scheme::XOR_FOLD;
+    for (uint32_t bit = 0; bit < num_bits; bit++) {
+        for (uint32_t source = low_bit + bit + num_bits; source < high_bit; source += num_bits) {
+            mapping.bit_masks_[bit] |= 1ULL << source;
+        }
+    }
+    return mapping;
+}
+
+AddressMapping AddressMapping::modulo(uint32_t low_bit, uint32_t count) {
+    if (count == 0 || low_bit >= 64) {
+        throw std::invalid_argument("Modulo address mapping needs a non-zero count");
+    }
+    AddressMapping mapping;
+    mapping.scheme_ = Scheme::MODULO;
+    mapping.low_bit_ = low_bit;
+    mapping.count_ = count;
+    return mapping;
+}
+
+AddressMapping AddressMapping::parse(const std::string& spec) {
+    size_t colon = spec.find(':');
+    std::string kind = spec.substr(0, colon);
+    std::string args = colon == std::string::npos ? "" : spec.substr(colon + 1);
+
+    try {
+        if (kind == "bits") {
+            std::vector<uint64_t> values = split_numbers(args, ',');
+            return permutation(std::vector<uint32_t>(values.begin(), values.end()));
+        }
+        std::vector<uint64_t> values = split_numbers(args, ':');
+        if (kind == "slice" && values.size() == 2) {
+            return bit_slice(static_cast<uint32_t>(values[0]), static_cast<uint32_t>(values[1]));
+        }
+        if (kind == "xor" && values.size() == 3) {
+            return xor_fold(static_cast<uint32_t>(values[0]), static_cast<uint32_t>(values[1]),
+                            static_cast<uint32_t>(values[2]));
+        }
+        if (kind == "mod" && values.size() == 2) {
+            return modulo(static_cast<uint32_t>(values[0]), static_cast<uint32_t>(values[1]));
+        }
+    } catch (const std::logic_error& e) {
+        throw std::invalid_argument("Invalid address mapping '" + spec + "': " + e.what());
+    }
+    throw std::invalid_argument("Invalid address mapping '" + spec + "'");
+}
+
+std::string AddressMapping::to_string() const {
+    std::ostringstream out;
+    switch (scheme_) {
+        case Scheme::BIT_SLICE:
+            out << "slice:" << low_bit_ << ":" << bit_masks_.size();
+            break;
+        case Scheme::PERMUTATION:
+            out << "bits:";
+            for (size_t i = 0; i < bit_masks_.size(); i++) {
+                out << (i > 0 ? "," : "") << __builtin_ctzll(bit_masks_[i]);
+            }
+            break;
+        case Scheme::XOR_FOLD: {
+            // Every bit below high feeds exactly one output, so the highest
+            // bit of any mask is high - 1
+            uint64_t sources = 0;
+            for (uint64_t mask : bit_masks_) {
+                sources |= mask;
+            }
+            out << "xor:" << low_bit_ << ":" << bit_masks_.size() << ":" << 64 - __builtin_clzll(sources);
+            break;
+        }
+        case Scheme::MODULO:
+            out << "mod:" << low_bit_ << ":" << count_;
+            break;
+    }
+    return out.str();
+}
+
+// LoadBalanceHistogram
+
+double LoadBalanceHistogram::max_over_mean() const {
+    if (total_ == 0 || counts_.empty()) {
+        return 0.0;
+    }
+    double mean = static_cast<double>(total_) / counts_.size();
+    return *std::max_element(counts_.begin(), counts_.end()) / mean;
+}
+
+double LoadBalanceHistogram::coefficient_of_variation() const {
+    if (total_ == 0 || counts_.empty()) {
+        return 0.0;
+    }
+    double mean = static_cast<double>(total_) / counts_.size();
+    double variance = 0.0;
+    for (uint64_t count : counts_) {
+        double delta = count - mean;
+        variance += delta * delta;
+    }
+    return std::sqrt(variance / counts_.size()) / mean;
+}
+
+void LoadBalanceHistogram::reset() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_ = 0;
+}
+
+void LoadBalanceHistogram::reset(uint32_t num_buckets) {
+    counts_.assign(num_buckets, 0);
+    total_ = 0;
+}
@@ -0,0 +1,100 @@
+#ifndef ADDRESS_MAPPING_H
+#define ADDRESS_MAPPING_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// Address-to-index mapping for channels, banks and cache sets
+//
+// Every power-of-two scheme is a list of output bits, each the parity
+// (XOR) of a mask of address bits:
+//   BIT_SLICE    output bit i = address bit low + i (the classic mapping)
+//   PERMUTATION  output bit i = an arbitrary address bit
+//   XOR_FOLD     output bit i = XOR of address bits low + i, low + i + n,
+//                low + i + 2n, ... below high. Folding upper (row) bits into
+//                the index spreads power-of-two strides and avoids
+//                partition camping.
+//   MODULO       (addr >> low) % count, for non-power-of-two counts
+// Mappings can be built from a text spec so they can be swapped per run
+// without recompiling (see parse()).
+class AddressMapping {
+public:
+    enum class Scheme : uint8_t { BIT_SLICE, PERMUTATION, XOR_FOLD, MODULO };
+
+    // Default mapping has a single index
+    AddressMapping();
+
+    // Factories
+    static AddressMapping bit_slice(uint32_t low_bit, uint32_t num_bits);
+    static AddressMapping permutation(const std::vector<uint32_t>& bits);
+    static AddressMapping xor_fold(uint32_t low_bit, uint32_t num_bits, uint32_t high_bit);
+    static AddressMapping modulo(uint32_t low_bit, uint32_t count);
+
+    // Parse "slice:LOW:BITS", "bits:B0,B1,...", "xor:LOW:BITS:HIGH" or
+    // "mod:LOW:COUNT" (throws std::invalid_argument)
+    static AddressMapping parse(const std::string& spec);
+    std::string to_string() const;
+
+    // Map an address to an index in [0, num_indices())
+    uint32_t index(uint64_t addr) const {
+        if (scheme_ == Scheme::MODULO) {
+            return static_cast<uint32_t>((addr >> low_bit_) % count_);
+        }
+        uint32_t result = 0;
+        for (size_t bit = 0; bit < bit_masks_.size(); bit++) {
+            result |= static_cast<uint32_t>(__builtin_parityll(addr & bit_masks_[bit])) << bit;
+        }
+        return result;
+    }
+
+    // Properties
+    Scheme scheme() const { return scheme_; }
+    uint32_t num_indices() const { return count_; }
+
+private:
+    Scheme scheme_;
+    std::vector<uint64_t> bit_masks_;   // One mask per output bit
+    uint32_t low_bit_;
+    uint32_t count_;
+};
+
+// Distribution of accesses over the indices of a mapping
+class LoadBalanceHistogram {
+public:
+    // Constructor
+    explicit LoadBalanceHistogram(uint32_t num_buckets = 0) : counts_(num_buckets, 0), total_(0) {}
+
+    // Record one access
+    void record(uint32_t index) {
+        counts_[index]++;
+        total_++;
+    }
+
+    // Histogram data
+    const std::vector<uint64_t>& counts() const { return counts_; }
+    uint64_t total() const { return total_; }
+
+    // Busiest bucket relative to the mean (1.0 = perfectly balanced)
+    double max_over_mean() const;
+    // Standard deviation over mean of the bucket counts
+    double coefficient_of_variation() const;
+
+    // Reset (optionally resizing)
+    void reset();
+    void reset(uint32_t num_buckets);
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    std::vector<uint64_t> counts_;
+    uint64_t total_;
+};
+
+#endif // ADDRESS_MAPPING_H
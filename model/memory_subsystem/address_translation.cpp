@@ -0,0 +1,383 @@
+#include "address_translation.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// In-flight walks kept before completed ones are pruned
+const size_t WALK_PRUNE_THRESHOLD = 1024;
+
+// Page sizes in lookup order, largest first
+const PageSize LOOKUP_ORDER[NUM_PAGE_SIZES] = {PageSize::SIZE_2MB, PageSize::SIZE_64KB, PageSize::SIZE_4KB};
+
+}  // namespace
+
+const uint32_t PageTable::LEVELS;
+const uint32_t PageTable::VIRTUAL_ADDRESS_BITS;
+
+// PageTable
+
+void PageTable::map(uint64_t vaddr, uint64_t paddr, PageSize size) {
+    uint64_t mask = page_bytes(size) - 1;
+    if ((vaddr & mask) != 0 || (paddr & mask) != 0) {
+        throw std::invalid_argument("Page mapping is not aligned to its page size");
+    }
+    if ((vaddr >> VIRTUAL_ADDRESS_BITS) != 0) {
+        throw std::invalid_argument("Virtual address exceeds 48 bits");
+    }
+    if (overlaps(vaddr, size)) {
+        throw std::invalid_argument("Page mapping overlaps an existing page");
+    }
+    pages_[static_cast<uint32_t>(size)][vaddr >> page_shift(size)] = paddr;
+}
+
+void PageTable::map_range(uint64_t vaddr, uint64_t paddr, uint64_t bytes, PageSize size) {
+    for (uint64_t offset = 0; offset < bytes; offset += page_bytes(size)) {
+        map(vaddr + offset, paddr + offset, size);
+    }
+}
+
+bool PageTable::unmap(uint64_t vaddr) {
+    PageMapping mapping;
+    if (!lookup(vaddr, mapping)) {
+        return false;
+    }
+    pages_[static_cast<uint32_t>(mapping.size)].erase(vaddr >> page_shift(mapping.size));
+    return true;
+}
+
+bool PageTable::lookup(uint64_t vaddr, PageMapping& mapping) const {
+    for (PageSize size : LOOKUP_ORDER) {
+        const std::unordered_map<uint64_t, uint64_t>& pages = pages_[static_cast<uint32_t>(size)];
+        if (pages.empty()) {
+            continue;
+        }
+        auto it = pages.find(vaddr >> page_shift(size));
+        if (it != pages.end()) {
+            mapping.virtual_base = it->first << page_shift(size);
+            mapping.physical_base = it->second;
+            mapping.size = size;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t PageTable::num_pages() const {
+    size_t total = 0;
+    for (const std::unordered_map<uint64_t, uint64_t>& pages : pages_) {
+        total += pages.size();
+    }
+    return total;
+}
+
+void PageTable::clear() {
+    for (std::unordered_map<uint64_t, uint64_t>& pages : pages_) {
+        pages.clear();
+    }
+}
+
+bool PageTable::overlaps(uint64_t vaddr, PageSize size) const {
+    for (uint32_t i = 0; i < NUM_PAGE_SIZES; i++) {
+        const std::unordered_map<uint64_t, uint64_t>& pages = pages_[i];
+        if (pages.empty()) {
+            continue;
+        }
+        uint32_t shift = page_shift(static_cast<PageSize>(i));
+        if (shift >= page_shift(size)) {
+            // A page at least as large covers vaddr
+            if (pages.count(vaddr >> shift) != 0) {
+                return true;
+            }
+            continue;
+        }
+        // Smaller pages inside the new one
+        uint64_t first = vaddr >> shift;
+        uint64_t count = page_bytes(size) >> shift;
+        for (uint64_t page = first; page < first + count; page++) {
+            if (pages.count(page) != 0) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// Tlb
+
+Tlb::Tlb(const TlbConfig& config)
+    : config_(config),
+      num_sets_(config.associativity > 0 ? config.entries / config.associativity : 0),
+      entries_(std::max(num_sets_, 1u), config.associativity, 1, false),
+      replacement_(std::max(num_sets_, 1u), config.associativity),
+      physical_base_(config.entries, 0),
+      ready_(config.entries, 0) {
+    if (num_sets_ == 0 || config.entries % config.associativity != 0) {
+        throw std::invalid_argument("TLB entries must be a non-zero multiple of its associativity");
+    }
+    std::fill(resident_, resident_ + NUM_PAGE_SIZES, 0u);
+}
+
+bool Tlb::lookup(uint64_t vaddr, PageMapping& mapping, uint64_t& ready) {
+    for (PageSize size : LOOKUP_ORDER) {
+        uint32_t set = 0;
+        uint32_t way = 0;
+        if (resident_[static_cast<uint32_t>(size)] == 0 || !find(vaddr, size, set, way)) {
+            continue;
+        }
+        replacement_.on_hit(set, way);
+        size_t index = static_cast<size_t>(set) * config_.associativity + way;
+        mapping.virtual_base = vaddr & ~(page_bytes(size) - 1);
+        mapping.physical_base = physical_base_[index];
+        mapping.size = size;
+        ready = ready_[index];
+        return true;
+    }
+    return false;
+}
+
+void Tlb::insert(const PageMapping& mapping, uint64_t ready) {
+    uint32_t set = 0;
+    int32_t way = 0;
+    uint32_t present_way = 0;
+    if (find(mapping.virtual_base, mapping.size, set, present_way)) {
+        way = static_cast<int32_t>(present_way);
+    } else {
+        way = entries_.find_invalid(set);
+        if (way < 0) {
+            way = static_cast<int32_t>(replacement_.victim(set));
+            remove(set, static_cast<uint32_t>(way));
+        }
+        entries_.fill(set, static_cast<uint32_t>(way), make_tag(mapping.virtual_base, mapping.size), nullptr);
+        replacement_.on_fill(set, static_cast<uint32_t>(way));
+        resident_[static_cast<uint32_t>(mapping.size)]++;
+    }
+    size_t index = static_cast<size_t>(set) * config_.associativity + static_cast<uint32_t>(way);
+    physical_base_[index] = mapping.physical_base;
+    ready_[index] = ready;
+}
+
+bool Tlb::invalidate(uint64_t vaddr) {
+    for (PageSize size : LOOKUP_ORDER) {
+        uint32_t set = 0;
+        uint32_t way = 0;
+        if (resident_[static_cast<uint32_t>(size)] > 0 && find(vaddr, size, set, way)) {
+            remove(set, way);
+            return true;
+        }
+    }
+    return false;
+}
+
+void Tlb::flush() {
+    entries_.clear();
+    replacement_.reset();
+    std::fill(resident_, resident_ + NUM_PAGE_SIZES, 0u);
+}
+
+uint64_t Tlb::reach() const {
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < NUM_PAGE_SIZES; i++) {
+        bytes += resident_[i] * page_bytes(static_cast<PageSize>(i));
+    }
+    return bytes;
+}
+
+uint32_t Tlb::occupancy() const {
+    return resident_[0] + resident_[1] + resident_[2];
+}
+
+bool Tlb::find(uint64_t vaddr, PageSize size, uint32_t& set, uint32_t& way) const {
+    set = set_of(vaddr, size);
+    int32_t found = entries_.find(set, make_tag(vaddr, size));
+    way = found >= 0 ? static_cast<uint32_t>(found) : 0;
+    return found >= 0;
+}
+
+void Tlb::remove(uint32_t set, uint32_t way) {
+    if (!entries_.valid(set, way)) {
+        return;
+    }
+    resident_[entries_.tag(set, way) & 3]--;
+    entries_.invalidate(set, way);
+    replacement_.on_invalidate(set, way);
+}
+
+// PageWalker
+
+PageWalker::PageWalker(const PageWalkerConfig& config)
+    : config_(config),
+      walk_cache_(1, std::max(config.walk_cache_entries, 1u), 1, false),
+      walk_cache_replacement_(1, std::max(config.walk_cache_entries, 1u)) {
+    if (config_.num_walkers == 0) {
+        throw std::invalid_argument("Page walker needs at least one walker");
+    }
+    if (config_.walk_cache_entries == 0 || config_.walk_cache_entries > CacheArray::MAX_ASSOCIATIVITY) {
+        throw std::invalid_argument("Walk cache entries must be between 1 and 64");
+    }
+    clear();
+}
+
+PageWalker::Walk PageWalker::walk(uint64_t vaddr, const PageMapping& leaf, uint64_t cycle) {
+    prune(cycle);
+    Walk result;
+    auto in_flight = in_flight_.find(leaf.virtual_base);
+    if (in_flight != in_flight_.end() && in_flight->second > cycle) {
+        result.done = in_flight->second;
+        result.merged = true;
+        return result;
+    }
+
+    // Deepest non-leaf level held in the walk cache; the leaf is always read
+    uint32_t depth = PageTable::walk_depth(leaf.size);
+    uint32_t start_level = 0;
+    for (uint32_t level = depth - 1; level-- > 0;) {
+        int32_t way = walk_cache_.find(0, walk_cache_tag(vaddr, level));
+        if (way >= 0) {
+            walk_cache_replacement_.on_hit(0, static_cast<uint32_t>(way));
+            start_level = level + 1;
+            break;
+        }
+    }
+    (start_level > 0 ? walk_cache_hits_ : walk_cache_misses_)++;
+
+    // Non-leaf entries read by this walk are cached for later walks
+    for (uint32_t level = start_level; level + 1 < depth; level++) {
+        int32_t way = walk_cache_.find_invalid(0);
+        if (way < 0) {
+            way = static_cast<int32_t>(walk_cache_replacement_.victim(0));
+            walk_cache_replacement_.on_invalidate(0, static_cast<uint32_t>(way));
+        }
+        walk_cache_.fill(0, static_cast<uint32_t>(way), walk_cache_tag(vaddr, level), nullptr);
+        walk_cache_replacement_.on_fill(0, static_cast<uint32_t>(way));
+    }
+
+    auto walker = std::min_element(walker_free_.begin(), walker_free_.end());
+    uint64_t start = std::max(cycle, *walker);
+    result.stalled = start > cycle;
+    result.reads = depth - start_level;
+    result.done = start + config_.walk_cache_latency + static_cast<uint64_t>(result.reads) * config_.memory_latency;
+    *walker = result.done;
+    in_flight_[leaf.virtual_base] = result.done;
+    return result;
+}
+
+void PageWalker::flush_walk_cache() {
+    walk_cache_.clear();
+    walk_cache_replacement_.reset();
+}
+
+uint32_t PageWalker::busy_walkers(uint64_t cycle) const {
+    return static_cast<uint32_t>(std::count_if(walker_free_.begin(), walker_free_.end(),
+                                               [cycle](uint64_t free) { return free > cycle; }));
+}
+
+void PageWalker::clear() {
+    walker_free_.assign(config_.num_walkers, 0);
+    in_flight_.clear();
+    flush_walk_cache();
+    walk_cache_hits_ = 0;
+    walk_cache_misses_ = 0;
+}
+
+void PageWalker::prune(uint64_t cycle) {
+    if (in_flight_.size() < WALK_PRUNE_THRESHOLD) {
+        return;
+    }
+    for (auto it = in_flight_.begin(); it != in_flight_.end();) {
+        if (it->second <= cycle) {
+            it = in_flight_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// AddressTranslation
+
+AddressTranslation::AddressTranslation(const AddressTranslationConfig& config)
+    : config_(config),
+      l1_tlbs_(config.num_cores, Tlb(config.l1)),
+      l2_tlb_(config.l2),
+      walker_(config.walker) {
+    if (config_.num_cores == 0) {
+        throw std::invalid_argument("Address translation needs at least one core");
+    }
+}
+
+TranslationResult AddressTranslation::translate(uint32_t core, uint64_t vaddr, uint64_t cycle) {
+    Tlb& l1 = l1_tlbs_.at(core);
+    TranslationResult result;
+    PageMapping mapping;
+    uint64_t entry_ready = 0;
+    uint64_t ready = cycle + config_.l1.latency;
+    stats_.translations++;
+
+    if (l1.lookup(vaddr, mapping, entry_ready)) {
+        stats_.l1_hits++;
+        result.level = TranslationLevel::L1_TLB;
+        ready = std::max(ready, entry_ready);
+    } else {
+        stats_.l1_misses++;
+        ready += config_.l2.latency;
+        if (l2_tlb_.lookup(vaddr, mapping, entry_ready)) {
+            stats_.l2_hits++;
+            result.level = TranslationLevel::L2_TLB;
+            ready = std::max(ready, entry_ready);
+        } else {
+            stats_.l2_misses++;
+            if (!page_table_.lookup(vaddr, mapping)) {
+                throw std::out_of_range("Page fault: virtual address is not mapped");
+            }
+            PageWalker::Walk walk = walker_.walk(vaddr, mapping, ready);
+            if (walk.merged) {
+                stats_.merged_walks++;
+            } else {
+                stats_.walks++;
+                stats_.walks_by_size[static_cast<uint32_t>(mapping.size)]++;
+                stats_.page_table_reads += walk.reads;
+            }
+            stats_.walker_stalls += walk.stalled ? 1 : 0;
+            stats_.total_walk_latency += walk.done - ready;
+            walk_latency_.record(walk.done - ready);
+            ready = walk.done;
+            result.level = TranslationLevel::PAGE_WALK;
+            l2_tlb_.insert(mapping, ready);
+        }
+        l1.insert(mapping, ready);
+    }
+
+    result.physical_address = mapping.translate(vaddr);
+    result.page_size = mapping.size;
+    result.ready = ready;
+    result.latency = static_cast<uint32_t>(ready - cycle);
+    stats_.total_latency += result.latency;
+    return result;
+}
+
+void AddressTranslation::invalidate(uint64_t vaddr) {
+    for (Tlb& l1 : l1_tlbs_) {
+        l1.invalidate(vaddr);
+    }
+    l2_tlb_.invalidate(vaddr);
+}
+
+void AddressTranslation::flush() {
+    for (Tlb& l1 : l1_tlbs_) {
+        l1.flush();
+    }
+    l2_tlb_.flush();
+    walker_.flush_walk_cache();
+}
+
+void AddressTranslation::reset_stats() {
+    stats_ = TranslationStats();
+    walk_latency_.clear();
+}
+
+void AddressTranslation::clear() {
+    flush();
+    walker_.clear();
+    reset_stats();
+}
@@ -0,0 +1,318 @@
+#ifndef ADDRESS_TRANSLATION_H
+#define ADDRESS_TRANSLATION_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "cache_array.h"
+#include "replacement_policy.h"
+#include "latency_histogram.h"
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// Page sizes. 64 KB pages are leaf entries at the 4 KB level covering 16
+// contiguous slots (like a contiguous-hint PTE), so they walk as deep as
+// 4 KB pages but take one TLB entry; 2 MB pages are leaves one level up.
+enum class PageSize : uint8_t { SIZE_4KB, SIZE_64KB, SIZE_2MB };
+
+const uint32_t NUM_PAGE_SIZES = 3;
+
+inline uint32_t page_shift(PageSize size) {
+    return size == PageSize::SIZE_4KB ? 12 : size == PageSize::SIZE_64KB ? 16 : 21;
+}
+inline uint64_t page_bytes(PageSize size) { return 1ULL << page_shift(size); }
+
+// One virtual-to-physical page mapping
+struct PageMapping {
+    uint64_t virtual_base = 0;
+    uint64_t physical_base = 0;
+    PageSize size = PageSize::SIZE_4KB;
+
+    uint64_t translate(uint64_t vaddr) const { return physical_base + (vaddr - virtual_base); }
+};
+
+// Four-level radix page table over a 48-bit virtual address space
+//
+// Levels are numbered from the root: level 0 indexes bits 47:39, level 1
+// bits 38:30, level 2 bits 29:21 and level 3 bits 20:12, 512 entries each.
+// A walk reads one entry per level down to the leaf, so 4 KB and 64 KB
+// pages take four reads and 2 MB pages three. Only leaves are stored; the
+// intermediate tables are implied by the leaves below them.
+class PageTable {
+public:
+    static const uint32_t LEVELS = 4;
+    static const uint32_t VIRTUAL_ADDRESS_BITS = 48;
+
+    // Map one page (throws std::invalid_argument for misaligned or
+    // overlapping mappings)
+    void map(uint64_t vaddr, uint64_t paddr, PageSize size);
+
+    // Map [vaddr, vaddr + bytes) onto contiguous physical memory with pages
+    // of one size; bytes is rounded up to whole pages
+    void map_range(uint64_t vaddr, uint64_t paddr, uint64_t bytes, PageSize size);
+
+    // Remove the page containing vaddr; returns false if none
+    bool unmap(uint64_t vaddr);
+
+    // Leaf covering vaddr, if mapped
+    bool lookup(uint64_t vaddr, PageMapping& mapping) const;
+
+    // Levels read by a walk that ends at a leaf of this size
+    static uint32_t walk_depth(PageSize size) { return size == PageSize::SIZE_2MB ? LEVELS - 1 : LEVELS; }
+
+    // Bits of vaddr that select the entry at level (the virtual address
+    // prefix down to and including that level)
+    static uint64_t level_prefix(uint64_t vaddr, uint32_t level) { return vaddr >> (39 - 9 * level); }
+
+    // Pages mapped, per size
+    size_t num_pages() const;
+    size_t num_pages(PageSize size) const { return pages_[static_cast<uint32_t>(size)].size(); }
+
+    // Reset
+    void clear();
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    // Physical base per virtual page number, one map per page size
+    std::unordered_map<uint64_t, uint64_t> pages_[NUM_PAGE_SIZES];
+
+    bool overlaps(uint64_t vaddr, PageSize size) const;
+};
+
+// Geometry and lookup latency of one TLB. Cycles are core clock cycles.
+struct TlbConfig {
+    uint32_t entries = 32;
+    uint32_t associativity = 32;   // entries / associativity sets; equal for fully associative
+    uint32_t latency = 1;          // Lookup latency, hit or miss
+};
+
+// Set-associative TLB holding all page sizes
+//
+// Entries are indexed by the virtual page number of their own page size,
+// so a lookup probes the set of each size the TLB currently holds
+// (hash-rehash) and one entry maps a whole page whatever its size. Tags
+// and replacement state are a tag-only CacheArray and the cache
+// replacement policy; the physical base lives beside the tags.
+class Tlb {
+public:
+    // Constructor (throws std::invalid_argument for a degenerate geometry)
+    explicit Tlb(const TlbConfig& config = TlbConfig());
+
+    // Translation of vaddr if an entry covers it; a hit updates replacement
+    // state. ready is the cycle the entry's fill completes, so hits under
+    // an outstanding walk wait for it.
+    bool lookup(uint64_t vaddr, PageMapping& mapping, uint64_t& ready);
+
+    // Install a translation available from cycle ready, evicting by the
+    // replacement policy
+    void insert(const PageMapping& mapping, uint64_t ready = 0);
+
+    // Drop the entry covering vaddr (returns false if none), or every entry
+    bool invalidate(uint64_t vaddr);
+    void flush();
+
+    // Bytes of virtual memory currently mapped by valid entries
+    uint64_t reach() const;
+    uint32_t occupancy() const;
+
+    const TlbConfig& config() const { return config_; }
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    TlbConfig config_;
+    uint32_t num_sets_;
+    CacheArray entries_;                       // Tag = virtual page number << 2 | page size
+    CacheReplacementPolicy replacement_;
+    std::vector<uint64_t> physical_base_;      // Per entry, indexed like the tags
+    std::vector<uint64_t> ready_;
+    uint32_t resident_[NUM_PAGE_SIZES];        // Valid entries per page size
+
+    static uint64_t make_tag(uint64_t vaddr, PageSize size) {
+        return (vaddr >> page_shift(size)) << 2 | static_cast<uint64_t>(size);
+    }
+    uint32_t set_of(uint64_t vaddr, PageSize size) const {
+        return static_cast<uint32_t>((vaddr >> page_shift(size)) % num_sets_);
+    }
+    bool find(uint64_t vaddr, PageSize size, uint32_t& set, uint32_t& way) const;
+    void remove(uint32_t set, uint32_t way);
+};
+
+// Page-table walker configuration. Cycles are core clock cycles.
+struct PageWalkerConfig {
+    uint32_t num_walkers = 8;            // Concurrent walks
+    uint32_t walk_cache_entries = 32;    // Fully associative, at most 64
+    uint32_t memory_latency = 200;       // One page-table entry read through the L2
+    uint32_t walk_cache_latency = 2;     // Walk cache probe at the start of a walk
+};
+
+// Multi-threaded page-table walker
+//
+// Up to num_walkers walks are in flight at once; a walk that finds every
+// walker busy waits for the first to free up. Misses to a page whose walk
+// is already in flight merge into it instead of walking again. The walk
+// cache holds non-leaf entries tagged by level and virtual address prefix
+// (a translation cache): a walk starts below the deepest cached level, so
+// a hit on the level-2 entry leaves a single read for a 4 KB page. Each
+// remaining level costs one memory_latency read.
+class PageWalker {
+public:
+    // Walk outcome
+    struct Walk {
+        uint64_t done = 0;           // Cycle the leaf entry is known
+        uint32_t reads = 0;          // Page-table entries read from memory
+        bool merged = false;         // Joined an in-flight walk of the same page
+        bool stalled = false;        // Waited for a free walker
+    };
+
+    // Constructor (throws std::invalid_argument for a degenerate configuration)
+    explicit PageWalker(const PageWalkerConfig& config = PageWalkerConfig());
+
+    // Walk to the leaf mapping vaddr, starting at cycle
+    Walk walk(uint64_t vaddr, const PageMapping& leaf, uint64_t cycle);
+
+    // Drop every walk cache entry
+    void flush_walk_cache();
+
+    // Walk cache effectiveness: walks that skipped at least one level, and
+    // walks that started at the root
+    uint64_t walk_cache_hits() const { return walk_cache_hits_; }
+    uint64_t walk_cache_misses() const { return walk_cache_misses_; }
+
+    const PageWalkerConfig& config() const { return config_; }
+    uint32_t busy_walkers(uint64_t cycle) const;
+
+    // Reset
+    void clear();
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    PageWalkerConfig config_;
+    std::vector<uint64_t> walker_free_;                    // Cycle each walker becomes free
+    std::unordered_map<uint64_t, uint64_t> in_flight_;     // Leaf virtual base -> walk completion
+    CacheArray walk_cache_;                                // Tag = prefix << 2 | level
+    CacheReplacementPolicy walk_cache_replacement_;
+    uint64_t walk_cache_hits_;
+    uint64_t walk_cache_misses_;
+
+    static uint64_t walk_cache_tag(uint64_t vaddr, uint32_t level) {
+        return PageTable::level_prefix(vaddr, level) << 2 | level;
+    }
+
+    // Drop walks that completed before cycle once the map grows
+    void prune(uint64_t cycle);
+};
+
+// Where a translation was found
+enum class TranslationLevel : uint8_t { L1_TLB, L2_TLB, PAGE_WALK };
+
+// Address translation configuration: a private L1 TLB per core in front
+// of a shared L2 TLB and the page-table walker
+struct AddressTranslationConfig {
+    uint32_t num_cores = 16;
+    TlbConfig l1 = TlbConfig();
+    TlbConfig l2 = {1024, 8, 10};
+    PageWalkerConfig walker = PageWalkerConfig();
+};
+
+// Outcome of one translation
+struct TranslationResult {
+    uint64_t physical_address = 0;
+    PageSize page_size = PageSize::SIZE_4KB;
+    TranslationLevel level = TranslationLevel::L1_TLB;
+    uint64_t ready = 0;          // Cycle the physical address is available
+    uint32_t latency = 0;        // Cycles from the request
+};
+
+// Translation statistics
+struct TranslationStats {
+    uint64_t translations = 0;
+    uint64_t l1_hits = 0;
+    uint64_t l1_misses = 0;
+    uint64_t l2_hits = 0;
+    uint64_t l2_misses = 0;
+    uint64_t walks = 0;                          // Walks started (excludes merged misses)
+    uint64_t merged_walks = 0;                   // L2 misses merged into an in-flight walk
+    uint64_t walker_stalls = 0;                  // Walks that waited for a free walker
+    uint64_t page_table_reads = 0;
+    uint64_t walks_by_size[NUM_PAGE_SIZES] = {};
+    uint64_t total_latency = 0;
+    uint64_t total_walk_latency = 0;             // L2 miss to leaf, merged misses included
+
+    double l1_miss_rate() const { return translations > 0 ? static_cast<double>(l1_misses) / translations : 0.0; }
+    double l2_miss_rate() const {
+        return l1_misses > 0 ? static_cast<double>(l2_misses) / l1_misses : 0.0;
+    }
+    double average_latency() const {
+        return translations > 0 ? static_cast<double>(total_latency) / translations : 0.0;
+    }
+    double average_walk_latency() const {
+        return l2_misses > 0 ? static_cast<double>(total_walk_latency) / l2_misses : 0.0;
+    }
+};
+
+// Virtual memory for the memory hierarchy
+//
+// Translates a core's virtual address to a physical address and reports
+// when it is available: the core's L1 TLB is looked up first, its misses
+// go to the shared L2 TLB, and L2 TLB misses walk the page table. Fills go
+// into both TLB levels. Like AtomicUnit, timing is computed per request
+// from its arrival cycle rather than ticked. Accesses to unmapped pages
+// are page faults and throw, since the model has no fault handling.
+class AddressTranslation {
+public:
+    // Constructor
+    explicit AddressTranslation(const AddressTranslationConfig& config = AddressTranslationConfig());
+
+    // Page table shared by all cores
+    PageTable& page_table() { return page_table_; }
+    const PageTable& page_table() const { return page_table_; }
+
+    // Translate vaddr for core at cycle (throws std::out_of_range on a page fault)
+    TranslationResult translate(uint32_t core, uint64_t vaddr, uint64_t cycle);
+
+    // TLB shootdown of one page, or of every TLB and the walk cache
+    void invalidate(uint64_t vaddr);
+    void flush();
+
+    // TLB reach in bytes: a core's L1 TLB and the shared L2 TLB
+    uint64_t l1_reach(uint32_t core) const { return l1_tlbs_.at(core).reach(); }
+    uint64_t l2_reach() const { return l2_tlb_.reach(); }
+
+    // Statistics
+    const AddressTranslationConfig& config() const { return config_; }
+    const TranslationStats& stats() const { return stats_; }
+    const LatencyHistogram& walk_latency() const { return walk_latency_; }
+    const PageWalker& walker() const { return walker_; }
+    void reset_stats();
+
+    // Reset (keeps the page table)
+    void clear();
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    AddressTranslationConfig config_;
+    PageTable page_table_;
+    std::vector<Tlb> l1_tlbs_;
+    Tlb l2_tlb_;
+    PageWalker walker_;
+
+    TranslationStats stats_;
+    LatencyHistogram walk_latency_;
+};
+
+#endif // ADDRESS_TRANSLATION_H
@@ -0,0 +1,157 @@
+#include "atomic_unit.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+// Address entries kept before retired ones are pruned
+const size_t ADDRESS_PRUNE_THRESHOLD = 4096;
+
+int64_t sign_extend(uint64_t value, uint32_t size) {
+    return size == 4 ? static_cast<int64_t>(static_cast<int32_t>(value)) : static_cast<int64_t>(value);
+}
+
+}  // namespace
+
+AtomicUnit::AtomicUnit(const AtomicUnitConfig& config)
+    : config_(config),
+      hotspots_(config.hotspot_capacity) {
+    if (config_.num_slices == 0 || (config_.num_slices & (config_.num_slices - 1)) != 0 ||
+        config_.line_size == 0 || (config_.line_size & (config_.line_size - 1)) != 0 ||
+        config_.word_size == 0 || (config_.word_size & (config_.word_size - 1)) != 0) {
+        throw std::invalid_argument("Atomic unit slice count, line size and word size must be powers of two");
+    }
+    slice_mapping_ = AddressMapping::bit_slice(static_cast<uint32_t>(__builtin_ctz(config_.line_size)),
+                                               static_cast<uint32_t>(__builtin_ctz(config_.num_slices)));
+    clear();
+}
+
+uint64_t AtomicUnit::schedule(uint64_t addr, uint64_t cycle) {
+    prune(cycle);
+    uint32_t slice_index = slice(addr);
+    uint64_t start = cycle;
+    uint64_t word = addr & ~static_cast<uint64_t>(config_.word_size - 1);
+
+    auto it = address_free_.find(word);
+    if (it != address_free_.end() && it->second > start) {
+        start = it->second;
+        stats_.same_address_stalls++;
+        hotspots_.record(word, cycle);
+    }
+    if (slice_free_[slice_index] > start) {
+        start = slice_free_[slice_index];
+        stats_.slice_stalls++;
+    }
+
+    slice_free_[slice_index] = start + config_.slice_interval;
+    address_free_[word] = start + config_.same_address_interval;
+    uint64_t done = start + config_.alu_latency;
+
+    stats_.atomics++;
+    stats_.stall_cycles += start - cycle;
+    stats_.total_latency += done - cycle;
+    slice_load_.record(slice_index);
+    return done;
+}
+
+uint64_t AtomicUnit::execute(const MemoryTransaction& transaction, uint8_t* line_data) const {
+    uint32_t size = transaction.size();
+    if (size != 4 && size != 8) {
+        throw std::invalid_argument("Atomic operands must be 4 or 8 bytes");
+    }
+    uint32_t offset = static_cast<uint32_t>(transaction.address() & (config_.line_size - 1));
+    if (offset % size != 0) {
+        throw std::invalid_argument("Misaligned atomic access");
+    }
+
+    uint64_t old_value = 0;
+    std::memcpy(&old_value, line_data + offset, size);
+
+    uint64_t operand = transaction.data();
+    uint64_t compare = 0;
+    if (transaction.type() == MemoryTransactionType::ATOMIC_CAS) {
+        if (!transaction.has_payload() || transaction.payload().size() != size) {
+            throw std::invalid_argument("ATOMIC_CAS needs its compare value as an operand-sized payload");
+        }
+        std::memcpy(&compare, transaction.payload().data(), size);
+    }
+
+    uint64_t new_value = apply(transaction.type(), old_value, operand, compare, size);
+    std::memcpy(line_data + offset, &new_value, size);
+    return old_value;
+}
+
+uint64_t AtomicUnit::apply(MemoryTransactionType type, uint64_t old_value, uint64_t operand,
+                           uint64_t compare, uint32_t size) {
+    uint64_t mask = size == 8 ? ~0ULL : (1ULL << (size * 8)) - 1;
+    old_value &= mask;
+    operand &= mask;
+    uint64_t result;
+    switch (type) {
+        case MemoryTransactionType::ATOMIC_ADD:
+            result = old_value + operand;
+            break;
+        case MemoryTransactionType::ATOMIC_AND:
+            result = old_value & operand;
+            break;
+        case MemoryTransactionType::ATOMIC_OR:
+            result = old_value | operand;
+            break;
+        case MemoryTransactionType::ATOMIC_XOR:
+            result = old_value ^ operand;
+            break;
+        case MemoryTransactionType::ATOMIC_MIN:
+            result = sign_extend(operand, size) < sign_extend(old_value, size) ? operand : old_value;
+            break;
+        case MemoryTransactionType::ATOMIC_MAX:
+            result = sign_extend(operand, size) > sign_extend(old_value, size) ? operand : old_value;
+            break;
+        case MemoryTransactionType::ATOMIC_EXCH:
+            result = operand;
+            break;
+        case MemoryTransactionType::ATOMIC_CAS:
+            result = old_value == (compare & mask) ? operand : old_value;
+            break;
+        default:
+            throw std::invalid_argument("Not an atomic transaction type");
+    }
+    return result & mask;
+}
+
+void AtomicUnit::set_slice_mapping(const AddressMapping& mapping) {
+    if (mapping.num_indices() != config_.num_slices) {
+        throw std::invalid_argument("Atomic slice mapping must have one index per slice");
+    }
+    slice_mapping_ = mapping;
+}
+
+void AtomicUnit::reset_stats() {
+    stats_ = AtomicUnitStats();
+    slice_load_.reset();
+    hotspots_.clear();
+}
+
+void AtomicUnit::clear() {
+    slice_free_.assign(config_.num_slices, 0);
+    address_free_.clear();
+    last_cycle_ = 0;
+    stats_ = AtomicUnitStats();
+    slice_load_.reset(config_.num_slices);
+    hotspots_.clear();
+}
+
+void AtomicUnit::prune(uint64_t cycle) {
+    last_cycle_ = std::max(last_cycle_, cycle);
+    if (address_free_.size() < ADDRESS_PRUNE_THRESHOLD) {
+        return;
+    }
+    for (auto it = address_free_.begin(); it != address_free_.end();) {
+        if (it->second <= last_cycle_) {
+            it = address_free_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,106 @@
+#ifndef ATOMIC_UNIT_H
+#define ATOMIC_UNIT_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "memory_transaction.h"
+#include "address_mapping.h"
+#include "heavy_hitter_tracker.h"
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// Atomic unit timing. Cycles are L2 clock cycles.
+struct AtomicUnitConfig {
+    uint32_t num_slices = 8;              // L2 slices, each with its own atomic ALU
+    uint32_t slice_interval = 1;          // Cycles between atomics issued at one slice
+    uint32_t same_address_interval = 4;   // Cycles between atomics to one address (RMW turnaround)
+    uint32_t alu_latency = 2;             // Issue to result
+    uint32_t line_size = 128;             // Slice interleaving granularity
+    uint32_t word_size = 8;               // Serialisation granularity (widest operand)
+    uint32_t hotspot_capacity = 256;      // Contended addresses tracked
+};
+
+// Atomic throughput and contention
+struct AtomicUnitStats {
+    uint64_t atomics = 0;
+    uint64_t same_address_stalls = 0;     // Atomics that waited behind one to the same word
+    uint64_t slice_stalls = 0;            // Atomics that waited for a busy slice ALU
+    uint64_t stall_cycles = 0;
+    uint64_t total_latency = 0;
+
+    double average_latency() const {
+        return atomics > 0 ? static_cast<double>(total_latency) / atomics : 0.0;
+    }
+};
+
+// Near-memory atomic ALUs at the L2 slices
+//
+// Atomics execute in place on the L2 line instead of round-tripping to the
+// SM. Each slice issues at most one atomic every slice_interval cycles, and
+// atomics to the same aligned word serialise behind the previous one's
+// read-modify-write, which is what limits histogram and reduction kernels.
+// Keying on the word rather than the byte address makes overlapping
+// operands (e.g. a 4-byte atomic inside an 8-byte one) serialise too.
+// Addresses that serialise are counted in a heavy-hitter tracker so the
+// worst contention hotspots can be reported.
+//
+// Operand encoding (as built by MemoryCoalescer): one transaction per lane
+// at the lane's address, sized to the 4- or 8-byte operand, with the
+// operand in data(). For ATOMIC_CAS data() holds the swap value and the
+// payload holds the little-endian compare value of the same size.
+// ATOMIC_MIN/MAX compare as signed integers of the access size.
+class AtomicUnit {
+public:
+    // Constructor
+    explicit AtomicUnit(const AtomicUnitConfig& config = AtomicUnitConfig());
+
+    // Schedule an atomic arriving at cycle; returns its completion cycle
+    uint64_t schedule(uint64_t addr, uint64_t cycle);
+
+    // Perform the operation on the bytes of a cached line (line_data holds
+    // the line containing the address) and return the old value
+    uint64_t execute(const MemoryTransaction& transaction, uint8_t* line_data) const;
+
+    // Pure operation on values of size bytes (4 or 8)
+    static uint64_t apply(MemoryTransactionType type, uint64_t old_value, uint64_t operand,
+                          uint64_t compare, uint32_t size);
+
+    // Slice of an address (line-interleaved by default)
+    uint32_t slice(uint64_t addr) const { return slice_mapping_.index(addr); }
+    void set_slice_mapping(const AddressMapping& mapping);
+
+    // Statistics
+    const AtomicUnitConfig& config() const { return config_; }
+    const AtomicUnitStats& stats() const { return stats_; }
+    const LoadBalanceHistogram& slice_load() const { return slice_load_; }
+    std::vector<HeavyHitterTracker::Entry> contention_hotspots(uint32_t top_n = 10) const {
+        return hotspots_.top(top_n);
+    }
+    void reset_stats();
+
+    // Reset
+    void clear();
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    AtomicUnitConfig config_;
+    AddressMapping slice_mapping_;
+    std::vector<uint64_t> slice_free_;                 // Next issue cycle per slice
+    std::unordered_map<uint64_t, uint64_t> address_free_;   // Next issue cycle per in-flight word
+    uint64_t last_cycle_;
+
+    AtomicUnitStats stats_;
+    LoadBalanceHistogram slice_load_;
+    HeavyHitterTracker hotspots_;
+
+    // Drop words whose last atomic has retired once the map grows
+    void prune(uint64_t cycle);
+};
+
+#endif // ATOMIC_UNIT_H
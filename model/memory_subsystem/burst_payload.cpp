@@ -0,0 +1,184 @@
+#include "burst_payload.h"
+
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+const uint32_t BurstPayload::MAX_BYTES;
+const uint32_t BurstPayload::ENABLE_WORDS;
+
+namespace {
+
+// Blocks added to the pool each time it runs dry
+const uint32_t POOL_CHUNK_BLOCKS = 256;
+
+// Blocks moved between a thread cache and the shared free list at a time
+const uint32_t THREAD_CACHE_BATCH = 32;
+
+}  // namespace
+
+// The shared pool is a free list threaded through the blocks themselves,
+// guarded by a mutex. Each thread keeps up to two batches of blocks in a
+// private cache so allocation and release normally take no lock.
+struct BurstPayloadPool {
+    std::mutex lock;
+    std::vector<std::unique_ptr<uint8_t[]>> chunks;
+    void* free_list = nullptr;
+    std::atomic<uint64_t> capacity{0};
+    std::atomic<uint64_t> in_use{0};
+
+    // Never destroyed, so payloads held by static objects stay valid during shutdown
+    static BurstPayloadPool& instance() {
+        static BurstPayloadPool* pool = new BurstPayloadPool();
+        return *pool;
+    }
+};
+
+struct BurstPayloadThreadCache {
+    std::vector<void*> blocks;
+
+    // Return cached blocks to the shared pool when the thread exits
+    ~BurstPayloadThreadCache();
+
+    static BurstPayloadThreadCache& instance() {
+        thread_local BurstPayloadThreadCache cache;
+        return cache;
+    }
+};
+
+BurstPayload::Block* BurstPayload::allocate_block(uint32_t size) {
+    if (size == 0 || size > MAX_BYTES) {
+        throw std::invalid_argument("BurstPayload size must be between 1 and " +
+                                    std::to_string(MAX_BYTES) + " bytes");
+    }
+
+    BurstPayloadThreadCache& cache = BurstPayloadThreadCache::instance();
+    if (cache.blocks.empty()) {
+        BurstPayloadPool& pool = BurstPayloadPool::instance();
+        std::lock_guard<std::mutex> guard(pool.lock);
+        if (pool.free_list == nullptr) {
+            std::unique_ptr<uint8_t[]> chunk(new uint8_t[sizeof(Block) * POOL_CHUNK_BLOCKS]);
+            for (uint32_t i = 0; i < POOL_CHUNK_BLOCKS; i++) {
+                Block* block = new (chunk.get() + i * sizeof(Block)) Block();
+                block->next_free = static_cast<Block*>(pool.free_list);
+                pool.free_list = block;
+            }
+            pool.chunks.push_back(std::move(chunk));
+            pool.capacity += POOL_CHUNK_BLOCKS;
+        }
+        for (uint32_t i = 0; i < THREAD_CACHE_BATCH && pool.free_list != nullptr; i++) {
+            Block* block = static_cast<Block*>(pool.free_list);
+            pool.free_list = block->next_free;
+            cache.blocks.push_back(block);
+        }
+    }
+
+    Block* block = static_cast<Block*>(cache.blocks.back());
+    cache.blocks.pop_back();
+    BurstPayloadPool::instance().in_use.fetch_add(1, std::memory_order_relaxed);
+
+    block->ref_count.store(1, std::memory_order_relaxed);
+    block->size = size;
+    std::memset(block->byte_enable, 0, sizeof(block->byte_enable));
+    for (uint32_t offset = 0; offset < size; offset += 64) {
+        uint32_t bits = size - offset < 64 ? size - offset : 64;
+        block->byte_enable[offset / 64] = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+    }
+    return block;
+}
+
+void BurstPayload::free_block(Block* block) {
+    BurstPayloadPool& pool = BurstPayloadPool::instance();
+    pool.in_use.fetch_sub(1, std::memory_order_relaxed);
+
+    BurstPayloadThreadCache& cache = BurstPayloadThreadCache::instance();
+    cache.blocks.push_back(block);
+    if (cache.blocks.size() >= 2 * THREAD_CACHE_BATCH) {
+        std::lock_guard<std::mutex> guard(pool.lock);
+        for (uint32_t i = 0; i < THREAD_CACHE_BATCH; i++) {
+            Block* spilled = static_cast<Block*>(cache.blocks.back());
+            cache.blocks.pop_back();
+            spilled->next_free = static_cast<Block*>(pool.free_list);
+            pool.free_list = spilled;
+        }
+    }
+}
+
+BurstPayloadThreadCache::~BurstPayloadThreadCache() {
+    BurstPayloadPool& pool = BurstPayloadPool::instance();
+    std::lock_guard<std::mutex> guard(pool.lock);
+    for (void* block : blocks) {
+        static_cast<BurstPayload::Block*>(block)->next_free = static_cast<BurstPayload::Block*>(pool.free_list);
+        pool.free_list = block;
+    }
+}
+
+BurstPayload::BurstPayload(uint32_t size)
+    : block_(allocate_block(size)) {
+    std::memset(block_->data, 0, size);
+}
+
+BurstPayload::BurstPayload(const uint8_t* data, uint32_t size)
+    : block_(allocate_block(size)) {
+    std::memcpy(block_->data, data, size);
+}
+
+uint8_t* BurstPayload::mutable_data() {
+    if (block_ == nullptr) {
+        return nullptr;
+    }
+    if (block_->ref_count.load(std::memory_order_acquire) > 1) {
+        // Copy on write: detach from the other holders
+        Block* copy = allocate_block(block_->size);
+        std::memcpy(copy->byte_enable, block_->byte_enable, sizeof(copy->byte_enable));
+        std::memcpy(copy->data, block_->data, block_->size);
+        release();
+        block_ = copy;
+    }
+    return block_->data;
+}
+
+bool BurstPayload::all_enabled() const {
+    for (uint32_t offset = 0; offset < size(); offset++) {
+        if (!byte_enabled(offset)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void BurstPayload::set_byte_enable(uint32_t offset, uint32_t length, bool enabled) {
+    if (offset + length > size()) {
+        throw std::out_of_range("BurstPayload byte enable range exceeds payload size");
+    }
+    mutable_data();
+    for (uint32_t i = offset; i < offset + length; i++) {
+        if (enabled) {
+            block_->byte_enable[i / 64] |= 1ULL << (i % 64);
+        } else {
+            block_->byte_enable[i / 64] &= ~(1ULL << (i % 64));
+        }
+    }
+}
+
+bool BurstPayload::operator == (const BurstPayload& other) const {
+    if (block_ == other.block_) {
+        return true;
+    }
+    if (block_ == nullptr || other.block_ == nullptr || block_->size != other.block_->size) {
+        return false;
+    }
+    return std::memcmp(block_->byte_enable, other.block_->byte_enable, sizeof(block_->byte_enable)) == 0 &&
+           std::memcmp(block_->data, other.block_->data, block_->size) == 0;
+}
+
+uint64_t BurstPayload::pool_capacity() {
+    return BurstPayloadPool::instance().capacity;
+}
+
+uint64_t BurstPayload::pool_in_use() {
+    return BurstPayloadPool::instance().in_use;
+}
@@ -0,0 +1,103 @@
+#ifndef BURST_PAYLOAD_H
+#define BURST_PAYLOAD_H
+
+#include <atomic>
+#include <cstdint>
+
+// Variable-size burst payload carried by MemoryTransaction and MemoryResponse
+//
+// Holds up to one cache line of data plus a per-byte enable mask in a
+// fixed-size block taken from a process-wide pool. Copies share the block
+// through a reference count, so a payload travels through sc_signal and
+// the cache hierarchy without heap allocation or copying its bytes; the
+// first write through a shared handle detaches a private copy. Reference
+// counts are atomic and each host thread allocates from its own cache of
+// pool blocks, so payloads may cross threads (e.g. through
+// ConcurrentTransactionQueue); a single handle is not itself thread-safe.
+class BurstPayload {
+public:
+    static const uint32_t MAX_BYTES = 128;  // Largest cache line in the hierarchy
+
+    // Constructors
+    BurstPayload() : block_(nullptr) {}
+    explicit BurstPayload(uint32_t size);  // Zeroed, all bytes enabled
+    BurstPayload(const uint8_t* data, uint32_t size);
+    BurstPayload(const BurstPayload& other) : block_(other.block_) { retain(); }
+    BurstPayload(BurstPayload&& other) noexcept : block_(other.block_) { other.block_ = nullptr; }
+
+    BurstPayload& operator = (const BurstPayload& other) {
+        if (block_ != other.block_) {
+            release();
+            block_ = other.block_;
+            retain();
+        }
+        return *this;
+    }
+    BurstPayload& operator = (BurstPayload&& other) noexcept {
+        if (this != &other) {
+            release();
+            block_ = other.block_;
+            other.block_ = nullptr;
+        }
+        return *this;
+    }
+
+    // Destructor
+    ~BurstPayload() { release(); }
+
+    // Payload properties
+    bool empty() const { return block_ == nullptr; }
+    uint32_t size() const { return block_ != nullptr ? block_->size : 0; }
+    uint32_t use_count() const { return block_ != nullptr ? block_->ref_count.load(std::memory_order_relaxed) : 0; }
+
+    // Data access; mutable_data() detaches a shared block first
+    const uint8_t* data() const { return block_ != nullptr ? block_->data : nullptr; }
+    uint8_t* mutable_data();
+
+    // Byte enables
+    bool byte_enabled(uint32_t offset) const {
+        return (block_->byte_enable[offset / 64] >> (offset % 64)) & 1;
+    }
+    bool all_enabled() const;
+    void set_byte_enable(uint32_t offset, uint32_t length, bool enabled);
+
+    // Equal if both share a block or hold identical bytes and enables
+    bool operator == (const BurstPayload& other) const;
+    bool operator != (const BurstPayload& other) const { return !(*this == other); }
+
+    // Pool statistics
+    static uint64_t pool_capacity();
+    static uint64_t pool_in_use();
+
+private:
+    friend struct BurstPayloadThreadCache;
+
+    static const uint32_t ENABLE_WORDS = MAX_BYTES / 64;
+
+    struct Block {
+        std::atomic<uint32_t> ref_count;
+        uint32_t size;
+        uint64_t byte_enable[ENABLE_WORDS];
+        uint8_t data[MAX_BYTES];
+        Block* next_free;
+    };
+
+    Block* block_;
+
+    void retain() {
+        if (block_ != nullptr) {
+            block_->ref_count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    void release() {
+        if (block_ != nullptr && block_->ref_count.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            free_block(block_);
+        }
+        block_ = nullptr;
+    }
+
+    static Block* allocate_block(uint32_t size);
+    static void free_block(Block* block);
+};
+
+#endif // BURST_PAYLOAD_H
@@ -0,0 +1,55 @@
+#include "cache_array.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+const uint64_t CacheArray::INVALID_TAG;
+const uint32_t CacheArray::MAX_ASSOCIATIVITY;
+
+CacheArray::CacheArray(uint32_t num_sets, uint32_t associativity, uint32_t line_size, bool store_data)
+    : num_sets_(num_sets),
+      associativity_(associativity),
+      line_size_(line_size) {
+    if (associativity_ == 0 || associativity_ > MAX_ASSOCIATIVITY) {
+        throw std::invalid_argument("CacheArray associativity must be between 1 and 64");
+    }
+    way_mask_ = associativity_ == 64 ? ~0ULL : (1ULL << associativity_) - 1;
+    
+    size_t num_lines = static_cast<size_t>(num_sets_) * associativity_;
+    tags_.assign(num_lines, INVALID_TAG);
+    state_.assign(num_lines, 0);
+    valid_.assign(num_sets_, 0);
+    dirty_.assign(num_sets_, 0);
+    if (store_data) {
+        data_.assign(num_lines * line_size_, 0);
+    }
+}
+
+void CacheArray::fill(uint32_t set, uint32_t way, uint64_t tag, const uint8_t* data) {
+    tags_[line_index(set, way)] = tag;
+    valid_[set] |= 1ULL << way;
+    dirty_[set] &= ~(1ULL << way);
+    if (data_.empty()) {
+        return;
+    }
+    if (data != nullptr) {
+        std::memcpy(line_data(set, way), data, line_size_);
+    } else {
+        std::memset(line_data(set, way), 0, line_size_);
+    }
+}
+
+void CacheArray::invalidate(uint32_t set, uint32_t way) {
+    tags_[line_index(set, way)] = INVALID_TAG;
+    valid_[set] &= ~(1ULL << way);
+    dirty_[set] &= ~(1ULL << way);
+    state_[line_index(set, way)] = 0;
+}
+
+void CacheArray::clear() {
+    std::fill(tags_.begin(), tags_.end(), INVALID_TAG);
+    std::fill(state_.begin(), state_.end(), 0);
+    std::fill(valid_.begin(), valid_.end(), 0);
+    std::fill(dirty_.begin(), dirty_.end(), 0);
+}
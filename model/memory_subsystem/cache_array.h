@@ -0,0 +1,131 @@
+#ifndef CACHE_ARRAY_H
+#define CACHE_ARRAY_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// Tag and data storage shared by CacheL1 and CacheL2
+//
+// State is kept as flat structure-of-arrays indexed by (set, way): tags of
+// one set are contiguous so a lookup is a single vector compare, valid and
+// dirty bits are per-set way bitmasks, and line data lives in one slab.
+// Invalid ways hold INVALID_TAG so lookups need not consult the valid mask.
+// Trace-driven models that only need hit/miss behaviour build tag-only
+// arrays without the data slab.
+class CacheArray {
+public:
+    static const uint64_t INVALID_TAG = ~0ULL;
+    static const uint32_t MAX_ASSOCIATIVITY = 64;
+    
+    // Constructor (throws std::invalid_argument for associativity > 64)
+    CacheArray(uint32_t num_sets, uint32_t associativity, uint32_t line_size, bool store_data = true);
+    
+    // Geometry
+    uint32_t num_sets() const { return num_sets_; }
+    uint32_t associativity() const { return associativity_; }
+    uint32_t line_size() const { return line_size_; }
+    bool stores_data() const { return !data_.empty(); }
+    
+    // Lookup: way holding tag in set, or -1 on miss
+    int32_t find(uint32_t set, uint64_t tag) const {
+        const uint64_t* tags = &tags_[line_index(set, 0)];
+        uint32_t way = 0;
+#if defined(__AVX2__)
+        const __m256i needle = _mm256_set1_epi64x(static_cast<long long>(tag));
+        for (; way + 4 <= associativity_; way += 4) {
+            __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tags + way));
+            int mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, needle)));
+            if (mask != 0) {
+                return static_cast<int32_t>(way + __builtin_ctz(mask));
+            }
+        }
+#elif defined(__SSE4_1__)
+        const __m128i needle = _mm_set1_epi64x(static_cast<long long>(tag));
+        for (; way + 2 <= associativity_; way += 2) {
+            __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tags + way));
+            int mask = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(v, needle)));
+            if (mask != 0) {
+                return static_cast<int32_t>(way + __builtin_ctz(mask));
+            }
+        }
+#endif
+        for (; way < associativity_; way++) {
+            if (tags[way] == tag) {
+                return static_cast<int32_t>(way);
+            }
+        }
+        return -1;
+    }
+    
+    // First invalid way in set, or -1 if the set is full
+    int32_t find_invalid(uint32_t set) const {
+        uint64_t free_ways = ~valid_[set] & way_mask_;
+        return free_ways != 0 ? static_cast<int32_t>(__builtin_ctzll(free_ways)) : -1;
+    }
+    
+    // Per-line state
+    bool valid(uint32_t set, uint32_t way) const { return (valid_[set] >> way) & 1; }
+    bool dirty(uint32_t set, uint32_t way) const { return (dirty_[set] >> way) & 1; }
+    uint64_t tag(uint32_t set, uint32_t way) const { return tags_[line_index(set, way)]; }
+    uint64_t valid_mask(uint32_t set) const { return valid_[set]; }
+    uint64_t dirty_mask(uint32_t set) const { return dirty_[set]; }
+    void set_dirty(uint32_t set, uint32_t way, bool dirty) {
+        if (dirty) {
+            dirty_[set] |= 1ULL << way;
+        } else {
+            dirty_[set] &= ~(1ULL << way);
+        }
+    }
+    
+    // Auxiliary per-line state byte (e.g. coherence state)
+    uint8_t state(uint32_t set, uint32_t way) const { return state_[line_index(set, way)]; }
+    void set_state(uint32_t set, uint32_t way, uint8_t state) { state_[line_index(set, way)] = state; }
+    
+    // Line data in the contiguous slab (not available in tag-only arrays)
+    uint8_t* line_data(uint32_t set, uint32_t way) {
+        return &data_[static_cast<size_t>(line_index(set, way)) * line_size_];
+    }
+    const uint8_t* line_data(uint32_t set, uint32_t way) const {
+        return &data_[static_cast<size_t>(line_index(set, way)) * line_size_];
+    }
+    
+    // Line management
+    void fill(uint32_t set, uint32_t way, uint64_t tag, const uint8_t* data);
+    void invalidate(uint32_t set, uint32_t way);
+    void clear();
+    
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
+private:
+    uint32_t num_sets_;
+    uint32_t associativity_;
+    uint32_t line_size_;
+    uint64_t way_mask_;
+    
+    // Structure-of-arrays line state, indexed by set * associativity + way
+    std::vector<uint64_t> tags_;
+    std::vector<uint8_t> state_;
+    
+    // Per-set way bitmasks
+    std::vector<uint64_t> valid_;
+    std::vector<uint64_t> dirty_;
+    
+    // Line data slab
+    std::vector<uint8_t> data_;
+    
+    size_t line_index(uint32_t set, uint32_t way) const {
+        return static_cast<size_t>(set) * associativity_ + way;
+    }
+};
+
+#endif // CACHE_ARRAY_H
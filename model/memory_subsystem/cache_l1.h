@@ -6,8 +6,20 @@
 #include <unordered_map>
 #include <list>
 #include <cstdint>
+#include <stdexcept>
 #include "memory_transaction.h"
 #include "memory_response.h"
+#include "cache_array.h"
+#include "replacement_policy.h"
+#include "prefetcher.h"
+#include "address_mapping.h"
+#include "mshr_file.h"
+#include "write_policy.h"
+#include "coherence_directory.h"
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
 
 // L1 Cache implementation
 class CacheL1 : public sc_module {
@@ -46,9 +58,96 @@ public:
     uint64_t misses() const { return misses_; }
     double hit_rate() const;
     
+    // Replacement policy (selected at build time) and its statistics
+    static const char* replacement_policy() { return CacheReplacementPolicy::name(); }
+    const ReplacementStats& replacement_stats() const { return replacement_.stats(); }
+    
+    // Hardware prefetcher (disabled by default)
+    void configure_prefetcher(const PrefetcherConfig& config) { prefetcher_ = Prefetcher(config); }
+    const PrefetchStats& prefetch_stats() const { return prefetcher_.stats(); }
+    
+    // Write policy (write-back/write-allocate by default) and the
+    // write-combining buffer for stores sent on to L2. Under relaxed
+    // coherence store hits always write through.
+    void configure_write_policy(const WritePolicyConfig& config) {
+        WritePolicyConfig policy = config;
+        if (coherence_mode_ == CoherenceMode::RELAXED) {
+            policy.hit = WriteHitPolicy::WRITE_THROUGH;
+        }
+        writes_ = CacheWritePolicy(policy, line_size_);
+    }
+    const WriteTrafficStats& write_stats() const { return writes_.stats(); }
+    const WriteCombiningStats& combining_stats() const { return writes_.combining_stats(); }
+    void flush_writes() { writes_.flush(); }
+    
+    // Set index mapping (a bit slice above the line offset by default).
+    // Set it before simulation starts; resident lines are not remapped.
+    void set_index_mapping(const AddressMapping& mapping) {
+        if (mapping.num_indices() != num_sets_) {
+            throw std::invalid_argument("Set index mapping must have one index per set");
+        }
+        set_mapping_ = mapping;
+    }
+    const AddressMapping& index_mapping() const { return set_mapping_; }
+    
+    // Accesses per set since the last reset
+    const LoadBalanceHistogram& set_load() const { return set_load_; }
+    
+    // Coherence mode of the L2 directory above this cache. Relaxed mode
+    // only publishes stores at L2, so it switches the write policy to
+    // write-through. Set it before simulation starts.
+    void set_coherence_mode(CoherenceMode mode) {
+        coherence_mode_ = mode;
+        configure_write_policy(writes_.config());
+    }
+    CoherenceMode coherence_mode() const { return coherence_mode_; }
+    
+    // Coherence actions: an invalidation or downgrade from the L2 directory,
+    // or self-invalidation of the whole cache at BARRIER/SYNC in relaxed mode.
+    // Dirty lines are written back to L2 first, so no store is lost.
+    bool invalidate_line(uint64_t addr) {
+        uint32_t set_index, line_index;
+        if (!lookup(addr, set_index, line_index)) {
+            return false;
+        }
+        writes_.writeback_line(lines_, set_index, line_index);
+        lines_.invalidate(set_index, line_index);
+        replacement_.on_invalidate(set_index, line_index);
+        return true;
+    }
+    bool downgrade_line(uint64_t addr) {
+        uint32_t set_index, line_index;
+        if (!lookup(addr, set_index, line_index)) {
+            return false;
+        }
+        writes_.writeback_line(lines_, set_index, line_index);
+        return true;
+    }
+    uint32_t invalidate_all() {
+        uint32_t dropped = 0;
+        for (uint32_t set = 0; set < num_sets_; set++) {
+            for (uint64_t ways = lines_.valid_mask(set); ways != 0; ways &= ways - 1) {
+                uint32_t way = static_cast<uint32_t>(__builtin_ctzll(ways));
+                writes_.writeback_line(lines_, set, way);
+                lines_.invalidate(set, way);
+                replacement_.on_invalidate(set, way);
+                dropped++;
+            }
+        }
+        return dropped;
+    }
+    
+    // MSHR statistics (merged misses, stalls on exhausted MSHRs)
+    const MshrStats& mshr_stats() const { return mshrs_.stats(); }
+    uint32_t outstanding_misses() const { return mshrs_.occupancy(); }
+    
     // Reset statistics
     void reset_stats();
     
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
 private:
     // Cache configuration
     uint32_t size_bytes_;
@@ -60,32 +159,31 @@ private:
     uint64_t hits_;
     uint64_t misses_;
     
-    // Cache line definition
-    struct CacheLine {
-        bool valid;
-        bool dirty;
-        uint64_t tag;
-        std::vector<uint8_t> data;
-        uint64_t last_access_time;
-    };
+    // Cache storage - flat tag/state arrays and data slab indexed by (set, way)
+    CacheArray lines_;
+    
+    // Set index mapping and the per-set access histogram recorded on lookup
+    AddressMapping set_mapping_;
+    LoadBalanceHistogram set_load_;
     
-    // Cache storage - sets of cache lines
-    std::vector<std::vector<CacheLine>> cache_sets_;
+    // Replacement state, updated on every hit, fill and invalidation
+    CacheReplacementPolicy replacement_;
+    
+    // Prefetcher, trained on demand accesses; its requests use spare MSHRs
+    Prefetcher prefetcher_;
+    
+    // Store handling: hit/miss policy, dirty writebacks and combined
+    // write-through traffic queued for L2
+    CacheWritePolicy writes_;
+    CoherenceMode coherence_mode_ = CoherenceMode::DIRECTORY;
     
     // Pending transactions waiting for responses from L2
     std::vector<MemoryTransaction> pending_transactions_;
     
-    // MSHR (Miss Status Handling Register) for tracking in-flight misses
-    struct MSHR {
-        uint32_t transaction_id;
-        MemoryTransaction original_transaction;
-        uint64_t addr;
-        uint32_t set_index;
-        uint64_t tag;
-        bool pending;
-    };
-    
-    std::unordered_map<uint32_t, MSHR> mshr_entries_;
+    // MSHRs for in-flight misses; secondary misses to a line already being
+    // filled are merged as targets, so hits and further misses proceed
+    // under outstanding misses until the entries are exhausted
+    MshrFile mshrs_;
     uint32_t max_mshr_entries_;
     
     // Transaction counter
@@ -95,16 +193,21 @@ private:
     // Helper methods
     bool lookup(uint64_t addr, uint32_t& set_index, uint32_t& line_index);
     void handle_hit(const MemoryTransaction& transaction, uint32_t set_index, uint32_t line_index);
-    void handle_miss(const MemoryTransaction& transaction);
-    void allocate_line(uint32_t set_index, uint64_t tag, const std::vector<uint8_t>& data);
+    bool handle_miss(const MemoryTransaction& transaction);  // false if stalled on MSHRs
+    void handle_fill(uint32_t mshr_id, const uint8_t* line_data);
+    void allocate_line(uint32_t set_index, uint64_t tag, const uint8_t* data);
     uint32_t select_victim(uint32_t set_index);
     void evict_line(uint32_t set_index, uint32_t line_index);
     
-    // Address translation helpers
-    uint32_t get_set_index(uint64_t addr) const;
-    uint64_t get_tag(uint64_t addr) const;
+    // Address translation helpers. Hashed set indices can fold tag bits
+    // in, so the tag is the whole line number.
+    uint32_t get_set_index(uint64_t addr) const { return set_mapping_.index(addr); }
+    uint64_t get_tag(uint64_t addr) const { return addr / line_size_; }
     uint32_t get_offset(uint64_t addr) const;
     uint64_t get_block_addr(uint64_t addr) const;
+    
+    // Prefetch issue
+    void issue_prefetches(const MemoryTransaction& trigger, bool hit);
 };
 
 #endif // CACHE_L1_H
\ No newline at end of file
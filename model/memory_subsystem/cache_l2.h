@@ -6,8 +6,19 @@
 #include <unordered_map>
 #include <list>
 #include <cstdint>
+#include <stdexcept>
 #include "memory_transaction.h"
 #include "memory_response.h"
+#include "cache_array.h"
+#include "replacement_policy.h"
+#include "prefetcher.h"
+#include "address_mapping.h"
+#include "atomic_unit.h"
+#include "coherence_directory.h"
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
 
 // L2 Cache implementation
 class CacheL2 : public sc_module {
@@ -46,9 +57,47 @@ public:
     uint64_t misses() const { return misses_; }
     double hit_rate() const;
     
+    // Replacement policy (selected at build time) and its statistics
+    static const char* replacement_policy() { return CacheReplacementPolicy::name(); }
+    const ReplacementStats& replacement_stats() const { return replacement_.stats(); }
+    
+    // Hardware prefetcher (disabled by default)
+    void configure_prefetcher(const PrefetcherConfig& config) { prefetcher_ = Prefetcher(config); }
+    const PrefetchStats& prefetch_stats() const { return prefetcher_.stats(); }
+    
+    // Near-memory atomic ALUs: atomics execute in place on L2 lines with
+    // per-slice throughput and same-address serialisation
+    void configure_atomics(const AtomicUnitConfig& config) { atomics_ = AtomicUnit(config); }
+    const AtomicUnitStats& atomic_stats() const { return atomics_.stats(); }
+    const AtomicUnit& atomic_unit() const { return atomics_; }
+    
+    // Coherence of the private L1s: a MESI directory (default) or relaxed
+    // write-through with self-invalidation at BARRIER/SYNC
+    void configure_coherence(const CoherenceConfig& config) { directory_ = CoherenceDirectory(config); }
+    CoherenceDirectory& coherence() { return directory_; }
+    const CoherenceDirectory& coherence() const { return directory_; }
+    const CoherenceStats& coherence_stats() const { return directory_.stats(); }
+    
+    // Set index mapping (a bit slice above the line offset by default).
+    // Set it before simulation starts; resident lines are not remapped.
+    void set_index_mapping(const AddressMapping& mapping) {
+        if (mapping.num_indices() != num_sets_) {
+            throw std::invalid_argument("Set index mapping must have one index per set");
+        }
+        set_mapping_ = mapping;
+    }
+    const AddressMapping& index_mapping() const { return set_mapping_; }
+    
+    // Accesses per set since the last reset
+    const LoadBalanceHistogram& set_load() const { return set_load_; }
+    
     // Reset statistics
     void reset_stats();
     
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
 private:
     // Cache configuration
     uint32_t size_bytes_;
@@ -60,20 +109,29 @@ private:
     uint64_t hits_;
     uint64_t misses_;
     
-    // Cache line definition
-    struct CacheLine {
-        bool valid;
-        bool dirty;
-        uint64_t tag;
-        std::vector<uint8_t> data;
-        uint64_t last_access_time;
-        
-        // Coherence state (for future extensions)
-        enum class State { INVALID, SHARED, EXCLUSIVE, MODIFIED } state;
-    };
+    // Directory state of each line, kept in the array's per-line state byte
+    using LineState = CoherenceState;
+    
+    // Cache storage - flat tag/state arrays and data slab indexed by (set, way)
+    CacheArray lines_;
     
-    // Cache storage - sets of cache lines
-    std::vector<std::vector<CacheLine>> cache_sets_;
+    // Set index mapping and the per-set access histogram recorded on lookup
+    AddressMapping set_mapping_;
+    LoadBalanceHistogram set_load_;
+    
+    // Replacement state, updated on every hit, fill and invalidation
+    CacheReplacementPolicy replacement_;
+    
+    // Prefetcher, trained on demand accesses; its requests use spare MSHRs
+    Prefetcher prefetcher_;
+    
+    // Atomic ALUs; an atomic that hits is scheduled and executed on the
+    // line, a miss fills the line first
+    AtomicUnit atomics_;
+    
+    // Sharers of every line held by an L1; requests carry the issuing
+    // core in MemoryTransaction::source, and evicting a line recalls it
+    CoherenceDirectory directory_;
     
     // Pending transactions waiting for responses from global memory
     std::vector<MemoryTransaction> pending_transactions_;
@@ -101,16 +159,20 @@ private:
     bool lookup(uint64_t addr, uint32_t& set_index, uint32_t& line_index);
     void handle_hit(const MemoryTransaction& transaction, uint32_t set_index, uint32_t line_index);
     void handle_miss(const MemoryTransaction& transaction);
-    void allocate_line(uint32_t set_index, uint64_t tag, const std::vector<uint8_t>& data);
+    void allocate_line(uint32_t set_index, uint64_t tag, const uint8_t* data);
     uint32_t select_victim(uint32_t set_index);
     void evict_line(uint32_t set_index, uint32_t line_index);
     
-    // Address translation helpers
-    uint32_t get_set_index(uint64_t addr) const;
-    uint64_t get_tag(uint64_t addr) const;
+    // Address translation helpers. Hashed set indices can fold tag bits
+    // in, so the tag is the whole line number.
+    uint32_t get_set_index(uint64_t addr) const { return set_mapping_.index(addr); }
+    uint64_t get_tag(uint64_t addr) const { return addr / line_size_; }
     uint32_t get_offset(uint64_t addr) const;
     uint64_t get_block_addr(uint64_t addr) const;
     
+    // Prefetch issue
+    void issue_prefetches(const MemoryTransaction& trigger, bool hit);
+    
     // MSHR handling
     bool check_mshr_hit(uint64_t block_addr, uint32_t& mshr_id);
     bool allocate_mshr(const MemoryTransaction& transaction, uint32_t& mshr_id);
@@ -0,0 +1,323 @@
+#include "cache_sweep.h"
+#include "memory_trace.h"
+#include "cache_array.h"
+#include "replacement_policy.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+namespace {
+
+bool is_power_of_two(uint32_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+// Set of a line: a mask for power-of-two set counts, a modulo otherwise
+struct SetIndex {
+    uint32_t num_sets;
+    bool masked;
+
+    explicit SetIndex(uint32_t sets) : num_sets(sets), masked(is_power_of_two(sets)) {}
+    uint32_t operator()(uint64_t line) const {
+        return masked ? static_cast<uint32_t>(line & (num_sets - 1)) : static_cast<uint32_t>(line % num_sets);
+    }
+};
+
+// LRU recency stacks for one (line size, set count) group. Position p of a
+// set's stack holds the line referenced p distinct lines ago, so an
+// access found at position p hits in every associativity above p.
+struct StackGroup {
+    uint32_t line_shift;
+    SetIndex set_of;
+    uint32_t depth;
+    std::vector<uint64_t> stacks;
+    std::vector<uint64_t> hits_at;   // Hits per stack position
+
+    StackGroup(uint32_t line_size, uint32_t num_sets, uint32_t max_associativity)
+        : line_shift(static_cast<uint32_t>(__builtin_ctz(line_size))),
+          set_of(num_sets),
+          depth(max_associativity),
+          stacks(static_cast<size_t>(num_sets) * max_associativity, CacheArray::INVALID_TAG),
+          hits_at(max_associativity, 0) {}
+
+    void access(uint64_t addr) {
+        uint64_t line = addr >> line_shift;
+        uint64_t* stack = &stacks[static_cast<size_t>(set_of(line)) * depth];
+        if (stack[0] == line) {
+            hits_at[0]++;
+            return;
+        }
+        uint32_t position = 1;
+        while (position < depth && stack[position] != line) {
+            position++;
+        }
+        if (position < depth) {
+            hits_at[position]++;
+        } else {
+            position = depth - 1;   // Miss at every associativity; the deepest line drops out
+        }
+        std::memmove(stack + 1, stack, position * sizeof(uint64_t));
+        stack[0] = line;
+    }
+
+    uint64_t hits(uint32_t associativity) const {
+        uint64_t total = 0;
+        for (uint32_t position = 0; position < associativity; position++) {
+            total += hits_at[position];
+        }
+        return total;
+    }
+};
+
+// One tag-only cache with a given replacement policy
+template <class Policy>
+void simulate(MemoryTraceReader& trace, CacheSweepPoint& point) {
+    uint32_t num_sets = point.num_sets();
+    uint32_t line_shift = static_cast<uint32_t>(__builtin_ctz(point.line_size));
+    SetIndex set_of(num_sets);
+    CacheArray lines(num_sets, point.associativity, point.line_size, false);
+    Policy policy(num_sets, point.associativity);
+
+    TraceRecord record;
+    while (trace.next(record)) {
+        point.accesses++;
+        uint64_t line = record.address >> line_shift;
+        uint32_t set = set_of(line);
+        int32_t way = lines.find(set, line);
+        if (way >= 0) {
+            policy.on_hit(set, static_cast<uint32_t>(way));
+            continue;
+        }
+        point.misses++;
+        way = lines.find_invalid(set);
+        if (way < 0) {
+            way = static_cast<int32_t>(policy.victim(set));
+        }
+        lines.fill(set, static_cast<uint32_t>(way), line, nullptr);
+        policy.on_fill(set, static_cast<uint32_t>(way));
+    }
+}
+
+}  // namespace
+
+const char* sweep_policy_name(SweepPolicy policy) {
+    switch (policy) {
+        case SweepPolicy::LRU:
+            return LruPolicy::name();
+        case SweepPolicy::PLRU:
+            return TreePlruPolicy::name();
+        case SweepPolicy::SRRIP:
+            return SrripPolicy::name();
+        case SweepPolicy::BRRIP:
+            return BrripPolicy::name();
+        case SweepPolicy::DRRIP:
+            return DrripPolicy::name();
+        case SweepPolicy::RANDOM:
+            return RandomPolicy::name();
+    }
+    return "unknown";
+}
+
+CacheSweep::CacheSweep(const CacheSweepConfig& config)
+    : config_(config) {
+    for (SweepPolicy policy : config.policies) {
+        for (uint32_t line_size : config.line_sizes) {
+            if (!is_power_of_two(line_size)) {
+                throw std::invalid_argument("Sweep line sizes must be powers of two");
+            }
+            for (uint32_t associativity : config.associativities) {
+                if (associativity == 0 || associativity > CacheArray::MAX_ASSOCIATIVITY) {
+                    throw std::invalid_argument("Sweep associativities must be between 1 and 64");
+                }
+                if (policy == SweepPolicy::PLRU && !is_power_of_two(associativity)) {
+                    continue;   // Tree-PLRU needs a power-of-two associativity
+                }
+                for (uint32_t size : config.sizes) {
+                    uint64_t set_bytes = static_cast<uint64_t>(line_size) * associativity;
+                    if (size < set_bytes || size % set_bytes != 0) {
+                        continue;
+                    }
+                    CacheSweepPoint point;
+                    point.size_bytes = size;
+                    point.line_size = line_size;
+                    point.associativity = associativity;
+                    point.policy = policy;
+                    results_.push_back(point);
+                }
+            }
+        }
+    }
+    if (results_.empty()) {
+        throw std::invalid_argument("Cache sweep has no valid configuration");
+    }
+
+    auto key = [](const CacheSweepPoint& p) {
+        return std::make_tuple(static_cast<uint8_t>(p.policy), p.line_size, p.associativity, p.size_bytes);
+    };
+    std::sort(results_.begin(), results_.end(),
+              [&key](const CacheSweepPoint& a, const CacheSweepPoint& b) { return key(a) < key(b); });
+    results_.erase(std::unique(results_.begin(), results_.end(),
+                               [&key](const CacheSweepPoint& a, const CacheSweepPoint& b) { return key(a) == key(b); }),
+                   results_.end());
+}
+
+const std::vector<CacheSweepPoint>& CacheSweep::run(const std::string& trace_path) {
+    auto host_start = std::chrono::steady_clock::now();
+    MemoryTraceReader trace(trace_path);
+
+    // Task 0 is the shared LRU pass (if any); every other point is an instance
+    std::vector<size_t> lru_points;
+    std::vector<size_t> instances;
+    for (size_t i = 0; i < results_.size(); i++) {
+        results_[i].accesses = 0;
+        results_[i].misses = 0;
+        (results_[i].policy == SweepPolicy::LRU ? lru_points : instances).push_back(i);
+    }
+    size_t num_tasks = instances.size() + (lru_points.empty() ? 0 : 1);
+
+    uint32_t threads = config_.threads > 0 ? config_.threads : std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<uint32_t>(std::min<size_t>(threads, num_tasks));
+
+    std::atomic<size_t> next_task(0);
+    std::vector<std::exception_ptr> errors(threads);
+    auto worker = [&](uint32_t id) {
+        try {
+            for (size_t task = next_task++; task < num_tasks; task = next_task++) {
+                if (!lru_points.empty() && task == 0) {
+                    run_lru(trace, lru_points);
+                } else {
+                    run_instance(trace, results_[instances[task - (lru_points.empty() ? 0 : 1)]]);
+                }
+            }
+        } catch (...) {
+            errors[id] = std::current_exception();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (uint32_t id = 1; id < threads; id++) {
+        pool.emplace_back(worker, id);
+    }
+    worker(0);
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    std::chrono::duration<double> host_time = std::chrono::steady_clock::now() - host_start;
+    stats_ = CacheSweepStats();
+    stats_.accesses = results_.front().accesses;
+    stats_.configurations = static_cast<uint32_t>(results_.size());
+    stats_.instances = static_cast<uint32_t>(instances.size());
+    stats_.threads = threads;
+    stats_.host_seconds = host_time.count();
+    std::set<std::pair<uint32_t, uint32_t>> groups;
+    for (size_t i : lru_points) {
+        groups.insert(std::make_pair(results_[i].line_size, results_[i].num_sets()));
+    }
+    stats_.stack_groups = static_cast<uint32_t>(groups.size());
+    return results_;
+}
+
+std::vector<CacheSweepPoint> CacheSweep::curve(SweepPolicy policy, uint32_t line_size, uint32_t associativity) const {
+    std::vector<CacheSweepPoint> points;
+    for (const CacheSweepPoint& point : results_) {
+        if (point.policy == policy && point.line_size == line_size && point.associativity == associativity) {
+            points.push_back(point);
+        }
+    }
+    return points;
+}
+
+const CacheSweepPoint& CacheSweep::point(SweepPolicy policy, uint32_t size_bytes, uint32_t line_size,
+                                         uint32_t associativity) const {
+    for (const CacheSweepPoint& point : results_) {
+        if (point.policy == policy && point.size_bytes == size_bytes && point.line_size == line_size &&
+            point.associativity == associativity) {
+            return point;
+        }
+    }
+    throw std::out_of_range("Configuration is not part of the sweep");
+}
+
+void CacheSweep::write_csv(std::ostream& out) const {
+    out << "policy,size_bytes,line_size,associativity,accesses,misses,miss_rate\n";
+    for (const CacheSweepPoint& point : results_) {
+        out << sweep_policy_name(point.policy) << ',' << point.size_bytes << ',' << point.line_size << ','
+            << point.associativity << ',' << point.accesses << ',' << point.misses << ',' << point.miss_rate()
+            << '\n';
+    }
+}
+
+void CacheSweep::run_lru(const MemoryTraceReader& trace, const std::vector<size_t>& points) {
+    // One stack group per (line size, set count), as deep as its largest associativity
+    std::map<std::pair<uint32_t, uint32_t>, uint32_t> depths;
+    for (size_t i : points) {
+        uint32_t& depth = depths[std::make_pair(results_[i].line_size, results_[i].num_sets())];
+        depth = std::max(depth, results_[i].associativity);
+    }
+    std::vector<StackGroup> groups;
+    std::map<std::pair<uint32_t, uint32_t>, size_t> group_of;
+    for (const auto& entry : depths) {
+        group_of[entry.first] = groups.size();
+        groups.emplace_back(entry.first.first, entry.first.second, entry.second);
+    }
+
+    // A private cursor over the shared trace
+    MemoryTraceReader reader = trace;
+    reader.rewind();
+    TraceRecord record;
+    uint64_t accesses = 0;
+    while (reader.next(record)) {
+        accesses++;
+        for (StackGroup& group : groups) {
+            group.access(record.address);
+        }
+    }
+
+    for (size_t i : points) {
+        CacheSweepPoint& point = results_[i];
+        const StackGroup& group = groups[group_of[std::make_pair(point.line_size, point.num_sets())]];
+        point.accesses = accesses;
+        point.misses = accesses - group.hits(point.associativity);
+    }
+}
+
+void CacheSweep::run_instance(const MemoryTraceReader& trace, CacheSweepPoint& point) {
+    // A private cursor over the shared trace
+    MemoryTraceReader reader = trace;
+    reader.rewind();
+    switch (point.policy) {
+        case SweepPolicy::LRU:
+            simulate<LruPolicy>(reader, point);
+            break;
+        case SweepPolicy::PLRU:
+            simulate<TreePlruPolicy>(reader, point);
+            break;
+        case SweepPolicy::SRRIP:
+            simulate<SrripPolicy>(reader, point);
+            break;
+        case SweepPolicy::BRRIP:
+            simulate<BrripPolicy>(reader, point);
+            break;
+        case SweepPolicy::DRRIP:
+            simulate<DrripPolicy>(reader, point);
+            break;
+        case SweepPolicy::RANDOM:
+            simulate<RandomPolicy>(reader, point);
+            break;
+    }
+}
@@ -0,0 +1,95 @@
+#ifndef CACHE_SWEEP_H
+#define CACHE_SWEEP_H
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+class MemoryTraceReader;
+
+// Replacement policies a sweep can evaluate. Unlike CacheL1 and CacheL2,
+// whose policy is fixed by the CACHE_REPLACEMENT_POLICY build option, a
+// sweep picks them at run time.
+enum class SweepPolicy : uint8_t { LRU, PLRU, SRRIP, BRRIP, DRRIP, RANDOM };
+
+const char* sweep_policy_name(SweepPolicy policy);
+
+// Design space: every combination of size, line size, associativity and
+// policy that forms a valid cache (a whole number of sets) is evaluated
+struct CacheSweepConfig {
+    std::vector<uint32_t> sizes;              // Bytes
+    std::vector<uint32_t> line_sizes;         // Bytes, powers of two
+    std::vector<uint32_t> associativities;    // 1..64 ways
+    std::vector<SweepPolicy> policies = {SweepPolicy::LRU};
+    uint32_t threads = 0;                     // Worker threads; 0 = one per host core
+};
+
+// Result for one configuration
+struct CacheSweepPoint {
+    uint32_t size_bytes = 0;
+    uint32_t line_size = 0;
+    uint32_t associativity = 0;
+    SweepPolicy policy = SweepPolicy::LRU;
+    uint64_t accesses = 0;
+    uint64_t misses = 0;
+
+    uint32_t num_sets() const { return size_bytes / (line_size * associativity); }
+    double miss_rate() const { return accesses > 0 ? static_cast<double>(misses) / accesses : 0.0; }
+};
+
+// Work done by a sweep
+struct CacheSweepStats {
+    uint64_t accesses = 0;        // Trace length
+    uint32_t configurations = 0;
+    uint32_t stack_groups = 0;    // LRU (line size, set count) groups sharing one pass
+    uint32_t instances = 0;       // Non-LRU configurations simulated directly
+    uint32_t threads = 0;
+    double host_seconds = 0.0;
+};
+
+// Single-pass, multi-configuration cache simulation over a memory trace
+//
+// LRU configurations are evaluated with stack distances (Mattson et al.):
+// LRU has the inclusion property, so for a fixed line size and set count a
+// single pass that keeps each set's recency stack, as deep as the largest
+// associativity in the group, yields the hit count of every associativity
+// at once. All such groups are updated in one walk over the trace. Other
+// policies have no inclusion property, so each of their configurations is
+// an independent tag-only cache; those instances and the LRU pass are
+// spread over worker threads, each decoding its own copy of the trace.
+//
+// Results are miss-rate curves: one point per configuration, ordered by
+// policy, line size, associativity and size, as CSV or in memory.
+class CacheSweep {
+public:
+    // Constructor (throws std::invalid_argument if no configuration is valid)
+    explicit CacheSweep(const CacheSweepConfig& config);
+
+    // Evaluate every configuration over a trace written by MemoryTraceWriter
+    const std::vector<CacheSweepPoint>& run(const std::string& trace_path);
+
+    // Results of the last run, and the points of one curve (fixed policy,
+    // line size and associativity, increasing size)
+    const std::vector<CacheSweepPoint>& results() const { return results_; }
+    std::vector<CacheSweepPoint> curve(SweepPolicy policy, uint32_t line_size, uint32_t associativity) const;
+    const CacheSweepPoint& point(SweepPolicy policy, uint32_t size_bytes, uint32_t line_size,
+                                 uint32_t associativity) const;
+
+    // Results as CSV: policy,size_bytes,line_size,associativity,accesses,misses,miss_rate
+    void write_csv(std::ostream& out) const;
+
+    // Statistics of the last run
+    const CacheSweepStats& stats() const { return stats_; }
+
+private:
+    CacheSweepConfig config_;
+    std::vector<CacheSweepPoint> results_;
+    CacheSweepStats stats_;
+
+    // One stack-distance pass for the given LRU points, or one instance
+    void run_lru(const MemoryTraceReader& trace, const std::vector<size_t>& points);
+    void run_instance(const MemoryTraceReader& trace, CacheSweepPoint& point);
+};
+
+#endif // CACHE_SWEEP_H
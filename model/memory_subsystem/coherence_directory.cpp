@@ -0,0 +1,224 @@
+#include "coherence_directory.h"
+
+#include <stdexcept>
+
+CoherenceDirectory::CoherenceDirectory(const CoherenceConfig& config)
+    : config_(config) {
+    if (config_.num_cores == 0 || config_.num_cores > 64) {
+        throw std::invalid_argument("Coherence directory tracks between 1 and 64 L1s");
+    }
+    if (config_.line_size == 0 || (config_.line_size & (config_.line_size - 1)) != 0) {
+        throw std::invalid_argument("Coherence line size must be a power of two");
+    }
+}
+
+CoherenceResult CoherenceDirectory::read(uint32_t core, uint64_t addr) {
+    uint64_t bit = core_bit(core);
+    uint64_t line = line_addr(addr);
+    CoherenceResult result;
+    stats_.reads++;
+
+    auto it = entries_.find(line);
+    if (it != entries_.end() && (it->second.sharers & bit) != 0) {
+        // The L1 already holds the line
+        result.grant = it->second.state;
+        return result;
+    }
+
+    send_control(1);
+    uint32_t wait = 0;
+    if (config_.mode == CoherenceMode::RELAXED) {
+        Entry& entry = entries_[line];
+        entry.state = CoherenceState::SHARED;
+        entry.sharers |= bit;
+    } else if (it == entries_.end()) {
+        entries_[line] = Entry{CoherenceState::EXCLUSIVE, bit};
+    } else {
+        Entry& entry = it->second;
+        if (entry.state == CoherenceState::EXCLUSIVE || entry.state == CoherenceState::MODIFIED) {
+            // Forward to the owner, which demotes its copy and returns dirty data
+            send_control(1);
+            if (entry.state == CoherenceState::MODIFIED) {
+                send_data(1, config_.line_size);
+                stats_.owner_writebacks++;
+                result.owner_data = true;
+            } else {
+                send_control(1);
+            }
+            stats_.downgrades++;
+            result.downgrade_mask = entry.sharers;
+            wait = 2 * config_.hop_latency;
+        }
+        entry.state = CoherenceState::SHARED;
+        entry.sharers |= bit;
+    }
+    send_data(1, config_.line_size);
+
+    result.grant = entries_[line].state;
+    result.latency = finish_request(wait);
+    return result;
+}
+
+CoherenceResult CoherenceDirectory::write(uint32_t core, uint64_t addr, uint32_t bytes) {
+    uint64_t bit = core_bit(core);
+    uint64_t line = line_addr(addr);
+    CoherenceResult result;
+    stats_.writes++;
+
+    auto it = entries_.find(line);
+    if (config_.mode == CoherenceMode::RELAXED) {
+        // Write through to L2 and wait for the acknowledgement; other copies go stale
+        stats_.write_throughs++;
+        send_data(1, bytes > 0 ? bytes : config_.line_size);
+        send_control(1);
+        bool held = it != entries_.end() && (it->second.sharers & bit) != 0;
+        result.grant = held ? CoherenceState::SHARED : CoherenceState::INVALID;
+        result.latency = finish_request(0);
+        return result;
+    }
+
+    if (it != entries_.end() && it->second.sharers == bit && it->second.state != CoherenceState::SHARED) {
+        // Silent E -> M upgrade, or a store to a line already modified
+        it->second.state = CoherenceState::MODIFIED;
+        result.grant = CoherenceState::MODIFIED;
+        return result;
+    }
+
+    send_control(1);
+    bool had_copy = false;
+    uint64_t others = 0;
+    if (it != entries_.end()) {
+        had_copy = (it->second.sharers & bit) != 0;
+        others = it->second.sharers & ~bit;
+        uint64_t count = static_cast<uint64_t>(__builtin_popcountll(others));
+        send_control(count);
+        if (it->second.state == CoherenceState::MODIFIED) {
+            // The owner answers with its dirty line instead of an acknowledgement
+            send_data(1, config_.line_size);
+            stats_.owner_writebacks++;
+            result.owner_data = true;
+            count--;
+        }
+        send_control(count);
+        stats_.invalidations += static_cast<uint64_t>(__builtin_popcountll(others));
+    }
+
+    if (had_copy) {
+        stats_.upgrades++;
+        send_control(1);
+    } else {
+        send_data(1, config_.line_size);
+    }
+    entries_[line] = Entry{CoherenceState::MODIFIED, bit};
+
+    result.grant = CoherenceState::MODIFIED;
+    result.invalidate_mask = others;
+    result.latency = finish_request(others != 0 ? 2 * config_.hop_latency : 0);
+    return result;
+}
+
+void CoherenceDirectory::evict(uint32_t core, uint64_t addr, bool dirty) {
+    uint64_t bit = core_bit(core);
+    auto it = entries_.find(line_addr(addr));
+    if (it == entries_.end() || (it->second.sharers & bit) == 0) {
+        return;
+    }
+    stats_.evictions++;
+    if (config_.mode == CoherenceMode::DIRECTORY) {
+        if (dirty) {
+            send_data(1, config_.line_size);
+        } else {
+            send_control(1);
+        }
+    }
+    it->second.sharers &= ~bit;
+    if (it->second.sharers == 0) {
+        entries_.erase(it);
+    }
+}
+
+uint64_t CoherenceDirectory::recall(uint64_t addr) {
+    if (config_.mode == CoherenceMode::RELAXED) {
+        // Untracked copies stay until the next barrier
+        return 0;
+    }
+    auto it = entries_.find(line_addr(addr));
+    if (it == entries_.end()) {
+        return 0;
+    }
+    uint64_t recalled = it->second.sharers;
+    uint64_t count = static_cast<uint64_t>(__builtin_popcountll(recalled));
+    send_control(count);
+    if (it->second.state == CoherenceState::MODIFIED) {
+        send_data(1, config_.line_size);
+        stats_.owner_writebacks++;
+        count--;
+    }
+    send_control(count);
+    stats_.back_invalidations += static_cast<uint64_t>(__builtin_popcountll(recalled));
+    entries_.erase(it);
+    return recalled;
+}
+
+uint32_t CoherenceDirectory::barrier(uint32_t core) {
+    uint64_t bit = core_bit(core);
+    stats_.barriers++;
+    if (config_.mode == CoherenceMode::DIRECTORY) {
+        return 0;
+    }
+
+    uint32_t dropped = 0;
+    for (auto it = entries_.begin(); it != entries_.end();) {
+        if ((it->second.sharers & bit) != 0) {
+            dropped++;
+            it->second.sharers &= ~bit;
+        }
+        if (it->second.sharers == 0) {
+            it = entries_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    stats_.self_invalidations += dropped;
+    return dropped;
+}
+
+CoherenceState CoherenceDirectory::state(uint64_t addr) const {
+    auto it = entries_.find(line_addr(addr));
+    return it != entries_.end() ? it->second.state : CoherenceState::INVALID;
+}
+
+uint64_t CoherenceDirectory::sharers(uint64_t addr) const {
+    auto it = entries_.find(line_addr(addr));
+    return it != entries_.end() ? it->second.sharers : 0;
+}
+
+void CoherenceDirectory::clear() {
+    entries_.clear();
+    stats_ = CoherenceStats();
+}
+
+uint64_t CoherenceDirectory::core_bit(uint32_t core) const {
+    if (core >= config_.num_cores) {
+        throw std::out_of_range("Core index outside the coherence directory");
+    }
+    return 1ULL << core;
+}
+
+void CoherenceDirectory::send_control(uint64_t count) {
+    stats_.control_messages += count;
+    stats_.bytes += count * config_.control_bytes;
+}
+
+void CoherenceDirectory::send_data(uint64_t count, uint32_t bytes) {
+    stats_.data_messages += count;
+    stats_.bytes += count * (config_.control_bytes + bytes);
+}
+
+uint32_t CoherenceDirectory::finish_request(uint32_t coherence_latency) {
+    uint32_t latency = 2 * config_.hop_latency + coherence_latency;
+    stats_.requests++;
+    stats_.total_latency += latency;
+    stats_.coherence_latency += coherence_latency;
+    return latency;
+}
@@ -0,0 +1,140 @@
+#ifndef COHERENCE_DIRECTORY_H
+#define COHERENCE_DIRECTORY_H
+
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// MESI state of a line. The L2 keeps it in the cache array's per-line state byte.
+enum class CoherenceState : uint8_t { INVALID, SHARED, EXCLUSIVE, MODIFIED };
+
+// How the private L1s are kept coherent
+enum class CoherenceMode : uint8_t {
+    DIRECTORY,   // MESI: the L2 directory tracks sharers and invalidates/downgrades L1 copies
+    RELAXED      // GPU style: write-through L1s that self-invalidate at BARRIER/SYNC
+};
+
+// Coherence configuration. Cycles are L2 clock cycles.
+struct CoherenceConfig {
+    CoherenceMode mode = CoherenceMode::DIRECTORY;
+    uint32_t num_cores = 16;        // Private L1s (at most 64)
+    uint32_t line_size = 128;
+    uint32_t control_bytes = 8;     // Request, invalidation and acknowledgement size; data message header
+    uint32_t hop_latency = 20;      // One-way L1 <-> L2 interconnect latency
+};
+
+// Coherence traffic and latency
+struct CoherenceStats {
+    uint64_t reads = 0;                // Read misses sent to L2
+    uint64_t writes = 0;               // Stores reported by L1s
+    uint64_t upgrades = 0;             // Writes to a line the writer held SHARED
+    uint64_t invalidations = 0;        // L1 copies invalidated by another core's write
+    uint64_t downgrades = 0;           // Owners demoted from E/M to S by another core's read
+    uint64_t owner_writebacks = 0;     // Dirty lines recalled from an owner L1
+    uint64_t evictions = 0;            // L1 evictions
+    uint64_t back_invalidations = 0;   // L1 copies recalled when the L2 evicts the line
+    uint64_t write_throughs = 0;
+    uint64_t barriers = 0;
+    uint64_t self_invalidations = 0;   // L1 lines dropped at barriers
+    uint64_t control_messages = 0;
+    uint64_t data_messages = 0;
+    uint64_t bytes = 0;
+    uint64_t requests = 0;             // Requests that left the L1
+    uint64_t total_latency = 0;        // L1 -> L2 -> L1 latency of those requests
+    uint64_t coherence_latency = 0;    // Part of it spent waiting on other L1s
+
+    uint64_t messages() const { return control_messages + data_messages; }
+    double average_latency() const {
+        return requests > 0 ? static_cast<double>(total_latency) / requests : 0.0;
+    }
+};
+
+// Outcome of one L1 request
+struct CoherenceResult {
+    CoherenceState grant = CoherenceState::INVALID;   // State the requesting L1 now holds the line in
+    uint64_t invalidate_mask = 0;                     // L1s that must drop the line
+    uint64_t downgrade_mask = 0;                      // L1s that must demote the line to SHARED
+    bool owner_data = false;                          // Dirty data came from another L1
+    uint32_t latency = 0;                             // Request latency (0 if the L1 handled it alone)
+};
+
+// L2 coherence for the private L1s
+//
+// DIRECTORY mode is MESI with a sparse full-map directory: every line held
+// by an L1 has a sharer bitmask. Reads of an unshared line grant EXCLUSIVE,
+// reads of an owned line downgrade the owner (recalling dirty data), and
+// writes invalidate every other copy. L1s report every store; stores to an
+// EXCLUSIVE or MODIFIED line stay local. The L2 is inclusive, so evicting a
+// line from L2 recalls its L1 copies.
+//
+// RELAXED mode keeps no sharer state in hardware. Stores write through to
+// L2 and never touch other L1s, so copies may go stale until the next
+// BARRIER/SYNC, where the core's L1 drops every line. Lines are still
+// tracked here, without traffic, to count those self-invalidations.
+//
+// Both modes count messages and bytes on the L1 <-> L2 interconnect and the
+// latency of requests, so the two approaches can be compared on the same
+// workload.
+class CoherenceDirectory {
+public:
+    // Constructor
+    explicit CoherenceDirectory(const CoherenceConfig& config = CoherenceConfig());
+
+    // L1 read miss
+    CoherenceResult read(uint32_t core, uint64_t addr);
+
+    // L1 store of bytes (a whole line if 0)
+    CoherenceResult write(uint32_t core, uint64_t addr, uint32_t bytes = 0);
+
+    // L1 eviction of a line; dirty lines carry their data back
+    void evict(uint32_t core, uint64_t addr, bool dirty);
+
+    // L2 eviction; returns the L1s whose copies were recalled
+    uint64_t recall(uint64_t addr);
+
+    // BARRIER/SYNC executed by a core; returns the L1 lines it dropped
+    uint32_t barrier(uint32_t core);
+
+    // Directory queries
+    CoherenceState state(uint64_t addr) const;
+    uint64_t sharers(uint64_t addr) const;
+    size_t tracked_lines() const { return entries_.size(); }
+
+    // Statistics
+    const CoherenceConfig& config() const { return config_; }
+    CoherenceMode mode() const { return config_.mode; }
+    const CoherenceStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = CoherenceStats(); }
+
+    // Reset
+    void clear();
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    // One bit per L1; in EXCLUSIVE/MODIFIED the owner is the only sharer
+    struct Entry {
+        CoherenceState state;
+        uint64_t sharers;
+    };
+
+    CoherenceConfig config_;
+    std::unordered_map<uint64_t, Entry> entries_;   // Lines held by at least one L1
+    CoherenceStats stats_;
+
+    uint64_t line_addr(uint64_t addr) const { return addr & ~static_cast<uint64_t>(config_.line_size - 1); }
+    uint64_t core_bit(uint32_t core) const;
+
+    // Traffic accounting
+    void send_control(uint64_t count);
+    void send_data(uint64_t count, uint32_t bytes);
+    uint32_t finish_request(uint32_t coherence_latency);
+};
+
+#endif // COHERENCE_DIRECTORY_H
@@ -0,0 +1,121 @@
+#include "concurrent_transaction_queue.h"
+
+#include <stdexcept>
+#include <utility>
+
+const uint32_t ConcurrentTransactionQueue::ID_FILTER_RATIO;
+
+ConcurrentTransactionQueue::ConcurrentTransactionQueue(uint32_t max_size, uint32_t pressure_threshold)
+    : capacity_(max_size),
+      pressure_threshold_(pressure_threshold != 0 ? pressure_threshold : max_size - max_size / 4),
+      enqueue_pos_(0),
+      dequeue_pos_(0),
+      rejected_pushes_(0) {
+    // Full and empty slots are told apart by sequence modulo capacity
+    if (max_size < 2) {
+        throw std::invalid_argument("ConcurrentTransactionQueue needs at least two slots");
+    }
+
+    slots_.reset(new Slot[capacity_]);
+    for (uint32_t i = 0; i < capacity_; i++) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+        slots_[i].id.store(0, std::memory_order_relaxed);
+    }
+
+    uint32_t buckets = 1;
+    while (buckets < capacity_ * ID_FILTER_RATIO) {
+        buckets <<= 1;
+    }
+    id_filter_mask_ = buckets - 1;
+    id_filter_.reset(new std::atomic<uint32_t>[buckets]);
+    for (uint32_t i = 0; i < buckets; i++) {
+        id_filter_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+bool ConcurrentTransactionQueue::push(const MemoryTransaction& transaction) {
+    uint64_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots_[pos % capacity_];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence - pos);
+        if (diff == 0) {
+            // Slot is free for this lap; claim the position
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Consumer has not freed the slot from the previous lap: full
+            rejected_pushes_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Count the ID before it becomes visible so the filter never undercounts
+    id_bucket(transaction.id()).fetch_add(1, std::memory_order_relaxed);
+    slot->transaction = transaction;
+    slot->id.store(transaction.id(), std::memory_order_relaxed);
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool ConcurrentTransactionQueue::pop(MemoryTransaction& transaction) {
+    uint64_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Slot* slot;
+    for (;;) {
+        slot = &slots_[pos % capacity_];
+        uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+        int64_t diff = static_cast<int64_t>(sequence - (pos + 1));
+        if (diff == 0) {
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Producer has not published this position yet: empty
+            return false;
+        } else {
+            pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // Moving out releases the slot's hold on the payload
+    transaction = std::move(slot->transaction);
+    // Free the slot for the next lap before uncounting the ID
+    slot->sequence.store(pos + capacity_, std::memory_order_release);
+    id_bucket(transaction.id()).fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+uint32_t ConcurrentTransactionQueue::size() const {
+    uint64_t dequeued = dequeue_pos_.load(std::memory_order_acquire);
+    uint64_t enqueued = enqueue_pos_.load(std::memory_order_acquire);
+    if (enqueued <= dequeued) {
+        return 0;
+    }
+    uint64_t queued = enqueued - dequeued;
+    return static_cast<uint32_t>(queued < capacity_ ? queued : capacity_);
+}
+
+bool ConcurrentTransactionQueue::has_transaction(uint32_t id) const {
+    if (id_bucket(id).load(std::memory_order_relaxed) == 0) {
+        return false;
+    }
+    for (uint32_t i = 0; i < capacity_; i++) {
+        const Slot& slot = slots_[i];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        // A published slot's sequence is one past its position
+        if ((sequence - 1) % capacity_ != i || sequence == i) {
+            continue;
+        }
+        // Re-read the sequence to reject IDs from a slot reused meanwhile
+        uint32_t slot_id = slot.id.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot_id == id && slot.sequence.load(std::memory_order_relaxed) == sequence) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,72 @@
+#ifndef CONCURRENT_TRANSACTION_QUEUE_H
+#define CONCURRENT_TRANSACTION_QUEUE_H
+
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include "memory_transaction.h"
+
+// Bounded lock-free multi-producer/multi-consumer transaction queue
+//
+// Thread-safe counterpart of TransactionQueue for parallel simulation, where
+// each core runs on its own host thread and issues transactions into a
+// shared memory subsystem. Slots form a ring with a per-slot sequence number
+// (Vyukov's bounded MPMC queue): producers and consumers claim positions
+// with a CAS on the enqueue/dequeue counters and publish through the slot
+// sequence, so no operation takes a lock and FIFO order holds per producer.
+//
+// Backpressure: push() fails instead of blocking when the ring is full, and
+// under_pressure() signals requestors to throttle before that happens.
+// has_transaction() consults a counting filter over IDs, then confirms
+// against the IDs published in the slots; under concurrent pushes and pops
+// it answers for some instant during the call.
+class ConcurrentTransactionQueue {
+public:
+    // Constructor (max_size >= 2; pressure defaults to 3/4 full)
+    explicit ConcurrentTransactionQueue(uint32_t max_size = 32, uint32_t pressure_threshold = 0);
+
+    // Queue operations; push fails when full, pop when empty
+    bool push(const MemoryTransaction& transaction);
+    bool pop(MemoryTransaction& transaction);
+
+    // Queue state (snapshots while other threads are active)
+    bool is_empty() const { return size() == 0; }
+    bool is_full() const { return size() >= capacity_; }
+    uint32_t size() const;
+    uint32_t capacity() const { return capacity_; }
+    bool under_pressure() const { return size() >= pressure_threshold_; }
+
+    // Transaction lookup
+    bool has_transaction(uint32_t id) const;
+
+    // Pushes rejected because the queue was full
+    uint64_t rejected_pushes() const { return rejected_pushes_.load(std::memory_order_relaxed); }
+
+private:
+    // Each slot on its own cache line so neighbouring producers do not share
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence;
+        std::atomic<uint32_t> id;
+        MemoryTransaction transaction;
+    };
+
+    static const uint32_t ID_FILTER_RATIO = 4;   // Filter buckets per slot
+
+    uint32_t capacity_;
+    uint32_t pressure_threshold_;
+    std::unique_ptr<Slot[]> slots_;
+
+    // Counting filter over queued IDs; a zero bucket proves absence
+    uint32_t id_filter_mask_;
+    std::unique_ptr<std::atomic<uint32_t>[]> id_filter_;
+
+    alignas(64) std::atomic<uint64_t> enqueue_pos_;
+    alignas(64) std::atomic<uint64_t> dequeue_pos_;
+    alignas(64) std::atomic<uint64_t> rejected_pushes_;
+
+    std::atomic<uint32_t>& id_bucket(uint32_t id) const {
+        return id_filter_[(id * 0x9E3779B1u) & id_filter_mask_];
+    }
+};
+
+#endif // CONCURRENT_TRANSACTION_QUEUE_H
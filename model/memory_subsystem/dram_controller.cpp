@@ -0,0 +1,430 @@
+#include "dram_controller.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace {
+
+bool is_power_of_two(uint64_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+uint32_t log2_exact(uint64_t value) {
+    uint32_t bits = 0;
+    while ((1ULL << bits) < value) {
+        bits++;
+    }
+    return bits;
+}
+
+}  // namespace
+
+void DramStats::accumulate(const DramStats& other) {
+    reads += other.reads;
+    writes += other.writes;
+    row_hits += other.row_hits;
+    row_misses += other.row_misses;
+    row_conflicts += other.row_conflicts;
+    activates += other.activates;
+    precharges += other.precharges;
+    refreshes += other.refreshes;
+    write_forwards += other.write_forwards;
+    write_drains += other.write_drains;
+    read_latency_cycles += other.read_latency_cycles;
+    data_bus_cycles += other.data_bus_cycles;
+}
+
+// DramChannel
+
+DramChannel::DramChannel(const DramTimingConfig& config)
+    : config_(config),
+      banks_(static_cast<size_t>(config.bank_groups) * config.banks_per_group),
+      group_column_ready_(config.bank_groups, 0),
+      group_act_ready_(config.bank_groups, 0),
+      group_read_ready_(config.bank_groups, 0),
+      column_ready_(0),
+      act_ready_(0),
+      read_ready_(0),
+      write_ready_(0),
+      data_bus_free_(0),
+      next_refresh_(config.tREFI),
+      refresh_pending_(false),
+      draining_writes_(false) {
+    if (config_.write_low_watermark >= config_.write_high_watermark ||
+        config_.write_high_watermark > config_.write_queue_size) {
+        throw std::invalid_argument("DRAM write watermarks must satisfy low < high <= queue size");
+    }
+}
+
+bool DramChannel::can_accept(bool is_write) const {
+    return is_write ? write_queue_.size() < config_.write_queue_size
+                    : read_queue_.size() < config_.read_queue_size;
+}
+
+bool DramChannel::enqueue(uint32_t id, const DramAddress& addr, uint64_t burst_addr, bool is_write,
+                          uint64_t cycle) {
+    if (!can_accept(is_write)) {
+        return false;
+    }
+
+    // Reads that hit a queued write are forwarded without touching DRAM
+    if (!is_write) {
+        for (const Request& write : write_queue_) {
+            if (write.burst_addr == burst_addr) {
+                completions_.push_back(PendingCompletion{cycle + 1, DramCompletion{id, false, 1}});
+                stats_.write_forwards++;
+                stats_.reads++;
+                stats_.read_latency_cycles++;
+                return true;
+            }
+        }
+    }
+
+    Request req{id, addr.bank_group, addr.bank, addr.row, burst_addr, cycle, is_write, RowOutcome::HIT};
+    (is_write ? write_queue_ : read_queue_).push_back(req);
+    return true;
+}
+
+bool DramChannel::can_issue_column(const Request& req, uint64_t cycle) const {
+    const Bank& bank = banks_[bank_index(req.bank_group, req.bank)];
+    if (!bank.open || bank.row != req.row || bank.column_ready > cycle) {
+        return false;
+    }
+    if (group_column_ready_[req.bank_group] > cycle || column_ready_ > cycle) {
+        return false;
+    }
+    if (req.is_write) {
+        return write_ready_ <= cycle && data_bus_free_ <= cycle + config_.tCWL;
+    }
+    return read_ready_ <= cycle && group_read_ready_[req.bank_group] <= cycle &&
+           data_bus_free_ <= cycle + config_.tCL;
+}
+
+bool DramChannel::can_activate(const Request& req, uint64_t cycle) const {
+    const Bank& bank = banks_[bank_index(req.bank_group, req.bank)];
+    if (bank.open || bank.act_ready > cycle) {
+        return false;
+    }
+    if (group_act_ready_[req.bank_group] > cycle || act_ready_ > cycle) {
+        return false;
+    }
+    return recent_activates_.size() < 4 || recent_activates_.front() + config_.tFAW <= cycle;
+}
+
+bool DramChannel::has_pending_hit(const std::deque<Request>& queue, uint32_t bank_group, uint32_t bank) const {
+    const Bank& state = banks_[bank_index(bank_group, bank)];
+    for (const Request& req : queue) {
+        if (req.bank_group == bank_group && req.bank == bank && req.row == state.row) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void DramChannel::issue_column(std::deque<Request>& queue, size_t index, uint64_t cycle) {
+    Request req = queue[index];
+    queue.erase(queue.begin() + static_cast<std::ptrdiff_t>(index));
+    Bank& bank = banks_[bank_index(req.bank_group, req.bank)];
+
+    switch (req.outcome) {
+        case RowOutcome::HIT: stats_.row_hits++; break;
+        case RowOutcome::MISS: stats_.row_misses++; break;
+        case RowOutcome::CONFLICT: stats_.row_conflicts++; break;
+    }
+
+    group_column_ready_[req.bank_group] = cycle + config_.tCCD_L;
+    column_ready_ = cycle + config_.tCCD_S;
+
+    uint64_t data_end;
+    if (req.is_write) {
+        data_end = cycle + config_.tCWL + config_.tBURST;
+        bank.pre_ready = std::max(bank.pre_ready, data_end + config_.tWR);
+        group_read_ready_[req.bank_group] = data_end + config_.tWTR_L;
+        read_ready_ = std::max(read_ready_, data_end + config_.tWTR_S);
+        stats_.writes++;
+    } else {
+        data_end = cycle + config_.tCL + config_.tBURST;
+        bank.pre_ready = std::max(bank.pre_ready, cycle + config_.tRTP);
+        write_ready_ = std::max(write_ready_, cycle + config_.tRTW);
+        stats_.reads++;
+        stats_.read_latency_cycles += data_end - req.arrival;
+    }
+    data_bus_free_ = data_end;
+    stats_.data_bus_cycles += config_.tBURST;
+    completions_.push_back(PendingCompletion{data_end, DramCompletion{req.id, req.is_write, data_end - req.arrival}});
+}
+
+void DramChannel::issue_activate(Request& req, uint64_t cycle) {
+    Bank& bank = banks_[bank_index(req.bank_group, req.bank)];
+    bank.open = true;
+    bank.row = req.row;
+    bank.column_ready = cycle + config_.tRCD;
+    bank.pre_ready = cycle + config_.tRAS;
+    bank.act_ready = cycle + config_.tRAS + config_.tRP;
+    group_act_ready_[req.bank_group] = cycle + config_.tRRD_L;
+    act_ready_ = cycle + config_.tRRD_S;
+    recent_activates_.push_back(cycle);
+    if (recent_activates_.size() > 4) {
+        recent_activates_.pop_front();
+    }
+    if (req.outcome == RowOutcome::HIT) {
+        req.outcome = RowOutcome::MISS;
+    }
+    stats_.activates++;
+}
+
+void DramChannel::issue_precharge(Bank& bank, uint64_t cycle) {
+    bank.open = false;
+    bank.act_ready = std::max(bank.act_ready, cycle + config_.tRP);
+    stats_.precharges++;
+}
+
+bool DramChannel::schedule_refresh(uint64_t cycle) {
+    if (cycle >= next_refresh_) {
+        refresh_pending_ = true;
+    }
+    if (!refresh_pending_) {
+        return false;
+    }
+
+    // Close every bank, then refresh them all at once
+    bool all_closed = true;
+    for (Bank& bank : banks_) {
+        if (!bank.open) {
+            continue;
+        }
+        all_closed = false;
+        if (bank.pre_ready <= cycle) {
+            issue_precharge(bank, cycle);
+            return true;
+        }
+    }
+    if (!all_closed) {
+        return true;
+    }
+    for (const Bank& bank : banks_) {
+        if (bank.act_ready > cycle) {
+            return true;
+        }
+    }
+    for (Bank& bank : banks_) {
+        bank.act_ready = cycle + config_.tRFC;
+    }
+    next_refresh_ += config_.tREFI;
+    refresh_pending_ = false;
+    stats_.refreshes++;
+    return true;
+}
+
+bool DramChannel::schedule(std::deque<Request>& queue, uint64_t cycle) {
+    // First ready: oldest row hit whose column command can issue now
+    for (size_t i = 0; i < queue.size(); i++) {
+        if (can_issue_column(queue[i], cycle)) {
+            issue_column(queue, i, cycle);
+            return true;
+        }
+    }
+
+    // First come: oldest request whose ACT or PRE can issue now. A bank is
+    // not closed while queued requests still hit its open row.
+    for (Request& req : queue) {
+        Bank& bank = banks_[bank_index(req.bank_group, req.bank)];
+        if (bank.open && bank.row == req.row) {
+            continue;
+        }
+        if (!bank.open) {
+            if (can_activate(req, cycle)) {
+                issue_activate(req, cycle);
+                return true;
+            }
+            continue;
+        }
+        if (bank.pre_ready <= cycle && !has_pending_hit(queue, req.bank_group, req.bank)) {
+            issue_precharge(bank, cycle);
+            req.outcome = RowOutcome::CONFLICT;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DramChannel::tick(uint64_t cycle, std::vector<DramCompletion>& completed) {
+    for (size_t i = 0; i < completions_.size();) {
+        if (completions_[i].ready_cycle <= cycle) {
+            completed.push_back(completions_[i].completion);
+            completions_[i] = completions_.back();
+            completions_.pop_back();
+        } else {
+            i++;
+        }
+    }
+
+    if (schedule_refresh(cycle)) {
+        return;
+    }
+
+    // Write drain hysteresis between the watermarks
+    if (!draining_writes_ && write_queue_.size() >= config_.write_high_watermark) {
+        draining_writes_ = true;
+        stats_.write_drains++;
+    } else if (draining_writes_ && write_queue_.size() <= config_.write_low_watermark) {
+        draining_writes_ = false;
+    }
+
+    bool serve_writes = draining_writes_ || read_queue_.empty();
+    if (serve_writes) {
+        if (!schedule(write_queue_, cycle) && !draining_writes_) {
+            schedule(read_queue_, cycle);
+        }
+    } else if (!schedule(read_queue_, cycle)) {
+        schedule(write_queue_, cycle);
+    }
+}
+
+// DramSystem
+
+DramSystem::DramSystem(uint32_t num_channels, const DramTimingConfig& config)
+    : num_channels_(num_channels),
+      config_(config),
+      cycle_(0),
+      stats_start_cycle_(0) {
+    if (!is_power_of_two(num_channels_) || !is_power_of_two(config_.pseudo_channels) ||
+        !is_power_of_two(config_.bank_groups) || !is_power_of_two(config_.banks_per_group) ||
+        !is_power_of_two(config_.burst_size) || !is_power_of_two(config_.row_size) ||
+        config_.row_size < config_.burst_size) {
+        throw std::invalid_argument("DRAM organisation sizes must be powers of two");
+    }
+    offset_bits_ = log2_exact(config_.burst_size);
+    column_bits_ = log2_exact(config_.row_size / config_.burst_size);
+    channel_bits_ = log2_exact(num_channels_);
+    pseudo_channel_bits_ = log2_exact(config_.pseudo_channels);
+    bank_group_bits_ = log2_exact(config_.bank_groups);
+    bank_bits_ = log2_exact(config_.banks_per_group);
+
+    uint32_t channel_low = offset_bits_ + column_bits_;
+    channel_mapping_ = AddressMapping::bit_slice(channel_low, channel_bits_ + pseudo_channel_bits_);
+    bank_mapping_ = AddressMapping::bit_slice(channel_low + channel_bits_ + pseudo_channel_bits_,
+                                              bank_group_bits_ + bank_bits_);
+    channel_load_.reset(num_channels_);
+
+    controllers_.reserve(static_cast<size_t>(num_channels_) * config_.pseudo_channels);
+    for (uint32_t i = 0; i < num_channels_ * config_.pseudo_channels; i++) {
+        controllers_.emplace_back(config_);
+    }
+}
+
+DramAddress DramSystem::decode(uint64_t addr) const {
+    DramAddress decoded;
+    uint32_t controller = channel_mapping_.index(addr);
+    uint32_t bank = bank_mapping_.index(addr);
+    decoded.column = static_cast<uint32_t>((addr >> offset_bits_) & ((1ULL << column_bits_) - 1));
+    decoded.channel = controller & (num_channels_ - 1);
+    decoded.pseudo_channel = controller >> channel_bits_;
+    decoded.bank_group = bank & (config_.bank_groups - 1);
+    decoded.bank = bank >> bank_group_bits_;
+    decoded.row = addr >> (offset_bits_ + column_bits_ + channel_bits_ + pseudo_channel_bits_ +
+                           bank_group_bits_ + bank_bits_);
+    return decoded;
+}
+
+void DramSystem::set_channel_mapping(const AddressMapping& mapping) {
+    if (mapping.num_indices() != num_channels_ * config_.pseudo_channels) {
+        throw std::invalid_argument("Channel mapping must have one index per pseudo-channel");
+    }
+    if (!is_idle()) {
+        throw std::logic_error("Cannot change the DRAM address mapping with requests in flight");
+    }
+    channel_mapping_ = mapping;
+}
+
+void DramSystem::set_bank_mapping(const AddressMapping& mapping) {
+    if (mapping.num_indices() != config_.bank_groups * config_.banks_per_group) {
+        throw std::invalid_argument("Bank mapping must have one index per bank");
+    }
+    if (!is_idle()) {
+        throw std::logic_error("Cannot change the DRAM address mapping with requests in flight");
+    }
+    bank_mapping_ = mapping;
+}
+
+bool DramSystem::enqueue(uint32_t id, uint64_t addr, uint32_t size, bool is_write) {
+    if (outstanding_.count(id) != 0) {
+        throw std::invalid_argument("DramSystem request ID " + std::to_string(id) + " already in flight");
+    }
+    uint64_t first_burst = addr >> offset_bits_;
+    uint64_t last_burst = (addr + std::max<uint32_t>(size, 1) - 1) >> offset_bits_;
+
+    // All bursts must fit before any is queued
+    for (uint64_t burst = first_burst; burst <= last_burst; burst++) {
+        DramAddress decoded = decode(burst << offset_bits_);
+        const DramChannel& ctrl = controller(decoded.channel, decoded.pseudo_channel);
+        if (!ctrl.can_accept(is_write)) {
+            return false;
+        }
+    }
+    if (last_burst > first_burst) {
+        // Bursts of one request landing in the same queue must also fit together
+        std::unordered_map<uint32_t, uint32_t> per_controller;
+        for (uint64_t burst = first_burst; burst <= last_burst; burst++) {
+            DramAddress decoded = decode(burst << offset_bits_);
+            uint32_t index = decoded.channel * config_.pseudo_channels + decoded.pseudo_channel;
+            const DramChannel& ctrl = controllers_[index];
+            uint32_t depth = (is_write ? ctrl.write_queue_depth() : ctrl.read_queue_depth()) +
+                             ++per_controller[index];
+            if (depth > (is_write ? config_.write_queue_size : config_.read_queue_size)) {
+                return false;
+            }
+        }
+    }
+
+    for (uint64_t burst = first_burst; burst <= last_burst; burst++) {
+        DramAddress decoded = decode(burst << offset_bits_);
+        controllers_[decoded.channel * config_.pseudo_channels + decoded.pseudo_channel]
+            .enqueue(id, decoded, burst, is_write, cycle_);
+        channel_load_.record(decoded.channel);
+    }
+    outstanding_[id] = Outstanding{static_cast<uint32_t>(last_burst - first_burst + 1), cycle_, is_write};
+    return true;
+}
+
+void DramSystem::tick(std::vector<DramCompletion>& completed) {
+    burst_completions_.clear();
+    for (DramChannel& ctrl : controllers_) {
+        ctrl.tick(cycle_, burst_completions_);
+    }
+    for (const DramCompletion& burst : burst_completions_) {
+        auto it = outstanding_.find(burst.id);
+        if (it == outstanding_.end() || --it->second.bursts_left > 0) {
+            continue;
+        }
+        uint64_t latency = cycle_ - it->second.arrival;
+        (it->second.is_write ? write_latency_ : read_latency_).record(latency);
+        completed.push_back(DramCompletion{burst.id, it->second.is_write, latency});
+        outstanding_.erase(it);
+    }
+    cycle_++;
+}
+
+DramStats DramSystem::stats() const {
+    DramStats total;
+    for (const DramChannel& ctrl : controllers_) {
+        total.accumulate(ctrl.stats());
+    }
+    return total;
+}
+
+double DramSystem::bus_utilization() const {
+    uint64_t elapsed = (cycle_ - stats_start_cycle_) * controllers_.size();
+    return elapsed > 0 ? static_cast<double>(stats().data_bus_cycles) / elapsed : 0.0;
+}
+
+void DramSystem::reset_stats() {
+    for (DramChannel& ctrl : controllers_) {
+        ctrl.reset_stats();
+    }
+    channel_load_.reset();
+    read_latency_.clear();
+    write_latency_.clear();
+    stats_start_cycle_ = cycle_;
+}
@@ -0,0 +1,283 @@
+#ifndef DRAM_CONTROLLER_H
+#define DRAM_CONTROLLER_H
+
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include "address_mapping.h"
+#include "latency_histogram.h"
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// HBM3e organisation and timing. Timing parameters are in controller
+// cycles, which GlobalMemory advances once per model clock.
+struct DramTimingConfig {
+    // Organisation (per channel)
+    uint32_t pseudo_channels = 2;
+    uint32_t bank_groups = 4;
+    uint32_t banks_per_group = 4;
+    uint32_t row_size = 1024;          // Bytes per row in one pseudo-channel
+    uint32_t burst_size = 64;          // Bytes per BL8 burst on a 64-bit pseudo-channel
+
+    // Core timing
+    uint32_t tRCD = 21;                // ACT to column command
+    uint32_t tCL = 21;                 // READ to data
+    uint32_t tCWL = 8;                 // WRITE to data
+    uint32_t tRP = 21;                 // PRE to ACT
+    uint32_t tRAS = 50;                // ACT to PRE
+    uint32_t tRTP = 6;                 // READ to PRE
+    uint32_t tWR = 24;                 // End of write data to PRE
+    uint32_t tBURST = 2;               // Data bus cycles per burst
+
+    // Inter-command spacing
+    uint32_t tCCD_S = 2;               // Column to column, different bank group
+    uint32_t tCCD_L = 4;               // Column to column, same bank group
+    uint32_t tRRD_S = 3;               // ACT to ACT, different bank group
+    uint32_t tRRD_L = 5;               // ACT to ACT, same bank group
+    uint32_t tFAW = 24;                // Window for at most four ACTs
+    uint32_t tWTR_S = 4;               // End of write data to READ, different bank group
+    uint32_t tWTR_L = 12;              // End of write data to READ, same bank group
+    uint32_t tRTW = 18;                // READ to WRITE bus turnaround
+
+    // Refresh (all-bank)
+    uint32_t tREFI = 5850;
+    uint32_t tRFC = 525;
+
+    // Scheduler queues; writes are drained in bursts between watermarks
+    uint32_t read_queue_size = 32;
+    uint32_t write_queue_size = 32;
+    uint32_t write_high_watermark = 24;
+    uint32_t write_low_watermark = 8;
+};
+
+// Decoded DRAM location of a burst
+struct DramAddress {
+    uint32_t channel;
+    uint32_t pseudo_channel;
+    uint32_t bank_group;
+    uint32_t bank;
+    uint64_t row;
+    uint32_t column;
+};
+
+// A finished request
+struct DramCompletion {
+    uint32_t id;
+    bool is_write;
+    uint64_t latency;                  // Cycles from enqueue to last data beat
+};
+
+// DRAM statistics
+struct DramStats {
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    uint64_t row_hits = 0;             // Column access to an already open row
+    uint64_t row_misses = 0;           // Bank was closed, needed ACT
+    uint64_t row_conflicts = 0;        // Another row was open, needed PRE + ACT
+    uint64_t activates = 0;
+    uint64_t precharges = 0;
+    uint64_t refreshes = 0;
+    uint64_t write_forwards = 0;       // Reads served from the write queue
+    uint64_t write_drains = 0;         // Times the scheduler switched to draining writes
+    uint64_t read_latency_cycles = 0;
+    uint64_t data_bus_cycles = 0;
+
+    double row_hit_rate() const {
+        uint64_t accesses = row_hits + row_misses + row_conflicts;
+        return accesses > 0 ? static_cast<double>(row_hits) / accesses : 0.0;
+    }
+    double average_read_latency() const {
+        return reads > 0 ? static_cast<double>(read_latency_cycles) / reads : 0.0;
+    }
+    void accumulate(const DramStats& other);
+};
+
+// Command scheduler for one pseudo-channel
+//
+// Open-page policy with FR-FCFS scheduling: ready row-hit column commands
+// go first, then the oldest request's ACT or PRE. Reads are served from
+// the read queue until the write queue crosses its high watermark, then
+// writes drain down to the low watermark. One command issues per cycle and
+// every command is checked against bank, bank group, tFAW, bus turnaround
+// and refresh constraints.
+class DramChannel {
+public:
+    // Constructor
+    explicit DramChannel(const DramTimingConfig& config);
+
+    // Queue a burst; returns false if the corresponding queue is full
+    bool can_accept(bool is_write) const;
+    bool enqueue(uint32_t id, const DramAddress& addr, uint64_t burst_addr, bool is_write, uint64_t cycle);
+
+    // Advance to cycle; bursts finishing by then are appended to completed
+    void tick(uint64_t cycle, std::vector<DramCompletion>& completed);
+
+    // State
+    bool is_idle() const { return read_queue_.empty() && write_queue_.empty() && completions_.empty(); }
+    uint32_t read_queue_depth() const { return static_cast<uint32_t>(read_queue_.size()); }
+    uint32_t write_queue_depth() const { return static_cast<uint32_t>(write_queue_.size()); }
+    bool is_row_open(uint32_t bank_group, uint32_t bank) const { return banks_[bank_index(bank_group, bank)].open; }
+    const DramStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = DramStats(); }
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    enum class RowOutcome : uint8_t { HIT, MISS, CONFLICT };
+
+    struct Request {
+        uint32_t id;
+        uint32_t bank_group;
+        uint32_t bank;
+        uint64_t row;
+        uint64_t burst_addr;
+        uint64_t arrival;
+        bool is_write;
+        RowOutcome outcome;
+    };
+
+    struct Bank {
+        bool open = false;
+        uint64_t row = 0;
+        uint64_t act_ready = 0;
+        uint64_t pre_ready = 0;
+        uint64_t column_ready = 0;
+    };
+
+    struct PendingCompletion {
+        uint64_t ready_cycle;
+        DramCompletion completion;
+    };
+
+    DramTimingConfig config_;
+    std::vector<Bank> banks_;
+    std::deque<Request> read_queue_;
+    std::deque<Request> write_queue_;
+    std::vector<PendingCompletion> completions_;
+
+    // Constraint registers: earliest cycle each command class may issue
+    std::vector<uint64_t> group_column_ready_;
+    std::vector<uint64_t> group_act_ready_;
+    std::vector<uint64_t> group_read_ready_;
+    uint64_t column_ready_;
+    uint64_t act_ready_;
+    uint64_t read_ready_;
+    uint64_t write_ready_;
+    uint64_t data_bus_free_;
+    std::deque<uint64_t> recent_activates_;   // Last four ACT cycles for tFAW
+
+    // Refresh state
+    uint64_t next_refresh_;
+    bool refresh_pending_;
+    bool draining_writes_;
+
+    DramStats stats_;
+
+    size_t bank_index(uint32_t bank_group, uint32_t bank) const {
+        return static_cast<size_t>(bank_group) * config_.banks_per_group + bank;
+    }
+    bool can_issue_column(const Request& req, uint64_t cycle) const;
+    bool can_activate(const Request& req, uint64_t cycle) const;
+    bool has_pending_hit(const std::deque<Request>& queue, uint32_t bank_group, uint32_t bank) const;
+    void issue_column(std::deque<Request>& queue, size_t index, uint64_t cycle);
+    void issue_activate(Request& req, uint64_t cycle);
+    void issue_precharge(Bank& bank, uint64_t cycle);
+    bool schedule_refresh(uint64_t cycle);
+    bool schedule(std::deque<Request>& queue, uint64_t cycle);
+};
+
+// All channels of an HBM3e stack plus the address decoder
+//
+// Requests larger than a burst are split across bursts (and possibly
+// channels) and complete when their last burst does. The channel and bank
+// fields come from replaceable address mappings; the defaults slice the
+// bits shown on decode(). Mappings only change timing, so a non-bijective
+// mapping aliases locations in the DRAM model but never corrupts data.
+class DramSystem {
+public:
+    // Constructor (organisation sizes must be powers of two)
+    DramSystem(uint32_t num_channels, const DramTimingConfig& config = DramTimingConfig());
+
+    // Address decode: [row | bank | bank group | pseudo-channel | channel | column | burst offset]
+    DramAddress decode(uint64_t addr) const;
+
+    // Replace the mapping that selects the channel (low index bits) and
+    // pseudo-channel (high bits), or the bank group (low) and bank (high).
+    // Index counts must match the organisation; only allowed while idle.
+    void set_channel_mapping(const AddressMapping& mapping);
+    void set_bank_mapping(const AddressMapping& mapping);
+    const AddressMapping& channel_mapping() const { return channel_mapping_; }
+    const AddressMapping& bank_mapping() const { return bank_mapping_; }
+
+    // Queue a request of size bytes; false if any of its bursts cannot be queued
+    bool enqueue(uint32_t id, uint64_t addr, uint32_t size, bool is_write);
+
+    // Advance one controller cycle
+    void tick(std::vector<DramCompletion>& completed);
+
+    // State
+    uint64_t cycle() const { return cycle_; }
+    bool is_idle() const { return outstanding_.empty(); }
+    uint32_t num_channels() const { return num_channels_; }
+    const DramTimingConfig& config() const { return config_; }
+    const DramChannel& controller(uint32_t channel, uint32_t pseudo_channel) const {
+        return controllers_[channel * config_.pseudo_channels + pseudo_channel];
+    }
+
+    // Statistics summed over all pseudo-channels; bus utilisation is the
+    // fraction of data bus cycles in use since the last reset
+    DramStats stats() const;
+    double bus_utilization() const;
+    void reset_stats();
+
+    // Bursts per channel since the last reset
+    const LoadBalanceHistogram& channel_load() const { return channel_load_; }
+    
+    // Request latency distributions (enqueue to last data beat) since the last reset
+    const LatencyHistogram& read_latency() const { return read_latency_; }
+    const LatencyHistogram& write_latency() const { return write_latency_; }
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    struct Outstanding {
+        uint32_t bursts_left;
+        uint64_t arrival;
+        bool is_write;
+    };
+
+    uint32_t num_channels_;
+    DramTimingConfig config_;
+    std::vector<DramChannel> controllers_;
+    std::unordered_map<uint32_t, Outstanding> outstanding_;
+    std::vector<DramCompletion> burst_completions_;
+    uint64_t cycle_;
+    uint64_t stats_start_cycle_;
+
+    // Address mappings and load balance
+    AddressMapping channel_mapping_;
+    AddressMapping bank_mapping_;
+    LoadBalanceHistogram channel_load_;
+
+    // Request latency distributions
+    LatencyHistogram read_latency_;
+    LatencyHistogram write_latency_;
+
+    // Address field widths
+    uint32_t offset_bits_;
+    uint32_t column_bits_;
+    uint32_t channel_bits_;
+    uint32_t pseudo_channel_bits_;
+    uint32_t bank_group_bits_;
+    uint32_t bank_bits_;
+};
+
+#endif // DRAM_CONTROLLER_H
@@ -3,14 +3,24 @@
 
 #include <systemc.h>
 #include <vector>
+#include <algorithm>
 #include <queue>
 #include <unordered_map>
 #include <cstdint>
 #include "memory_transaction.h"
 #include "memory_response.h"
+#include "sparse_memory.h"
+#include "dram_controller.h"
+#include "memory_tlm.h"
 
-// Global memory with HBM3e simulation
-class GlobalMemory : public sc_module {
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// Global memory with HBM3e simulation. Besides the signal ports it can be
+// exposed to loosely-timed TLM-2.0 initiators through a TlmMemoryTarget,
+// which bypasses the DRAM timing model.
+class GlobalMemory : public sc_module, public TlmBackingStore {
 public:
     // Ports
     sc_in<bool> clk;
@@ -23,7 +33,9 @@ public:
     GlobalMemory(sc_module_name name, 
                 uint64_t size_bytes = 16ULL * 1024 * 1024 * 1024,  // Default 16GB
                 uint32_t num_channels = 8,                         // Default 8 channels
-                uint32_t channel_width_bits = 256);                // Default 256-bit wide channels
+                uint32_t channel_width_bits = 256,                 // Default 256-bit wide channels
+                const SparseMemoryConfig& backing = SparseMemoryConfig(),   // Lazily allocated pages
+                const DramTimingConfig& timing = DramTimingConfig());       // HBM3e bank/row timing
     
     // Destructor
     virtual ~GlobalMemory();
@@ -32,45 +44,92 @@ public:
     void handle_transaction();
     void update_channels();
     
-    // Direct memory access for testing
-    uint8_t read_byte(uint64_t addr) const;
-    void write_byte(uint64_t addr, uint8_t data);
+    // Direct memory access for testing and program loading
+    uint8_t read_byte(uint64_t addr) const { return memory_.read_byte(addr); }
+    void write_byte(uint64_t addr, uint8_t data) { memory_.write_byte(addr, data); }
+    void read_block(uint64_t addr, uint8_t* data, uint64_t size) const { memory_.read_block(addr, data, size); }
+    void write_block(uint64_t addr, const uint8_t* data, uint64_t size) { memory_.write_block(addr, data, size); }
+    
+    // Burst access: one transaction moves a whole payload (e.g. a cache line);
+    // writes only update enabled bytes
+    void read_burst(uint64_t addr, BurstPayload& payload) const {
+        memory_.read_block(addr, payload.mutable_data(), payload.size());
+    }
+    void write_burst(uint64_t addr, const BurstPayload& payload) {
+        if (payload.all_enabled()) {
+            memory_.write_block(addr, payload.data(), payload.size());
+            return;
+        }
+        for (uint32_t offset = 0; offset < payload.size(); offset++) {
+            if (payload.byte_enabled(offset)) {
+                memory_.write_byte(addr + offset, payload.data()[offset]);
+            }
+        }
+    }
+    
+    // TlmBackingStore: DMI regions are single backing pages
+    uint64_t tlm_size() const override { return memory_.size(); }
+    void tlm_read(uint64_t addr, uint8_t* data, uint32_t length) const override {
+        memory_.read_block(addr, data, length);
+    }
+    void tlm_write(uint64_t addr, const uint8_t* data, uint32_t length) override {
+        memory_.write_block(addr, data, length);
+    }
+    uint8_t* tlm_dmi_region(uint64_t addr, uint64_t& start, uint64_t& end) override {
+        uint64_t page = addr / memory_.page_size();
+        start = page * memory_.page_size();
+        end = std::min(start + memory_.page_size(), memory_.size()) - 1;
+        return memory_.host_page(page);
+    }
     
     // HBM3e specific methods
     double current_bandwidth_usage() const;
     double peak_bandwidth() const;
     double average_latency() const;
     
+    // Distribution of DRAM read and write latencies (cycles) since the last reset
+    LatencyHistogram latency_histogram() const {
+        LatencyHistogram histogram = dram_.read_latency();
+        histogram.merge(dram_.write_latency());
+        return histogram;
+    }
+    
+    // DRAM timing model state and statistics (row hits, refreshes, bus utilisation)
+    const DramSystem& dram() const { return dram_; }
+    DramStats dram_stats() const { return dram_.stats(); }
+    
     // Memory properties
     uint64_t size() const { return memory_.size(); }
+    uint64_t resident_bytes() const { return memory_.resident_bytes(); }
     
     // Reset statistics
     void reset_stats();
     
+    // Checkpointing. Memory contents are saved sparsely (all-zero pages are
+    // skipped); an incremental writer only records pages written since the
+    // last mark_checkpoint(). Neither call moves that baseline, so state can
+    // be snapshotted and restored between two checkpoints; pages a restore
+    // rewrites count as written.
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
+    // Start a new incremental epoch after a checkpoint has been taken. DMI
+    // regions are revoked so direct writers re-acquire, and so re-mark, pages.
+    void mark_checkpoint();
+    
 private:
-    // Memory storage (byte addressable)
-    std::vector<uint8_t> memory_;
+    // Memory storage (byte addressable, allocated on first touch)
+    SparseMemory memory_;
     uint64_t size_bytes_;
-    uint32_t latency_ns_;
-    
-    // Pending transaction tracking
-    struct PendingTransaction {
-        MemoryTransaction txn;
-        uint32_t cycles_left;
-    };
     
-    std::vector<PendingTransaction> pending_transactions_;
+    // Bank/row-buffer timing model with a FR-FCFS scheduler per pseudo-channel
+    DramSystem dram_;
     
-    // Memory channel simulation
-    struct MemoryChannel {
-        bool busy;
-        uint64_t busy_until_cycle;
-        std::queue<MemoryTransaction> pending_transactions;
-        uint64_t bytes_transferred;
-    };
+    // Transactions queued in the DRAM model, by transaction ID
+    std::unordered_map<uint32_t, MemoryTransaction> in_flight_;
     
-    std::vector<MemoryChannel> channels_;
-    std::unordered_map<uint32_t, uint32_t> transaction_to_channel_;
+    // Transactions waiting for space in the DRAM scheduler queues
+    std::queue<MemoryTransaction> backlog_;
     
     // Transaction counter and timing
     uint32_t transaction_id_;
@@ -79,8 +138,6 @@ private:
     // HBM3e configuration
     uint32_t num_channels_;
     uint32_t channel_width_bits_;
-    uint64_t max_bandwidth_gbps_;
-    uint32_t base_latency_cycles_;
     
     // Performance tracking
     uint64_t total_bytes_transferred_;
@@ -89,19 +146,17 @@ private:
     uint64_t current_bandwidth_gbps_;
     
     // Helper methods
-    uint32_t get_channel_index(uint64_t addr) const;
-    uint32_t calculate_transaction_latency(const MemoryTransaction& transaction) const;
     void schedule_transaction(const MemoryTransaction& transaction);
-    void complete_transaction(uint32_t channel_idx);
+    void complete_transaction(const DramCompletion& completion);
     
-    // HBM3e simulation methods
-    uint32_t simulate_hbm3e_latency(const MemoryTransaction& txn);
-    uint32_t simulate_hbm3e_bandwidth(const MemoryTransaction& txn);
+    // Checkpoint granularity
+    static const uint32_t CHECKPOINT_PAGE_SIZE = 4096;
     
-    // HBM3e specific parameters
-    static const uint32_t HBM3E_BASE_LATENCY = 100;  // Base latency in cycles
-    static const uint32_t HBM3E_BANDWIDTH_PER_CHANNEL_GBPS = 24;  // 24 Gbps per channel for HBM3e
-    static const uint32_t HBM3E_BURST_LENGTH = 16;  // Burst length in cycles
+    // Bytes of a checkpoint page; the last one is partial when the memory
+    // size is not a multiple of CHECKPOINT_PAGE_SIZE
+    uint64_t checkpoint_page_bytes(uint64_t page) const {
+        return std::min<uint64_t>(CHECKPOINT_PAGE_SIZE, memory_.size() - page * CHECKPOINT_PAGE_SIZE);
+    }
 };
 
 #endif // GLOBAL_MEMORY_H
\ No newline at end of file
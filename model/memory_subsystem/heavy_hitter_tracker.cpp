@@ -0,0 +1,84 @@
+#include "heavy_hitter_tracker.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+HeavyHitterTracker::HeavyHitterTracker(uint32_t capacity)
+    : total_(0) {
+    if (capacity == 0) {
+        throw std::invalid_argument("HeavyHitterTracker capacity must be non-zero");
+    }
+    entries_.resize(capacity);
+    positions_.reserve(capacity);
+    clear();
+}
+
+void HeavyHitterTracker::record(uint64_t key, uint64_t time) {
+    total_++;
+    auto it = positions_.find(key);
+    if (it != positions_.end()) {
+        increment(it->second, time);
+        return;
+    }
+
+    // Take over the minimum counter; its count becomes the newcomer's error
+    Entry& victim = entries_[0];
+    if (victim.count > 0) {
+        positions_.erase(victim.key);
+    }
+    victim.key = key;
+    victim.error = victim.count;
+    positions_[key] = 0;
+    increment(0, time);
+}
+
+std::vector<HeavyHitterTracker::Entry> HeavyHitterTracker::top(uint32_t n) const {
+    std::vector<Entry> result;
+    for (auto it = entries_.rbegin(); it != entries_.rend() && result.size() < n && it->count > 0; ++it) {
+        result.push_back(*it);
+    }
+    return result;
+}
+
+void HeavyHitterTracker::clear() {
+    std::fill(entries_.begin(), entries_.end(), Entry{0, 0, 0, 0});
+    positions_.clear();
+    run_end_.clear();
+    run_end_[0] = static_cast<uint32_t>(entries_.size() - 1);
+    total_ = 0;
+}
+
+void HeavyHitterTracker::increment(uint32_t index, uint64_t time) {
+    uint64_t count = entries_[index].count;
+
+    // Move to the end of the run of equal counts so the order survives the increment
+    uint32_t end = run_end_[count];
+    if (end != index) {
+        std::swap(entries_[index], entries_[end]);
+        if (entries_[index].count > 0) {
+            positions_[entries_[index].key] = index;
+        }
+        positions_[entries_[end].key] = end;
+    }
+    entries_[end].count = count + 1;
+    entries_[end].last_seen = time;
+
+    if (end > 0 && entries_[end - 1].count == count) {
+        run_end_[count] = end - 1;
+    } else {
+        run_end_.erase(count);
+    }
+    // A longer run of count + 1 already ends past this index
+    run_end_.emplace(count + 1, end);
+}
+
+void HeavyHitterTracker::rebuild_runs() {
+    positions_.clear();
+    run_end_.clear();
+    for (uint32_t i = 0; i < entries_.size(); i++) {
+        if (entries_[i].count > 0) {
+            positions_[entries_[i].key] = i;
+        }
+        run_end_[entries_[i].count] = i;
+    }
+}
@@ -0,0 +1,62 @@
+#ifndef HEAVY_HITTER_TRACKER_H
+#define HEAVY_HITTER_TRACKER_H
+
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// Bounded-memory heavy-hitter tracking (Space-Saving)
+//
+// Keeps at most capacity counters. A key that is not tracked takes over the
+// counter with the smallest count and inherits that count as its error, so
+// every reported count overestimates the true count by at most error, and
+// any key with more than total / capacity accesses is guaranteed to be
+// tracked. Counters are kept sorted by count with the end of each run of
+// equal counts indexed, so an update is O(1): the counter swaps to the end
+// of its run and increments, and the minimum is always the first counter.
+class HeavyHitterTracker {
+public:
+    struct Entry {
+        uint64_t key;
+        uint64_t count;      // Upper bound on the true access count
+        uint64_t error;      // Maximum overestimate in count
+        uint64_t last_seen;  // Time of the most recent access
+    };
+
+    // Constructor
+    explicit HeavyHitterTracker(uint32_t capacity = 1024);
+
+    // Count one access to key at time
+    void record(uint64_t key, uint64_t time);
+
+    // Up to n entries with the highest counts, highest first
+    std::vector<Entry> top(uint32_t n) const;
+
+    // Properties
+    uint32_t capacity() const { return static_cast<uint32_t>(entries_.size()); }
+    uint32_t size() const { return static_cast<uint32_t>(positions_.size()); }
+    uint64_t total() const { return total_; }
+
+    // Reset
+    void clear();
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    // Ascending by count; unused counters have count 0 and sit at the front
+    std::vector<Entry> entries_;
+    std::unordered_map<uint64_t, uint32_t> positions_;    // Key to index in entries_
+    std::unordered_map<uint64_t, uint32_t> run_end_;      // Count to last index with that count
+    uint64_t total_;
+
+    void increment(uint32_t index, uint64_t time);
+    void rebuild_runs();
+};
+
+#endif // HEAVY_HITTER_TRACKER_H
@@ -0,0 +1,232 @@
+#include "latency_histogram.h"
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+const uint32_t LatencyHistogram::DEFAULT_PRECISION_BITS;
+const uint32_t MemoryLatencyProfile::NUM_LEVELS;
+const uint32_t MemoryLatencyProfile::NUM_TYPES;
+
+namespace {
+
+// Dump headers
+const uint32_t HISTOGRAM_MAGIC = 0x5453484C;  // "LHST"
+const uint32_t PROFILE_MAGIC = 0x5046504C;    // "LPFP"
+
+void put_varint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+uint64_t get_varint(const std::vector<uint8_t>& in, size_t& pos) {
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        if (pos >= in.size()) {
+            throw std::runtime_error("Truncated latency histogram dump");
+        }
+        uint8_t byte = in[pos++];
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("Malformed varint in latency histogram dump");
+}
+
+uint32_t checked_precision(uint32_t precision_bits) {
+    if (precision_bits < 1 || precision_bits > 16) {
+        throw std::invalid_argument("LatencyHistogram precision must be between 1 and 16 bits");
+    }
+    return precision_bits;
+}
+
+void put_histogram(std::vector<uint8_t>& out, const std::vector<uint8_t>& histogram) {
+    put_varint(out, histogram.size());
+    out.insert(out.end(), histogram.begin(), histogram.end());
+}
+
+}  // namespace
+
+LatencyHistogram::LatencyHistogram(uint32_t precision_bits)
+    : precision_bits_(checked_precision(precision_bits)),
+      sub_bucket_count_(1u << precision_bits_) {
+    // Linear range plus half a sub-bucket range per remaining power of two
+    counts_.assign(sub_bucket_count_ + static_cast<size_t>(64 - precision_bits_) * (sub_bucket_count_ / 2), 0);
+    clear();
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    if (other.precision_bits_ != precision_bits_) {
+        throw std::invalid_argument("Cannot merge latency histograms of different precision");
+    }
+    for (size_t i = 0; i < counts_.size(); i++) {
+        counts_[i] += other.counts_[i];
+    }
+    if (other.total_count_ > 0) {
+        min_ = other.min_ < min_ ? other.min_ : min_;
+        max_ = other.max_ > max_ ? other.max_ : max_;
+    }
+    total_count_ += other.total_count_;
+    total_value_ += other.total_value_;
+}
+
+uint64_t LatencyHistogram::value_at_percentile(double percentile) const {
+    if (total_count_ == 0) {
+        return 0;
+    }
+    double clamped = percentile < 0.0 ? 0.0 : (percentile > 100.0 ? 100.0 : percentile);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(clamped / 100.0 * total_count_));
+    rank = rank < 1 ? 1 : rank;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts_.size(); i++) {
+        seen += counts_[i];
+        if (seen >= rank) {
+            uint64_t high = bucket_high(i);
+            return high > max_ ? max_ : (high < min_ ? min_ : high);
+        }
+    }
+    return max_;
+}
+
+LatencySummary LatencyHistogram::summary() const {
+    LatencySummary result;
+    result.count = total_count_;
+    result.min = min();
+    result.max = max();
+    result.mean = mean();
+    result.p50 = value_at_percentile(50.0);
+    result.p90 = value_at_percentile(90.0);
+    result.p99 = value_at_percentile(99.0);
+    result.p999 = value_at_percentile(99.9);
+    return result;
+}
+
+std::vector<uint8_t> LatencyHistogram::dump() const {
+    std::vector<uint8_t> out;
+    put_varint(out, HISTOGRAM_MAGIC);
+    put_varint(out, precision_bits_);
+    put_varint(out, total_count_);
+    put_varint(out, total_value_);
+    put_varint(out, min());
+    put_varint(out, max_);
+
+    // (zero run length, count) pairs for each non-zero bucket
+    size_t previous = 0;
+    for (size_t i = 0; i < counts_.size(); i++) {
+        if (counts_[i] != 0) {
+            put_varint(out, i - previous);
+            put_varint(out, counts_[i]);
+            previous = i + 1;
+        }
+    }
+    return out;
+}
+
+LatencyHistogram LatencyHistogram::load(const std::vector<uint8_t>& data) {
+    size_t pos = 0;
+    if (get_varint(data, pos) != HISTOGRAM_MAGIC) {
+        throw std::runtime_error("Not a latency histogram dump");
+    }
+    LatencyHistogram histogram(static_cast<uint32_t>(get_varint(data, pos)));
+    histogram.total_count_ = get_varint(data, pos);
+    histogram.total_value_ = get_varint(data, pos);
+    uint64_t min = get_varint(data, pos);
+    histogram.max_ = get_varint(data, pos);
+    histogram.min_ = histogram.total_count_ > 0 ? min : std::numeric_limits<uint64_t>::max();
+
+    size_t index = 0;
+    while (pos < data.size()) {
+        index += get_varint(data, pos);
+        if (index >= histogram.counts_.size()) {
+            throw std::runtime_error("Latency histogram dump bucket out of range");
+        }
+        histogram.counts_[index++] = get_varint(data, pos);
+    }
+    return histogram;
+}
+
+void LatencyHistogram::clear() {
+    std::fill(counts_.begin(), counts_.end(), 0);
+    total_count_ = 0;
+    total_value_ = 0;
+    min_ = std::numeric_limits<uint64_t>::max();
+    max_ = 0;
+}
+
+uint64_t LatencyHistogram::bucket_high(size_t index) const {
+    if (index < sub_bucket_count_) {
+        return index;
+    }
+    uint32_t half = sub_bucket_count_ / 2;
+    uint32_t shift = static_cast<uint32_t>((index - sub_bucket_count_) / half) + 1;
+    uint64_t sub_bucket = (index - sub_bucket_count_) % half + half;
+    uint64_t high = ((sub_bucket + 1) << shift) - 1;
+    // The top bucket's upper edge overflows 64 bits
+    return high < (sub_bucket << shift) ? std::numeric_limits<uint64_t>::max() : high;
+}
+
+// MemoryLatencyProfile
+
+MemoryLatencyProfile::MemoryLatencyProfile(uint32_t precision_bits)
+    : histograms_(NUM_LEVELS * NUM_TYPES, LatencyHistogram(precision_bits)) {
+}
+
+LatencyHistogram MemoryLatencyProfile::level(MemoryLevel level) const {
+    LatencyHistogram merged(histograms_[0].precision_bits());
+    for (uint32_t type = 0; type < NUM_TYPES; type++) {
+        merged.merge(histograms_[index(level, static_cast<MemoryTransactionType>(type))]);
+    }
+    return merged;
+}
+
+void MemoryLatencyProfile::merge(const MemoryLatencyProfile& other) {
+    for (size_t i = 0; i < histograms_.size(); i++) {
+        histograms_[i].merge(other.histograms_[i]);
+    }
+}
+
+std::vector<uint8_t> MemoryLatencyProfile::dump() const {
+    std::vector<uint8_t> out;
+    put_varint(out, PROFILE_MAGIC);
+    put_varint(out, NUM_LEVELS);
+    put_varint(out, NUM_TYPES);
+    for (const LatencyHistogram& histogram : histograms_) {
+        put_histogram(out, histogram.dump());
+    }
+    return out;
+}
+
+MemoryLatencyProfile MemoryLatencyProfile::load(const std::vector<uint8_t>& data) {
+    size_t pos = 0;
+    if (get_varint(data, pos) != PROFILE_MAGIC || get_varint(data, pos) != NUM_LEVELS ||
+        get_varint(data, pos) != NUM_TYPES) {
+        throw std::runtime_error("Not a latency profile dump for this model");
+    }
+    // Every histogram of a profile has the same precision
+    std::vector<LatencyHistogram> histograms;
+    for (uint32_t i = 0; i < NUM_LEVELS * NUM_TYPES; i++) {
+        uint64_t size = get_varint(data, pos);
+        if (size > data.size() - pos) {
+            throw std::runtime_error("Truncated latency profile dump");
+        }
+        histograms.push_back(LatencyHistogram::load(std::vector<uint8_t>(data.begin() + pos, data.begin() + pos + size)));
+        pos += size;
+        if (histograms.back().precision_bits() != histograms.front().precision_bits()) {
+            throw std::runtime_error("Latency profile dump mixes histogram precisions");
+        }
+    }
+    MemoryLatencyProfile profile(histograms.front().precision_bits());
+    profile.histograms_ = std::move(histograms);
+    return profile;
+}
+
+void MemoryLatencyProfile::clear() {
+    for (LatencyHistogram& histogram : histograms_) {
+        histogram.clear();
+    }
+}
@@ -0,0 +1,139 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <vector>
+#include <cstdint>
+#include "memory_transaction.h"
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// Percentile summary of a latency distribution (cycles)
+struct LatencySummary {
+    uint64_t count = 0;
+    uint64_t min = 0;
+    uint64_t max = 0;
+    double mean = 0.0;
+    uint64_t p50 = 0;
+    uint64_t p90 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+};
+
+// Log-linear (HDR-style) latency histogram
+//
+// Values below 2^precision_bits get one bucket each; every power-of-two
+// range above that is split into 2^(precision_bits - 1) linear buckets, so
+// the relative error of any reported value is below 2^-(precision_bits - 1)
+// (about 3% at the default of 6 bits) over the full 64-bit range, in a few
+// KB of counters. Histograms with the same precision merge by adding
+// counters, so per-run results can be combined exactly.
+class LatencyHistogram {
+public:
+    static const uint32_t DEFAULT_PRECISION_BITS = 6;
+
+    // Constructor (precision_bits between 1 and 16)
+    explicit LatencyHistogram(uint32_t precision_bits = DEFAULT_PRECISION_BITS);
+
+    // Record count samples of value
+    void record(uint64_t value, uint64_t count = 1) {
+        counts_[bucket_index(value)] += count;
+        total_count_ += count;
+        total_value_ += value * count;
+        min_ = value < min_ ? value : min_;
+        max_ = value > max_ ? value : max_;
+    }
+
+    // Add another histogram's samples (throws on precision mismatch)
+    void merge(const LatencyHistogram& other);
+
+    // Queries; percentile in [0, 100]. A percentile reports the highest
+    // value its bucket can hold, clamped to the recorded range.
+    uint64_t count() const { return total_count_; }
+    uint64_t min() const { return total_count_ > 0 ? min_ : 0; }
+    uint64_t max() const { return max_; }
+    double mean() const { return total_count_ > 0 ? static_cast<double>(total_value_) / total_count_ : 0.0; }
+    uint64_t value_at_percentile(double percentile) const;
+    LatencySummary summary() const;
+    uint32_t precision_bits() const { return precision_bits_; }
+
+    // Compact binary form: non-zero buckets as run-length varints
+    std::vector<uint8_t> dump() const;
+    static LatencyHistogram load(const std::vector<uint8_t>& data);
+
+    // Reset
+    void clear();
+
+    // Checkpointing (restore throws on a precision mismatch)
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    uint32_t precision_bits_;
+    uint32_t sub_bucket_count_;        // 2^precision_bits
+    std::vector<uint64_t> counts_;
+    uint64_t total_count_;
+    uint64_t total_value_;
+    uint64_t min_;
+    uint64_t max_;
+
+    size_t bucket_index(uint64_t value) const {
+        if (value < sub_bucket_count_) {
+            return static_cast<size_t>(value);
+        }
+        uint32_t shift = 64 - __builtin_clzll(value) - precision_bits_;
+        uint32_t half = sub_bucket_count_ / 2;
+        return sub_bucket_count_ + static_cast<size_t>(shift - 1) * half + ((value >> shift) - half);
+    }
+    uint64_t bucket_high(size_t index) const;
+};
+
+// Where in the hierarchy a latency was measured
+enum class MemoryLevel : uint8_t { SHARED_MEMORY, L1, L2, DRAM };
+
+// Latency histograms per hierarchy level and transaction type
+class MemoryLatencyProfile {
+public:
+    static const uint32_t NUM_LEVELS = 4;
+    static const uint32_t NUM_TYPES = static_cast<uint32_t>(MemoryTransactionType::ATOMIC_CAS) + 1;
+
+    // Constructor
+    explicit MemoryLatencyProfile(uint32_t precision_bits = LatencyHistogram::DEFAULT_PRECISION_BITS);
+
+    // Record a completed access
+    void record(MemoryLevel level, MemoryTransactionType type, uint64_t cycles) {
+        histograms_[index(level, type)].record(cycles);
+    }
+
+    // Per level and type, or all types of a level merged
+    const LatencyHistogram& histogram(MemoryLevel level, MemoryTransactionType type) const {
+        return histograms_[index(level, type)];
+    }
+    LatencyHistogram level(MemoryLevel level) const;
+    uint32_t precision_bits() const { return histograms_.front().precision_bits(); }
+
+    // Combine with another run's profile
+    void merge(const MemoryLatencyProfile& other);
+
+    // Compact binary form of all histograms; load() takes the precision
+    // from the dump and rejects dumps that mix precisions
+    std::vector<uint8_t> dump() const;
+    static MemoryLatencyProfile load(const std::vector<uint8_t>& data);
+
+    // Reset
+    void clear();
+
+    // Checkpointing (restore throws on a precision mismatch)
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    std::vector<LatencyHistogram> histograms_;
+
+    static size_t index(MemoryLevel level, MemoryTransactionType type) {
+        return static_cast<size_t>(level) * NUM_TYPES + static_cast<size_t>(type);
+    }
+};
+
+#endif // LATENCY_HISTOGRAM_H
@@ -0,0 +1,1434 @@
+// Checkpoint save/restore for the memory subsystem components
+
+#include "memory_subsystem.h"
+#include "../common/checkpoint.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+
+void write_payload(CheckpointWriter& writer, const BurstPayload& payload) {
+    writer.write_varint(payload.size());
+    if (payload.empty()) {
+        return;
+    }
+    writer.write_bytes(payload.data(), payload.size());
+    for (uint32_t offset = 0; offset < payload.size(); offset += 8) {
+        uint8_t enables = 0;
+        for (uint32_t i = offset; i < offset + 8 && i < payload.size(); i++) {
+            enables |= static_cast<uint8_t>(payload.byte_enabled(i)) << (i - offset);
+        }
+        writer.write_u8(enables);
+    }
+}
+
+BurstPayload read_payload(CheckpointReader& reader) {
+    uint32_t size = static_cast<uint32_t>(reader.read_varint());
+    if (size == 0) {
+        return BurstPayload();
+    }
+    BurstPayload payload(size);
+    reader.read_bytes(payload.mutable_data(), size);
+    for (uint32_t offset = 0; offset < size; offset += 8) {
+        uint8_t enables = reader.read_u8();
+        for (uint32_t i = offset; i < offset + 8 && i < size; i++) {
+            if (((enables >> (i - offset)) & 1) == 0) {
+                payload.set_byte_enable(i, 1, false);
+            }
+        }
+    }
+    return payload;
+}
+
+void write_transaction(CheckpointWriter& writer, const MemoryTransaction& txn) {
+    writer.write_varint(static_cast<uint64_t>(txn.type()));
+    writer.write_varint(txn.address());
+    writer.write_varint(txn.size());
+    writer.write_u64(txn.data());
+    write_payload(writer, txn.payload());
+    writer.write_varint(txn.pc());
+    writer.write_varint(txn.source());
+    writer.write_varint(txn.id());
+    writer.write_bool(txn.is_pending());
+}
+
+MemoryTransaction read_transaction(CheckpointReader& reader) {
+    MemoryTransactionType type = static_cast<MemoryTransactionType>(reader.read_varint());
+    uint64_t address = reader.read_varint();
+    uint32_t size = static_cast<uint32_t>(reader.read_varint());
+    MemoryTransaction txn(type, address, size);
+    txn.set_data(reader.read_u64());
+    txn.set_payload(read_payload(reader));
+    txn.set_pc(reader.read_varint());
+    txn.set_source(static_cast<uint32_t>(reader.read_varint()));
+    txn.set_id(static_cast<uint32_t>(reader.read_varint()));
+    txn.set_pending(reader.read_bool());
+    return txn;
+}
+
+void write_response(CheckpointWriter& writer, const MemoryResponse& resp) {
+    writer.write_varint(resp.id());
+    writer.write_varint(static_cast<uint64_t>(resp.status()));
+    writer.write_u64(resp.data());
+    write_payload(writer, resp.payload());
+    writer.write_varint(resp.latency());
+    writer.write_bool(resp.is_valid());
+}
+
+MemoryResponse read_response(CheckpointReader& reader) {
+    uint32_t id = static_cast<uint32_t>(reader.read_varint());
+    MemoryResponseStatus status = static_cast<MemoryResponseStatus>(reader.read_varint());
+    MemoryResponse resp(id, status);
+    resp.set_data(reader.read_u64());
+    resp.set_payload(read_payload(reader));
+    resp.set_latency(static_cast<uint32_t>(reader.read_varint()));
+    resp.set_valid(reader.read_bool());
+    return resp;
+}
+
+void check_config(const char* component, uint64_t saved, uint64_t current) {
+    if (saved != current) {
+        throw std::runtime_error(std::string("Checkpoint configuration mismatch in ") +
+                                 component + ": saved " + std::to_string(saved) +
+                                 ", elaborated " + std::to_string(current));
+    }
+}
+
+void check_policy(CheckpointReader& reader, const char* policy) {
+    std::string saved = reader.read_string();
+    if (saved != policy) {
+        throw std::runtime_error("Checkpoint replacement policy mismatch: saved " + saved +
+                                 ", elaborated " + policy);
+    }
+}
+
+void check_mapping(CheckpointReader& reader, const char* component, const AddressMapping& mapping) {
+    std::string saved = reader.read_string();
+    if (saved != mapping.to_string()) {
+        throw std::runtime_error(std::string("Checkpoint address mapping mismatch in ") + component +
+                                 ": saved " + saved + ", elaborated " + mapping.to_string());
+    }
+}
+
+bool is_zero_page(const uint8_t* page, size_t size) {
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, page + i, sizeof(word));
+        if (word != 0) {
+            return false;
+        }
+    }
+    for (; i < size; i++) {
+        if (page[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Page record kinds in the global memory section
+const uint8_t PAGE_ZERO = 0;
+const uint8_t PAGE_DATA = 1;
+
+}  // namespace
+
+// RegisterFile
+
+void RegisterFile::save_state(CheckpointWriter& writer) const {
+    writer.begin_section(checkpoint::SectionTag::MEMORY_REGISTER_FILE);
+    writer.write_varint(registers_.size());
+    for (uint32_t value : registers_) {
+        writer.write_varint(value);
+    }
+    writer.write_varint(transaction_id_);
+    writer.end_section();
+}
+
+void RegisterFile::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::MEMORY_REGISTER_FILE);
+    check_config("RegisterFile size", reader.read_varint(), registers_.size());
+    for (uint32_t& value : registers_) {
+        value = static_cast<uint32_t>(reader.read_varint());
+    }
+    transaction_id_ = static_cast<uint32_t>(reader.read_varint());
+    reader.end_section();
+}
+
+// LoadBalanceHistogram
+
+void LoadBalanceHistogram::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(counts_.size());
+    for (uint64_t count : counts_) {
+        writer.write_varint(count);
+    }
+}
+
+void LoadBalanceHistogram::restore_state(CheckpointReader& reader) {
+    check_config("Load histogram buckets", reader.read_varint(), counts_.size());
+    total_ = 0;
+    for (uint64_t& count : counts_) {
+        count = reader.read_varint();
+        total_ += count;
+    }
+}
+
+// SharedMemoryBankModel
+
+void SharedMemoryBankModel::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(num_banks_);
+    writer.write_u8(static_cast<uint8_t>(mode_));
+    writer.write_string(mapping_.to_string());
+    writer.write_varint(swizzle_.bits);
+    writer.write_varint(swizzle_.base);
+    writer.write_varint(swizzle_.shift);
+    const uint64_t counters[] = {
+        stats_.accesses, stats_.wavefronts, stats_.ideal_wavefronts, stats_.conflicted_accesses,
+        stats_.broadcast_words};
+    for (uint64_t counter : counters) {
+        writer.write_varint(counter);
+    }
+}
+
+void SharedMemoryBankModel::restore_state(CheckpointReader& reader) {
+    check_config("Shared memory banks", reader.read_varint(), num_banks_);
+    check_config("Shared memory bank mode", reader.read_u8(), static_cast<uint8_t>(mode_));
+    check_mapping(reader, "Shared memory bank", mapping_);
+    check_config("Shared memory swizzle bits", reader.read_varint(), swizzle_.bits);
+    check_config("Shared memory swizzle base", reader.read_varint(), swizzle_.base);
+    check_config("Shared memory swizzle shift", reader.read_varint(), swizzle_.shift);
+    uint64_t* counters[] = {
+        &stats_.accesses, &stats_.wavefronts, &stats_.ideal_wavefronts, &stats_.conflicted_accesses,
+        &stats_.broadcast_words};
+    for (uint64_t* counter : counters) {
+        *counter = reader.read_varint();
+    }
+}
+
+// SharedMemory
+
+void SharedMemory::save_state(CheckpointWriter& writer) const {
+    writer.begin_section(checkpoint::SectionTag::SHARED_MEMORY);
+    writer.write_byte_vector(memory_);
+    writer.write_varint(transaction_id_);
+    writer.write_varint(bank_states_.size());
+    for (const BankState& bank : bank_states_) {
+        writer.write_bool(bank.busy);
+        writer.write_varint(bank.busy_until_cycle);
+    }
+    writer.write_varint(current_cycle_);
+    banks_.save_state(writer);
+    bank_load_.save_state(writer);
+    writer.end_section();
+}
+
+void SharedMemory::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::SHARED_MEMORY);
+    std::vector<uint8_t> memory = reader.read_byte_vector();
+    check_config("SharedMemory size", memory.size(), memory_.size());
+    invalidate_dmi_regions();
+    memory_.swap(memory);
+    transaction_id_ = static_cast<uint32_t>(reader.read_varint());
+    check_config("SharedMemory banks", reader.read_varint(), bank_states_.size());
+    for (BankState& bank : bank_states_) {
+        bank.busy = reader.read_bool();
+        bank.busy_until_cycle = static_cast<uint32_t>(reader.read_varint());
+    }
+    current_cycle_ = static_cast<uint32_t>(reader.read_varint());
+    banks_.restore_state(reader);
+    bank_load_.restore_state(reader);
+    reader.end_section();
+}
+
+// CacheArray
+
+void CacheArray::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(num_sets_);
+    writer.write_varint(associativity_);
+    writer.write_varint(line_size_);
+
+    // Tags, state and data are only stored for valid lines
+    for (uint32_t set = 0; set < num_sets_; set++) {
+        writer.write_varint(valid_[set]);
+        writer.write_varint(dirty_[set]);
+        for (uint32_t way = 0; way < associativity_; way++) {
+            if (!valid(set, way)) {
+                continue;
+            }
+            writer.write_varint(tag(set, way));
+            writer.write_u8(state(set, way));
+            if (stores_data()) {
+                writer.write_bytes(line_data(set, way), line_size_);
+            }
+        }
+    }
+}
+
+void CacheArray::restore_state(CheckpointReader& reader) {
+    check_config("CacheArray sets", reader.read_varint(), num_sets_);
+    check_config("CacheArray associativity", reader.read_varint(), associativity_);
+    check_config("CacheArray line size", reader.read_varint(), line_size_);
+
+    clear();
+    for (uint32_t set = 0; set < num_sets_; set++) {
+        uint64_t valid_mask = reader.read_varint();
+        uint64_t dirty_mask = reader.read_varint();
+        for (uint32_t way = 0; way < associativity_; way++) {
+            if (((valid_mask >> way) & 1) == 0) {
+                continue;
+            }
+            uint64_t line_tag = reader.read_varint();
+            uint8_t line_state = reader.read_u8();
+            fill(set, way, line_tag, nullptr);
+            if (stores_data()) {
+                reader.read_bytes(line_data(set, way), line_size_);
+            }
+            set_state(set, way, line_state);
+        }
+        dirty_[set] = dirty_mask & valid_mask;
+    }
+}
+
+// Replacement policies
+
+void ReplacementPolicyBase::save_stats(CheckpointWriter& writer) const {
+    writer.write_varint(num_sets_);
+    writer.write_varint(associativity_);
+    writer.write_varint(stats_.hits);
+    writer.write_varint(stats_.misses);
+    writer.write_varint(stats_.evictions);
+}
+
+void ReplacementPolicyBase::restore_stats(CheckpointReader& reader) {
+    check_config("Replacement policy sets", reader.read_varint(), num_sets_);
+    check_config("Replacement policy associativity", reader.read_varint(), associativity_);
+    stats_.hits = reader.read_varint();
+    stats_.misses = reader.read_varint();
+    stats_.evictions = reader.read_varint();
+}
+
+void LruPolicy::save_state(CheckpointWriter& writer) const {
+    writer.write_string(name());
+    save_stats(writer);
+    writer.write_bytes(ranks_.data(), ranks_.size());
+}
+
+void LruPolicy::restore_state(CheckpointReader& reader) {
+    check_policy(reader, name());
+    restore_stats(reader);
+    reader.read_bytes(ranks_.data(), ranks_.size());
+}
+
+void TreePlruPolicy::save_state(CheckpointWriter& writer) const {
+    writer.write_string(name());
+    save_stats(writer);
+    for (uint64_t bits : tree_bits_) {
+        writer.write_varint(bits);
+    }
+}
+
+void TreePlruPolicy::restore_state(CheckpointReader& reader) {
+    check_policy(reader, name());
+    restore_stats(reader);
+    for (uint64_t& bits : tree_bits_) {
+        bits = reader.read_varint();
+    }
+}
+
+void RripPolicy::save_state(CheckpointWriter& writer) const {
+    writer.write_string("rrip");
+    writer.write_u8(static_cast<uint8_t>(insertion_));
+    save_stats(writer);
+    writer.write_bytes(rrpv_.data(), rrpv_.size());
+    writer.write_varint(bimodal_counter_);
+    writer.write_varint(psel_);
+    writer.write_varint(srrip_leader_misses_);
+    writer.write_varint(brrip_leader_misses_);
+}
+
+void RripPolicy::restore_state(CheckpointReader& reader) {
+    check_policy(reader, "rrip");
+    check_config("RRIP insertion mode", reader.read_u8(), static_cast<uint8_t>(insertion_));
+    restore_stats(reader);
+    reader.read_bytes(rrpv_.data(), rrpv_.size());
+    bimodal_counter_ = static_cast<uint32_t>(reader.read_varint());
+    psel_ = static_cast<uint32_t>(reader.read_varint());
+    srrip_leader_misses_ = reader.read_varint();
+    brrip_leader_misses_ = reader.read_varint();
+}
+
+void RandomPolicy::save_state(CheckpointWriter& writer) const {
+    writer.write_string(name());
+    save_stats(writer);
+    writer.write_u64(rng_state_);
+}
+
+void RandomPolicy::restore_state(CheckpointReader& reader) {
+    check_policy(reader, name());
+    restore_stats(reader);
+    rng_state_ = reader.read_u64();
+}
+
+// MshrFile
+
+void MshrFile::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(entries_.size());
+    writer.write_varint(max_targets_);
+    for (const Entry& entry : entries_) {
+        writer.write_bool(entry.valid);
+        if (!entry.valid) {
+            continue;
+        }
+        writer.write_varint(entry.block_addr);
+        writer.write_varint(entry.targets.size());
+        for (const MemoryTransaction& txn : entry.targets) {
+            write_transaction(writer, txn);
+        }
+    }
+    writer.write_varint(stats_.primary_misses);
+    writer.write_varint(stats_.secondary_misses);
+    writer.write_varint(stats_.entry_full_stalls);
+    writer.write_varint(stats_.target_full_stalls);
+    writer.write_varint(stats_.stall_cycles);
+    writer.write_varint(stats_.peak_occupancy);
+}
+
+void MshrFile::restore_state(CheckpointReader& reader) {
+    check_config("MSHR entries", reader.read_varint(), entries_.size());
+    check_config("MSHR targets", reader.read_varint(), max_targets_);
+    clear();
+    for (Entry& entry : entries_) {
+        entry.valid = reader.read_bool();
+        if (!entry.valid) {
+            continue;
+        }
+        entry.block_addr = reader.read_varint();
+        uint64_t num_targets = reader.read_varint();
+        for (uint64_t i = 0; i < num_targets; i++) {
+            entry.targets.push_back(read_transaction(reader));
+        }
+        occupancy_++;
+    }
+    stats_.primary_misses = reader.read_varint();
+    stats_.secondary_misses = reader.read_varint();
+    stats_.entry_full_stalls = reader.read_varint();
+    stats_.target_full_stalls = reader.read_varint();
+    stats_.stall_cycles = reader.read_varint();
+    stats_.peak_occupancy = static_cast<uint32_t>(reader.read_varint());
+}
+
+// Prefetcher
+
+void Prefetcher::save_state(CheckpointWriter& writer) const {
+    writer.write_u8(static_cast<uint8_t>(config_.type));
+    writer.write_varint(config_.line_size);
+    writer.write_varint(degree_);
+    writer.write_varint(access_count_);
+
+    writer.write_varint(stats_.issued);
+    writer.write_varint(stats_.dropped);
+    writer.write_varint(stats_.useful);
+    writer.write_varint(stats_.late);
+    writer.write_varint(stats_.useless);
+    writer.write_varint(stats_.uncovered_misses);
+
+    writer.write_varint(stride_table_.size());
+    for (const StrideEntry& entry : stride_table_) {
+        writer.write_bool(entry.valid);
+        writer.write_varint(entry.pc);
+        writer.write_varint(entry.last_addr);
+        writer.write_u64(static_cast<uint64_t>(entry.stride));
+        writer.write_u8(entry.confidence);
+    }
+    writer.write_varint(streams_.size());
+    for (const Stream& stream : streams_) {
+        writer.write_bool(stream.valid);
+        writer.write_varint(stream.head_line);
+        writer.write_u8(static_cast<uint8_t>(stream.direction + 1));
+        writer.write_varint(stream.last_use);
+    }
+
+    writer.write_varint(in_flight_.size());
+    for (uint64_t line : in_flight_) {
+        writer.write_varint(line);
+    }
+    writer.write_varint(unused_.size());
+    for (uint64_t line : unused_) {
+        writer.write_varint(line);
+    }
+    writer.write_varint(epoch_issued_);
+    writer.write_varint(epoch_useful_);
+}
+
+void Prefetcher::restore_state(CheckpointReader& reader) {
+    check_config("Prefetcher type", reader.read_u8(), static_cast<uint8_t>(config_.type));
+    check_config("Prefetcher line size", reader.read_varint(), config_.line_size);
+    degree_ = static_cast<uint32_t>(reader.read_varint());
+    access_count_ = reader.read_varint();
+
+    stats_.issued = reader.read_varint();
+    stats_.dropped = reader.read_varint();
+    stats_.useful = reader.read_varint();
+    stats_.late = reader.read_varint();
+    stats_.useless = reader.read_varint();
+    stats_.uncovered_misses = reader.read_varint();
+
+    check_config("Prefetcher stride table", reader.read_varint(), stride_table_.size());
+    for (StrideEntry& entry : stride_table_) {
+        entry.valid = reader.read_bool();
+        entry.pc = reader.read_varint();
+        entry.last_addr = reader.read_varint();
+        entry.stride = static_cast<int64_t>(reader.read_u64());
+        entry.confidence = reader.read_u8();
+    }
+    check_config("Prefetcher streams", reader.read_varint(), streams_.size());
+    for (Stream& stream : streams_) {
+        stream.valid = reader.read_bool();
+        stream.head_line = reader.read_varint();
+        stream.direction = static_cast<int32_t>(reader.read_u8()) - 1;
+        stream.last_use = reader.read_varint();
+    }
+
+    in_flight_.clear();
+    uint64_t num_in_flight = reader.read_varint();
+    for (uint64_t i = 0; i < num_in_flight; i++) {
+        in_flight_.insert(reader.read_varint());
+    }
+    unused_.clear();
+    uint64_t num_unused = reader.read_varint();
+    for (uint64_t i = 0; i < num_unused; i++) {
+        unused_.insert(reader.read_varint());
+    }
+    epoch_issued_ = reader.read_varint();
+    epoch_useful_ = reader.read_varint();
+}
+
+// CacheL1
+
+void CacheL1::save_state(CheckpointWriter& writer) const {
+    writer.begin_section(checkpoint::SectionTag::CACHE_L1);
+    writer.write_varint(size_bytes_);
+    writer.write_varint(line_size_);
+    writer.write_varint(associativity_);
+    writer.write_string(set_mapping_.to_string());
+    writer.write_varint(hits_);
+    writer.write_varint(misses_);
+    set_load_.save_state(writer);
+
+    lines_.save_state(writer);
+    replacement_.save_state(writer);
+    prefetcher_.save_state(writer);
+    writes_.save_state(writer);
+
+    writer.write_varint(pending_transactions_.size());
+    for (const MemoryTransaction& txn : pending_transactions_) {
+        write_transaction(writer, txn);
+    }
+
+    mshrs_.save_state(writer);
+    writer.write_varint(max_mshr_entries_);
+
+    writer.write_varint(transaction_id_);
+    writer.write_varint(current_cycle_);
+    writer.end_section();
+}
+
+void CacheL1::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::CACHE_L1);
+    check_config("CacheL1 size", reader.read_varint(), size_bytes_);
+    check_config("CacheL1 line size", reader.read_varint(), line_size_);
+    check_config("CacheL1 associativity", reader.read_varint(), associativity_);
+    check_mapping(reader, "CacheL1 set index", set_mapping_);
+    hits_ = reader.read_varint();
+    misses_ = reader.read_varint();
+    set_load_.restore_state(reader);
+
+    lines_.restore_state(reader);
+    replacement_.restore_state(reader);
+    prefetcher_.restore_state(reader);
+    writes_.restore_state(reader);
+
+    pending_transactions_.clear();
+    uint64_t num_pending = reader.read_varint();
+    for (uint64_t i = 0; i < num_pending; i++) {
+        pending_transactions_.push_back(read_transaction(reader));
+    }
+
+    mshrs_.restore_state(reader);
+    max_mshr_entries_ = static_cast<uint32_t>(reader.read_varint());
+
+    transaction_id_ = static_cast<uint32_t>(reader.read_varint());
+    current_cycle_ = reader.read_varint();
+    reader.end_section();
+}
+
+// CacheL2
+
+void CacheL2::save_state(CheckpointWriter& writer) const {
+    writer.begin_section(checkpoint::SectionTag::CACHE_L2);
+    writer.write_varint(size_bytes_);
+    writer.write_varint(line_size_);
+    writer.write_varint(associativity_);
+    writer.write_string(set_mapping_.to_string());
+    writer.write_varint(hits_);
+    writer.write_varint(misses_);
+    set_load_.save_state(writer);
+
+    lines_.save_state(writer);
+    replacement_.save_state(writer);
+    prefetcher_.save_state(writer);
+    atomics_.save_state(writer);
+    directory_.save_state(writer);
+
+    writer.write_varint(pending_transactions_.size());
+    for (const MemoryTransaction& txn : pending_transactions_) {
+        write_transaction(writer, txn);
+    }
+
+    writer.write_varint(mshr_entries_.size());
+    for (const auto& entry : mshr_entries_) {
+        const MSHR& mshr = entry.second;
+        writer.write_varint(entry.first);
+        writer.write_varint(mshr.transaction_id);
+        write_transaction(writer, mshr.original_transaction);
+        writer.write_varint(mshr.addr);
+        writer.write_varint(mshr.set_index);
+        writer.write_varint(mshr.tag);
+        writer.write_bool(mshr.pending);
+        writer.write_varint(mshr.dependent_transactions.size());
+        for (uint32_t id : mshr.dependent_transactions) {
+            writer.write_varint(id);
+        }
+    }
+    writer.write_varint(addr_to_mshr_.size());
+    for (const auto& entry : addr_to_mshr_) {
+        writer.write_varint(entry.first);
+        writer.write_varint(entry.second);
+    }
+    writer.write_varint(max_mshr_entries_);
+
+    writer.write_varint(transaction_id_);
+    writer.write_varint(current_cycle_);
+    writer.end_section();
+}
+
+void CacheL2::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::CACHE_L2);
+    check_config("CacheL2 size", reader.read_varint(), size_bytes_);
+    check_config("CacheL2 line size", reader.read_varint(), line_size_);
+    check_config("CacheL2 associativity", reader.read_varint(), associativity_);
+    check_mapping(reader, "CacheL2 set index", set_mapping_);
+    hits_ = reader.read_varint();
+    misses_ = reader.read_varint();
+    set_load_.restore_state(reader);
+
+    lines_.restore_state(reader);
+    replacement_.restore_state(reader);
+    prefetcher_.restore_state(reader);
+    atomics_.restore_state(reader);
+    directory_.restore_state(reader);
+
+    pending_transactions_.clear();
+    uint64_t num_pending = reader.read_varint();
+    for (uint64_t i = 0; i < num_pending; i++) {
+        pending_transactions_.push_back(read_transaction(reader));
+    }
+
+    mshr_entries_.clear();
+    uint64_t num_mshrs = reader.read_varint();
+    for (uint64_t i = 0; i < num_mshrs; i++) {
+        uint32_t key = static_cast<uint32_t>(reader.read_varint());
+        MSHR mshr;
+        mshr.transaction_id = static_cast<uint32_t>(reader.read_varint());
+        mshr.original_transaction = read_transaction(reader);
+        mshr.addr = reader.read_varint();
+        mshr.set_index = static_cast<uint32_t>(reader.read_varint());
+        mshr.tag = reader.read_varint();
+        mshr.pending = reader.read_bool();
+        mshr.dependent_transactions.resize(reader.read_varint());
+        for (uint32_t& id : mshr.dependent_transactions) {
+            id = static_cast<uint32_t>(reader.read_varint());
+        }
+        mshr_entries_[key] = mshr;
+    }
+    addr_to_mshr_.clear();
+    uint64_t num_addr_entries = reader.read_varint();
+    for (uint64_t i = 0; i < num_addr_entries; i++) {
+        uint64_t block_addr = reader.read_varint();
+        addr_to_mshr_[block_addr] = static_cast<uint32_t>(reader.read_varint());
+    }
+    max_mshr_entries_ = static_cast<uint32_t>(reader.read_varint());
+
+    transaction_id_ = static_cast<uint32_t>(reader.read_varint());
+    current_cycle_ = reader.read_varint();
+    reader.end_section();
+}
+
+// DRAM timing model
+
+void DramChannel::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(banks_.size());
+    for (const Bank& bank : banks_) {
+        writer.write_bool(bank.open);
+        writer.write_varint(bank.row);
+        writer.write_varint(bank.act_ready);
+        writer.write_varint(bank.pre_ready);
+        writer.write_varint(bank.column_ready);
+    }
+    for (const std::deque<Request>* queue : {&read_queue_, &write_queue_}) {
+        writer.write_varint(queue->size());
+        for (const Request& req : *queue) {
+            writer.write_varint(req.id);
+            writer.write_varint(req.bank_group);
+            writer.write_varint(req.bank);
+            writer.write_varint(req.row);
+            writer.write_varint(req.burst_addr);
+            writer.write_varint(req.arrival);
+            writer.write_bool(req.is_write);
+            writer.write_u8(static_cast<uint8_t>(req.outcome));
+        }
+    }
+    writer.write_varint(completions_.size());
+    for (const PendingCompletion& pending : completions_) {
+        writer.write_varint(pending.ready_cycle);
+        writer.write_varint(pending.completion.id);
+        writer.write_bool(pending.completion.is_write);
+        writer.write_varint(pending.completion.latency);
+    }
+
+    for (uint32_t group = 0; group < config_.bank_groups; group++) {
+        writer.write_varint(group_column_ready_[group]);
+        writer.write_varint(group_act_ready_[group]);
+        writer.write_varint(group_read_ready_[group]);
+    }
+    writer.write_varint(column_ready_);
+    writer.write_varint(act_ready_);
+    writer.write_varint(read_ready_);
+    writer.write_varint(write_ready_);
+    writer.write_varint(data_bus_free_);
+    writer.write_varint(recent_activates_.size());
+    for (uint64_t cycle : recent_activates_) {
+        writer.write_varint(cycle);
+    }
+    writer.write_varint(next_refresh_);
+    writer.write_bool(refresh_pending_);
+    writer.write_bool(draining_writes_);
+
+    const uint64_t counters[] = {
+        stats_.reads, stats_.writes, stats_.row_hits, stats_.row_misses, stats_.row_conflicts,
+        stats_.activates, stats_.precharges, stats_.refreshes, stats_.write_forwards,
+        stats_.write_drains, stats_.read_latency_cycles, stats_.data_bus_cycles};
+    for (uint64_t counter : counters) {
+        writer.write_varint(counter);
+    }
+}
+
+void DramChannel::restore_state(CheckpointReader& reader) {
+    check_config("DRAM banks", reader.read_varint(), banks_.size());
+    for (Bank& bank : banks_) {
+        bank.open = reader.read_bool();
+        bank.row = reader.read_varint();
+        bank.act_ready = reader.read_varint();
+        bank.pre_ready = reader.read_varint();
+        bank.column_ready = reader.read_varint();
+    }
+    for (std::deque<Request>* queue : {&read_queue_, &write_queue_}) {
+        queue->clear();
+        uint64_t size = reader.read_varint();
+        for (uint64_t i = 0; i < size; i++) {
+            Request req;
+            req.id = static_cast<uint32_t>(reader.read_varint());
+            req.bank_group = static_cast<uint32_t>(reader.read_varint());
+            req.bank = static_cast<uint32_t>(reader.read_varint());
+            req.row = reader.read_varint();
+            req.burst_addr = reader.read_varint();
+            req.arrival = reader.read_varint();
+            req.is_write = reader.read_bool();
+            req.outcome = static_cast<RowOutcome>(reader.read_u8());
+            queue->push_back(req);
+        }
+    }
+    completions_.resize(reader.read_varint());
+    for (PendingCompletion& pending : completions_) {
+        pending.ready_cycle = reader.read_varint();
+        pending.completion.id = static_cast<uint32_t>(reader.read_varint());
+        pending.completion.is_write = reader.read_bool();
+        pending.completion.latency = reader.read_varint();
+    }
+
+    for (uint32_t group = 0; group < config_.bank_groups; group++) {
+        group_column_ready_[group] = reader.read_varint();
+        group_act_ready_[group] = reader.read_varint();
+        group_read_ready_[group] = reader.read_varint();
+    }
+    column_ready_ = reader.read_varint();
+    act_ready_ = reader.read_varint();
+    read_ready_ = reader.read_varint();
+    write_ready_ = reader.read_varint();
+    data_bus_free_ = reader.read_varint();
+    recent_activates_.resize(reader.read_varint());
+    for (uint64_t& cycle : recent_activates_) {
+        cycle = reader.read_varint();
+    }
+    next_refresh_ = reader.read_varint();
+    refresh_pending_ = reader.read_bool();
+    draining_writes_ = reader.read_bool();
+
+    uint64_t* counters[] = {
+        &stats_.reads, &stats_.writes, &stats_.row_hits, &stats_.row_misses, &stats_.row_conflicts,
+        &stats_.activates, &stats_.precharges, &stats_.refreshes, &stats_.write_forwards,
+        &stats_.write_drains, &stats_.read_latency_cycles, &stats_.data_bus_cycles};
+    for (uint64_t* counter : counters) {
+        *counter = reader.read_varint();
+    }
+}
+
+void DramSystem::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(controllers_.size());
+    writer.write_string(channel_mapping_.to_string());
+    writer.write_string(bank_mapping_.to_string());
+    writer.write_varint(cycle_);
+    writer.write_varint(stats_start_cycle_);
+    for (const DramChannel& ctrl : controllers_) {
+        ctrl.save_state(writer);
+    }
+    channel_load_.save_state(writer);
+    read_latency_.save_state(writer);
+    write_latency_.save_state(writer);
+    writer.write_varint(outstanding_.size());
+    for (const auto& entry : outstanding_) {
+        writer.write_varint(entry.first);
+        writer.write_varint(entry.second.bursts_left);
+        writer.write_varint(entry.second.arrival);
+        writer.write_bool(entry.second.is_write);
+    }
+}
+
+void DramSystem::restore_state(CheckpointReader& reader) {
+    check_config("DRAM pseudo-channels", reader.read_varint(), controllers_.size());
+    check_mapping(reader, "DRAM channel", channel_mapping_);
+    check_mapping(reader, "DRAM bank", bank_mapping_);
+    cycle_ = reader.read_varint();
+    stats_start_cycle_ = reader.read_varint();
+    for (DramChannel& ctrl : controllers_) {
+        ctrl.restore_state(reader);
+    }
+    channel_load_.restore_state(reader);
+    read_latency_.restore_state(reader);
+    write_latency_.restore_state(reader);
+    outstanding_.clear();
+    uint64_t num_outstanding = reader.read_varint();
+    for (uint64_t i = 0; i < num_outstanding; i++) {
+        uint32_t id = static_cast<uint32_t>(reader.read_varint());
+        Outstanding entry;
+        entry.bursts_left = static_cast<uint32_t>(reader.read_varint());
+        entry.arrival = reader.read_varint();
+        entry.is_write = reader.read_bool();
+        outstanding_[id] = entry;
+    }
+}
+
+// GlobalMemory
+
+void GlobalMemory::save_state(CheckpointWriter& writer) const {
+    writer.begin_section(checkpoint::SectionTag::GLOBAL_MEMORY);
+    writer.write_varint(size_bytes_);
+    writer.write_varint(num_channels_);
+    writer.write_varint(channel_width_bits_);
+
+    dram_.save_state(writer);
+    writer.write_varint(in_flight_.size());
+    for (const auto& entry : in_flight_) {
+        write_transaction(writer, entry.second);
+    }
+    std::queue<MemoryTransaction> backlog = backlog_;
+    writer.write_varint(backlog.size());
+    while (!backlog.empty()) {
+        write_transaction(writer, backlog.front());
+        backlog.pop();
+    }
+
+    writer.write_varint(transaction_id_);
+    writer.write_varint(current_cycle_);
+    writer.write_varint(total_bytes_transferred_);
+    writer.write_varint(total_latency_cycles_);
+    writer.write_varint(total_transactions_);
+    writer.write_varint(current_bandwidth_gbps_);
+
+    // Sparse page records. A full checkpoint emits every non-zero page; an
+    // incremental one emits every page written since mark_checkpoint(),
+    // with pages that now read as zero recorded as such. Only pages the
+    // backing store has allocated or marked can hold changes, so the scan is
+    // proportional to touched memory rather than the simulated size. The
+    // last page is partial when the size is not a multiple of the page size.
+    std::vector<uint64_t> backing_pages = writer.is_incremental() ? memory_.dirty_pages() : memory_.touched_pages();
+    std::vector<uint64_t> zeroed_pages;
+    std::vector<uint64_t> data_pages;
+    uint64_t chunks_per_page = memory_.page_size() / CHECKPOINT_PAGE_SIZE;
+    for (uint64_t backing_page : backing_pages) {
+        const uint8_t* backing_data = memory_.page_data(backing_page);
+        for (uint64_t chunk = 0; chunk < chunks_per_page; chunk++) {
+            uint64_t page = backing_page * chunks_per_page + chunk;
+            if (page * CHECKPOINT_PAGE_SIZE >= memory_.size()) {
+                break;
+            }
+            if (backing_data == nullptr || is_zero_page(backing_data + chunk * CHECKPOINT_PAGE_SIZE,
+                                                        checkpoint_page_bytes(page))) {
+                if (writer.is_incremental()) {
+                    zeroed_pages.push_back(page);
+                }
+                continue;
+            }
+            data_pages.push_back(page);
+        }
+    }
+
+    writer.write_varint(zeroed_pages.size() + data_pages.size());
+    for (uint64_t page : zeroed_pages) {
+        writer.write_varint(page);
+        writer.write_u8(PAGE_ZERO);
+    }
+    for (uint64_t page : data_pages) {
+        writer.write_varint(page);
+        writer.write_u8(PAGE_DATA);
+        uint8_t data[CHECKPOINT_PAGE_SIZE];
+        uint64_t bytes = checkpoint_page_bytes(page);
+        memory_.read_block(page * CHECKPOINT_PAGE_SIZE, data, bytes);
+        writer.write_bytes(data, bytes);
+    }
+    writer.end_section();
+}
+
+void GlobalMemory::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::GLOBAL_MEMORY);
+    check_config("GlobalMemory size", reader.read_varint(), size_bytes_);
+    check_config("GlobalMemory channels", reader.read_varint(), num_channels_);
+    check_config("GlobalMemory channel width", reader.read_varint(), channel_width_bits_);
+
+    dram_.restore_state(reader);
+    in_flight_.clear();
+    uint64_t num_in_flight = reader.read_varint();
+    for (uint64_t i = 0; i < num_in_flight; i++) {
+        MemoryTransaction txn = read_transaction(reader);
+        in_flight_[txn.id()] = txn;
+    }
+    backlog_ = std::queue<MemoryTransaction>();
+    uint64_t backlog_size = reader.read_varint();
+    for (uint64_t i = 0; i < backlog_size; i++) {
+        backlog_.push(read_transaction(reader));
+    }
+
+    transaction_id_ = static_cast<uint32_t>(reader.read_varint());
+    current_cycle_ = reader.read_varint();
+    total_bytes_transferred_ = reader.read_varint();
+    total_latency_cycles_ = reader.read_varint();
+    total_transactions_ = reader.read_varint();
+    current_bandwidth_gbps_ = reader.read_varint();
+
+    // A full checkpoint replaces memory contents; an incremental one is
+    // applied on top of the previously restored state
+    if (!reader.is_incremental()) {
+        invalidate_dmi_regions();
+        memory_.clear();
+    }
+    uint64_t num_records = reader.read_varint();
+    for (uint64_t i = 0; i < num_records; i++) {
+        uint64_t page = reader.read_varint();
+        if (page * CHECKPOINT_PAGE_SIZE >= memory_.size()) {
+            throw std::runtime_error("Checkpoint page out of range");
+        }
+        uint64_t addr = page * CHECKPOINT_PAGE_SIZE;
+        uint64_t bytes = checkpoint_page_bytes(page);
+        if (reader.read_u8() == PAGE_ZERO) {
+            memory_.fill(addr, 0, bytes);
+        } else {
+            uint8_t data[CHECKPOINT_PAGE_SIZE];
+            reader.read_bytes(data, bytes);
+            memory_.write_block(addr, data, bytes);
+        }
+    }
+    reader.end_section();
+}
+
+void GlobalMemory::mark_checkpoint() {
+    memory_.clear_dirty();
+    invalidate_dmi_regions();
+}
+
+// AtomicUnit
+
+void AtomicUnit::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(slice_free_.size());
+    for (uint64_t cycle : slice_free_) {
+        writer.write_varint(cycle);
+    }
+    writer.write_varint(address_free_.size());
+    for (const auto& entry : address_free_) {
+        writer.write_varint(entry.first);
+        writer.write_varint(entry.second);
+    }
+    writer.write_varint(last_cycle_);
+    writer.write_varint(stats_.atomics);
+    writer.write_varint(stats_.same_address_stalls);
+    writer.write_varint(stats_.slice_stalls);
+    writer.write_varint(stats_.stall_cycles);
+    writer.write_varint(stats_.total_latency);
+    hotspots_.save_state(writer);
+}
+
+void AtomicUnit::restore_state(CheckpointReader& reader) {
+    check_config("Atomic unit slices", reader.read_varint(), slice_free_.size());
+    for (uint64_t& cycle : slice_free_) {
+        cycle = reader.read_varint();
+    }
+    address_free_.clear();
+    uint64_t num_addresses = reader.read_varint();
+    for (uint64_t i = 0; i < num_addresses; i++) {
+        uint64_t addr = reader.read_varint();
+        address_free_[addr] = reader.read_varint();
+    }
+    last_cycle_ = reader.read_varint();
+    stats_.atomics = reader.read_varint();
+    stats_.same_address_stalls = reader.read_varint();
+    stats_.slice_stalls = reader.read_varint();
+    stats_.stall_cycles = reader.read_varint();
+    stats_.total_latency = reader.read_varint();
+    hotspots_.restore_state(reader);
+}
+
+// CoherenceDirectory
+
+void CoherenceDirectory::save_state(CheckpointWriter& writer) const {
+    writer.write_u8(static_cast<uint8_t>(config_.mode));
+    writer.write_varint(config_.num_cores);
+    writer.write_varint(entries_.size());
+    for (const auto& entry : entries_) {
+        writer.write_varint(entry.first);
+        writer.write_u8(static_cast<uint8_t>(entry.second.state));
+        writer.write_u64(entry.second.sharers);
+    }
+
+    const uint64_t counters[] = {
+        stats_.reads, stats_.writes, stats_.upgrades, stats_.invalidations, stats_.downgrades,
+        stats_.owner_writebacks, stats_.evictions, stats_.back_invalidations, stats_.write_throughs,
+        stats_.barriers, stats_.self_invalidations, stats_.control_messages, stats_.data_messages,
+        stats_.bytes, stats_.requests, stats_.total_latency, stats_.coherence_latency};
+    for (uint64_t counter : counters) {
+        writer.write_varint(counter);
+    }
+}
+
+void CoherenceDirectory::restore_state(CheckpointReader& reader) {
+    check_config("Coherence mode", reader.read_u8(), static_cast<uint8_t>(config_.mode));
+    check_config("Coherence cores", reader.read_varint(), config_.num_cores);
+    entries_.clear();
+    uint64_t num_entries = reader.read_varint();
+    for (uint64_t i = 0; i < num_entries; i++) {
+        uint64_t line = reader.read_varint();
+        Entry entry;
+        entry.state = static_cast<CoherenceState>(reader.read_u8());
+        entry.sharers = reader.read_u64();
+        entries_[line] = entry;
+    }
+
+    uint64_t* counters[] = {
+        &stats_.reads, &stats_.writes, &stats_.upgrades, &stats_.invalidations, &stats_.downgrades,
+        &stats_.owner_writebacks, &stats_.evictions, &stats_.back_invalidations, &stats_.write_throughs,
+        &stats_.barriers, &stats_.self_invalidations, &stats_.control_messages, &stats_.data_messages,
+        &stats_.bytes, &stats_.requests, &stats_.total_latency, &stats_.coherence_latency};
+    for (uint64_t* counter : counters) {
+        *counter = reader.read_varint();
+    }
+}
+
+// WriteCombiningBuffer
+
+void WriteCombiningBuffer::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(num_entries_);
+    writer.write_varint(line_size_);
+    writer.write_varint(entries_.size());
+    for (const Entry& entry : entries_) {
+        writer.write_varint(entry.line);
+        write_payload(writer, entry.payload);
+        writer.write_varint(entry.last_write);
+    }
+    const uint64_t counters[] = {
+        stats_.stores, stats_.merged_stores, stats_.full_line_writes, stats_.partial_line_writes,
+        stats_.capacity_drains, stats_.timeout_drains, stats_.bytes_drained};
+    for (uint64_t counter : counters) {
+        writer.write_varint(counter);
+    }
+}
+
+void WriteCombiningBuffer::restore_state(CheckpointReader& reader) {
+    check_config("Write-combining entries", reader.read_varint(), num_entries_);
+    check_config("Write-combining line size", reader.read_varint(), line_size_);
+    entries_.clear();
+    uint64_t num_buffered = reader.read_varint();
+    for (uint64_t i = 0; i < num_buffered; i++) {
+        Entry entry;
+        entry.line = reader.read_varint();
+        entry.payload = read_payload(reader);
+        entry.last_write = reader.read_varint();
+        entries_.push_back(std::move(entry));
+    }
+    uint64_t* counters[] = {
+        &stats_.stores, &stats_.merged_stores, &stats_.full_line_writes,
+        &stats_.partial_line_writes, &stats_.capacity_drains, &stats_.timeout_drains,
+        &stats_.bytes_drained};
+    for (uint64_t* counter : counters) {
+        *counter = reader.read_varint();
+    }
+}
+
+// CacheWritePolicy
+
+void CacheWritePolicy::save_state(CheckpointWriter& writer) const {
+    writer.write_u8(static_cast<uint8_t>(config_.hit));
+    writer.write_u8(static_cast<uint8_t>(config_.miss));
+    writer.write_varint(config_.combining_entries);
+    combining_.save_state(writer);
+    writer.write_varint(outgoing_.size());
+    for (const MemoryTransaction& write : outgoing_) {
+        write_transaction(writer, write);
+    }
+    const uint64_t counters[] = {
+        stats_.stores, stats_.store_bytes, stats_.write_hits, stats_.write_misses,
+        stats_.write_allocations, stats_.fill_bytes, stats_.forwarded_stores, stats_.writebacks,
+        stats_.read_flushes, stats_.downstream_writes, stats_.downstream_bytes,
+        stats_.partial_line_writes};
+    for (uint64_t counter : counters) {
+        writer.write_varint(counter);
+    }
+}
+
+void CacheWritePolicy::restore_state(CheckpointReader& reader) {
+    check_config("Write hit policy", reader.read_u8(), static_cast<uint8_t>(config_.hit));
+    check_config("Write miss policy", reader.read_u8(), static_cast<uint8_t>(config_.miss));
+    check_config("Write-combining buffer", reader.read_varint(), config_.combining_entries);
+    combining_.restore_state(reader);
+    outgoing_.clear();
+    uint64_t num_outgoing = reader.read_varint();
+    for (uint64_t i = 0; i < num_outgoing; i++) {
+        outgoing_.push_back(read_transaction(reader));
+    }
+    uint64_t* counters[] = {
+        &stats_.stores, &stats_.store_bytes, &stats_.write_hits, &stats_.write_misses,
+        &stats_.write_allocations, &stats_.fill_bytes, &stats_.forwarded_stores, &stats_.writebacks,
+        &stats_.read_flushes, &stats_.downstream_writes, &stats_.downstream_bytes,
+        &stats_.partial_line_writes};
+    for (uint64_t* counter : counters) {
+        *counter = reader.read_varint();
+    }
+}
+
+// AddressTranslation
+
+void PageTable::save_state(CheckpointWriter& writer) const {
+    for (const std::unordered_map<uint64_t, uint64_t>& pages : pages_) {
+        writer.write_varint(pages.size());
+        for (const auto& page : pages) {
+            writer.write_varint(page.first);
+            writer.write_varint(page.second);
+        }
+    }
+}
+
+void PageTable::restore_state(CheckpointReader& reader) {
+    for (std::unordered_map<uint64_t, uint64_t>& pages : pages_) {
+        pages.clear();
+        uint64_t num_pages = reader.read_varint();
+        for (uint64_t i = 0; i < num_pages; i++) {
+            uint64_t page = reader.read_varint();
+            pages[page] = reader.read_varint();
+        }
+    }
+}
+
+void Tlb::save_state(CheckpointWriter& writer) const {
+    entries_.save_state(writer);
+    replacement_.save_state(writer);
+    for (uint32_t set = 0; set < num_sets_; set++) {
+        for (uint32_t way = 0; way < config_.associativity; way++) {
+            if (entries_.valid(set, way)) {
+                size_t index = static_cast<size_t>(set) * config_.associativity + way;
+                writer.write_varint(physical_base_[index]);
+                writer.write_varint(ready_[index]);
+            }
+        }
+    }
+}
+
+void Tlb::restore_state(CheckpointReader& reader) {
+    entries_.restore_state(reader);
+    replacement_.restore_state(reader);
+    std::fill(resident_, resident_ + NUM_PAGE_SIZES, 0u);
+    for (uint32_t set = 0; set < num_sets_; set++) {
+        for (uint32_t way = 0; way < config_.associativity; way++) {
+            if (entries_.valid(set, way)) {
+                size_t index = static_cast<size_t>(set) * config_.associativity + way;
+                physical_base_[index] = reader.read_varint();
+                ready_[index] = reader.read_varint();
+                resident_[entries_.tag(set, way) & 3]++;
+            }
+        }
+    }
+}
+
+void PageWalker::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(walker_free_.size());
+    for (uint64_t cycle : walker_free_) {
+        writer.write_varint(cycle);
+    }
+    writer.write_varint(in_flight_.size());
+    for (const auto& walk : in_flight_) {
+        writer.write_varint(walk.first);
+        writer.write_varint(walk.second);
+    }
+    walk_cache_.save_state(writer);
+    walk_cache_replacement_.save_state(writer);
+    writer.write_varint(walk_cache_hits_);
+    writer.write_varint(walk_cache_misses_);
+}
+
+void PageWalker::restore_state(CheckpointReader& reader) {
+    check_config("Page walkers", reader.read_varint(), walker_free_.size());
+    for (uint64_t& cycle : walker_free_) {
+        cycle = reader.read_varint();
+    }
+    in_flight_.clear();
+    uint64_t num_walks = reader.read_varint();
+    for (uint64_t i = 0; i < num_walks; i++) {
+        uint64_t page = reader.read_varint();
+        in_flight_[page] = reader.read_varint();
+    }
+    walk_cache_.restore_state(reader);
+    walk_cache_replacement_.restore_state(reader);
+    walk_cache_hits_ = reader.read_varint();
+    walk_cache_misses_ = reader.read_varint();
+}
+
+void AddressTranslation::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(config_.num_cores);
+    page_table_.save_state(writer);
+    for (const Tlb& l1 : l1_tlbs_) {
+        l1.save_state(writer);
+    }
+    l2_tlb_.save_state(writer);
+    walker_.save_state(writer);
+
+    const uint64_t counters[] = {
+        stats_.translations, stats_.l1_hits, stats_.l1_misses, stats_.l2_hits, stats_.l2_misses,
+        stats_.walks, stats_.merged_walks, stats_.walker_stalls, stats_.page_table_reads,
+        stats_.walks_by_size[0], stats_.walks_by_size[1], stats_.walks_by_size[2],
+        stats_.total_latency, stats_.total_walk_latency};
+    for (uint64_t counter : counters) {
+        writer.write_varint(counter);
+    }
+    walk_latency_.save_state(writer);
+}
+
+void AddressTranslation::restore_state(CheckpointReader& reader) {
+    check_config("Address translation cores", reader.read_varint(), config_.num_cores);
+    page_table_.restore_state(reader);
+    for (Tlb& l1 : l1_tlbs_) {
+        l1.restore_state(reader);
+    }
+    l2_tlb_.restore_state(reader);
+    walker_.restore_state(reader);
+
+    uint64_t* counters[] = {
+        &stats_.translations, &stats_.l1_hits, &stats_.l1_misses, &stats_.l2_hits, &stats_.l2_misses,
+        &stats_.walks, &stats_.merged_walks, &stats_.walker_stalls, &stats_.page_table_reads,
+        &stats_.walks_by_size[0], &stats_.walks_by_size[1], &stats_.walks_by_size[2],
+        &stats_.total_latency, &stats_.total_walk_latency};
+    for (uint64_t* counter : counters) {
+        *counter = reader.read_varint();
+    }
+    walk_latency_.restore_state(reader);
+}
+
+// LatencyHistogram
+
+void LatencyHistogram::save_state(CheckpointWriter& writer) const {
+    writer.write_byte_vector(dump());
+}
+
+void LatencyHistogram::restore_state(CheckpointReader& reader) {
+    LatencyHistogram loaded = load(reader.read_byte_vector());
+    check_config("LatencyHistogram precision", loaded.precision_bits(), precision_bits_);
+    *this = loaded;
+}
+
+// MemoryLatencyProfile
+
+void MemoryLatencyProfile::save_state(CheckpointWriter& writer) const {
+    writer.write_byte_vector(dump());
+}
+
+void MemoryLatencyProfile::restore_state(CheckpointReader& reader) {
+    MemoryLatencyProfile loaded = load(reader.read_byte_vector());
+    check_config("MemoryLatencyProfile precision", loaded.precision_bits(), precision_bits());
+    *this = loaded;
+}
+
+// HeavyHitterTracker
+
+void HeavyHitterTracker::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(entries_.size());
+    writer.write_varint(total_);
+    for (const Entry& entry : entries_) {
+        writer.write_varint(entry.key);
+        writer.write_varint(entry.count);
+        writer.write_varint(entry.error);
+        writer.write_varint(entry.last_seen);
+    }
+}
+
+void HeavyHitterTracker::restore_state(CheckpointReader& reader) {
+    check_config("Hotspot tracker capacity", reader.read_varint(), entries_.size());
+    total_ = reader.read_varint();
+    for (Entry& entry : entries_) {
+        entry.key = reader.read_varint();
+        entry.count = reader.read_varint();
+        entry.error = reader.read_varint();
+        entry.last_seen = reader.read_varint();
+    }
+    rebuild_runs();
+}
+
+// MemoryState
+
+void MemoryState::save_state(CheckpointWriter& writer) const {
+    writer.begin_section(checkpoint::SectionTag::MEMORY_STATE);
+    writer.write_varint(total_reads_);
+    writer.write_varint(total_writes_);
+    writer.write_varint(total_atomics_);
+
+    writer.write_varint(hotspot_granularity_bits_);
+    hotspots_.save_state(writer);
+
+    writer.write_double(current_bandwidth_);
+    writer.write_double(peak_bandwidth_);
+    writer.write_varint(current_cycle_);
+    writer.write_varint(bandwidth_window_size_);
+    writer.write_varint(bandwidth_history_.size());
+    for (uint64_t bytes : bandwidth_history_) {
+        writer.write_varint(bytes);
+    }
+
+    writer.write_varint(total_latency_cycles_);
+    writer.write_varint(total_latency_samples_);
+    writer.write_varint(max_latency_);
+    writer.end_section();
+}
+
+void MemoryState::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::MEMORY_STATE);
+    total_reads_ = reader.read_varint();
+    total_writes_ = reader.read_varint();
+    total_atomics_ = reader.read_varint();
+
+    check_config("Hotspot granularity", reader.read_varint(), hotspot_granularity_bits_);
+    hotspots_.restore_state(reader);
+
+    current_bandwidth_ = reader.read_double();
+    peak_bandwidth_ = reader.read_double();
+    current_cycle_ = reader.read_varint();
+    bandwidth_window_size_ = reader.read_varint();
+    bandwidth_history_.resize(reader.read_varint());
+    for (uint64_t& bytes : bandwidth_history_) {
+        bytes = reader.read_varint();
+    }
+
+    total_latency_cycles_ = reader.read_varint();
+    total_latency_samples_ = reader.read_varint();
+    max_latency_ = static_cast<uint32_t>(reader.read_varint());
+    reader.end_section();
+}
+
+// TransactionQueue
+
+void TransactionQueue::save_state(CheckpointWriter& writer) const {
+    writer.begin_section(checkpoint::SectionTag::TRANSACTION_QUEUE);
+    writer.write_varint(max_size_);
+    writer.write_varint(static_cast<uint64_t>(order_));
+    writer.write_varint(entries_.size());
+    for (const auto& entry : entries_) {
+        write_transaction(writer, entry.second);
+    }
+    writer.end_section();
+}
+
+void TransactionQueue::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::TRANSACTION_QUEUE);
+    check_config("TransactionQueue capacity", reader.read_varint(), max_size_);
+    order_ = static_cast<Order>(reader.read_varint());
+    clear();
+    uint64_t num_transactions = reader.read_varint();
+    for (uint64_t i = 0; i < num_transactions; i++) {
+        // push() rebuilds the ID and address indices in arrival order
+        push(read_transaction(reader));
+    }
+    reader.end_section();
+}
+
+// MemorySubsystem
+
+void MemorySubsystem::save_state(CheckpointWriter& writer) const {
+    // Hierarchy geometry up front, so a mismatched checkpoint is rejected
+    // before any component is overwritten
+    writer.begin_section(checkpoint::SectionTag::MEMORY_SUBSYSTEM);
+    writer.write_varint(shared_memory->size());
+    writer.write_varint(l1_cache->size());
+    writer.write_varint(l1_cache->line_size());
+    writer.write_varint(l2_cache->size());
+    writer.write_varint(l2_cache->line_size());
+    writer.write_varint(global_memory->size());
+    writer.end_section();
+
+    registers->save_state(writer);
+    shared_memory->save_state(writer);
+    l1_cache->save_state(writer);
+    l2_cache->save_state(writer);
+    global_memory->save_state(writer);
+    state.save_state(writer);
+    pending_transactions.save_state(writer);
+}
+
+void MemorySubsystem::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::MEMORY_SUBSYSTEM);
+    check_config("SharedMemory size", reader.read_varint(), shared_memory->size());
+    check_config("CacheL1 size", reader.read_varint(), l1_cache->size());
+    check_config("CacheL1 line size", reader.read_varint(), l1_cache->line_size());
+    check_config("CacheL2 size", reader.read_varint(), l2_cache->size());
+    check_config("CacheL2 line size", reader.read_varint(), l2_cache->line_size());
+    check_config("GlobalMemory size", reader.read_varint(), global_memory->size());
+    reader.end_section();
+
+    registers->restore_state(reader);
+    shared_memory->restore_state(reader);
+    l1_cache->restore_state(reader);
+    l2_cache->restore_state(reader);
+    global_memory->restore_state(reader);
+    state.restore_state(reader);
+    pending_transactions.restore_state(reader);
+}
+
+void MemorySubsystem::save_checkpoint(const std::string& path, bool incremental) {
+    CheckpointWriter writer(incremental ? checkpoint::FLAG_INCREMENTAL : 0);
+    save_state(writer);
+    writer.save_to_file(path);
+    global_memory->mark_checkpoint();
+}
+
+void MemorySubsystem::restore_checkpoint(const std::string& path) {
+    CheckpointReader reader = CheckpointReader::load_from_file(path);
+    restore_state(reader);
+    if (!reader.at_end()) {
+        throw std::runtime_error("Trailing data in memory subsystem checkpoint: " + path);
+    }
+    global_memory->mark_checkpoint();
+}
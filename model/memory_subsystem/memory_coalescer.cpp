@@ -0,0 +1,151 @@
+#include "memory_coalescer.h"
+
+#include <stdexcept>
+
+const uint32_t WarpMemoryAccess::MAX_LANES;
+
+MemoryCoalescer::MemoryCoalescer(uint32_t line_size, uint32_t sector_size)
+    : line_size_(line_size),
+      sector_size_(sector_size) {
+    if (line_size_ == 0 || line_size_ > BurstPayload::MAX_BYTES || (line_size_ & (line_size_ - 1)) != 0) {
+        throw std::invalid_argument("Coalescer line size must be a power of two up to 128 bytes");
+    }
+    if (sector_size_ == 0 || sector_size_ > line_size_ || (sector_size_ & (sector_size_ - 1)) != 0) {
+        throw std::invalid_argument("Coalescer sector size must be a power of two dividing the line size");
+    }
+    requests_.reserve(2 * WarpMemoryAccess::MAX_LANES);
+}
+
+bool MemoryCoalescer::is_atomic(MemoryTransactionType type) const {
+    return type != MemoryTransactionType::READ && type != MemoryTransactionType::WRITE;
+}
+
+MemoryTransaction MemoryCoalescer::lane_atomic(const WarpMemoryAccess& access, uint32_t lane, uint32_t id) const {
+    MemoryTransaction txn(access.type, access.addresses[lane], access.access_size);
+    txn.set_id(id);
+    txn.set_data(access.data[lane]);
+    if (access.type == MemoryTransactionType::ATOMIC_CAS) {
+        // Little-endian compare value of the operand size
+        uint8_t compare[8];
+        for (uint32_t i = 0; i < sizeof(compare); i++) {
+            compare[i] = static_cast<uint8_t>(access.compare[lane] >> (8 * i));
+        }
+        txn.set_payload(BurstPayload(compare, access.access_size));
+    }
+    return txn;
+}
+
+void MemoryCoalescer::add_bytes(uint32_t lane, uint64_t addr, uint32_t size) {
+    uint64_t line_addr = addr & ~static_cast<uint64_t>(line_size_ - 1);
+    uint32_t offset = static_cast<uint32_t>(addr - line_addr);
+
+    // A warp touches at most 64 lines, so a linear search beats hashing
+    CoalescedRequest* request = nullptr;
+    for (CoalescedRequest& existing : requests_) {
+        if (existing.line_addr == line_addr) {
+            request = &existing;
+            break;
+        }
+    }
+    if (request == nullptr) {
+        requests_.push_back(CoalescedRequest{line_addr, 0, 0, {0, 0}});
+        request = &requests_.back();
+    }
+
+    request->lane_mask |= 1u << lane;
+    for (uint32_t byte = offset; byte < offset + size; byte++) {
+        request->byte_mask[byte / 64] |= 1ULL << (byte % 64);
+        request->sector_mask |= 1u << (byte / sector_size_);
+    }
+}
+
+const std::vector<CoalescedRequest>& MemoryCoalescer::coalesce(const WarpMemoryAccess& access) {
+    requests_.clear();
+    bool atomic = is_atomic(access.type);
+
+    for (uint32_t lane = 0; lane < WarpMemoryAccess::MAX_LANES; lane++) {
+        if (((access.active_mask >> lane) & 1) == 0) {
+            continue;
+        }
+        uint64_t addr = access.addresses[lane];
+        uint64_t line_end = (addr | (line_size_ - 1)) + 1;
+        uint32_t first = static_cast<uint32_t>(
+            addr + access.access_size <= line_end ? access.access_size : line_end - addr);
+
+        if (atomic) {
+            // Atomics are never merged, even when lanes share a line; they are
+            // naturally aligned so never straddle lines
+            requests_.push_back(CoalescedRequest{line_end - line_size_, 0, 0, {0, 0}});
+            CoalescedRequest& request = requests_.back();
+            uint32_t offset = static_cast<uint32_t>(addr - request.line_addr);
+            request.lane_mask = 1u << lane;
+            for (uint32_t byte = offset; byte < offset + first; byte++) {
+                request.byte_mask[byte / 64] |= 1ULL << (byte % 64);
+                request.sector_mask |= 1u << (byte / sector_size_);
+            }
+            continue;
+        }
+
+        add_bytes(lane, addr, first);
+        if (first < access.access_size) {
+            add_bytes(lane, line_end, access.access_size - first);
+        }
+    }
+
+    stats_.instructions++;
+    stats_.requests += requests_.size();
+    stats_.bytes_requested += static_cast<uint64_t>(__builtin_popcount(access.active_mask)) *
+                              access.access_size;
+    for (const CoalescedRequest& request : requests_) {
+        uint32_t sectors = static_cast<uint32_t>(__builtin_popcount(request.sector_mask));
+        stats_.sectors += sectors;
+        stats_.bytes_fetched += static_cast<uint64_t>(sectors) * sector_size_;
+    }
+    return requests_;
+}
+
+std::vector<MemoryTransaction> MemoryCoalescer::coalesce_to_transactions(const WarpMemoryAccess& access,
+                                                                         uint32_t first_id) {
+    const std::vector<CoalescedRequest>& requests = coalesce(access);
+    std::vector<MemoryTransaction> transactions;
+    transactions.reserve(requests.size());
+
+    for (const CoalescedRequest& request : requests) {
+        if (is_atomic(access.type)) {
+            transactions.push_back(lane_atomic(access, static_cast<uint32_t>(__builtin_ctz(request.lane_mask)),
+                                               first_id++));
+            continue;
+        }
+
+        MemoryTransaction txn(access.type, request.line_addr, line_size_);
+        txn.set_id(first_id++);
+
+        BurstPayload payload(line_size_);
+        uint8_t* line = payload.mutable_data();
+        for (uint32_t byte = 0; byte < line_size_; byte++) {
+            if (((request.byte_mask[byte / 64] >> (byte % 64)) & 1) == 0) {
+                payload.set_byte_enable(byte, 1, false);
+            }
+        }
+
+        // Scatter lane data into the line image (little-endian lanes)
+        if (access.type != MemoryTransactionType::READ) {
+            for (uint32_t lane = 0; lane < WarpMemoryAccess::MAX_LANES; lane++) {
+                if (((request.lane_mask >> lane) & 1) == 0) {
+                    continue;
+                }
+                for (uint32_t i = 0; i < access.access_size; i++) {
+                    uint64_t byte_addr = access.addresses[lane] + i;
+                    if (byte_addr >= request.line_addr && byte_addr < request.line_addr + line_size_) {
+                        line[byte_addr - request.line_addr] =
+                            static_cast<uint8_t>(access.data[lane] >> (8 * i));
+                    }
+                }
+            }
+        }
+
+        txn.set_payload(payload);
+        transactions.push_back(txn);
+    }
+    return transactions;
+}
@@ -0,0 +1,88 @@
+#ifndef MEMORY_COALESCER_H
+#define MEMORY_COALESCER_H
+
+#include <vector>
+#include <cstdint>
+#include "memory_transaction.h"
+
+// One warp-wide load, store or atomic as issued by the shader core
+struct WarpMemoryAccess {
+    static const uint32_t MAX_LANES = 32;
+
+    MemoryTransactionType type = MemoryTransactionType::READ;
+    uint32_t active_mask = 0;          // Bit i set if lane i participates
+    uint32_t access_size = 4;          // Bytes per lane (1, 2, 4 or 8)
+    uint64_t addresses[MAX_LANES] = {};
+    uint64_t data[MAX_LANES] = {};     // Store data / atomic operands per lane
+    uint64_t compare[MAX_LANES] = {};  // ATOMIC_CAS compare values per lane
+};
+
+// One line request produced by the coalescer
+struct CoalescedRequest {
+    uint64_t line_addr;
+    uint32_t sector_mask;              // Sectors of the line that must be transferred
+    uint32_t lane_mask;                // Lanes served by this request
+    uint64_t byte_mask[2];             // Bytes of the line touched by those lanes
+};
+
+// Coalescing statistics
+struct CoalescerStats {
+    uint64_t instructions = 0;
+    uint64_t requests = 0;
+    uint64_t sectors = 0;
+    uint64_t bytes_requested = 0;      // Active lanes x access size
+    uint64_t bytes_fetched = 0;        // Sectors x sector size
+
+    double requests_per_instruction() const {
+        return instructions > 0 ? static_cast<double>(requests) / instructions : 0.0;
+    }
+    // Fraction of transferred bytes that lanes actually used (1.0 = fully coalesced)
+    double efficiency() const {
+        return bytes_fetched > 0 ? static_cast<double>(bytes_requested) / bytes_fetched : 0.0;
+    }
+};
+
+// Warp memory coalescing unit in front of CacheL1
+//
+// Merges the per-lane addresses of a warp access into the minimal set of
+// cache line requests, each carrying a sector mask, in order of the first
+// lane touching each line. Lanes straddling a line boundary contribute to
+// both lines. Loads and stores coalesce freely; atomics are issued per lane
+// because each needs its own read-modify-write at the L2.
+class MemoryCoalescer {
+public:
+    // Constructor (line size up to 128 bytes, power-of-two sector size dividing it)
+    MemoryCoalescer(uint32_t line_size = 128, uint32_t sector_size = 32);
+
+    // Coalesce one warp access; the result is valid until the next call
+    const std::vector<CoalescedRequest>& coalesce(const WarpMemoryAccess& access);
+
+    // Coalesce and build the transactions sent to CacheL1. Each covers one
+    // line with a burst payload whose byte enables mark the touched bytes;
+    // stores carry the lane data. Atomics are one transaction per lane in
+    // AtomicUnit's operand form instead: the lane's address and access
+    // size, the operand in data() and, for ATOMIC_CAS, the compare value
+    // as the payload. Transaction IDs count up from first_id.
+    std::vector<MemoryTransaction> coalesce_to_transactions(const WarpMemoryAccess& access,
+                                                            uint32_t first_id);
+
+    // Configuration
+    uint32_t line_size() const { return line_size_; }
+    uint32_t sector_size() const { return sector_size_; }
+
+    // Statistics
+    const CoalescerStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = CoalescerStats(); }
+
+private:
+    uint32_t line_size_;
+    uint32_t sector_size_;
+    CoalescerStats stats_;
+    std::vector<CoalescedRequest> requests_;
+
+    void add_bytes(uint32_t lane, uint64_t addr, uint32_t size);
+    bool is_atomic(MemoryTransactionType type) const;
+    MemoryTransaction lane_atomic(const WarpMemoryAccess& access, uint32_t lane, uint32_t id) const;
+};
+
+#endif // MEMORY_COALESCER_H
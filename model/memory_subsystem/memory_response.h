@@ -4,6 +4,7 @@
 #include <systemc.h>
 #include <cstdint>
 #include <iostream>
+#include "burst_payload.h"
 
 // Memory response status
 enum class MemoryResponseStatus {
@@ -32,6 +33,12 @@ public:
     void set_data(uint64_t data) { data_ = data; }
     uint64_t data() const { return data_; }
     
+    // Burst payload (up to one cache line, with byte enables); copies share the buffer
+    void set_payload(const BurstPayload& payload) { payload_ = payload; }
+    const BurstPayload& payload() const { return payload_; }
+    BurstPayload& payload() { return payload_; }
+    bool has_payload() const { return !payload_.empty(); }
+    
     // Latency information
     void set_latency(uint32_t cycles) { latency_cycles_ = cycles; }
     uint32_t latency() const { return latency_cycles_; }
@@ -49,6 +56,7 @@ public:
         return id_ == other.id_ && 
                status_ == other.status_ && 
                data_ == other.data_ && 
+               payload_ == other.payload_ && 
                latency_cycles_ == other.latency_cycles_ && 
                valid_ == other.valid_;
     }
@@ -61,6 +69,7 @@ private:
     uint32_t id_;
     MemoryResponseStatus status_;
     uint64_t data_;
+    BurstPayload payload_;
     uint32_t latency_cycles_;
     bool valid_;
 };
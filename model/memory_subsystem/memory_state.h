@@ -1,9 +1,15 @@
 #ifndef MEMORY_STATE_H
 #define MEMORY_STATE_H
 
+#include <algorithm>
 #include <cstdint>
-#include <unordered_map>
+#include <stdexcept>
 #include <vector>
+#include "heavy_hitter_tracker.h"
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
 
 // Memory state class to track memory subsystem state
 class MemoryState {
@@ -11,24 +17,55 @@ public:
     // Constructor
     MemoryState();
     
-    // Memory access tracking
-    void track_read(uint64_t address, uint32_t size);
-    void track_write(uint64_t address, uint32_t size);
-    void track_atomic(uint64_t address, uint32_t size);
+    // Memory access tracking: counts the access and records every hotspot
+    // granule it touches
+    void track_read(uint64_t address, uint32_t size) {
+        total_reads_++;
+        record_hotspots(address, size);
+    }
+    void track_write(uint64_t address, uint32_t size) {
+        total_writes_++;
+        record_hotspots(address, size);
+    }
+    void track_atomic(uint64_t address, uint32_t size) {
+        total_atomics_++;
+        record_hotspots(address, size);
+    }
     
     // Memory statistics
     uint64_t total_reads() const { return total_reads_; }
     uint64_t total_writes() const { return total_writes_; }
     uint64_t total_atomics() const { return total_atomics_; }
+    uint64_t current_cycle() const { return current_cycle_; }
     
-    // Memory hotspot analysis
+    // Memory hotspot analysis. Accesses are counted per granule (a cache
+    // line by default) in a bounded heavy-hitter tracker, so memory stays
+    // constant however many addresses a run touches; counts are upper
+    // bounds that exceed the true count by at most count_error.
     struct HotspotInfo {
         uint64_t address;
         uint64_t access_count;
         uint64_t last_access_time;
+        uint64_t count_error;
     };
     
-    std::vector<HotspotInfo> get_hotspots(uint32_t top_n = 10) const;
+    std::vector<HotspotInfo> get_hotspots(uint32_t top_n = 10) const {
+        std::vector<HotspotInfo> hotspots;
+        for (const HeavyHitterTracker::Entry& entry : hotspots_.top(top_n)) {
+            hotspots.push_back({entry.key << hotspot_granularity_bits_, entry.count, entry.last_seen, entry.error});
+        }
+        return hotspots;
+    }
+    
+    // Hotspot tracker size and granularity (power of two bytes, e.g. 64 for
+    // lines or 4096 for pages); clears the tracked hotspots
+    void configure_hotspots(uint32_t capacity, uint32_t granularity_bytes) {
+        if (granularity_bytes == 0 || (granularity_bytes & (granularity_bytes - 1)) != 0) {
+            throw std::invalid_argument("Hotspot granularity must be a power of two");
+        }
+        hotspots_ = HeavyHitterTracker(capacity);
+        hotspot_granularity_bits_ = static_cast<uint32_t>(__builtin_ctz(granularity_bytes));
+    }
     
     // Memory bandwidth tracking
     void update_bandwidth_usage(uint64_t bytes_transferred);
@@ -43,15 +80,29 @@ public:
     // Reset statistics
     void reset_stats();
     
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
 private:
     // Access counters
     uint64_t total_reads_;
     uint64_t total_writes_;
     uint64_t total_atomics_;
     
-    // Access tracking
-    std::unordered_map<uint64_t, uint64_t> address_access_count_;
-    std::unordered_map<uint64_t, uint64_t> address_last_access_;
+    // Hotspot tracking per granule of the tracked accesses
+    HeavyHitterTracker hotspots_;
+    uint32_t hotspot_granularity_bits_ = DEFAULT_HOTSPOT_GRANULARITY_BITS;
+    
+    static const uint32_t DEFAULT_HOTSPOT_GRANULARITY_BITS = 6;
+    
+    void record_hotspots(uint64_t address, uint32_t size) {
+        uint64_t first = address >> hotspot_granularity_bits_;
+        uint64_t last = (address + std::max<uint32_t>(size, 1) - 1) >> hotspot_granularity_bits_;
+        for (uint64_t granule = first; granule <= last; granule++) {
+            hotspots_.record(granule, current_cycle_);
+        }
+    }
     
     // Bandwidth tracking
     double current_bandwidth_;
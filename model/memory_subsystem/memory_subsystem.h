@@ -2,6 +2,7 @@
 #define MEMORY_SUBSYSTEM_H
 
 #include <systemc.h>
+#include <string>
 #include "memory_transaction.h"
 #include "memory_response.h"
 #include "register_file.h"
@@ -51,6 +52,14 @@ public:
     void simulate_hbm3e_bandwidth();
     void simulate_hbm3e_latency();
     
+    // Checkpointing of the full hierarchy. save_checkpoint() and
+    // restore_checkpoint() also start the next incremental epoch;
+    // save_state() and restore_state() alone leave it untouched.
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    void save_checkpoint(const std::string& path, bool incremental = false);
+    void restore_checkpoint(const std::string& path);
+    
 private:
     // Memory state
     MemoryState state;
@@ -0,0 +1,212 @@
+#include "memory_tlm.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+void TlmBackingStore::invalidate_dmi_regions() {
+    for (TlmMemoryTarget* target : tlm_targets_) {
+        target->invalidate_dmi();
+    }
+}
+
+// TlmMemoryTarget
+
+TlmMemoryTarget::TlmMemoryTarget(sc_module_name name, TlmBackingStore& backing, const TlmTimingConfig& timing)
+    : sc_module(name),
+      socket("socket"),
+      backing_(backing),
+      timing_(timing) {
+    socket.register_b_transport(this, &TlmMemoryTarget::b_transport);
+    socket.register_get_direct_mem_ptr(this, &TlmMemoryTarget::get_direct_mem_ptr);
+    socket.register_transport_dbg(this, &TlmMemoryTarget::transport_dbg);
+    backing_.tlm_targets_.push_back(this);
+}
+
+TlmMemoryTarget::~TlmMemoryTarget() {
+    std::vector<TlmMemoryTarget*>& targets = backing_.tlm_targets_;
+    targets.erase(std::remove(targets.begin(), targets.end(), this), targets.end());
+}
+
+void TlmMemoryTarget::invalidate_dmi() {
+    stats_.dmi_invalidations++;
+    socket->invalidate_direct_mem_ptr(0, ~static_cast<sc_dt::uint64>(0));
+}
+
+void TlmMemoryTarget::b_transport(tlm::tlm_generic_payload& trans, sc_time& delay) {
+    stats_.transports++;
+    if (!access(trans)) {
+        return;
+    }
+    if (trans.is_read()) {
+        delay += timing_.read_latency;
+    } else if (trans.is_write()) {
+        delay += timing_.write_latency;
+    }
+    trans.set_dmi_allowed(timing_.dmi_enabled);
+}
+
+bool TlmMemoryTarget::get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi) {
+    if (!timing_.dmi_enabled || trans.get_address() >= backing_.tlm_size()) {
+        return false;
+    }
+    uint64_t start = 0;
+    uint64_t end = 0;
+    uint8_t* region = backing_.tlm_dmi_region(trans.get_address(), start, end);
+    if (region == nullptr) {
+        return false;
+    }
+    dmi.set_dmi_ptr(region);
+    dmi.set_start_address(start);
+    dmi.set_end_address(end);
+    dmi.set_granted_access(tlm::tlm_dmi::DMI_ACCESS_READ_WRITE);
+    dmi.set_read_latency(timing_.read_latency);
+    dmi.set_write_latency(timing_.write_latency);
+    stats_.dmi_grants++;
+    return true;
+}
+
+unsigned int TlmMemoryTarget::transport_dbg(tlm::tlm_generic_payload& trans) {
+    stats_.debug_transports++;
+    return access(trans) ? trans.get_data_length() : 0;
+}
+
+bool TlmMemoryTarget::access(tlm::tlm_generic_payload& trans) {
+    uint64_t addr = trans.get_address();
+    uint32_t length = trans.get_data_length();
+    uint8_t* data = trans.get_data_ptr();
+    const uint8_t* enables = trans.get_byte_enable_ptr();
+    uint32_t enable_length = trans.get_byte_enable_length();
+
+    if (addr >= backing_.tlm_size() || length > backing_.tlm_size() - addr) {
+        stats_.address_errors++;
+        trans.set_response_status(tlm::TLM_ADDRESS_ERROR_RESPONSE);
+        return false;
+    }
+    if (trans.get_streaming_width() < length) {
+        trans.set_response_status(tlm::TLM_BURST_ERROR_RESPONSE);
+        return false;
+    }
+    if (enables != nullptr && enable_length == 0) {
+        trans.set_response_status(tlm::TLM_BYTE_ENABLE_ERROR_RESPONSE);
+        return false;
+    }
+
+    if (trans.is_read()) {
+        if (enables == nullptr) {
+            backing_.tlm_read(addr, data, length);
+        } else {
+            scratch_.resize(length);
+            backing_.tlm_read(addr, scratch_.data(), length);
+            for (uint32_t i = 0; i < length; i++) {
+                if (enables[i % enable_length] == TLM_BYTE_ENABLED) {
+                    data[i] = scratch_[i];
+                }
+            }
+        }
+        stats_.bytes_read += length;
+    } else if (trans.is_write()) {
+        if (enables == nullptr) {
+            backing_.tlm_write(addr, data, length);
+        } else {
+            // Merge enabled bytes into the current contents
+            scratch_.resize(length);
+            backing_.tlm_read(addr, scratch_.data(), length);
+            for (uint32_t i = 0; i < length; i++) {
+                if (enables[i % enable_length] == TLM_BYTE_ENABLED) {
+                    scratch_[i] = data[i];
+                }
+            }
+            backing_.tlm_write(addr, scratch_.data(), length);
+        }
+        stats_.bytes_written += length;
+    }
+    trans.set_response_status(tlm::TLM_OK_RESPONSE);
+    return true;
+}
+
+// TlmMemoryInitiator
+
+TlmMemoryInitiator::TlmMemoryInitiator(sc_module_name name, bool use_dmi)
+    : sc_module(name),
+      socket("socket"),
+      use_dmi_(use_dmi) {
+    socket.register_invalidate_direct_mem_ptr(this, &TlmMemoryInitiator::invalidate_direct_mem_ptr);
+}
+
+void TlmMemoryInitiator::read(uint64_t addr, uint8_t* data, uint32_t length, sc_time& delay) {
+    stats_.reads++;
+    const tlm::tlm_dmi* region = find_region(addr, length, false);
+    if (region != nullptr) {
+        std::memcpy(data, region->get_dmi_ptr() + (addr - region->get_start_address()), length);
+        delay += region->get_read_latency();
+        stats_.dmi_accesses++;
+        return;
+    }
+    transport(tlm::TLM_READ_COMMAND, addr, data, length, delay);
+}
+
+void TlmMemoryInitiator::write(uint64_t addr, const uint8_t* data, uint32_t length, sc_time& delay) {
+    stats_.writes++;
+    const tlm::tlm_dmi* region = find_region(addr, length, true);
+    if (region != nullptr) {
+        std::memcpy(region->get_dmi_ptr() + (addr - region->get_start_address()), data, length);
+        delay += region->get_write_latency();
+        stats_.dmi_accesses++;
+        return;
+    }
+    transport(tlm::TLM_WRITE_COMMAND, addr, const_cast<uint8_t*>(data), length, delay);
+}
+
+const tlm::tlm_dmi* TlmMemoryInitiator::find_region(uint64_t addr, uint32_t length, bool write) const {
+    auto it = regions_.upper_bound(addr);
+    if (it == regions_.begin()) {
+        return nullptr;
+    }
+    --it;
+    const tlm::tlm_dmi& region = it->second;
+    if (length == 0 || addr + length - 1 > region.get_end_address()) {
+        return nullptr;
+    }
+    bool allowed = write ? region.is_write_allowed() : region.is_read_allowed();
+    return allowed ? &region : nullptr;
+}
+
+void TlmMemoryInitiator::transport(tlm::tlm_command command, uint64_t addr, uint8_t* data, uint32_t length,
+                                   sc_time& delay) {
+    trans_.set_command(command);
+    trans_.set_address(addr);
+    trans_.set_data_ptr(data);
+    trans_.set_data_length(length);
+    trans_.set_streaming_width(length);
+    trans_.set_byte_enable_ptr(nullptr);
+    trans_.set_byte_enable_length(0);
+    trans_.set_dmi_allowed(false);
+    trans_.set_response_status(tlm::TLM_INCOMPLETE_RESPONSE);
+
+    socket->b_transport(trans_, delay);
+    stats_.transports++;
+    if (trans_.is_response_error()) {
+        throw std::runtime_error(std::string("TLM memory access failed: ") + trans_.get_response_string());
+    }
+
+    if (use_dmi_ && trans_.is_dmi_allowed()) {
+        tlm::tlm_dmi dmi;
+        if (socket->get_direct_mem_ptr(trans_, dmi)) {
+            regions_[dmi.get_start_address()] = dmi;
+            stats_.dmi_regions++;
+        }
+    }
+}
+
+void TlmMemoryInitiator::invalidate_direct_mem_ptr(sc_dt::uint64 start, sc_dt::uint64 end) {
+    stats_.dmi_invalidations++;
+    for (auto it = regions_.begin(); it != regions_.end();) {
+        if (it->second.get_start_address() <= end && it->second.get_end_address() >= start) {
+            it = regions_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#ifndef MEMORY_TLM_H
+#define MEMORY_TLM_H
+
+#include <systemc.h>
+#include <tlm.h>
+#include <tlm_utils/simple_target_socket.h>
+#include <tlm_utils/simple_initiator_socket.h>
+#include <vector>
+#include <map>
+#include <cstdint>
+
+class TlmMemoryTarget;
+
+// Memory that can be exposed through a TlmMemoryTarget: functional
+// access, plus host storage for the Direct Memory Interface. Stores call
+// invalidate_dmi_regions() whenever host storage is released or moved
+// (restore, clear), so initiators drop their DMI pointers.
+class TlmBackingStore {
+public:
+    virtual ~TlmBackingStore() {}
+
+    virtual uint64_t tlm_size() const = 0;
+    virtual void tlm_read(uint64_t addr, uint8_t* data, uint32_t length) const = 0;
+    virtual void tlm_write(uint64_t addr, const uint8_t* data, uint32_t length) = 0;
+
+    // Host storage of the contiguous region holding addr, as [start, end];
+    // nullptr if the store cannot be accessed directly
+    virtual uint8_t* tlm_dmi_region(uint64_t addr, uint64_t& start, uint64_t& end) = 0;
+
+protected:
+    void invalidate_dmi_regions();
+
+private:
+    friend class TlmMemoryTarget;
+    std::vector<TlmMemoryTarget*> tlm_targets_;
+};
+
+// Loosely-timed latency of one target
+struct TlmTimingConfig {
+    sc_time read_latency = sc_time(100, SC_NS);
+    sc_time write_latency = sc_time(50, SC_NS);
+    bool dmi_enabled = true;
+};
+
+// Target statistics
+struct TlmTargetStats {
+    uint64_t transports = 0;
+    uint64_t debug_transports = 0;
+    uint64_t dmi_grants = 0;
+    uint64_t dmi_invalidations = 0;
+    uint64_t bytes_read = 0;
+    uint64_t bytes_written = 0;
+    uint64_t address_errors = 0;
+};
+
+// TLM-2.0 blocking-transport target for a backing store
+//
+// b_transport performs the access functionally and annotates the
+// configured latency onto the caller's delay instead of waiting, which is
+// the loosely-timed coding style: no delta cycles, no signal copies.
+// Byte enables (a non-null pointer needs a non-zero length) and streaming
+// widths equal to the data length are supported. DMI grants one region of
+// host storage per request (a page of GlobalMemory, all of SharedMemory).
+class TlmMemoryTarget : public sc_module {
+public:
+    tlm_utils::simple_target_socket<TlmMemoryTarget> socket;
+
+    // Constructor
+    TlmMemoryTarget(sc_module_name name, TlmBackingStore& backing,
+                    const TlmTimingConfig& timing = TlmTimingConfig());
+    virtual ~TlmMemoryTarget();
+
+    // Revoke every DMI pointer handed out
+    void invalidate_dmi();
+
+    // Configuration and statistics
+    const TlmTimingConfig& timing() const { return timing_; }
+    const TlmTargetStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = TlmTargetStats(); }
+
+private:
+    TlmBackingStore& backing_;
+    TlmTimingConfig timing_;
+    TlmTargetStats stats_;
+    std::vector<uint8_t> scratch_;   // Line image for byte-enabled accesses
+
+    // Socket callbacks
+    void b_transport(tlm::tlm_generic_payload& trans, sc_time& delay);
+    bool get_direct_mem_ptr(tlm::tlm_generic_payload& trans, tlm::tlm_dmi& dmi);
+    unsigned int transport_dbg(tlm::tlm_generic_payload& trans);
+
+    // Functional access shared by b_transport and transport_dbg; false on an address error
+    bool access(tlm::tlm_generic_payload& trans);
+};
+
+// Initiator statistics
+struct TlmInitiatorStats {
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    uint64_t dmi_accesses = 0;      // Accesses served from a DMI pointer
+    uint64_t transports = 0;        // Accesses sent through b_transport
+    uint64_t dmi_regions = 0;       // DMI regions granted
+    uint64_t dmi_invalidations = 0;
+};
+
+// TLM-2.0 initiator for functional and software bring-up runs
+//
+// read() and write() use a cached DMI pointer when one covers the access
+// (a memcpy plus the DMI latency) and fall back to b_transport otherwise,
+// requesting DMI whenever the target allows it. Latency accumulates in the
+// caller's delay for it to synchronise on.
+class TlmMemoryInitiator : public sc_module {
+public:
+    tlm_utils::simple_initiator_socket<TlmMemoryInitiator> socket;
+
+    // Constructor
+    explicit TlmMemoryInitiator(sc_module_name name, bool use_dmi = true);
+
+    // Accesses (throw std::runtime_error if the target returns an error)
+    void read(uint64_t addr, uint8_t* data, uint32_t length, sc_time& delay);
+    void write(uint64_t addr, const uint8_t* data, uint32_t length, sc_time& delay);
+
+    // Statistics
+    const TlmInitiatorStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = TlmInitiatorStats(); }
+    size_t dmi_region_count() const { return regions_.size(); }
+
+private:
+    bool use_dmi_;
+    TlmInitiatorStats stats_;
+    std::map<uint64_t, tlm::tlm_dmi> regions_;   // DMI regions by start address
+    tlm::tlm_generic_payload trans_;
+
+    // DMI region covering [addr, addr + length), or nullptr
+    const tlm::tlm_dmi* find_region(uint64_t addr, uint32_t length, bool write) const;
+    void transport(tlm::tlm_command command, uint64_t addr, uint8_t* data, uint32_t length, sc_time& delay);
+
+    // Socket callback
+    void invalidate_direct_mem_ptr(sc_dt::uint64 start, sc_dt::uint64 end);
+};
+
+#endif // MEMORY_TLM_H
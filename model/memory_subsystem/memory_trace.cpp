@@ -0,0 +1,254 @@
+#include "memory_trace.h"
+
+#include <stdexcept>
+
+namespace {
+
+uint64_t zigzag_encode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigzag_decode(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+void write_fixed32(std::vector<uint8_t>& buffer, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        buffer.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+uint32_t read_fixed32(const std::vector<uint8_t>& buffer, size_t pos) {
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++) {
+        value |= static_cast<uint32_t>(buffer[pos + i]) << (8 * i);
+    }
+    return value;
+}
+
+}  // namespace
+
+// MemoryTraceWriter implementation
+
+MemoryTraceWriter::MemoryTraceWriter(const std::string& path)
+    : path_(path),
+      out_(path, std::ios::binary | std::ios::trunc),
+      closed_(false),
+      records_(0),
+      bytes_(0),
+      cycle_delta_(0),
+      address_delta_(0),
+      run_length_(0) {
+    if (!out_) {
+        throw std::runtime_error("Cannot open memory trace for writing: " + path);
+    }
+    write_fixed32(buffer_, memory_trace::MAGIC);
+    write_fixed32(buffer_, memory_trace::VERSION);
+}
+
+MemoryTraceWriter::~MemoryTraceWriter() {
+    try {
+        close();
+    } catch (...) {
+        // Destructors must not throw; call close() to see write errors
+    }
+}
+
+void MemoryTraceWriter::append(const TraceRecord& record) {
+    if (closed_) {
+        throw std::logic_error("Memory trace is closed: " + path_);
+    }
+
+    // Deltas and flags are relative to the previous record; the reader
+    // starts from the same all-zero record
+    int64_t cycle_delta = static_cast<int64_t>(record.cycle - previous_.cycle);
+    int64_t address_delta = static_cast<int64_t>(record.address - previous_.address);
+    bool new_size = record.size != previous_.size;
+    bool new_source = record.source != previous_.source;
+    bool repeats = records_ > 0 && record.type == previous_.type && !new_size && !new_source &&
+                   cycle_delta == cycle_delta_ && address_delta == address_delta_;
+    records_++;
+    previous_ = record;
+    if (repeats) {
+        run_length_++;
+        return;
+    }
+    flush_run();
+
+    uint8_t token = static_cast<uint8_t>(record.type) & memory_trace::TYPE_MASK;
+    token |= new_size ? memory_trace::FLAG_SIZE : 0;
+    token |= new_source ? memory_trace::FLAG_SOURCE : 0;
+    buffer_.push_back(token);
+    if (new_size) {
+        write_varint(record.size);
+    }
+    if (new_source) {
+        write_varint(record.source);
+    }
+    write_varint(zigzag_encode(cycle_delta));
+    write_varint(zigzag_encode(address_delta));
+    cycle_delta_ = cycle_delta;
+    address_delta_ = address_delta;
+    if (buffer_.size() >= FLUSH_BYTES) {
+        flush_buffer();
+    }
+}
+
+void MemoryTraceWriter::close() {
+    if (closed_) {
+        return;
+    }
+    closed_ = true;
+    flush_run();
+    buffer_.push_back(memory_trace::TOKEN_END);
+    write_varint(records_);
+    flush_buffer();
+    out_.close();
+    if (!out_) {
+        throw std::runtime_error("Failed to write memory trace: " + path_);
+    }
+}
+
+void MemoryTraceWriter::write_varint(uint64_t value) {
+    while (value >= 0x80) {
+        buffer_.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    buffer_.push_back(static_cast<uint8_t>(value));
+}
+
+void MemoryTraceWriter::flush_run() {
+    if (run_length_ > 0) {
+        buffer_.push_back(memory_trace::TOKEN_RUN);
+        write_varint(run_length_);
+        run_length_ = 0;
+    }
+}
+
+void MemoryTraceWriter::flush_buffer() {
+    out_.write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size());
+    if (!out_) {
+        throw std::runtime_error("Failed to write memory trace: " + path_);
+    }
+    bytes_ += buffer_.size();
+    buffer_.clear();
+}
+
+// MemoryTraceReader implementation
+
+MemoryTraceReader::MemoryTraceReader(const std::string& path)
+    : data_(nullptr),
+      size_(0),
+      start_(8),
+      pos_(8),
+      position_(0),
+      ended_(false),
+      cycle_delta_(0),
+      address_delta_(0),
+      run_remaining_(0) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Cannot open memory trace: " + path);
+    }
+    in.seekg(0, std::ios::end);
+    std::vector<uint8_t> buffer(static_cast<size_t>(in.tellg()));
+    in.seekg(0, std::ios::beg);
+    in.read(reinterpret_cast<char*>(buffer.data()), buffer.size());
+    if (!in) {
+        throw std::runtime_error("Failed to read memory trace: " + path);
+    }
+    if (buffer.size() < start_ || read_fixed32(buffer, 0) != memory_trace::MAGIC) {
+        throw std::runtime_error("Not a memory trace: " + path);
+    }
+    if (read_fixed32(buffer, 4) != memory_trace::VERSION) {
+        throw std::runtime_error("Unsupported memory trace version: " + path);
+    }
+    buffer_ = std::make_shared<const std::vector<uint8_t>>(std::move(buffer));
+    data_ = buffer_->data();
+    size_ = buffer_->size();
+}
+
+bool MemoryTraceReader::next(TraceRecord& record) {
+    while (run_remaining_ == 0) {
+        if (ended_) {
+            return false;
+        }
+        uint8_t token = read_u8();
+        if (token == memory_trace::TOKEN_END) {
+            if (read_varint() != position_) {
+                throw std::runtime_error("Memory trace record count mismatch");
+            }
+            ended_ = true;
+            return false;
+        }
+        if (token == memory_trace::TOKEN_RUN) {
+            run_remaining_ = read_varint();
+            continue;
+        }
+
+        previous_.type = static_cast<MemoryTransactionType>(token & memory_trace::TYPE_MASK);
+        if (token & memory_trace::FLAG_SIZE) {
+            previous_.size = static_cast<uint32_t>(read_varint());
+        }
+        if (token & memory_trace::FLAG_SOURCE) {
+            previous_.source = static_cast<uint32_t>(read_varint());
+        }
+        cycle_delta_ = zigzag_decode(read_varint());
+        address_delta_ = zigzag_decode(read_varint());
+        run_remaining_ = 1;
+    }
+
+    run_remaining_--;
+    previous_.cycle += static_cast<uint64_t>(cycle_delta_);
+    previous_.address += static_cast<uint64_t>(address_delta_);
+    position_++;
+    record.cycle = previous_.cycle;
+    record.type = previous_.type;
+    record.address = previous_.address;
+    record.size = previous_.size;
+    record.source = previous_.source;
+    return true;
+}
+
+void MemoryTraceReader::rewind() {
+    pos_ = start_;
+    position_ = 0;
+    ended_ = false;
+    previous_ = TraceRecord();
+    cycle_delta_ = 0;
+    address_delta_ = 0;
+    run_remaining_ = 0;
+}
+
+uint8_t MemoryTraceReader::read_u8() {
+    if (pos_ >= size_) {
+        throw std::runtime_error("Memory trace is truncated");
+    }
+    return data_[pos_++];
+}
+
+uint64_t MemoryTraceReader::read_varint() {
+    // Fast path: one- and two-byte varints (most deltas) without bounds
+    // checks on each byte
+    if (pos_ + 2 <= size_) {
+        uint8_t first = data_[pos_];
+        if ((first & 0x80) == 0) {
+            pos_++;
+            return first;
+        }
+        uint8_t second = data_[pos_ + 1];
+        if ((second & 0x80) == 0) {
+            pos_ += 2;
+            return static_cast<uint64_t>(first & 0x7F) | (static_cast<uint64_t>(second) << 7);
+        }
+    }
+    uint64_t value = 0;
+    for (uint32_t shift = 0; shift < 64; shift += 7) {
+        uint8_t byte = read_u8();
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return value;
+        }
+    }
+    throw std::runtime_error("Malformed varint in memory trace");
+}
@@ -0,0 +1,143 @@
+#ifndef MEMORY_TRACE_H
+#define MEMORY_TRACE_H
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+#include "memory_transaction.h"
+
+// Binary memory trace format
+//
+// A trace is a header (magic, version) followed by one token per record or
+// run of records and an end token carrying the record count. A record
+// token's low four bits are the transaction type; flag bits say whether the
+// size and source differ from the previous record. The cycle and address
+// follow as zigzag LEB128 deltas from the previous record, so sequential
+// and strided streams cost two or three bytes per access. A run token
+// repeats the previous record's deltas N times, which collapses a constant
+// stride to a handful of bytes however long it runs.
+namespace memory_trace {
+
+static const uint32_t MAGIC = 0x52544D47;  // "GMTR"
+static const uint32_t VERSION = 1;
+
+// Token byte layout
+static const uint8_t TYPE_MASK = 0x0F;
+static const uint8_t FLAG_SIZE = 0x10;     // Varint size follows
+static const uint8_t FLAG_SOURCE = 0x20;   // Varint source follows
+static const uint8_t TOKEN_RUN = 0x80;     // Varint repeat count follows
+static const uint8_t TOKEN_END = 0xFF;     // Varint record count follows
+
+}  // namespace memory_trace
+
+// One traced access
+struct TraceRecord {
+    uint64_t cycle = 0;
+    MemoryTransactionType type = MemoryTransactionType::READ;
+    uint64_t address = 0;
+    uint32_t size = 0;
+    uint32_t source = 0;   // Issuing core
+
+    static TraceRecord from(uint64_t cycle, const MemoryTransaction& transaction) {
+        TraceRecord record;
+        record.cycle = cycle;
+        record.type = transaction.type();
+        record.address = transaction.address();
+        record.size = transaction.size();
+        record.source = transaction.source();
+        return record;
+    }
+
+    bool operator==(const TraceRecord& other) const {
+        return cycle == other.cycle && type == other.type && address == other.address &&
+               size == other.size && source == other.source;
+    }
+    bool operator!=(const TraceRecord& other) const { return !(*this == other); }
+};
+
+// Streams trace records to a file
+class MemoryTraceWriter {
+public:
+    // Constructor (throws std::runtime_error if the file cannot be created)
+    explicit MemoryTraceWriter(const std::string& path);
+    ~MemoryTraceWriter();
+
+    MemoryTraceWriter(const MemoryTraceWriter&) = delete;
+    MemoryTraceWriter& operator=(const MemoryTraceWriter&) = delete;
+
+    // Append one access
+    void append(const TraceRecord& record);
+    void append(uint64_t cycle, const MemoryTransaction& transaction) {
+        append(TraceRecord::from(cycle, transaction));
+    }
+
+    // Write the end token and flush; further appends throw std::logic_error
+    void close();
+
+    // Statistics
+    uint64_t records() const { return records_; }
+    uint64_t bytes() const { return bytes_; }
+    double bytes_per_record() const { return records_ > 0 ? static_cast<double>(bytes_) / records_ : 0.0; }
+
+private:
+    static const size_t FLUSH_BYTES = 64 * 1024;
+
+    std::string path_;
+    std::ofstream out_;
+    std::vector<uint8_t> buffer_;
+    bool closed_;
+    uint64_t records_;
+    uint64_t bytes_;
+
+    // Previous record and the deltas that produced it, for run detection
+    TraceRecord previous_;
+    int64_t cycle_delta_;
+    int64_t address_delta_;
+    uint64_t run_length_;
+
+    void write_varint(uint64_t value);
+    void flush_run();
+    void flush_buffer();
+};
+
+// Reads a trace written by MemoryTraceWriter
+//
+// The encoded trace is loaded once and is immutable. Copies share it and
+// only carry their own decode cursor, so parallel consumers each copy one
+// reader instead of reloading or duplicating the file.
+class MemoryTraceReader {
+public:
+    // Constructor loads the file (throws std::runtime_error on malformed input)
+    explicit MemoryTraceReader(const std::string& path);
+
+    // Next record; false at the end of the trace
+    bool next(TraceRecord& record);
+
+    // Start again from the first record
+    void rewind();
+
+    // Records decoded so far, and the encoded size
+    uint64_t position() const { return position_; }
+    uint64_t encoded_bytes() const { return size_; }
+
+private:
+    std::shared_ptr<const std::vector<uint8_t>> buffer_;
+    const uint8_t* data_;   // Shared encoded trace
+    size_t size_;
+    size_t start_;
+    size_t pos_;
+    uint64_t position_;
+    bool ended_;
+
+    TraceRecord previous_;
+    int64_t cycle_delta_;
+    int64_t address_delta_;
+    uint64_t run_remaining_;
+
+    uint8_t read_u8();
+    uint64_t read_varint();
+};
+
+#endif // MEMORY_TRACE_H
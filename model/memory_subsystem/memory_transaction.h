@@ -4,6 +4,7 @@
 #include <systemc.h>
 #include <cstdint>
 #include <iostream>
+#include "burst_payload.h"
 
 // Memory transaction types
 enum class MemoryTransactionType {
@@ -29,12 +30,27 @@ public:
     // Transaction properties
     MemoryTransactionType type() const { return type_; }
     uint64_t address() const { return address_; }
+    void set_address(uint64_t address) { address_ = address; }
     uint32_t size() const { return size_; }
     
     // Data access
     void set_data(uint64_t data) { data_ = data; }
     uint64_t data() const { return data_; }
     
+    // Burst payload (up to one cache line, with byte enables); copies share the buffer
+    void set_payload(const BurstPayload& payload) { payload_ = payload; }
+    const BurstPayload& payload() const { return payload_; }
+    BurstPayload& payload() { return payload_; }
+    bool has_payload() const { return !payload_.empty(); }
+    
+    // Program counter of the issuing instruction (trains PC-indexed prefetchers)
+    void set_pc(uint64_t pc) { pc_ = pc; }
+    uint64_t pc() const { return pc_; }
+    
+    // Issuing core (selects the requesting L1 for directory coherence)
+    void set_source(uint32_t source) { source_ = source; }
+    uint32_t source() const { return source_; }
+    
     // Transaction ID
     void set_id(uint32_t id) { id_ = id; }
     uint32_t id() const { return id_; }
@@ -53,6 +69,9 @@ public:
                address_ == other.address_ && 
                size_ == other.size_ && 
                data_ == other.data_ && 
+               payload_ == other.payload_ && 
+               pc_ == other.pc_ && 
+               source_ == other.source_ && 
                id_ == other.id_ && 
                pending_ == other.pending_;
     }
@@ -66,6 +85,9 @@ private:
     uint64_t address_;
     uint32_t size_;
     uint64_t data_;
+    BurstPayload payload_;
+    uint64_t pc_ = 0;
+    uint32_t source_ = 0;
     uint32_t id_;
     bool pending_;
 };
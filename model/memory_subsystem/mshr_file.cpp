@@ -0,0 +1,89 @@
+#include "mshr_file.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+const uint32_t MshrFile::DEFAULT_MAX_TARGETS;
+
+MshrFile::MshrFile(uint32_t num_entries, uint32_t max_targets)
+    : entries_(num_entries),
+      max_targets_(max_targets),
+      occupancy_(0) {
+    if (num_entries == 0 || max_targets == 0) {
+        throw std::invalid_argument("MshrFile needs at least one entry and one target");
+    }
+    for (Entry& entry : entries_) {
+        entry.targets.reserve(max_targets_);
+    }
+}
+
+bool MshrFile::find(uint64_t block_addr, uint32_t& mshr_id) const {
+    for (uint32_t i = 0; i < entries_.size(); i++) {
+        if (entries_[i].valid && entries_[i].block_addr == block_addr) {
+            mshr_id = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+MshrFile::Outcome MshrFile::allocate(uint64_t block_addr, const MemoryTransaction& transaction,
+                                     uint32_t& mshr_id) {
+    // Secondary miss: merge into the in-flight fill
+    if (find(block_addr, mshr_id)) {
+        Entry& entry = entries_[mshr_id];
+        if (entry.targets.size() >= max_targets_) {
+            stats_.target_full_stalls++;
+            return Outcome::STALL_TARGETS;
+        }
+        entry.targets.push_back(transaction);
+        stats_.secondary_misses++;
+        return Outcome::SECONDARY;
+    }
+
+    // Primary miss: claim a free entry
+    for (uint32_t i = 0; i < entries_.size(); i++) {
+        Entry& entry = entries_[i];
+        if (entry.valid) {
+            continue;
+        }
+        entry.valid = true;
+        entry.block_addr = block_addr;
+        entry.targets.clear();
+        entry.targets.push_back(transaction);
+        occupancy_++;
+        stats_.primary_misses++;
+        stats_.peak_occupancy = std::max(stats_.peak_occupancy, occupancy_);
+        mshr_id = i;
+        return Outcome::PRIMARY;
+    }
+
+    stats_.entry_full_stalls++;
+    return Outcome::STALL_ENTRIES;
+}
+
+std::vector<MemoryTransaction> MshrFile::complete(uint32_t mshr_id) {
+    if (!is_valid(mshr_id)) {
+        throw std::out_of_range("MshrFile::complete on an idle MSHR");
+    }
+    Entry& entry = entries_[mshr_id];
+    std::vector<MemoryTransaction> targets;
+    targets.reserve(max_targets_);
+    targets.swap(entry.targets);
+    entry.valid = false;
+    occupancy_--;
+    return targets;
+}
+
+void MshrFile::reset_stats() {
+    stats_ = MshrStats();
+    stats_.peak_occupancy = occupancy_;
+}
+
+void MshrFile::clear() {
+    for (Entry& entry : entries_) {
+        entry.valid = false;
+        entry.targets.clear();
+    }
+    occupancy_ = 0;
+}
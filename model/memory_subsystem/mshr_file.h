@@ -0,0 +1,91 @@
+#ifndef MSHR_FILE_H
+#define MSHR_FILE_H
+
+#include <vector>
+#include <cstdint>
+#include "memory_transaction.h"
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// MSHR statistics
+struct MshrStats {
+    uint64_t primary_misses = 0;     // Misses that allocated an MSHR and went to the next level
+    uint64_t secondary_misses = 0;   // Misses merged into an in-flight MSHR
+    uint64_t entry_full_stalls = 0;  // Requests rejected because all MSHRs were busy
+    uint64_t target_full_stalls = 0; // Requests rejected because the MSHR's target list was full
+    uint64_t stall_cycles = 0;       // Cycles with a request blocked on MSHR resources
+    uint32_t peak_occupancy = 0;
+};
+
+// Miss status holding registers for a non-blocking cache
+//
+// Each entry tracks one in-flight line fill and the list of requests
+// (targets) waiting for it. A miss to a line already in flight is merged
+// into the existing entry instead of issuing a duplicate request, so the
+// cache keeps serving hits and further misses while fills are outstanding.
+// Entries are a fixed array searched associatively by block address, like
+// the CAM in hardware; the entry index is the ID used for the fill request.
+class MshrFile {
+public:
+    enum class Outcome {
+        PRIMARY,         // New entry allocated, caller issues the fill request
+        SECONDARY,       // Merged into an in-flight entry, no request needed
+        STALL_ENTRIES,   // No free entry
+        STALL_TARGETS    // Matching entry has no free target slot
+    };
+
+    static const uint32_t DEFAULT_MAX_TARGETS = 8;
+
+    // Constructor
+    MshrFile(uint32_t num_entries = 16, uint32_t max_targets = DEFAULT_MAX_TARGETS);
+
+    // Record a miss on block_addr; mshr_id receives the entry index for
+    // PRIMARY and SECONDARY outcomes
+    Outcome allocate(uint64_t block_addr, const MemoryTransaction& transaction, uint32_t& mshr_id);
+
+    // Lookup of an in-flight fill by block address or entry index
+    bool find(uint64_t block_addr, uint32_t& mshr_id) const;
+    bool is_valid(uint32_t mshr_id) const { return mshr_id < entries_.size() && entries_[mshr_id].valid; }
+    uint64_t block_addr(uint32_t mshr_id) const { return entries_[mshr_id].block_addr; }
+    const std::vector<MemoryTransaction>& targets(uint32_t mshr_id) const { return entries_[mshr_id].targets; }
+
+    // Retire an entry when its fill arrives; targets are returned in arrival order
+    std::vector<MemoryTransaction> complete(uint32_t mshr_id);
+
+    // Occupancy
+    uint32_t num_entries() const { return static_cast<uint32_t>(entries_.size()); }
+    uint32_t max_targets() const { return max_targets_; }
+    uint32_t occupancy() const { return occupancy_; }
+    bool is_full() const { return occupancy_ == entries_.size(); }
+    bool is_empty() const { return occupancy_ == 0; }
+
+    // Stall accounting; called once per cycle in which a request is blocked
+    void record_stall_cycle() { stats_.stall_cycles++; }
+
+    // Statistics
+    const MshrStats& stats() const { return stats_; }
+    void reset_stats();
+
+    // Reset
+    void clear();
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    struct Entry {
+        bool valid = false;
+        uint64_t block_addr = 0;
+        std::vector<MemoryTransaction> targets;
+    };
+
+    std::vector<Entry> entries_;
+    uint32_t max_targets_;
+    uint32_t occupancy_;
+    MshrStats stats_;
+};
+
+#endif // MSHR_FILE_H
@@ -0,0 +1,221 @@
+#include "prefetcher.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+Prefetcher::Prefetcher(const PrefetcherConfig& config)
+    : config_(config),
+      degree_(std::min(config.degree, config.max_degree)),
+      access_count_(0),
+      stride_table_(config.stride_table_size),
+      streams_(config.num_streams),
+      epoch_issued_(0),
+      epoch_useful_(0) {
+    if (config_.line_size == 0 || config_.degree == 0 || config_.max_degree == 0 ||
+        config_.distance == 0) {
+        throw std::invalid_argument("Prefetcher line size, degree and distance must be non-zero");
+    }
+    if (config_.type == PrefetcherType::STRIDE && config_.stride_table_size == 0) {
+        throw std::invalid_argument("Stride prefetcher needs a non-empty table");
+    }
+    if (config_.type == PrefetcherType::STREAM && config_.num_streams == 0) {
+        throw std::invalid_argument("Stream prefetcher needs at least one stream");
+    }
+}
+
+void Prefetcher::on_demand_access(uint64_t pc, uint64_t addr, bool hit, double mshr_occupancy,
+                                  std::vector<uint64_t>& prefetches) {
+    uint64_t line = addr / config_.line_size;
+    access_count_++;
+
+    // Credit prefetches first so accuracy feedback is current when throttling
+    bool prefetched = false;
+    if (in_flight_.erase(line) != 0) {
+        stats_.useful++;
+        stats_.late++;
+        epoch_useful_++;
+        prefetched = true;
+    } else if (unused_.erase(line) != 0) {
+        stats_.useful++;
+        epoch_useful_++;
+        prefetched = true;
+    } else if (!hit) {
+        stats_.uncovered_misses++;
+    }
+
+    // Next-line and stream prefetchers train on misses and on first use of a
+    // prefetched line, so a covered stream keeps running ahead
+    bool trigger = !hit || prefetched;
+    std::vector<uint64_t> candidates;
+    switch (config_.type) {
+        case PrefetcherType::NONE:
+            return;
+        case PrefetcherType::NEXT_LINE:
+            if (trigger) {
+                train_next_line(line, candidates);
+            }
+            break;
+        case PrefetcherType::STRIDE:
+            train_stride(pc, addr, candidates);
+            break;
+        case PrefetcherType::STREAM:
+            if (trigger) {
+                train_stream(line, candidates);
+            }
+            break;
+    }
+    issue(candidates, mshr_occupancy, prefetches);
+}
+
+void Prefetcher::on_prefetch_fill(uint64_t line_addr) {
+    uint64_t line = line_addr / config_.line_size;
+    if (in_flight_.erase(line) != 0) {
+        unused_.insert(line);
+    }
+}
+
+void Prefetcher::on_prefetch_cancelled(uint64_t line_addr) {
+    if (in_flight_.erase(line_addr / config_.line_size) != 0) {
+        stats_.issued--;
+        if (epoch_issued_ > 0) {
+            epoch_issued_--;
+        }
+    }
+}
+
+void Prefetcher::on_eviction(uint64_t line_addr) {
+    if (unused_.erase(line_addr / config_.line_size) != 0) {
+        stats_.useless++;
+    }
+}
+
+void Prefetcher::train_next_line(uint64_t line, std::vector<uint64_t>& candidates) {
+    for (uint32_t k = 0; k < degree_; k++) {
+        candidates.push_back(line + config_.distance + k);
+    }
+}
+
+void Prefetcher::train_stride(uint64_t pc, uint64_t addr, std::vector<uint64_t>& candidates) {
+    StrideEntry& entry = stride_table_[(pc >> 2) % stride_table_.size()];
+    if (!entry.valid || entry.pc != pc) {
+        entry = StrideEntry();
+        entry.pc = pc;
+        entry.last_addr = addr;
+        entry.valid = true;
+        return;
+    }
+
+    int64_t delta = static_cast<int64_t>(addr - entry.last_addr);
+    if (delta == 0) {
+        return;
+    }
+    // Two-bit confidence: a stride is replaced only after confidence drains
+    if (delta == entry.stride) {
+        entry.confidence = std::min<uint8_t>(entry.confidence + 1, 3);
+    } else if (entry.confidence > 0) {
+        entry.confidence--;
+    } else {
+        entry.stride = delta;
+    }
+    entry.last_addr = addr;
+
+    if (entry.confidence < 2) {
+        return;
+    }
+    uint64_t line = addr / config_.line_size;
+    for (uint32_t k = 0; k < degree_; k++) {
+        uint64_t target = addr + static_cast<uint64_t>(entry.stride * (config_.distance + k));
+        uint64_t target_line = target / config_.line_size;
+        if (target_line != line && (candidates.empty() || candidates.back() != target_line)) {
+            candidates.push_back(target_line);
+        }
+    }
+}
+
+void Prefetcher::train_stream(uint64_t line, std::vector<uint64_t>& candidates) {
+    Stream* stream = nullptr;
+    for (Stream& candidate : streams_) {
+        if (!candidate.valid) {
+            continue;
+        }
+        uint64_t gap = line > candidate.head_line ? line - candidate.head_line : candidate.head_line - line;
+        if (gap <= config_.stream_window) {
+            stream = &candidate;
+            break;
+        }
+    }
+
+    if (stream == nullptr) {
+        // Allocate over the least recently used stream; direction is learned
+        // from the next miss that joins it
+        stream = &*std::min_element(streams_.begin(), streams_.end(),
+                                    [](const Stream& a, const Stream& b) {
+                                        if (a.valid != b.valid) {
+                                            return !a.valid;
+                                        }
+                                        return a.last_use < b.last_use;
+                                    });
+        *stream = Stream();
+        stream->head_line = line;
+        stream->last_use = access_count_;
+        stream->valid = true;
+        return;
+    }
+
+    stream->last_use = access_count_;
+    if (line == stream->head_line) {
+        return;
+    }
+    int32_t direction = line > stream->head_line ? 1 : -1;
+    bool confirmed = stream->direction == direction;
+    stream->direction = direction;
+    stream->head_line = line;
+    if (!confirmed) {
+        return;
+    }
+    for (uint32_t k = 0; k < degree_; k++) {
+        int64_t offset = static_cast<int64_t>(config_.distance + k) * direction;
+        candidates.push_back(line + static_cast<uint64_t>(offset));
+    }
+}
+
+void Prefetcher::issue(const std::vector<uint64_t>& candidates, double mshr_occupancy,
+                       std::vector<uint64_t>& prefetches) {
+    for (uint64_t line : candidates) {
+        if (in_flight_.count(line) != 0 || unused_.count(line) != 0) {
+            continue;
+        }
+        if (mshr_occupancy >= config_.mshr_pressure_limit) {
+            stats_.dropped++;
+            continue;
+        }
+        prefetches.push_back(line * config_.line_size);
+        in_flight_.insert(line);
+        stats_.issued++;
+        if (++epoch_issued_ >= config_.throttle_epoch) {
+            adjust_degree();
+        }
+    }
+}
+
+void Prefetcher::adjust_degree() {
+    double accuracy = static_cast<double>(epoch_useful_) / epoch_issued_;
+    if (accuracy < config_.low_accuracy && degree_ > 1) {
+        degree_--;
+    } else if (accuracy > config_.high_accuracy && degree_ < config_.max_degree) {
+        degree_++;
+    }
+    epoch_issued_ = 0;
+    epoch_useful_ = 0;
+}
+
+void Prefetcher::clear() {
+    degree_ = std::min(config_.degree, config_.max_degree);
+    access_count_ = 0;
+    std::fill(stride_table_.begin(), stride_table_.end(), StrideEntry());
+    std::fill(streams_.begin(), streams_.end(), Stream());
+    in_flight_.clear();
+    unused_.clear();
+    epoch_issued_ = 0;
+    epoch_useful_ = 0;
+}
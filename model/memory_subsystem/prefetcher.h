@@ -0,0 +1,142 @@
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// Prefetch algorithms
+enum class PrefetcherType : uint8_t {
+    NONE,
+    NEXT_LINE,   // Next-N-line on demand misses and prefetch hits
+    STRIDE,      // PC-indexed reference prediction table
+    STREAM       // Stream buffers that detect ascending/descending miss streams
+};
+
+// Prefetcher configuration
+struct PrefetcherConfig {
+    PrefetcherType type = PrefetcherType::NONE;
+    uint32_t line_size = 64;
+    uint32_t degree = 2;               // Initial lines issued per trigger
+    uint32_t max_degree = 8;
+    uint32_t distance = 1;             // Lines ahead of the trigger the first prefetch lands
+    uint32_t stride_table_size = 64;
+    uint32_t num_streams = 8;
+    uint32_t stream_window = 16;       // Lines a miss may be from a stream head to join it
+
+    // Throttling: degree is adjusted every epoch of issued prefetches, and
+    // prefetches are dropped while MSHR occupancy is above the limit
+    uint32_t throttle_epoch = 256;
+    double low_accuracy = 0.40;
+    double high_accuracy = 0.75;
+    double mshr_pressure_limit = 0.75;
+};
+
+// Prefetch effectiveness
+struct PrefetchStats {
+    uint64_t issued = 0;
+    uint64_t dropped = 0;              // Suppressed by MSHR pressure
+    uint64_t useful = 0;               // Demand accesses to prefetched lines
+    uint64_t late = 0;                 // ... of which arrived while the prefetch was in flight
+    uint64_t useless = 0;              // Prefetched lines evicted before use
+    uint64_t uncovered_misses = 0;     // Demand misses not prefetched
+
+    // Fraction of would-be misses removed or shortened by prefetching
+    double coverage() const {
+        uint64_t total = useful + uncovered_misses;
+        return total > 0 ? static_cast<double>(useful) / total : 0.0;
+    }
+    // Fraction of issued prefetches that were used
+    double accuracy() const {
+        return issued > 0 ? static_cast<double>(useful) / issued : 0.0;
+    }
+    // Fraction of useful prefetches that completed before the demand access
+    double timeliness() const {
+        return useful > 0 ? static_cast<double>(useful - late) / useful : 0.0;
+    }
+};
+
+// Hardware prefetcher attached to CacheL1 or CacheL2
+//
+// The cache reports demand accesses, prefetch fills and evictions; the
+// prefetcher returns line addresses to fetch and tracks which lines it
+// brought in so it can measure coverage, accuracy and timeliness itself.
+class Prefetcher {
+public:
+    // Constructor
+    explicit Prefetcher(const PrefetcherConfig& config = PrefetcherConfig());
+
+    // Observe a demand access and append line addresses to prefetch.
+    // mshr_occupancy is the fraction of the cache's MSHRs in use.
+    void on_demand_access(uint64_t pc, uint64_t addr, bool hit, double mshr_occupancy,
+                          std::vector<uint64_t>& prefetches);
+
+    // A prefetch issued earlier has been filled into the cache
+    void on_prefetch_fill(uint64_t line_addr);
+
+    // A returned prefetch was not sent (line already cached or no MSHR)
+    void on_prefetch_cancelled(uint64_t line_addr);
+
+    // A line left the cache
+    void on_eviction(uint64_t line_addr);
+
+    // Configuration and current (throttled) degree
+    const PrefetcherConfig& config() const { return config_; }
+    uint32_t degree() const { return degree_; }
+
+    // Statistics
+    const PrefetchStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = PrefetchStats(); }
+
+    // Reset
+    void clear();
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    struct StrideEntry {
+        uint64_t pc = 0;
+        uint64_t last_addr = 0;
+        int64_t stride = 0;
+        uint8_t confidence = 0;
+        bool valid = false;
+    };
+
+    struct Stream {
+        uint64_t head_line = 0;        // Most recent miss in the stream (line number)
+        int32_t direction = 0;         // +1, -1, or 0 while training
+        uint64_t last_use = 0;
+        bool valid = false;
+    };
+
+    PrefetcherConfig config_;
+    uint32_t degree_;
+    PrefetchStats stats_;
+    uint64_t access_count_;
+
+    std::vector<StrideEntry> stride_table_;
+    std::vector<Stream> streams_;
+
+    // Prefetched lines that are still in flight, or filled and not yet used
+    std::unordered_set<uint64_t> in_flight_;
+    std::unordered_set<uint64_t> unused_;
+
+    // Accuracy over the current throttle epoch
+    uint64_t epoch_issued_;
+    uint64_t epoch_useful_;
+
+    void train_next_line(uint64_t line, std::vector<uint64_t>& candidates);
+    void train_stride(uint64_t pc, uint64_t addr, std::vector<uint64_t>& candidates);
+    void train_stream(uint64_t line, std::vector<uint64_t>& candidates);
+    void issue(const std::vector<uint64_t>& candidates, double mshr_occupancy,
+               std::vector<uint64_t>& prefetches);
+    void adjust_degree();
+};
+
+#endif // PREFETCHER_H
@@ -7,6 +7,10 @@
 #include "memory_transaction.h"
 #include "memory_response.h"
 
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
 // Memory subsystem register file
 class RegisterFile : public sc_module {
 public:
@@ -27,6 +31,10 @@ public:
     uint32_t read(uint32_t addr) const;
     void write(uint32_t addr, uint32_t data);
     
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
 private:
     // Register storage
     std::vector<uint32_t> registers_;
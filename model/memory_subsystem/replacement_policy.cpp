@@ -0,0 +1,195 @@
+#include "replacement_policy.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+const uint8_t RripPolicy::MAX_RRPV;
+const uint32_t RripPolicy::BIMODAL_THROTTLE;
+const uint32_t RripPolicy::PSEL_BITS;
+const uint32_t RripPolicy::LEADER_SETS;
+const uint64_t RandomPolicy::DEFAULT_SEED;
+
+// ReplacementPolicyBase
+
+ReplacementPolicyBase::ReplacementPolicyBase(uint32_t num_sets, uint32_t associativity)
+    : num_sets_(num_sets),
+      associativity_(associativity) {
+    if (associativity_ == 0 || associativity_ > 64) {
+        throw std::invalid_argument("Replacement policy associativity must be between 1 and 64");
+    }
+}
+
+// LruPolicy
+
+LruPolicy::LruPolicy(uint32_t num_sets, uint32_t associativity)
+    : ReplacementPolicyBase(num_sets, associativity) {
+    reset();
+}
+
+void LruPolicy::reset() {
+    ranks_.resize(static_cast<size_t>(num_sets_) * associativity_);
+    for (size_t i = 0; i < ranks_.size(); i++) {
+        ranks_[i] = static_cast<uint8_t>(i % associativity_);
+    }
+}
+
+void LruPolicy::promote(uint32_t set, uint32_t way) {
+    uint8_t* ranks = &ranks_[static_cast<size_t>(set) * associativity_];
+    uint8_t rank = ranks[way];
+    if (rank == 0) {
+        return;   // Already most recently used
+    }
+    for (uint32_t w = 0; w < associativity_; w++) {
+        if (ranks[w] < rank) {
+            ranks[w]++;
+        }
+    }
+    ranks[way] = 0;
+}
+
+uint32_t LruPolicy::victim(uint32_t set) {
+    const uint8_t* ranks = &ranks_[static_cast<size_t>(set) * associativity_];
+    stats_.evictions++;
+    return static_cast<uint32_t>(
+        std::max_element(ranks, ranks + associativity_) - ranks);
+}
+
+// TreePlruPolicy
+
+TreePlruPolicy::TreePlruPolicy(uint32_t num_sets, uint32_t associativity)
+    : ReplacementPolicyBase(num_sets, associativity),
+      levels_(0) {
+    if ((associativity_ & (associativity_ - 1)) != 0) {
+        throw std::invalid_argument("Tree-PLRU requires a power-of-two associativity");
+    }
+    while ((1u << levels_) < associativity_) {
+        levels_++;
+    }
+    reset();
+}
+
+void TreePlruPolicy::reset() {
+    tree_bits_.assign(num_sets_, 0);
+}
+
+void TreePlruPolicy::promote(uint32_t set, uint32_t way) {
+    // Walk root to leaf, pointing each node away from the accessed half
+    uint64_t bits = tree_bits_[set];
+    uint32_t node = 1;
+    for (uint32_t level = levels_; level > 0; level--) {
+        uint32_t right = (way >> (level - 1)) & 1;
+        if (right) {
+            bits &= ~(1ULL << node);
+        } else {
+            bits |= 1ULL << node;
+        }
+        node = 2 * node + right;
+    }
+    tree_bits_[set] = bits;
+}
+
+uint32_t TreePlruPolicy::victim(uint32_t set) {
+    uint64_t bits = tree_bits_[set];
+    uint32_t node = 1;
+    while (node < associativity_) {
+        node = 2 * node + static_cast<uint32_t>((bits >> node) & 1);
+    }
+    stats_.evictions++;
+    return node - associativity_;
+}
+
+// RripPolicy
+
+RripPolicy::RripPolicy(uint32_t num_sets, uint32_t associativity, Insertion insertion)
+    : ReplacementPolicyBase(num_sets, associativity),
+      insertion_(insertion),
+      leader_sets_(std::min(LEADER_SETS, num_sets / 4)),
+      leader_stride_(leader_sets_ > 0 ? num_sets / leader_sets_ : 0) {
+    reset();
+}
+
+void RripPolicy::reset() {
+    rrpv_.assign(static_cast<size_t>(num_sets_) * associativity_, MAX_RRPV);
+    bimodal_counter_ = 0;
+    psel_ = 1u << (PSEL_BITS - 1);
+    srrip_leader_misses_ = 0;
+    brrip_leader_misses_ = 0;
+}
+
+RripPolicy::SetRole RripPolicy::set_role(uint32_t set) const {
+    if (insertion_ != Insertion::DYNAMIC || set >= leader_sets_ * leader_stride_) {
+        return SetRole::FOLLOWER;
+    }
+    switch (set % leader_stride_) {
+        case 0: return SetRole::SRRIP_LEADER;
+        case 1: return SetRole::BRRIP_LEADER;
+        default: return SetRole::FOLLOWER;
+    }
+}
+
+uint8_t RripPolicy::bimodal_insertion() {
+    if (++bimodal_counter_ >= BIMODAL_THROTTLE) {
+        bimodal_counter_ = 0;
+        return MAX_RRPV - 1;
+    }
+    return MAX_RRPV;
+}
+
+void RripPolicy::on_fill(uint32_t set, uint32_t way) {
+    stats_.misses++;
+    
+    bool bimodal = insertion_ == Insertion::BIMODAL;
+    if (insertion_ == Insertion::DYNAMIC) {
+        // Leader misses train PSEL; a high PSEL means SRRIP is missing more
+        const uint32_t psel_max = (1u << PSEL_BITS) - 1;
+        switch (set_role(set)) {
+            case SetRole::SRRIP_LEADER:
+                srrip_leader_misses_++;
+                psel_ = std::min(psel_ + 1, psel_max);
+                break;
+            case SetRole::BRRIP_LEADER:
+                brrip_leader_misses_++;
+                psel_ = psel_ > 0 ? psel_ - 1 : 0;
+                bimodal = true;
+                break;
+            case SetRole::FOLLOWER:
+                bimodal = psel_ >= (1u << (PSEL_BITS - 1));
+                break;
+        }
+    }
+    rrpv_[index(set, way)] = bimodal ? bimodal_insertion() : MAX_RRPV - 1;
+}
+
+uint32_t RripPolicy::victim(uint32_t set) {
+    uint8_t* rrpv = &rrpv_[index(set, 0)];
+    
+    // Age the whole set at once so the oldest line reaches MAX_RRPV
+    uint8_t oldest = *std::max_element(rrpv, rrpv + associativity_);
+    uint8_t delta = MAX_RRPV - oldest;
+    uint32_t victim_way = 0;
+    bool found = false;
+    for (uint32_t way = 0; way < associativity_; way++) {
+        rrpv[way] += delta;
+        if (!found && rrpv[way] == MAX_RRPV) {
+            victim_way = way;
+            found = true;
+        }
+    }
+    stats_.evictions++;
+    return victim_way;
+}
+
+// RandomPolicy
+
+RandomPolicy::RandomPolicy(uint32_t num_sets, uint32_t associativity)
+    : ReplacementPolicyBase(num_sets, associativity),
+      rng_state_(DEFAULT_SEED) {
+}
+
+uint32_t RandomPolicy::victim(uint32_t) {
+    rng_state_ ^= rng_state_ << 13;
+    rng_state_ ^= rng_state_ >> 7;
+    rng_state_ ^= rng_state_ << 17;
+    stats_.evictions++;
+    return static_cast<uint32_t>(rng_state_ % associativity_);
+}
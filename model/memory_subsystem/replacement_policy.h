@@ -0,0 +1,267 @@
+#ifndef REPLACEMENT_POLICY_H
+#define REPLACEMENT_POLICY_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// Cache replacement policies
+//
+// Policies are plain classes selected at compile time (no virtual dispatch)
+// and keep compact per-set state instead of per-line timestamps. They share
+// one interface:
+//   on_hit(set, way)      - line was referenced
+//   on_fill(set, way)     - line was installed after a miss
+//   on_invalidate(set, way)
+//   victim(set)           - way to evict from a full set
+// Callers fill invalid ways before asking for a victim.
+
+// Per-policy access statistics
+struct ReplacementStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+
+    double miss_rate() const {
+        uint64_t accesses = hits + misses;
+        return accesses > 0 ? static_cast<double>(misses) / accesses : 0.0;
+    }
+};
+
+// State shared by all policies
+class ReplacementPolicyBase {
+public:
+    uint32_t num_sets() const { return num_sets_; }
+    uint32_t associativity() const { return associativity_; }
+
+    const ReplacementStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = ReplacementStats(); }
+
+protected:
+    // Constructor (throws std::invalid_argument for associativity outside 1..64)
+    ReplacementPolicyBase(uint32_t num_sets, uint32_t associativity);
+
+    uint32_t num_sets_;
+    uint32_t associativity_;
+    ReplacementStats stats_;
+
+    void save_stats(CheckpointWriter& writer) const;
+    void restore_stats(CheckpointReader& reader);
+};
+
+// True LRU: one recency rank byte per line, 0 = most recently used
+class LruPolicy : public ReplacementPolicyBase {
+public:
+    LruPolicy(uint32_t num_sets, uint32_t associativity);
+
+    static const char* name() { return "lru"; }
+
+    void on_hit(uint32_t set, uint32_t way) { stats_.hits++; promote(set, way); }
+    void on_fill(uint32_t set, uint32_t way) { stats_.misses++; promote(set, way); }
+    void on_invalidate(uint32_t, uint32_t) {}
+    uint32_t victim(uint32_t set);
+    void reset();
+
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    std::vector<uint8_t> ranks_;
+
+    void promote(uint32_t set, uint32_t way);
+};
+
+// Tree pseudo-LRU: associativity - 1 direction bits per set in one word.
+// Node i (1-based, heap order) points towards the less recently used half;
+// associativity must be a power of two.
+class TreePlruPolicy : public ReplacementPolicyBase {
+public:
+    TreePlruPolicy(uint32_t num_sets, uint32_t associativity);
+
+    static const char* name() { return "tree-plru"; }
+
+    void on_hit(uint32_t set, uint32_t way) { stats_.hits++; promote(set, way); }
+    void on_fill(uint32_t set, uint32_t way) { stats_.misses++; promote(set, way); }
+    void on_invalidate(uint32_t, uint32_t) {}
+    uint32_t victim(uint32_t set);
+    void reset();
+
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    std::vector<uint64_t> tree_bits_;
+    uint32_t levels_;
+
+    void promote(uint32_t set, uint32_t way);
+};
+
+// Re-reference interval prediction (Jaleel et al., ISCA 2010) with 2-bit
+// RRPVs. SRRIP inserts with a long re-reference interval, BRRIP mostly
+// inserts with a distant one, and DRRIP picks between them per follower set
+// from a PSEL counter trained by dedicated SRRIP and BRRIP leader sets.
+// Each policy leads at most a quarter of the sets (LEADER_SETS in larger
+// caches), so at least half are followers; caches of fewer than four sets
+// have no leaders and follow the untrained PSEL, i.e. insert as BRRIP.
+class RripPolicy : public ReplacementPolicyBase {
+public:
+    enum class Insertion : uint8_t { STATIC, BIMODAL, DYNAMIC };
+
+    static const uint8_t MAX_RRPV = 3;
+    static const uint32_t BIMODAL_THROTTLE = 32;   // 1 in 32 BRRIP fills are long
+    static const uint32_t PSEL_BITS = 10;
+    static const uint32_t LEADER_SETS = 32;        // Per competing policy, at most
+
+    RripPolicy(uint32_t num_sets, uint32_t associativity, Insertion insertion);
+
+    void on_hit(uint32_t set, uint32_t way) {
+        stats_.hits++;
+        rrpv_[index(set, way)] = 0;
+    }
+    void on_fill(uint32_t set, uint32_t way);
+    void on_invalidate(uint32_t set, uint32_t way) { rrpv_[index(set, way)] = MAX_RRPV; }
+    uint32_t victim(uint32_t set);
+    void reset();
+
+    // Set dueling state (DYNAMIC only)
+    uint32_t psel() const { return psel_; }
+    uint64_t srrip_leader_misses() const { return srrip_leader_misses_; }
+    uint64_t brrip_leader_misses() const { return brrip_leader_misses_; }
+
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    enum class SetRole : uint8_t { FOLLOWER, SRRIP_LEADER, BRRIP_LEADER };
+
+    Insertion insertion_;
+    std::vector<uint8_t> rrpv_;
+    uint32_t bimodal_counter_;
+    uint32_t psel_;
+    uint32_t leader_sets_;         // Per competing policy
+    uint32_t leader_stride_;       // One leader of each kind per stride
+    uint64_t srrip_leader_misses_;
+    uint64_t brrip_leader_misses_;
+
+    size_t index(uint32_t set, uint32_t way) const {
+        return static_cast<size_t>(set) * associativity_ + way;
+    }
+    SetRole set_role(uint32_t set) const;
+    uint8_t bimodal_insertion();
+};
+
+class SrripPolicy : public RripPolicy {
+public:
+    SrripPolicy(uint32_t num_sets, uint32_t associativity)
+        : RripPolicy(num_sets, associativity, Insertion::STATIC) {}
+    static const char* name() { return "srrip"; }
+};
+
+class BrripPolicy : public RripPolicy {
+public:
+    BrripPolicy(uint32_t num_sets, uint32_t associativity)
+        : RripPolicy(num_sets, associativity, Insertion::BIMODAL) {}
+    static const char* name() { return "brrip"; }
+};
+
+class DrripPolicy : public RripPolicy {
+public:
+    DrripPolicy(uint32_t num_sets, uint32_t associativity)
+        : RripPolicy(num_sets, associativity, Insertion::DYNAMIC) {}
+    static const char* name() { return "drrip"; }
+};
+
+// Random replacement from a deterministic xorshift generator
+class RandomPolicy : public ReplacementPolicyBase {
+public:
+    static const uint64_t DEFAULT_SEED = 0x9E3779B97F4A7C15ULL;
+
+    RandomPolicy(uint32_t num_sets, uint32_t associativity);
+
+    static const char* name() { return "random"; }
+
+    void on_hit(uint32_t, uint32_t) { stats_.hits++; }
+    void on_fill(uint32_t, uint32_t) { stats_.misses++; }
+    void on_invalidate(uint32_t, uint32_t) {}
+    uint32_t victim(uint32_t set);
+    void reset() { rng_state_ = DEFAULT_SEED; }
+
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    uint64_t rng_state_;
+};
+
+// Policy used by CacheL1 and CacheL2, chosen with the CACHE_REPLACEMENT_POLICY
+// CMake option
+#if defined(CACHE_REPLACEMENT_POLICY_PLRU)
+using CacheReplacementPolicy = TreePlruPolicy;
+#elif defined(CACHE_REPLACEMENT_POLICY_SRRIP)
+using CacheReplacementPolicy = SrripPolicy;
+#elif defined(CACHE_REPLACEMENT_POLICY_BRRIP)
+using CacheReplacementPolicy = BrripPolicy;
+#elif defined(CACHE_REPLACEMENT_POLICY_DRRIP)
+using CacheReplacementPolicy = DrripPolicy;
+#elif defined(CACHE_REPLACEMENT_POLICY_RANDOM)
+using CacheReplacementPolicy = RandomPolicy;
+#else
+using CacheReplacementPolicy = LruPolicy;
+#endif
+
+// Tag-only set-associative cache driven by a replacement policy, for
+// evaluating policies against address traces without the SystemC model
+template <typename Policy>
+class ReplacementSimulator {
+public:
+    ReplacementSimulator(uint32_t num_sets, uint32_t associativity, uint32_t line_size)
+        : num_sets_(num_sets),
+          associativity_(associativity),
+          line_size_(line_size),
+          policy_(num_sets, associativity),
+          tags_(static_cast<size_t>(num_sets) * associativity, INVALID_TAG) {}
+
+    // Reference one address; returns true on a hit
+    bool access(uint64_t addr) {
+        uint64_t block = addr / line_size_;
+        uint32_t set = static_cast<uint32_t>(block % num_sets_);
+        uint64_t tag = block / num_sets_;
+        uint64_t* tags = &tags_[static_cast<size_t>(set) * associativity_];
+
+        uint32_t free_way = associativity_;
+        for (uint32_t way = 0; way < associativity_; way++) {
+            if (tags[way] == tag) {
+                policy_.on_hit(set, way);
+                return true;
+            }
+            if (tags[way] == INVALID_TAG && free_way == associativity_) {
+                free_way = way;
+            }
+        }
+        uint32_t way = free_way != associativity_ ? free_way : policy_.victim(set);
+        tags[way] = tag;
+        policy_.on_fill(set, way);
+        return false;
+    }
+
+    const Policy& policy() const { return policy_; }
+    const ReplacementStats& stats() const { return policy_.stats(); }
+
+private:
+    static const uint64_t INVALID_TAG = ~0ULL;
+
+    uint32_t num_sets_;
+    uint32_t associativity_;
+    uint32_t line_size_;
+    Policy policy_;
+    std::vector<uint64_t> tags_;
+};
+
+template <typename Policy>
+const uint64_t ReplacementSimulator<Policy>::INVALID_TAG;
+
+#endif // REPLACEMENT_POLICY_H
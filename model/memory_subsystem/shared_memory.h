@@ -5,11 +5,21 @@
 #include <vector>
 #include <unordered_map>
 #include <cstdint>
+#include <cstring>
+#include <stdexcept>
 #include "memory_transaction.h"
 #include "memory_response.h"
+#include "shared_memory_banks.h"
+#include "memory_tlm.h"
 
-// Shared memory class
-class SharedMemory : public sc_module {
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// Shared memory class. Besides the signal ports it can be exposed to
+// loosely-timed TLM-2.0 initiators through a TlmMemoryTarget, whose DMI
+// region covers the whole memory.
+class SharedMemory : public sc_module, public TlmBackingStore {
 public:
     // Ports
     sc_in<bool> clk;
@@ -31,6 +41,45 @@ public:
     // Memory properties
     uint32_t size() const { return memory_.size(); }
     
+    // TlmBackingStore
+    uint64_t tlm_size() const override { return memory_.size(); }
+    void tlm_read(uint64_t addr, uint8_t* data, uint32_t length) const override {
+        std::memcpy(data, memory_.data() + addr, length);
+    }
+    void tlm_write(uint64_t addr, const uint8_t* data, uint32_t length) override {
+        std::memcpy(memory_.data() + addr, data, length);
+    }
+    uint8_t* tlm_dmi_region(uint64_t, uint64_t& start, uint64_t& end) override {
+        start = 0;
+        end = memory_.size() - 1;
+        return memory_.data();
+    }
+    
+    // Bank model: bank width, address-to-bank mapping (word-interleaved by
+    // default) and swizzled layout
+    void set_bank_mode(SharedMemoryBankMode mode) { banks_.set_mode(mode); }
+    void set_bank_mapping(const AddressMapping& mapping) { banks_.set_mapping(mapping); }
+    void set_swizzle(const SharedMemorySwizzle& swizzle) { banks_.set_swizzle(swizzle); }
+    const SharedMemoryBankModel& banks() const { return banks_; }
+    
+    // Resolve all lanes of a warp access against the banks in one call;
+    // the per-bank words are added to the bank load histogram
+    WarpBankConflicts resolve_warp_access(const WarpMemoryAccess& access) {
+        WarpBankConflicts conflicts = banks_.resolve(access);
+        for (uint32_t bank = 0; bank < NUM_BANKS; bank++) {
+            for (uint32_t word = 0; word < conflicts.bank_words[bank]; word++) {
+                bank_load_.record(bank);
+            }
+        }
+        return conflicts;
+    }
+    const BankConflictStats& bank_conflict_stats() const { return banks_.stats(); }
+    const LoadBalanceHistogram& bank_load() const { return bank_load_; }
+    
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
 private:
     // Memory storage (byte addressable)
     std::vector<uint8_t> memory_;
@@ -47,6 +96,10 @@ private:
     std::vector<BankState> bank_states_;
     uint32_t current_cycle_;
     
+    // Warp-wide bank conflict model and the per-bank access histogram
+    SharedMemoryBankModel banks_;
+    LoadBalanceHistogram bank_load_{NUM_BANKS};
+    
     // Shared memory configuration
     static const uint32_t NUM_BANKS = 32;
     static const uint32_t BANK_SIZE_BYTES = 4;
@@ -55,7 +108,7 @@ private:
     static const uint32_t BANK_CONFLICT_PENALTY = 1;
     
     // Helper methods
-    uint32_t get_bank_index(uint32_t addr) const;
+    uint32_t get_bank_index(uint32_t addr) const { return banks_.bank(addr); }
     uint32_t calculate_latency(const MemoryTransaction& transaction);
     bool check_bank_conflicts(const MemoryTransaction& transaction, std::vector<uint32_t>& conflict_banks);
     void update_bank_states(const std::vector<uint32_t>& banks, uint32_t cycles);
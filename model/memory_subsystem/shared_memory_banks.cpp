@@ -0,0 +1,80 @@
+#include "shared_memory_banks.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+bool is_atomic(MemoryTransactionType type) {
+    return type != MemoryTransactionType::READ && type != MemoryTransactionType::WRITE;
+}
+
+}  // namespace
+
+SharedMemoryBankModel::SharedMemoryBankModel(uint32_t num_banks, SharedMemoryBankMode mode)
+    : num_banks_(num_banks) {
+    if (num_banks == 0 || (num_banks & (num_banks - 1)) != 0) {
+        throw std::invalid_argument("Shared memory bank count must be a power of two");
+    }
+    touched_.reserve(WarpMemoryAccess::MAX_LANES * 2);
+    set_mode(mode);
+}
+
+void SharedMemoryBankModel::set_mode(SharedMemoryBankMode mode) {
+    mode_ = mode;
+    width_bits_ = mode == SharedMemoryBankMode::EIGHT_BYTE ? 3 : 2;
+    mapping_ = AddressMapping::bit_slice(width_bits_, static_cast<uint32_t>(__builtin_ctz(num_banks_)));
+}
+
+void SharedMemoryBankModel::set_mapping(const AddressMapping& mapping) {
+    if (mapping.num_indices() != num_banks_) {
+        throw std::invalid_argument("Shared memory bank mapping must have one index per bank");
+    }
+    mapping_ = mapping;
+}
+
+WarpBankConflicts SharedMemoryBankModel::resolve(const WarpMemoryAccess& access) {
+    WarpBankConflicts result;
+    result.bank_words.assign(num_banks_, 0);
+    if (access.active_mask == 0) {
+        return result;
+    }
+
+    // Every bank word each active lane touches
+    touched_.clear();
+    for (uint32_t lane = 0; lane < WarpMemoryAccess::MAX_LANES; lane++) {
+        if (((access.active_mask >> lane) & 1) == 0) {
+            continue;
+        }
+        uint64_t first = access.addresses[lane] >> width_bits_;
+        uint64_t last = (access.addresses[lane] + std::max<uint32_t>(access.access_size, 1) - 1) >> width_bits_;
+        for (uint64_t word = first; word <= last; word++) {
+            uint64_t physical = swizzle_.apply(word << width_bits_);
+            touched_.emplace_back(mapping_.index(physical), physical >> width_bits_);
+        }
+    }
+
+    // Loads and stores share identical words; atomics serialise per lane
+    uint32_t lane_words = static_cast<uint32_t>(touched_.size());
+    std::sort(touched_.begin(), touched_.end());
+    if (!is_atomic(access.type)) {
+        touched_.erase(std::unique(touched_.begin(), touched_.end()), touched_.end());
+        result.broadcast_words = lane_words - static_cast<uint32_t>(touched_.size());
+    }
+
+    for (const auto& entry : touched_) {
+        uint32_t words = ++result.bank_words[entry.first];
+        result.wavefronts = std::max(result.wavefronts, words);
+    }
+    result.unique_words = static_cast<uint32_t>(touched_.size());
+    result.ideal_wavefronts = (result.unique_words + num_banks_ - 1) / num_banks_;
+
+    stats_.accesses++;
+    stats_.wavefronts += result.wavefronts;
+    stats_.ideal_wavefronts += result.ideal_wavefronts;
+    stats_.broadcast_words += result.broadcast_words;
+    if (result.wavefronts > result.ideal_wavefronts) {
+        stats_.conflicted_accesses++;
+    }
+    return result;
+}
@@ -0,0 +1,113 @@
+#ifndef SHARED_MEMORY_BANKS_H
+#define SHARED_MEMORY_BANKS_H
+
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "address_mapping.h"
+#include "memory_coalescer.h"
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// Width of a shared memory bank
+enum class SharedMemoryBankMode : uint8_t {
+    FOUR_BYTE,   // 32-bit banks
+    EIGHT_BYTE   // 64-bit banks: two adjacent 32-bit words share a bank word
+};
+
+// XOR swizzle applied to shared memory offsets, in the form used by tiled
+// GEMM layouts: bits [base + shift, base + shift + bits) are XORed into
+// [base, base + bits). E.g. {5, 2, 5} makes column walks through a 32x32
+// float tile conflict-free.
+struct SharedMemorySwizzle {
+    uint32_t bits = 0;
+    uint32_t base = 0;
+    uint32_t shift = 0;
+
+    uint64_t apply(uint64_t addr) const {
+        uint64_t mask = ((1ULL << bits) - 1) << (base + shift);
+        return addr ^ ((addr & mask) >> shift);
+    }
+};
+
+// Bank conflicts of one warp access
+struct WarpBankConflicts {
+    uint32_t wavefronts = 0;           // Bank cycles needed; the most distinct words in one bank
+    uint32_t ideal_wavefronts = 0;     // Cycles needed with no conflicts (distinct words / banks)
+    uint32_t unique_words = 0;         // Distinct bank words touched
+    uint32_t broadcast_words = 0;      // Lane words served by broadcast of a word another lane reads
+    std::vector<uint32_t> bank_words;  // Distinct words (or atomic lanes) per bank
+
+    // n of an n-way bank conflict (1 = conflict-free)
+    uint32_t conflict_degree() const {
+        return ideal_wavefronts > 0 ? (wavefronts + ideal_wavefronts - 1) / ideal_wavefronts : 0;
+    }
+};
+
+// Accumulated bank conflict statistics
+struct BankConflictStats {
+    uint64_t accesses = 0;
+    uint64_t wavefronts = 0;
+    uint64_t ideal_wavefronts = 0;
+    uint64_t conflicted_accesses = 0;
+    uint64_t broadcast_words = 0;
+
+    // Average bank cycles per access relative to conflict-free
+    double slowdown() const {
+        return ideal_wavefronts > 0 ? static_cast<double>(wavefronts) / ideal_wavefronts : 0.0;
+    }
+};
+
+// Warp-wide shared memory bank model
+//
+// Resolves all active lanes of a warp access in one step. Each lane's
+// bytes are swizzled, split into bank words and mapped to banks; lanes
+// reading the same word share it (broadcast/multicast), so a bank needs
+// one cycle per distinct word. Atomics never share: every lane is a
+// separate read-modify-write of its bank.
+class SharedMemoryBankModel {
+public:
+    // Constructor (power-of-two bank count)
+    explicit SharedMemoryBankModel(uint32_t num_banks = 32,
+                                   SharedMemoryBankMode mode = SharedMemoryBankMode::FOUR_BYTE);
+
+    // Configuration. Changing the mode restores the default mapping of
+    // consecutive bank words to consecutive banks.
+    void set_mode(SharedMemoryBankMode mode);
+    void set_mapping(const AddressMapping& mapping);
+    void set_swizzle(const SharedMemorySwizzle& swizzle) { swizzle_ = swizzle; }
+    SharedMemoryBankMode mode() const { return mode_; }
+    uint32_t num_banks() const { return num_banks_; }
+    uint32_t bank_width() const { return 1u << width_bits_; }
+    const AddressMapping& mapping() const { return mapping_; }
+    const SharedMemorySwizzle& swizzle() const { return swizzle_; }
+
+    // Bank of one byte address
+    uint32_t bank(uint64_t addr) const { return mapping_.index(swizzle_.apply(addr)); }
+
+    // Resolve a warp access and accumulate statistics
+    WarpBankConflicts resolve(const WarpMemoryAccess& access);
+
+    // Statistics
+    const BankConflictStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = BankConflictStats(); }
+
+    // Checkpointing (the layout must match; statistics are restored)
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    uint32_t num_banks_;
+    SharedMemoryBankMode mode_;
+    uint32_t width_bits_;
+    AddressMapping mapping_;
+    SharedMemorySwizzle swizzle_;
+    BankConflictStats stats_;
+
+    // (bank, word) pairs of the current access, reused between calls
+    std::vector<std::pair<uint32_t, uint64_t>> touched_;
+};
+
+#endif // SHARED_MEMORY_BANKS_H
@@ -0,0 +1,297 @@
+#include "sparse_memory.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+const uint64_t NO_PAGE = ~0ULL;
+
+}  // namespace
+
+SparseMemory::SparseMemory(uint64_t size_bytes, const Config& config)
+    : size_bytes_(size_bytes),
+      backing_(config.backing),
+      page_size_(config.page_size),
+      page_shift_(0),
+      page_mask_(0),
+      num_pages_(0),
+      touched_page_count_(0),
+      read_cache_page_(NO_PAGE),
+      read_cache_data_(nullptr),
+      write_cache_page_(NO_PAGE),
+      write_cache_data_(nullptr),
+      base_(nullptr),
+      mapping_size_(0),
+      file_fd_(-1) {
+    if (page_size_ != SMALL_PAGE_SIZE && page_size_ != LARGE_PAGE_SIZE) {
+        throw std::invalid_argument("SparseMemory page size must be 4 KB or 2 MB");
+    }
+    while ((1ULL << page_shift_) < page_size_) {
+        page_shift_++;
+    }
+    page_mask_ = page_size_ - 1;
+    num_pages_ = (size_bytes_ + page_mask_) >> page_shift_;
+    dirty_bitmap_.assign((num_pages_ + 63) / 64, 0);
+    
+    if (backing_ == Backing::SPARSE_PAGES) {
+        directory_.resize((num_pages_ + LEAF_ENTRIES - 1) >> LEAF_SHIFT);
+        return;
+    }
+    
+    // mmap backings
+    mapping_size_ = num_pages_ << page_shift_;
+    touched_bitmap_.assign((num_pages_ + 63) / 64, 0);
+    int flags = MAP_NORESERVE;
+    uint64_t file_size = 0;
+    if (backing_ == Backing::FILE_MMAP) {
+        file_fd_ = ::open(config.file_path.c_str(), O_RDWR | O_CREAT, 0644);
+        struct stat file_stat;
+        if (file_fd_ >= 0 && ::fstat(file_fd_, &file_stat) == 0) {
+            file_size = static_cast<uint64_t>(file_stat.st_size);
+        }
+        if (file_fd_ < 0 || ::ftruncate(file_fd_, mapping_size_) != 0) {
+            if (file_fd_ >= 0) {
+                ::close(file_fd_);
+            }
+            throw std::runtime_error("Cannot create memory backing file: " + config.file_path);
+        }
+        flags |= MAP_SHARED;
+    } else {
+        flags |= MAP_PRIVATE | MAP_ANONYMOUS;
+    }
+    void* mapping = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, flags, file_fd_, 0);
+    if (mapping == MAP_FAILED) {
+        if (file_fd_ >= 0) {
+            ::close(file_fd_);
+        }
+        throw std::runtime_error("Cannot map simulated memory");
+    }
+    base_ = static_cast<uint8_t*>(mapping);
+    if (page_size_ == LARGE_PAGE_SIZE) {
+        ::madvise(base_, mapping_size_, MADV_HUGEPAGE);
+    }
+    mark_preloaded_pages(file_size);
+}
+
+SparseMemory::~SparseMemory() {
+    if (base_ != nullptr) {
+        ::munmap(base_, mapping_size_);
+    }
+    if (file_fd_ >= 0) {
+        ::close(file_fd_);
+    }
+}
+
+void SparseMemory::read_block(uint64_t addr, uint8_t* data, uint64_t size) const {
+    if (size == 0) {
+        return;
+    }
+    check_range(addr, size);
+    if (base_ != nullptr) {
+        std::memcpy(data, base_ + addr, size);
+        return;
+    }
+    while (size > 0) {
+        uint64_t offset = addr & page_mask_;
+        uint64_t chunk = std::min<uint64_t>(size, page_size_ - offset);
+        const uint8_t* page = lookup_page(addr >> page_shift_);
+        if (page != nullptr) {
+            std::memcpy(data, page + offset, chunk);
+        } else {
+            std::memset(data, 0, chunk);
+        }
+        addr += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+void SparseMemory::write_block(uint64_t addr, const uint8_t* data, uint64_t size) {
+    if (size == 0) {
+        return;
+    }
+    check_range(addr, size);
+    while (size > 0) {
+        uint64_t offset = addr & page_mask_;
+        uint64_t chunk = std::min<uint64_t>(size, page_size_ - offset);
+        uint64_t page = addr >> page_shift_;
+        if (base_ != nullptr) {
+            mark_touched(page);
+            std::memcpy(base_ + addr, data, chunk);
+        } else {
+            std::memcpy(allocate_page(page) + offset, data, chunk);
+        }
+        mark_dirty(page);
+        addr += chunk;
+        data += chunk;
+        size -= chunk;
+    }
+}
+
+void SparseMemory::fill(uint64_t addr, uint8_t value, uint64_t size) {
+    if (size == 0) {
+        return;
+    }
+    check_range(addr, size);
+    while (size > 0) {
+        uint64_t offset = addr & page_mask_;
+        uint64_t chunk = std::min<uint64_t>(size, page_size_ - offset);
+        uint64_t page = addr >> page_shift_;
+        if (base_ != nullptr) {
+            mark_touched(page);
+            mark_dirty(page);
+            std::memset(base_ + addr, value, chunk);
+        } else if (value != 0 || lookup_page(page) != nullptr) {
+            // Zero fills of untouched pages need no storage
+            std::memset(allocate_page(page) + offset, value, chunk);
+            mark_dirty(page);
+        }
+        addr += chunk;
+        size -= chunk;
+    }
+}
+
+void SparseMemory::clear() {
+    // Every page that held data now reads as zero
+    for (uint64_t page : touched_pages()) {
+        mark_dirty(page);
+    }
+    if (base_ == nullptr) {
+        for (auto& leaf : directory_) {
+            leaf.reset();
+        }
+    } else {
+        for (uint64_t page : touched_pages()) {
+            uint8_t* data = base_ + (page << page_shift_);
+            if (backing_ == Backing::ANONYMOUS_MMAP) {
+                ::madvise(data, page_size_, MADV_DONTNEED);  // Releases and zeroes
+            } else {
+                std::memset(data, 0, page_size_);
+            }
+        }
+        std::fill(touched_bitmap_.begin(), touched_bitmap_.end(), 0);
+    }
+    touched_page_count_ = 0;
+    invalidate_caches();
+}
+
+std::vector<uint64_t> SparseMemory::touched_pages() const {
+    std::vector<uint64_t> pages;
+    pages.reserve(touched_page_count_);
+    if (base_ != nullptr) {
+        for (uint64_t w = 0; w < touched_bitmap_.size(); w++) {
+            uint64_t word = touched_bitmap_[w];
+            while (word != 0) {
+                pages.push_back(w * 64 + __builtin_ctzll(word));
+                word &= word - 1;
+            }
+        }
+        return pages;
+    }
+    for (uint64_t l = 0; l < directory_.size(); l++) {
+        if (!directory_[l]) {
+            continue;
+        }
+        for (uint32_t e = 0; e < LEAF_ENTRIES; e++) {
+            if (directory_[l]->pages[e]) {
+                pages.push_back((l << LEAF_SHIFT) | e);
+            }
+        }
+    }
+    return pages;
+}
+
+const uint8_t* SparseMemory::page_data(uint64_t page) const {
+    if (base_ != nullptr) {
+        return page < num_pages_ ? base_ + (page << page_shift_) : nullptr;
+    }
+    return lookup_page(page);
+}
+
+uint8_t* SparseMemory::host_page(uint64_t page) {
+    if (page >= num_pages_) {
+        throw std::out_of_range("SparseMemory access beyond end of memory");
+    }
+    if (base_ != nullptr) {
+        mark_touched(page);
+        mark_dirty(page);
+        return base_ + (page << page_shift_);
+    }
+    uint8_t* data = allocate_page(page);
+    mark_dirty(page);
+    return data;
+}
+
+std::vector<uint64_t> SparseMemory::dirty_pages() const {
+    std::vector<uint64_t> pages;
+    for (uint64_t w = 0; w < dirty_bitmap_.size(); w++) {
+        uint64_t word = dirty_bitmap_[w];
+        while (word != 0) {
+            pages.push_back(w * 64 + __builtin_ctzll(word));
+            word &= word - 1;
+        }
+    }
+    return pages;
+}
+
+void SparseMemory::clear_dirty() {
+    std::fill(dirty_bitmap_.begin(), dirty_bitmap_.end(), 0);
+    // The cached write page must be marked again on its next write
+    write_cache_page_ = NO_PAGE;
+    write_cache_data_ = nullptr;
+}
+
+const uint8_t* SparseMemory::lookup_page(uint64_t page) const {
+    uint64_t leaf = page >> LEAF_SHIFT;
+    if (leaf >= directory_.size() || !directory_[leaf]) {
+        return nullptr;
+    }
+    return directory_[leaf]->pages[page & (LEAF_ENTRIES - 1)].get();
+}
+
+uint8_t* SparseMemory::allocate_page(uint64_t page) {
+    uint64_t leaf = page >> LEAF_SHIFT;
+    if (leaf >= directory_.size()) {
+        throw std::out_of_range("SparseMemory access beyond end of memory");
+    }
+    if (!directory_[leaf]) {
+        directory_[leaf].reset(new Leaf());
+    }
+    std::unique_ptr<uint8_t[]>& entry = directory_[leaf]->pages[page & (LEAF_ENTRIES - 1)];
+    if (!entry) {
+        entry.reset(new uint8_t[page_size_]());
+        touched_page_count_++;
+        if (read_cache_page_ == page) {
+            read_cache_data_ = entry.get();
+        }
+    }
+    return entry.get();
+}
+
+void SparseMemory::mark_preloaded_pages(uint64_t file_size) {
+    // Contents of an existing file are memory state like any written page
+    uint64_t preloaded_pages = std::min(num_pages_, (file_size + page_mask_) >> page_shift_);
+    for (uint64_t page = 0; page < preloaded_pages; page++) {
+        const uint64_t* words = reinterpret_cast<const uint64_t*>(base_ + (page << page_shift_));
+        uint64_t num_words = page_size_ / sizeof(uint64_t);
+        for (uint64_t w = 0; w < num_words; w++) {
+            if (words[w] != 0) {
+                mark_touched(page);
+                mark_dirty(page);
+                break;
+            }
+        }
+    }
+}
+
+void SparseMemory::invalidate_caches() {
+    read_cache_page_ = NO_PAGE;
+    read_cache_data_ = nullptr;
+    write_cache_page_ = NO_PAGE;
+    write_cache_data_ = nullptr;
+}
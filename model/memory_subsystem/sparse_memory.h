@@ -0,0 +1,172 @@
+#ifndef SPARSE_MEMORY_H
+#define SPARSE_MEMORY_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+// Host storage used for the simulated memory
+enum class SparseMemoryBacking {
+    SPARSE_PAGES,
+    ANONYMOUS_MMAP,
+    FILE_MMAP
+};
+
+// Backing store configuration
+struct SparseMemoryConfig {
+    SparseMemoryBacking backing = SparseMemoryBacking::SPARSE_PAGES;
+    uint32_t page_size = 4096;    // 4 KB or 2 MB
+    std::string file_path;        // FILE_MMAP only
+};
+
+// Sparse byte-addressable backing store for large simulated memories
+//
+// Storage is allocated lazily so elaboration cost and host RSS are
+// proportional to the memory actually touched, not the simulated size.
+//
+// SPARSE_PAGES    two-level page table of lazily allocated, zero-filled
+//                 pages (4 KB or 2 MB); reads of untouched pages return 0
+//                 without allocating
+// ANONYMOUS_MMAP  one MAP_NORESERVE anonymous mapping; the host kernel
+//                 provides the pages on first touch
+// FILE_MMAP       a shared mapping of a file, so memory images persist and
+//                 can be preloaded or inspected outside the simulator;
+//                 non-zero pages of an existing file count as touched
+//
+// Every access must lie below size() and throws std::out_of_range
+// otherwise, whatever the backing.
+class SparseMemory {
+public:
+    using Backing = SparseMemoryBacking;
+    using Config = SparseMemoryConfig;
+    
+    static const uint32_t SMALL_PAGE_SIZE = 4096;
+    static const uint32_t LARGE_PAGE_SIZE = 2 * 1024 * 1024;
+    
+    // Constructor (throws std::runtime_error if a mapping cannot be created)
+    explicit SparseMemory(uint64_t size_bytes, const Config& config = Config());
+    ~SparseMemory();
+    
+    SparseMemory(const SparseMemory&) = delete;
+    SparseMemory& operator=(const SparseMemory&) = delete;
+    
+    // Single byte access (fast paths)
+    uint8_t read_byte(uint64_t addr) const {
+        check_range(addr, 1);
+        if (base_ != nullptr) {
+            return base_[addr];
+        }
+        uint64_t page = addr >> page_shift_;
+        if (page != read_cache_page_) {
+            read_cache_page_ = page;
+            read_cache_data_ = lookup_page(page);
+        }
+        return read_cache_data_ != nullptr ? read_cache_data_[addr & page_mask_] : 0;
+    }
+    
+    void write_byte(uint64_t addr, uint8_t data) {
+        check_range(addr, 1);
+        uint64_t page = addr >> page_shift_;
+        if (base_ != nullptr) {
+            mark_touched(page);
+            mark_dirty(page);
+            base_[addr] = data;
+            return;
+        }
+        if (page != write_cache_page_) {
+            write_cache_page_ = page;
+            write_cache_data_ = allocate_page(page);
+            mark_dirty(page);
+        }
+        write_cache_data_[addr & page_mask_] = data;
+    }
+    
+    // Bulk access; ranges may span pages
+    void read_block(uint64_t addr, uint8_t* data, uint64_t size) const;
+    void write_block(uint64_t addr, const uint8_t* data, uint64_t size);
+    void fill(uint64_t addr, uint8_t value, uint64_t size);
+    
+    // Drop all contents (memory reads as zero afterwards)
+    void clear();
+    
+    // Properties
+    uint64_t size() const { return size_bytes_; }
+    uint32_t page_size() const { return page_size_; }
+    Backing backing() const { return backing_; }
+    uint64_t resident_bytes() const { return touched_page_count_ * page_size_; }
+    
+    // Page enumeration (page indices in units of page_size())
+    std::vector<uint64_t> touched_pages() const;
+    const uint8_t* page_data(uint64_t page) const;
+    
+    // Writable host storage of a page, allocated on demand (direct memory
+    // interfaces); valid until clear() or destruction. The page counts as
+    // written.
+    uint8_t* host_page(uint64_t page);
+    
+    // Dirty-page tracking for incremental checkpoints: every write path
+    // (including clear() and host_page()) marks the pages it may change
+    // until clear_dirty() starts a new epoch
+    std::vector<uint64_t> dirty_pages() const;
+    void clear_dirty();
+    
+private:
+    uint64_t size_bytes_;
+    Backing backing_;
+    uint32_t page_size_;
+    uint32_t page_shift_;
+    uint64_t page_mask_;
+    uint64_t num_pages_;
+    uint64_t touched_page_count_;
+    
+    // Page table: directory of leaves, each holding LEAF_ENTRIES pages
+    static const uint32_t LEAF_SHIFT = 9;
+    static const uint32_t LEAF_ENTRIES = 1u << LEAF_SHIFT;
+    struct Leaf {
+        std::unique_ptr<uint8_t[]> pages[LEAF_ENTRIES];
+    };
+    std::vector<std::unique_ptr<Leaf>> directory_;
+    
+    // Single-entry translation caches for the byte fast paths
+    mutable uint64_t read_cache_page_;
+    mutable const uint8_t* read_cache_data_;
+    uint64_t write_cache_page_;
+    uint8_t* write_cache_data_;
+    
+    // mmap backings: base of the mapping and a touched-page bitmap
+    uint8_t* base_;
+    uint64_t mapping_size_;
+    int file_fd_;
+    std::vector<uint64_t> touched_bitmap_;
+    
+    // Pages written since the last clear_dirty()
+    std::vector<uint64_t> dirty_bitmap_;
+    
+    // Helper methods
+    void check_range(uint64_t addr, uint64_t size) const {
+        if (addr >= size_bytes_ || size > size_bytes_ - addr) {
+            throw std::out_of_range("SparseMemory access beyond end of memory");
+        }
+    }
+    const uint8_t* lookup_page(uint64_t page) const;
+    uint8_t* allocate_page(uint64_t page);
+    void mark_touched(uint64_t page) {
+        if (page >= num_pages_) {
+            throw std::out_of_range("SparseMemory access beyond end of memory");
+        }
+        uint64_t& word = touched_bitmap_[page >> 6];
+        uint64_t bit = 1ULL << (page & 63);
+        if ((word & bit) == 0) {
+            word |= bit;
+            touched_page_count_++;
+        }
+    }
+    void mark_dirty(uint64_t page) { dirty_bitmap_[page >> 6] |= 1ULL << (page & 63); }
+    void invalidate_caches();
+    void mark_preloaded_pages(uint64_t file_size);
+};
+
+#endif // SPARSE_MEMORY_H
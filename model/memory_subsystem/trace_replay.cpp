@@ -0,0 +1,181 @@
+#include "trace_replay.h"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace {
+
+bool is_power_of_two(uint32_t value) {
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+}  // namespace
+
+ReplayCacheConfig::ReplayCacheConfig(uint32_t size_bytes, uint32_t line_size, uint32_t associativity)
+    : size_bytes(size_bytes),
+      line_size(line_size),
+      associativity(associativity) {
+    if (!is_power_of_two(line_size) || associativity == 0 || size_bytes < line_size * associativity) {
+        throw std::invalid_argument("Cache geometry needs a power-of-two line size and at least one set");
+    }
+    uint32_t offset_bits = static_cast<uint32_t>(__builtin_ctz(line_size));
+    uint32_t sets = num_sets();
+    index_mapping = is_power_of_two(sets)
+                        ? AddressMapping::bit_slice(offset_bits, static_cast<uint32_t>(__builtin_ctz(sets)))
+                        : AddressMapping::modulo(offset_bits, sets);
+}
+
+TraceReplayer::Level::Level(const ReplayCacheConfig& config)
+    : line_size(config.line_size),
+      mapping(config.index_mapping),
+      lines(config.num_sets(), config.associativity, config.line_size, false),
+      replacement(config.num_sets(), config.associativity),
+      sliced(false),
+      shift(static_cast<uint32_t>(__builtin_ctz(config.line_size))),
+      set_mask(config.num_sets() - 1),
+      last_tag(CacheArray::INVALID_TAG),
+      last_set(0),
+      last_way(0) {
+    if (mapping.num_indices() != config.num_sets()) {
+        throw std::invalid_argument("Set index mapping must have one index per set");
+    }
+    if (is_power_of_two(config.num_sets())) {
+        AddressMapping slice = AddressMapping::bit_slice(shift, static_cast<uint32_t>(__builtin_ctz(config.num_sets())));
+        sliced = mapping.to_string() == slice.to_string();
+    }
+}
+
+TraceReplayer::TraceReplayer(const TraceReplayConfig& config)
+    : config_(config),
+      l2_(config.l2) {
+    if (config.num_l1s == 0) {
+        throw std::invalid_argument("Trace replay needs at least one L1");
+    }
+    l1s_.reserve(config.num_l1s);
+    for (uint32_t i = 0; i < config.num_l1s; i++) {
+        l1s_.emplace_back(config.l1);
+    }
+}
+
+void TraceReplayer::access(const TraceRecord& record) {
+    stats_.accesses++;
+    Level& l1 = l1s_[record.source % config_.num_l1s];
+    bool evicted_dirty = false;
+    uint64_t writeback = 0;
+
+    switch (record.type) {
+        case MemoryTransactionType::READ:
+        case MemoryTransactionType::WRITE: {
+            bool write = record.type == MemoryTransactionType::WRITE;
+            (write ? stats_.writes : stats_.reads)++;
+            bool hit = lookup(l1, stats_.l1, record.address, write, evicted_dirty, writeback);
+            if (evicted_dirty) {
+                stats_.l1_writebacks++;
+                l2_access(writeback, true);
+            }
+            if (!hit) {
+                l2_access(record.address, false);
+            }
+            break;
+        }
+
+        default: {
+            // Atomics execute at the L2; the issuing L1 gives up its copy
+            stats_.atomics++;
+            uint32_t set = l1.set_of(record.address);
+            int32_t way = l1.lines.find(set, record.address / l1.line_size);
+            if (way >= 0) {
+                if (l1.lines.dirty(set, static_cast<uint32_t>(way))) {
+                    stats_.l1_writebacks++;
+                    l2_access(record.address, true);
+                }
+                l1.lines.invalidate(set, static_cast<uint32_t>(way));
+                l1.last_tag = CacheArray::INVALID_TAG;
+                l1.replacement.on_invalidate(set, static_cast<uint32_t>(way));
+            }
+            l2_access(record.address, true);
+            break;
+        }
+    }
+}
+
+uint64_t TraceReplayer::replay(MemoryTraceReader& reader, uint64_t max_records) {
+    auto host_start = std::chrono::steady_clock::now();
+    TraceRecord record;
+    uint64_t applied = 0;
+    while (applied < max_records && reader.next(record)) {
+        access(record);
+        applied++;
+    }
+    std::chrono::duration<double> host_time = std::chrono::steady_clock::now() - host_start;
+    stats_.host_seconds += host_time.count();
+    return applied;
+}
+
+void TraceReplayer::reset() {
+    for (Level& l1 : l1s_) {
+        l1.lines.clear();
+        l1.replacement.reset();
+        l1.last_tag = CacheArray::INVALID_TAG;
+    }
+    l2_.lines.clear();
+    l2_.replacement.reset();
+    l2_.last_tag = CacheArray::INVALID_TAG;
+    stats_ = TraceReplayStats();
+}
+
+bool TraceReplayer::lookup(Level& level, ReplacementStats& stats, uint64_t addr, bool write,
+                           bool& evicted_dirty, uint64_t& writeback) {
+    uint64_t tag = addr / level.line_size;
+    evicted_dirty = false;
+    if (tag == level.last_tag) {
+        // Same line as the previous access: still resident, and re-referencing
+        // it again leaves every policy's state unchanged apart from the count
+        stats.hits++;
+        level.replacement.on_hit(level.last_set, level.last_way);
+        if (write) {
+            level.lines.set_dirty(level.last_set, level.last_way, true);
+        }
+        return true;
+    }
+
+    uint32_t set = level.set_of(addr);
+    int32_t way = level.lines.find(set, tag);
+    bool hit = way >= 0;
+    if (hit) {
+        stats.hits++;
+        level.replacement.on_hit(set, static_cast<uint32_t>(way));
+    } else {
+        stats.misses++;
+        way = level.lines.find_invalid(set);
+        if (way < 0) {
+            way = static_cast<int32_t>(level.replacement.victim(set));
+            stats.evictions++;
+            evicted_dirty = level.lines.dirty(set, static_cast<uint32_t>(way));
+            writeback = level.lines.tag(set, static_cast<uint32_t>(way)) * level.line_size;
+        }
+        level.lines.fill(set, static_cast<uint32_t>(way), tag, nullptr);
+        level.replacement.on_fill(set, static_cast<uint32_t>(way));
+    }
+    if (write) {
+        level.lines.set_dirty(set, static_cast<uint32_t>(way), true);
+    }
+    level.last_tag = tag;
+    level.last_set = set;
+    level.last_way = static_cast<uint32_t>(way);
+    return hit;
+}
+
+void TraceReplayer::l2_access(uint64_t addr, bool write) {
+    bool evicted_dirty = false;
+    uint64_t writeback = 0;
+    if (!lookup(l2_, stats_.l2, addr, write, evicted_dirty, writeback)) {
+        stats_.dram_reads++;
+        stats_.dram_bytes += l2_.line_size;
+    }
+    if (evicted_dirty) {
+        stats_.l2_writebacks++;
+        stats_.dram_writes++;
+        stats_.dram_bytes += l2_.line_size;
+    }
+}
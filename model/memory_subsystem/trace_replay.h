@@ -0,0 +1,133 @@
+#ifndef TRACE_REPLAY_H
+#define TRACE_REPLAY_H
+
+#include <vector>
+#include <cstdint>
+#include "memory_trace.h"
+#include "cache_array.h"
+#include "replacement_policy.h"
+#include "address_mapping.h"
+#include "cache_l1.h"
+#include "cache_l2.h"
+
+// Geometry and set mapping of one replayed cache level
+struct ReplayCacheConfig {
+    uint32_t size_bytes;
+    uint32_t line_size;
+    uint32_t associativity;
+    AddressMapping index_mapping;   // A bit slice above the line offset unless set
+
+    // Constructor (throws std::invalid_argument for a degenerate geometry)
+    ReplayCacheConfig(uint32_t size_bytes, uint32_t line_size, uint32_t associativity);
+
+    uint32_t num_sets() const { return size_bytes / (line_size * associativity); }
+
+    // Same geometry and set mapping as a timed cache
+    static ReplayCacheConfig of(const CacheL1& cache) {
+        ReplayCacheConfig config(cache.size(), cache.line_size(), cache.associativity());
+        config.index_mapping = cache.index_mapping();
+        return config;
+    }
+    static ReplayCacheConfig of(const CacheL2& cache) {
+        ReplayCacheConfig config(cache.size(), cache.line_size(), cache.associativity());
+        config.index_mapping = cache.index_mapping();
+        return config;
+    }
+};
+
+// Replayed hierarchy: one L1 per core in front of a shared L2. The defaults
+// match the CacheL1 and CacheL2 constructor defaults.
+struct TraceReplayConfig {
+    ReplayCacheConfig l1 = ReplayCacheConfig(64 * 1024, 64, 4);
+    ReplayCacheConfig l2 = ReplayCacheConfig(2 * 1024 * 1024, 128, 8);
+    uint32_t num_l1s = 1;   // Records select L1 source % num_l1s
+};
+
+// Hierarchy statistics of a replay
+struct TraceReplayStats {
+    uint64_t accesses = 0;
+    uint64_t reads = 0;
+    uint64_t writes = 0;
+    uint64_t atomics = 0;
+    ReplacementStats l1;        // Summed over all L1s
+    ReplacementStats l2;        // Demand fills and L1 writebacks
+    uint64_t l1_writebacks = 0;
+    uint64_t l2_writebacks = 0;
+    uint64_t dram_reads = 0;    // Line fills from global memory
+    uint64_t dram_writes = 0;   // Dirty L2 evictions
+    uint64_t dram_bytes = 0;
+    double host_seconds = 0.0;
+
+    double accesses_per_second() const { return host_seconds > 0.0 ? accesses / host_seconds : 0.0; }
+};
+
+// Trace-driven replay of the cache hierarchy without the shader core
+//
+// Each record is applied to tag-only copies of the L1s and the L2 built
+// from the same CacheArray, replacement policy and set mapping as CacheL1
+// and CacheL2, with their default write-back, write-allocate policy.
+// Loads and stores look up the issuing core's L1; misses fill from the L2
+// and dirty victims are written back to it. Atomics execute at the L2 (the
+// issuing L1's copy is written back and dropped). L2 misses and dirty L2
+// victims are global memory traffic. There is no timing: records are
+// applied in trace order, one line per access, so hit, miss and writeback
+// counts match an in-order run of the timed hierarchy while replay runs at
+// host memory speed.
+class TraceReplayer {
+public:
+    // Constructor
+    explicit TraceReplayer(const TraceReplayConfig& config = TraceReplayConfig());
+
+    // Apply one access
+    void access(const TraceRecord& record);
+
+    // Apply records until the end of the trace or max_records; returns the
+    // number applied
+    uint64_t replay(MemoryTraceReader& reader, uint64_t max_records = ~0ULL);
+
+    // Configuration and statistics
+    const TraceReplayConfig& config() const { return config_; }
+    const TraceReplayStats& stats() const { return stats_; }
+
+    // Empty the caches and clear statistics
+    void reset();
+
+private:
+    // One replayed cache
+    struct Level {
+        uint32_t line_size;
+        AddressMapping mapping;
+        CacheArray lines;
+        CacheReplacementPolicy replacement;
+
+        // Plain bit-slice mappings are applied as a shift and mask
+        bool sliced;
+        uint32_t shift;
+        uint32_t set_mask;
+
+        // Most recently referenced line; runs of accesses to one line skip
+        // the tag search
+        uint64_t last_tag;
+        uint32_t last_set;
+        uint32_t last_way;
+
+        explicit Level(const ReplayCacheConfig& config);
+        uint32_t set_of(uint64_t addr) const {
+            return sliced ? static_cast<uint32_t>(addr >> shift) & set_mask : mapping.index(addr);
+        }
+    };
+
+    TraceReplayConfig config_;
+    std::vector<Level> l1s_;
+    Level l2_;
+    TraceReplayStats stats_;
+
+    // Look up addr, filling on a miss and counting into stats; returns
+    // true on a hit. A dirty victim's line address is returned through
+    // writeback.
+    bool lookup(Level& level, ReplacementStats& stats, uint64_t addr, bool write,
+                bool& evicted_dirty, uint64_t& writeback);
+    void l2_access(uint64_t addr, bool write);
+};
+
+#endif // TRACE_REPLAY_H
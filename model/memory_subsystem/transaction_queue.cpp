@@ -0,0 +1,146 @@
+#include "transaction_queue.h"
+
+#include <algorithm>
+
+TransactionQueue::TransactionQueue(uint32_t max_size)
+    : max_size_(max_size),
+      order_(Order::ARRIVAL),
+      next_seq_(0) {
+}
+
+bool TransactionQueue::push(const MemoryTransaction& transaction) {
+    if (is_full()) {
+        return false;
+    }
+    uint64_t seq = next_seq_++;
+    entries_.emplace(seq, transaction);
+    id_index_.emplace(transaction.id(), seq);
+    address_index_.emplace(transaction.address(), seq);
+    sizes_.insert(std::max<uint32_t>(transaction.size(), 1));
+    return true;
+}
+
+bool TransactionQueue::pop(MemoryTransaction& transaction) {
+    if (is_empty()) {
+        return false;
+    }
+    uint64_t seq = front_seq();
+    transaction = entries_.at(seq);
+    erase(seq);
+    return true;
+}
+
+bool TransactionQueue::peek(MemoryTransaction& transaction) const {
+    if (is_empty()) {
+        return false;
+    }
+    transaction = entries_.at(front_seq());
+    return true;
+}
+
+bool TransactionQueue::is_empty() const {
+    return entries_.empty();
+}
+
+bool TransactionQueue::is_full() const {
+    return entries_.size() >= max_size_;
+}
+
+uint32_t TransactionQueue::size() const {
+    return static_cast<uint32_t>(entries_.size());
+}
+
+uint32_t TransactionQueue::capacity() const {
+    return max_size_;
+}
+
+bool TransactionQueue::has_transaction(uint32_t id) const {
+    auto it = id_index_.lower_bound({id, 0});
+    return it != id_index_.end() && it->first == id;
+}
+
+bool TransactionQueue::get_transaction(uint32_t id, MemoryTransaction& transaction) const {
+    auto it = id_index_.lower_bound({id, 0});
+    if (it == id_index_.end() || it->first != id) {
+        return false;
+    }
+    transaction = entries_.at(it->second);
+    return true;
+}
+
+bool TransactionQueue::remove_transaction(uint32_t id) {
+    auto it = id_index_.lower_bound({id, 0});
+    if (it == id_index_.end() || it->first != id) {
+        return false;
+    }
+    erase(it->second);
+    return true;
+}
+
+template <typename Visitor>
+void TransactionQueue::for_each_conflict(uint64_t address, uint32_t size, Visitor visit) const {
+    if (entries_.empty()) {
+        return;
+    }
+    // A transaction overlapping the query starts at most max_size - 1 bytes below it
+    uint64_t max_size = *sizes_.rbegin();
+    uint64_t low = address >= max_size ? address - max_size + 1 : 0;
+    uint64_t end = address + std::max<uint32_t>(size, 1);
+    for (auto it = address_index_.lower_bound({low, 0}); it != address_index_.end() && it->first < end; ++it) {
+        const MemoryTransaction& transaction = entries_.at(it->second);
+        if (address_overlaps(address, size, transaction.address(), transaction.size()) && !visit(transaction)) {
+            return;
+        }
+    }
+}
+
+bool TransactionQueue::has_address_conflict(uint64_t address, uint32_t size) const {
+    bool found = false;
+    for_each_conflict(address, size, [&found](const MemoryTransaction&) {
+        found = true;
+        return false;
+    });
+    return found;
+}
+
+std::vector<uint32_t> TransactionQueue::get_conflicting_transactions(uint64_t address, uint32_t size) const {
+    std::vector<uint32_t> conflicts;
+    for_each_conflict(address, size, [&conflicts](const MemoryTransaction& transaction) {
+        conflicts.push_back(transaction.id());
+        return true;
+    });
+    return conflicts;
+}
+
+void TransactionQueue::clear() {
+    entries_.clear();
+    id_index_.clear();
+    address_index_.clear();
+    sizes_.clear();
+}
+
+bool TransactionQueue::address_overlaps(uint64_t addr1, uint32_t size1, uint64_t addr2, uint32_t size2) const {
+    // Zero-sized accesses still touch their first byte
+    return addr1 < addr2 + std::max<uint32_t>(size2, 1) && addr2 < addr1 + std::max<uint32_t>(size1, 1);
+}
+
+uint64_t TransactionQueue::front_seq() const {
+    switch (order_) {
+        case Order::ADDRESS:
+            return address_index_.begin()->second;
+        case Order::ID:
+            return id_index_.begin()->second;
+        case Order::ARRIVAL:
+        default:
+            return entries_.begin()->first;
+    }
+}
+
+void TransactionQueue::erase(uint64_t seq) {
+    auto it = entries_.find(seq);
+    const MemoryTransaction& transaction = it->second;
+    id_index_.erase({transaction.id(), seq});
+    address_index_.erase({transaction.address(), seq});
+    sizes_.erase(sizes_.find(std::max<uint32_t>(transaction.size(), 1)));
+    entries_.erase(it);
+}
@@ -1,53 +1,88 @@
 #ifndef TRANSACTION_QUEUE_H
 #define TRANSACTION_QUEUE_H
 
-#include <queue>
-#include <unordered_map>
+#include <map>
+#include <set>
 #include <vector>
+#include <utility>
+#include <cstdint>
 #include "memory_transaction.h"
 
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
 // Transaction queue for memory subsystem
+//
+// Transactions are stored once, keyed by an arrival sequence number, and
+// indexed by ID and by start address. The address index answers overlap
+// queries in O(log n + k): only transactions starting within the largest
+// queued size below the query can reach it. The same indices give the
+// address and ID pop orders, so reordering never re-sorts the queue.
 class TransactionQueue {
 public:
+    // Order in which pop() and peek() return transactions
+    enum class Order : uint8_t { ARRIVAL, ADDRESS, ID };
+
     // Constructor
     TransactionQueue(uint32_t max_size = 32);
-    
+
     // Queue operations
     bool push(const MemoryTransaction& transaction);
     bool pop(MemoryTransaction& transaction);
     bool peek(MemoryTransaction& transaction) const;
-    
+
     // Queue state
     bool is_empty() const;
     bool is_full() const;
     uint32_t size() const;
     uint32_t capacity() const;
-    
-    // Transaction management
+
+    // Transaction management (the oldest transaction wins on duplicate IDs)
     bool has_transaction(uint32_t id) const;
     bool get_transaction(uint32_t id, MemoryTransaction& transaction) const;
     bool remove_transaction(uint32_t id);
-    
-    // Reordering capabilities
-    void reorder_by_address();
-    void reorder_by_id();
-    
-    // Conflict detection
+
+    // Reordering capabilities. The order stays in effect for transactions
+    // pushed later, until changed again.
+    void reorder_by_address() { order_ = Order::ADDRESS; }
+    void reorder_by_id() { order_ = Order::ID; }
+    void reorder_by_arrival() { order_ = Order::ARRIVAL; }
+    Order order() const { return order_; }
+
+    // Conflict detection (results in address order)
     bool has_address_conflict(uint64_t address, uint32_t size) const;
     std::vector<uint32_t> get_conflicting_transactions(uint64_t address, uint32_t size) const;
-    
+
     // Reset
     void clear();
-    
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
 private:
     uint32_t max_size_;
-    std::queue<MemoryTransaction> queue_;
-    std::unordered_map<uint32_t, MemoryTransaction> id_map_;
-    std::unordered_map<uint64_t, std::vector<uint32_t>> address_map_;
-    
+    Order order_;
+    uint64_t next_seq_;
+
+    // Transactions by arrival sequence number, plus (key, sequence) indices
+    std::map<uint64_t, MemoryTransaction> entries_;
+    std::set<std::pair<uint32_t, uint64_t>> id_index_;
+    std::set<std::pair<uint64_t, uint64_t>> address_index_;
+
+    // Sizes of queued transactions; the largest bounds overlap searches
+    std::multiset<uint32_t> sizes_;
+
     // Helper methods
     bool address_overlaps(uint64_t addr1, uint32_t size1, uint64_t addr2, uint32_t size2) const;
-    void update_address_map(const MemoryTransaction& transaction, bool add);
+    uint64_t front_seq() const;
+    void erase(uint64_t seq);
+
+    // Visit queued transactions overlapping [address, address + size) in
+    // address order until the visitor returns false
+    template <typename Visitor>
+    void for_each_conflict(uint64_t address, uint32_t size, Visitor visit) const;
 };
 
-#endif // TRANSACTION_QUEUE_H
\ No newline at end of file
+#endif // TRANSACTION_QUEUE_H
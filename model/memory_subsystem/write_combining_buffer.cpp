@@ -0,0 +1,118 @@
+#include "write_combining_buffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+WriteCombiningBuffer::WriteCombiningBuffer(uint32_t num_entries, uint32_t line_size, uint32_t timeout)
+    : num_entries_(num_entries),
+      line_size_(line_size),
+      timeout_(timeout) {
+    if (num_entries_ == 0) {
+        throw std::invalid_argument("Write-combining buffer needs at least one entry");
+    }
+    if (line_size_ == 0 || (line_size_ & (line_size_ - 1)) != 0 || line_size_ > BurstPayload::MAX_BYTES) {
+        throw std::invalid_argument("Write-combining line size must be a power of two up to a burst payload");
+    }
+    entries_.reserve(num_entries_);
+}
+
+void WriteCombiningBuffer::write(uint64_t addr, const uint8_t* data, uint32_t size, uint64_t cycle,
+                                 std::vector<MemoryTransaction>& drained) {
+    while (size > 0) {
+        uint64_t line = line_addr(addr);
+        uint32_t offset = static_cast<uint32_t>(addr - line);
+        uint32_t length = std::min(size, line_size_ - offset);
+        stats_.stores++;
+
+        int32_t index = find(line);
+        if (index >= 0) {
+            stats_.merged_stores++;
+        } else {
+            if (entries_.size() == num_entries_) {
+                stats_.capacity_drains++;
+                drain(0, drained);
+            }
+            Entry entry;
+            entry.line = line;
+            entry.payload = BurstPayload(line_size_);
+            entry.payload.set_byte_enable(0, line_size_, false);
+            entries_.push_back(std::move(entry));
+            index = static_cast<int32_t>(entries_.size() - 1);
+        }
+
+        Entry& entry = entries_[index];
+        std::memcpy(entry.payload.mutable_data() + offset, data, length);
+        entry.payload.set_byte_enable(offset, length, true);
+        entry.last_write = cycle;
+        if (entry.payload.all_enabled()) {
+            drain(static_cast<size_t>(index), drained);
+        }
+
+        addr += length;
+        data += length;
+        size -= length;
+    }
+}
+
+void WriteCombiningBuffer::tick(uint64_t cycle, std::vector<MemoryTransaction>& drained) {
+    if (timeout_ == 0) {
+        return;
+    }
+    for (size_t i = 0; i < entries_.size();) {
+        if (cycle - entries_[i].last_write >= timeout_) {
+            stats_.timeout_drains++;
+            drain(i, drained);
+        } else {
+            i++;
+        }
+    }
+}
+
+bool WriteCombiningBuffer::flush_line(uint64_t addr, std::vector<MemoryTransaction>& drained) {
+    int32_t index = find(line_addr(addr));
+    if (index < 0) {
+        return false;
+    }
+    drain(static_cast<size_t>(index), drained);
+    return true;
+}
+
+void WriteCombiningBuffer::flush(std::vector<MemoryTransaction>& drained) {
+    while (!entries_.empty()) {
+        drain(0, drained);
+    }
+}
+
+void WriteCombiningBuffer::clear() {
+    entries_.clear();
+    stats_ = WriteCombiningStats();
+}
+
+int32_t WriteCombiningBuffer::find(uint64_t line) const {
+    for (size_t i = 0; i < entries_.size(); i++) {
+        if (entries_[i].line == line) {
+            return static_cast<int32_t>(i);
+        }
+    }
+    return -1;
+}
+
+void WriteCombiningBuffer::drain(size_t index, std::vector<MemoryTransaction>& drained) {
+    Entry& entry = entries_[index];
+    uint32_t enabled = 0;
+    for (uint32_t offset = 0; offset < line_size_; offset++) {
+        enabled += entry.payload.byte_enabled(offset) ? 1 : 0;
+    }
+    if (enabled == line_size_) {
+        stats_.full_line_writes++;
+    } else {
+        stats_.partial_line_writes++;
+    }
+    stats_.bytes_drained += enabled;
+
+    MemoryTransaction write(MemoryTransactionType::WRITE, entry.line, line_size_);
+    write.set_payload(entry.payload);
+    drained.push_back(write);
+    entries_.erase(entries_.begin() + static_cast<std::ptrdiff_t>(index));
+}
@@ -0,0 +1,85 @@
+#ifndef WRITE_COMBINING_BUFFER_H
+#define WRITE_COMBINING_BUFFER_H
+
+#include <vector>
+#include <cstdint>
+#include "memory_transaction.h"
+#include "burst_payload.h"
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// Write-combining buffer statistics
+struct WriteCombiningStats {
+    uint64_t stores = 0;             // Stores (or line pieces of a store) entering the buffer
+    uint64_t merged_stores = 0;      // Stores merged into a line already buffered
+    uint64_t full_line_writes = 0;   // Drained lines with every byte written
+    uint64_t partial_line_writes = 0;
+    uint64_t capacity_drains = 0;    // Oldest line drained to make room
+    uint64_t timeout_drains = 0;     // Idle lines drained by tick()
+    uint64_t bytes_drained = 0;      // Enabled bytes written downstream
+};
+
+// Write-combining buffer
+//
+// Holds a few line-sized entries that gather partial stores (sub-line
+// stores of a warp, or consecutive stores to one output tile) into one
+// line write with byte enables. A line drains downstream as a single WRITE
+// transaction as soon as every byte is written, when the buffer needs its
+// entry for a new line (oldest first), when it has been idle for timeout
+// cycles, or on an explicit flush (fence, barrier, or a read of the line).
+class WriteCombiningBuffer {
+public:
+    // Constructor (line_size up to BurstPayload::MAX_BYTES; timeout 0 never times out)
+    WriteCombiningBuffer(uint32_t num_entries = 8, uint32_t line_size = 128, uint32_t timeout = 64);
+
+    // Merge size bytes at addr; lines that drain are appended to drained
+    void write(uint64_t addr, const uint8_t* data, uint32_t size, uint64_t cycle,
+               std::vector<MemoryTransaction>& drained);
+
+    // Drain lines idle for the timeout
+    void tick(uint64_t cycle, std::vector<MemoryTransaction>& drained);
+
+    // Drain one line if buffered; returns whether it was
+    bool flush_line(uint64_t addr, std::vector<MemoryTransaction>& drained);
+
+    // Drain every line
+    void flush(std::vector<MemoryTransaction>& drained);
+
+    // Properties
+    uint32_t num_entries() const { return num_entries_; }
+    uint32_t line_size() const { return line_size_; }
+    uint32_t occupancy() const { return static_cast<uint32_t>(entries_.size()); }
+    bool contains(uint64_t addr) const { return find(line_addr(addr)) >= 0; }
+
+    // Statistics
+    const WriteCombiningStats& stats() const { return stats_; }
+    void reset_stats() { stats_ = WriteCombiningStats(); }
+
+    // Reset (drops buffered lines)
+    void clear();
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    struct Entry {
+        uint64_t line;
+        BurstPayload payload;   // Line data with an enable per written byte
+        uint64_t last_write;
+    };
+
+    uint32_t num_entries_;
+    uint32_t line_size_;
+    uint32_t timeout_;
+    std::vector<Entry> entries_;   // Allocation order, oldest first
+    WriteCombiningStats stats_;
+
+    uint64_t line_addr(uint64_t addr) const { return addr & ~static_cast<uint64_t>(line_size_ - 1); }
+    int32_t find(uint64_t line) const;
+    void drain(size_t index, std::vector<MemoryTransaction>& drained);
+};
+
+#endif // WRITE_COMBINING_BUFFER_H
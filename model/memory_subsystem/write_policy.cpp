@@ -0,0 +1,175 @@
+#include "write_policy.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+// Bytes a store writes: its enabled payload bytes, or size() bytes of data()
+uint32_t store_bytes(const MemoryTransaction& store) {
+    if (!store.has_payload()) {
+        return store.size();
+    }
+    uint32_t bytes = 0;
+    uint32_t size = std::min(store.size(), store.payload().size());
+    for (uint32_t offset = 0; offset < size; offset++) {
+        bytes += store.payload().byte_enabled(offset) ? 1 : 0;
+    }
+    return bytes;
+}
+
+}  // namespace
+
+CacheWritePolicy::CacheWritePolicy(const WritePolicyConfig& config, uint32_t line_size)
+    : config_(config),
+      line_size_(line_size),
+      combining_(std::max(config.combining_entries, 1u), line_size, config.combining_timeout) {
+}
+
+WriteAction CacheWritePolicy::store(const MemoryTransaction& store, bool hit, uint64_t cycle) {
+    WriteAction action;
+    uint32_t bytes = store_bytes(store);
+    stats_.stores++;
+    stats_.store_bytes += bytes;
+
+    bool write_through = config_.hit == WriteHitPolicy::WRITE_THROUGH;
+    if (hit) {
+        stats_.write_hits++;
+        action.update_line = true;
+    } else {
+        stats_.write_misses++;
+        if (config_.miss == WriteMissPolicy::NO_WRITE_ALLOCATE) {
+            forward(store, cycle);
+            return action;
+        }
+        // A store covering the whole line allocates it without a fill
+        bool full_line = bytes == line_size_ && store.address() % line_size_ == 0;
+        action.fetch_line = !full_line;
+        action.allocate = true;
+        action.update_line = true;
+        stats_.write_allocations++;
+        stats_.fill_bytes += full_line ? 0 : line_size_;
+    }
+
+    if (write_through) {
+        forward(store, cycle);
+    } else {
+        action.mark_dirty = true;
+    }
+    return action;
+}
+
+void CacheWritePolicy::writeback(uint64_t line_addr, const uint8_t* data) {
+    stats_.writebacks++;
+    MemoryTransaction write(MemoryTransactionType::WRITE, line_addr, line_size_);
+    if (data != nullptr && line_size_ <= BurstPayload::MAX_BYTES) {
+        write.set_payload(BurstPayload(data, line_size_));
+    }
+    send(write);
+}
+
+bool CacheWritePolicy::writeback_line(CacheArray& lines, uint32_t set, uint32_t way) {
+    if (!lines.dirty(set, way)) {
+        return false;
+    }
+    writeback(lines.tag(set, way) * line_size_, lines.stores_data() ? lines.line_data(set, way) : nullptr);
+    lines.set_dirty(set, way, false);
+    return true;
+}
+
+bool CacheWritePolicy::load(uint64_t addr) {
+    if (config_.combining_entries == 0 || !combining_.flush_line(addr, drained_)) {
+        return false;
+    }
+    stats_.read_flushes++;
+    send_drained();
+    return true;
+}
+
+void CacheWritePolicy::tick(uint64_t cycle) {
+    if (config_.combining_entries > 0) {
+        combining_.tick(cycle, drained_);
+        send_drained();
+    }
+}
+
+void CacheWritePolicy::flush() {
+    if (config_.combining_entries > 0) {
+        combining_.flush(drained_);
+        send_drained();
+    }
+}
+
+MemoryTransaction CacheWritePolicy::next_write() {
+    if (outgoing_.empty()) {
+        throw std::logic_error("No write waiting for the next level");
+    }
+    MemoryTransaction write = outgoing_.front();
+    outgoing_.pop_front();
+    return write;
+}
+
+void CacheWritePolicy::reset_stats() {
+    stats_ = WriteTrafficStats();
+    combining_.reset_stats();
+}
+
+void CacheWritePolicy::clear() {
+    combining_.clear();
+    outgoing_.clear();
+    drained_.clear();
+    stats_ = WriteTrafficStats();
+}
+
+void CacheWritePolicy::forward(const MemoryTransaction& store, uint64_t cycle) {
+    stats_.forwarded_stores++;
+    if (config_.combining_entries == 0) {
+        send(store);
+        return;
+    }
+
+    if (!store.has_payload()) {
+        uint64_t data = store.data();
+        uint8_t bytes[8];
+        uint32_t size = std::min<uint32_t>(store.size(), 8);
+        for (uint32_t i = 0; i < size; i++) {
+            bytes[i] = static_cast<uint8_t>(data >> (8 * i));
+        }
+        combining_.write(store.address(), bytes, size, cycle, drained_);
+    } else {
+        // Merge each run of enabled bytes
+        const BurstPayload& payload = store.payload();
+        uint32_t size = std::min(store.size(), payload.size());
+        uint32_t offset = 0;
+        while (offset < size) {
+            if (!payload.byte_enabled(offset)) {
+                offset++;
+                continue;
+            }
+            uint32_t end = offset;
+            while (end < size && payload.byte_enabled(end)) {
+                end++;
+            }
+            combining_.write(store.address() + offset, payload.data() + offset, end - offset, cycle, drained_);
+            offset = end;
+        }
+    }
+    send_drained();
+}
+
+void CacheWritePolicy::send(const MemoryTransaction& write) {
+    uint32_t bytes = store_bytes(write);
+    stats_.downstream_writes++;
+    stats_.downstream_bytes += bytes;
+    if (bytes < line_size_) {
+        stats_.partial_line_writes++;
+    }
+    outgoing_.push_back(write);
+}
+
+void CacheWritePolicy::send_drained() {
+    for (const MemoryTransaction& write : drained_) {
+        send(write);
+    }
+    drained_.clear();
+}
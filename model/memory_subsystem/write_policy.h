@@ -0,0 +1,124 @@
+#ifndef WRITE_POLICY_H
+#define WRITE_POLICY_H
+
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include "memory_transaction.h"
+#include "write_combining_buffer.h"
+#include "cache_array.h"
+
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
+// What a store hit does to the next level
+enum class WriteHitPolicy : uint8_t {
+    WRITE_BACK,      // Mark the line dirty; it is written when evicted
+    WRITE_THROUGH    // Forward every store; lines stay clean
+};
+
+// What a store miss does in this cache
+enum class WriteMissPolicy : uint8_t {
+    WRITE_ALLOCATE,     // Fill the line (unless the store covers it) and write into it
+    NO_WRITE_ALLOCATE   // Forward the store without caching the line
+};
+
+// Cache write policy. The defaults are the L1's original behaviour.
+struct WritePolicyConfig {
+    WriteHitPolicy hit = WriteHitPolicy::WRITE_BACK;
+    WriteMissPolicy miss = WriteMissPolicy::WRITE_ALLOCATE;
+    uint32_t combining_entries = 0;    // Write-combining buffer lines for forwarded stores (0 disables)
+    uint32_t combining_timeout = 64;   // Cycles an idle combining line waits before it drains
+};
+
+// Write traffic of one cache
+struct WriteTrafficStats {
+    uint64_t stores = 0;
+    uint64_t store_bytes = 0;
+    uint64_t write_hits = 0;
+    uint64_t write_misses = 0;
+    uint64_t write_allocations = 0;   // Lines allocated by store misses
+    uint64_t fill_bytes = 0;          // Bytes read to fill lines for partial-line store misses
+    uint64_t forwarded_stores = 0;    // Stores sent on to the next level (through the buffer if enabled)
+    uint64_t writebacks = 0;          // Dirty lines written back on eviction
+    uint64_t read_flushes = 0;        // Combining lines drained early because a load touched them
+    uint64_t downstream_writes = 0;   // Write transactions sent to the next level
+    uint64_t downstream_bytes = 0;    // Bytes they carry
+    uint64_t partial_line_writes = 0; // Of those, writes smaller than a line
+
+    // Bytes written to the next level per byte stored
+    double write_amplification() const {
+        return store_bytes > 0 ? static_cast<double>(downstream_bytes) / store_bytes : 0.0;
+    }
+};
+
+// How the cache handles one store
+struct WriteAction {
+    bool fetch_line = false;   // Miss: fill the line before writing into it
+    bool allocate = false;     // Miss: allocate the line (after the fill, if any)
+    bool update_line = false;  // Write the bytes into the cached line
+    bool mark_dirty = false;   // Write-back: the cached line is now the only up-to-date copy
+};
+
+// Write path of a cache: applies the hit/miss policies to each store,
+// counts write traffic, and sends forwarded stores and dirty writebacks to
+// the next level, combining forwarded stores into line writes when a
+// combining buffer is configured. Writes for the next level queue up until
+// the cache takes them with next_write().
+class CacheWritePolicy {
+public:
+    // Constructor
+    explicit CacheWritePolicy(const WritePolicyConfig& config = WritePolicyConfig(), uint32_t line_size = 64);
+
+    // Handle a store that hit or missed in the cache
+    WriteAction store(const MemoryTransaction& store, bool hit, uint64_t cycle);
+
+    // A dirty line left the cache
+    void writeback(uint64_t line_addr, const uint8_t* data);
+
+    // Write a cached line back if it is dirty and mark it clean, before a
+    // coherence action drops or downgrades it. Tags are line numbers.
+    // Returns whether the line was dirty.
+    bool writeback_line(CacheArray& lines, uint32_t set, uint32_t way);
+
+    // A load must see buffered stores to its line; drains it if buffered
+    bool load(uint64_t addr);
+
+    // Time out idle combining lines
+    void tick(uint64_t cycle);
+
+    // Drain the combining buffer (fence, barrier, kernel end)
+    void flush();
+
+    // Writes waiting for the next level
+    bool has_write() const { return !outgoing_.empty(); }
+    MemoryTransaction next_write();
+
+    // Configuration and statistics
+    const WritePolicyConfig& config() const { return config_; }
+    const WriteTrafficStats& stats() const { return stats_; }
+    const WriteCombiningStats& combining_stats() const { return combining_.stats(); }
+    void reset_stats();
+
+    // Reset (drops buffered and queued writes)
+    void clear();
+
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+
+private:
+    WritePolicyConfig config_;
+    uint32_t line_size_;
+    WriteCombiningBuffer combining_;
+    std::deque<MemoryTransaction> outgoing_;
+    std::vector<MemoryTransaction> drained_;   // Scratch for combining buffer drains
+    WriteTrafficStats stats_;
+
+    void forward(const MemoryTransaction& store, uint64_t cycle);
+    void send(const MemoryTransaction& write);
+    void send_drained();
+};
+
+#endif // WRITE_POLICY_H
@@ -0,0 +1,442 @@
+#include "assembler.h"
+
+#include <cctype>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+std::string trim(const std::string& text) {
+    size_t begin = 0;
+    while (begin < text.size() && std::isspace(static_cast<unsigned char>(text[begin]))) {
+        begin++;
+    }
+    size_t end = text.size();
+    while (end > begin && std::isspace(static_cast<unsigned char>(text[end - 1]))) {
+        end--;
+    }
+    return text.substr(begin, end - begin);
+}
+
+std::string strip_comment(const std::string& line) {
+    size_t pos = line.find_first_of("#;");
+    size_t slashes = line.find("//");
+    if (slashes != std::string::npos && (pos == std::string::npos || slashes < pos)) {
+        pos = slashes;
+    }
+    return pos == std::string::npos ? line : line.substr(0, pos);
+}
+
+// Split on commas that are not inside brackets
+std::vector<std::string> split_operands(const std::string& text) {
+    std::vector<std::string> operands;
+    std::string current;
+    int depth = 0;
+    for (char c : text) {
+        if (c == '[') depth++;
+        if (c == ']') depth--;
+        if (c == ',' && depth == 0) {
+            operands.push_back(trim(current));
+            current.clear();
+        } else {
+            current += c;
+        }
+    }
+    if (!trim(current).empty()) {
+        operands.push_back(trim(current));
+    }
+    return operands;
+}
+
+bool is_identifier(const std::string& text) {
+    if (text.empty() || !(std::isalpha(static_cast<unsigned char>(text[0])) || text[0] == '_' || text[0] == '.')) {
+        return false;
+    }
+    for (char c : text) {
+        if (!(std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '.')) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+Assembler::Assembler() : entry_line_(0) {
+    opcodes_ = {
+        {"add", InstructionOpcode::ALU_ADD},
+        {"sub", InstructionOpcode::ALU_SUB},
+        {"mul", InstructionOpcode::ALU_MUL},
+        {"div", InstructionOpcode::ALU_DIV},
+        {"and", InstructionOpcode::ALU_AND},
+        {"or", InstructionOpcode::ALU_OR},
+        {"xor", InstructionOpcode::ALU_XOR},
+        {"not", InstructionOpcode::ALU_NOT},
+        {"shl", InstructionOpcode::ALU_SHL},
+        {"shr", InstructionOpcode::ALU_SHR},
+        {"mma.fp16", InstructionOpcode::TENSOR_MATMUL_FP16},
+        {"mma.fp8", InstructionOpcode::TENSOR_MATMUL_FP8},
+        {"mma.fp4", InstructionOpcode::TENSOR_MATMUL_FP4},
+        {"conv2d", InstructionOpcode::TENSOR_CONV2D},
+        {"attention", InstructionOpcode::TENSOR_ATTENTION},
+        {"ld", InstructionOpcode::MEM_LOAD},
+        {"st", InstructionOpcode::MEM_STORE},
+        {"atom", InstructionOpcode::MEM_ATOMIC},
+        {"br", InstructionOpcode::BRANCH},
+        {"brc", InstructionOpcode::BRANCH_COND},
+        {"jmp", InstructionOpcode::JUMP},
+        {"call", InstructionOpcode::CALL},
+        {"ret", InstructionOpcode::RETURN},
+        {"barrier", InstructionOpcode::BARRIER},
+        {"sync", InstructionOpcode::SYNC},
+        {"nop", InstructionOpcode::NOP}
+    };
+}
+
+bool Assembler::assemble(const std::string& source, Kernel& kernel) {
+    errors_.clear();
+    statements_.clear();
+    labels_.clear();
+    entry_label_.clear();
+    entry_line_ = 0;
+    kernel = Kernel();
+    
+    // The second pass runs even after first-pass errors so that all
+    // diagnostics are reported at once
+    first_pass(source, kernel);
+    second_pass(kernel);
+    return errors_.empty();
+}
+
+bool Assembler::assemble_file(const std::string& path, Kernel& kernel) {
+    std::ifstream in(path);
+    if (!in) {
+        errors_.assign(1, path + ": cannot open file");
+        return false;
+    }
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    return assemble(buffer.str(), kernel);
+}
+
+uint32_t Assembler::encode(InstructionOpcode opcode, uint32_t dst, uint32_t src1,
+                           uint32_t src2, uint32_t imm) {
+    using namespace instruction_format;
+    return ((static_cast<uint32_t>(opcode) << OPCODE_SHIFT) & OPCODE_MASK) |
+           ((dst << REG_DST_SHIFT) & REG_DST_MASK) |
+           ((src1 << REG_SRC1_SHIFT) & REG_SRC1_MASK) |
+           ((src2 << REG_SRC2_SHIFT) & REG_SRC2_MASK) |
+           (imm & IMM_MASK);
+}
+
+void Assembler::first_pass(const std::string& source, Kernel& kernel) {
+    std::istringstream in(source);
+    std::string raw_line;
+    uint32_t line_number = 0;
+    Section section = Section::TEXT;
+    uint64_t pc = 0;
+    uint64_t data_offset = 0;
+    
+    while (std::getline(in, raw_line)) {
+        line_number++;
+        std::string line = trim(strip_comment(raw_line));
+        
+        // Leading labels
+        size_t colon;
+        while ((colon = line.find(':')) != std::string::npos &&
+               is_identifier(trim(line.substr(0, colon)))) {
+            std::string label = trim(line.substr(0, colon));
+            if (labels_.count(label)) {
+                error(line_number, "duplicate label '" + label + "'");
+            }
+            labels_[label] = section == Section::TEXT ? pc : kernel.data_load_address + data_offset;
+            line = trim(line.substr(colon + 1));
+        }
+        if (line.empty()) {
+            continue;
+        }
+        
+        Statement stmt;
+        stmt.line = line_number;
+        size_t space = line.find_first_of(" \t");
+        stmt.mnemonic = line.substr(0, space);
+        for (char& c : stmt.mnemonic) {
+            c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        std::string rest = space == std::string::npos ? "" : trim(line.substr(space));
+        
+        // Directives handled entirely in this pass
+        if (stmt.mnemonic == ".text") {
+            section = Section::TEXT;
+            continue;
+        }
+        if (stmt.mnemonic == ".data") {
+            section = Section::DATA;
+            continue;
+        }
+        if (stmt.mnemonic == ".kernel") {
+            kernel.name = rest;
+            continue;
+        }
+        if (stmt.mnemonic == ".entry") {
+            entry_label_ = rest;
+            entry_line_ = line_number;
+            continue;
+        }
+        if (stmt.mnemonic == ".meta") {
+            size_t split = rest.find_first_of(" \t");
+            if (split == std::string::npos) {
+                error(line_number, ".meta requires a key and a value");
+            } else {
+                kernel.metadata[rest.substr(0, split)] = trim(rest.substr(split));
+            }
+            continue;
+        }
+        if (stmt.mnemonic == ".org") {
+            int64_t address;
+            stmt.operands = {rest};
+            if (data_offset != 0) {
+                error(line_number, ".org must precede all data");
+            } else if (parse_value(stmt, rest, address)) {
+                kernel.data_load_address = static_cast<uint64_t>(address);
+            }
+            continue;
+        }
+        
+        stmt.section = section;
+        stmt.operands = split_operands(rest);
+        if (section == Section::TEXT) {
+            if (!opcodes_.count(stmt.mnemonic)) {
+                error(line_number, "unknown instruction '" + stmt.mnemonic + "'");
+                continue;
+            }
+            stmt.location = pc++;
+        } else {
+            stmt.location = data_offset;
+            if (stmt.mnemonic == ".word") {
+                data_offset += 4 * stmt.operands.size();
+            } else if (stmt.mnemonic == ".byte") {
+                data_offset += stmt.operands.size();
+            } else if (stmt.mnemonic == ".zero" || stmt.mnemonic == ".align") {
+                int64_t amount;
+                if (!expect_operands(stmt, 1) || !parse_value(stmt, stmt.operands[0], amount) || amount < 0) {
+                    error(line_number, stmt.mnemonic + " requires a non-negative size");
+                    continue;
+                }
+                if (stmt.mnemonic == ".zero") {
+                    data_offset += amount;
+                } else if (amount > 0) {
+                    data_offset = (data_offset + amount - 1) / amount * amount;
+                }
+            } else {
+                error(line_number, "unknown data directive '" + stmt.mnemonic + "'");
+                continue;
+            }
+        }
+        statements_.push_back(stmt);
+    }
+    
+    kernel.data.reserve(data_offset);
+}
+
+void Assembler::second_pass(Kernel& kernel) {
+    for (const Statement& stmt : statements_) {
+        if (stmt.section == Section::TEXT) {
+            emit_instruction(stmt, kernel);
+        } else {
+            emit_data(stmt, kernel);
+        }
+    }
+    
+    if (!entry_label_.empty()) {
+        auto it = labels_.find(entry_label_);
+        if (it == labels_.end()) {
+            error(entry_line_, "undefined entry label '" + entry_label_ + "'");
+        } else {
+            kernel.entry_pc = static_cast<uint32_t>(it->second);
+        }
+    }
+}
+
+void Assembler::emit_instruction(const Statement& stmt, Kernel& kernel) {
+    InstructionOpcode opcode = opcodes_.at(stmt.mnemonic);
+    uint32_t dst = 0;
+    uint32_t src1 = 0;
+    uint32_t src2 = 0;
+    uint32_t imm = 0;
+    int64_t value = 0;
+    bool ok = true;
+    
+    switch (opcode) {
+        case InstructionOpcode::ALU_NOT:
+            ok = expect_operands(stmt, 2) &&
+                 parse_register(stmt, stmt.operands[0], dst) &&
+                 parse_register(stmt, stmt.operands[1], src1);
+            break;
+            
+        case InstructionOpcode::MEM_LOAD:
+        case InstructionOpcode::MEM_STORE:
+            ok = expect_operands(stmt, 2) &&
+                 parse_register(stmt, stmt.operands[0], dst) &&
+                 parse_address(stmt, stmt.operands[1], src1, imm);
+            break;
+            
+        case InstructionOpcode::MEM_ATOMIC:
+            ok = expect_operands(stmt, 3) &&
+                 parse_register(stmt, stmt.operands[0], dst) &&
+                 parse_address(stmt, stmt.operands[1], src1, imm) &&
+                 parse_register(stmt, stmt.operands[2], src2);
+            if (ok && imm != 0) {
+                error(stmt.line, "atom does not take an address offset");
+                ok = false;
+            }
+            break;
+            
+        case InstructionOpcode::BRANCH:
+        case InstructionOpcode::BRANCH_COND: {
+            size_t target_index = opcode == InstructionOpcode::BRANCH ? 0 : 1;
+            ok = expect_operands(stmt, target_index + 1) &&
+                 (target_index == 0 || parse_register(stmt, stmt.operands[0], src1)) &&
+                 parse_value(stmt, stmt.operands[target_index], value);
+            if (ok) {
+                int64_t offset = value - static_cast<int64_t>(stmt.location);
+                if (offset < INT16_MIN || offset > INT16_MAX) {
+                    error(stmt.line, "branch target out of range");
+                    ok = false;
+                }
+                imm = static_cast<uint32_t>(offset) & instruction_format::IMM_MASK;
+            }
+            break;
+        }
+        
+        case InstructionOpcode::JUMP:
+        case InstructionOpcode::CALL:
+            ok = expect_operands(stmt, 1) && parse_value(stmt, stmt.operands[0], value);
+            if (ok && (value < 0 || value > instruction_format::IMM_MASK)) {
+                error(stmt.line, "jump target out of range");
+                ok = false;
+            }
+            imm = static_cast<uint32_t>(value);
+            break;
+            
+        case InstructionOpcode::RETURN:
+        case InstructionOpcode::BARRIER:
+        case InstructionOpcode::SYNC:
+        case InstructionOpcode::NOP:
+            ok = expect_operands(stmt, 0);
+            break;
+            
+        default:
+            // Three-register ALU and tensor operations
+            ok = expect_operands(stmt, 3) &&
+                 parse_register(stmt, stmt.operands[0], dst) &&
+                 parse_register(stmt, stmt.operands[1], src1) &&
+                 parse_register(stmt, stmt.operands[2], src2);
+            break;
+    }
+    
+    if (ok) {
+        kernel.code.push_back(encode(opcode, dst, src1, src2, imm));
+    }
+}
+
+void Assembler::emit_data(const Statement& stmt, Kernel& kernel) {
+    if (stmt.mnemonic == ".zero" || stmt.mnemonic == ".align") {
+        // Sizes were validated in the first pass; pad to the next statement
+        int64_t amount = 0;
+        parse_value(stmt, stmt.operands[0], amount);
+        uint64_t target = stmt.mnemonic == ".zero"
+                              ? stmt.location + amount
+                              : (amount > 0 ? (stmt.location + amount - 1) / amount * amount : stmt.location);
+        kernel.data.resize(target, 0);
+        return;
+    }
+    
+    uint32_t width = stmt.mnemonic == ".word" ? 4 : 1;
+    for (const std::string& operand : stmt.operands) {
+        int64_t value;
+        if (!parse_value(stmt, operand, value)) {
+            continue;
+        }
+        for (uint32_t i = 0; i < width; i++) {
+            kernel.data.push_back(static_cast<uint8_t>(static_cast<uint64_t>(value) >> (8 * i)));
+        }
+    }
+}
+
+bool Assembler::parse_register(const Statement& stmt, const std::string& text, uint32_t& reg) {
+    if (text.size() < 2 || (text[0] != 'r' && text[0] != 'R')) {
+        error(stmt.line, "expected register, found '" + text + "'");
+        return false;
+    }
+    try {
+        size_t used;
+        unsigned long index = std::stoul(text.substr(1), &used, 10);
+        if (used != text.size() - 1 || index > 31) {
+            throw std::out_of_range(text);
+        }
+        reg = static_cast<uint32_t>(index);
+        return true;
+    } catch (const std::exception&) {
+        error(stmt.line, "invalid register '" + text + "'");
+        return false;
+    }
+}
+
+bool Assembler::parse_value(const Statement& stmt, const std::string& text, int64_t& value) {
+    auto it = labels_.find(text);
+    if (it != labels_.end()) {
+        value = static_cast<int64_t>(it->second);
+        return true;
+    }
+    try {
+        size_t used;
+        value = std::stoll(text, &used, 0);
+        if (used == text.size()) {
+            return true;
+        }
+    } catch (const std::exception&) {
+    }
+    error(stmt.line, "undefined symbol or invalid number '" + text + "'");
+    return false;
+}
+
+bool Assembler::parse_address(const Statement& stmt, const std::string& text,
+                              uint32_t& base, uint32_t& offset) {
+    if (text.size() < 3 || text.front() != '[' || text.back() != ']') {
+        error(stmt.line, "expected memory operand '[reg + offset]', found '" + text + "'");
+        return false;
+    }
+    std::string inner = trim(text.substr(1, text.size() - 2));
+    size_t plus = inner.find('+');
+    if (!parse_register(stmt, trim(inner.substr(0, plus)), base)) {
+        return false;
+    }
+    offset = 0;
+    if (plus == std::string::npos) {
+        return true;
+    }
+    int64_t value;
+    if (!parse_value(stmt, trim(inner.substr(plus + 1)), value)) {
+        return false;
+    }
+    if (value < 0 || value > instruction_format::IMM_MASK) {
+        error(stmt.line, "address offset out of range");
+        return false;
+    }
+    offset = static_cast<uint32_t>(value);
+    return true;
+}
+
+bool Assembler::expect_operands(const Statement& stmt, size_t count) {
+    if (stmt.operands.size() != count) {
+        error(stmt.line, "'" + stmt.mnemonic + "' expects " + std::to_string(count) +
+                         " operand(s), found " + std::to_string(stmt.operands.size()));
+        return false;
+    }
+    return true;
+}
+
+void Assembler::error(uint32_t line, const std::string& message) {
+    errors_.push_back("line " + std::to_string(line) + ": " + message);
+}
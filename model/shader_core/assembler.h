@@ -0,0 +1,83 @@
+#ifndef ASSEMBLER_H
+#define ASSEMBLER_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "instruction_decoder.h"
+#include "kernel_image.h"
+
+// Two-pass assembler for the shader core ISA
+//
+// Syntax (one statement per line, '#', ';' or '//' start a comment):
+//   label:
+//   add   rd, rs1, rs2        (sub mul div and or xor shl shr)
+//   not   rd, rs1
+//   mma.fp16 rd, rs1, rs2     (mma.fp8 mma.fp4 conv2d attention)
+//   ld    rd, [rs1 + imm]
+//   st    rs, [rs1 + imm]
+//   atom  rd, [rs1], rs2
+//   br    target              (PC-relative)
+//   brc   rs1, target         (taken if rs1 != 0)
+//   jmp   target / call target
+//   ret / barrier / sync / nop
+// Directives:
+//   .kernel name      .entry label      .meta key value
+//   .text / .data     .org address      (data load address)
+//   .word v, ...      .byte v, ...      .zero n      .align n
+// Immediates are numbers (decimal, 0x hex) or labels; text labels resolve
+// to word indices, data labels to absolute load addresses.
+class Assembler {
+public:
+    // Constructor
+    Assembler();
+    
+    // Assemble source text into a kernel. Returns false and records
+    // line-numbered diagnostics in errors() on failure.
+    bool assemble(const std::string& source, Kernel& kernel);
+    bool assemble_file(const std::string& path, Kernel& kernel);
+    
+    // Diagnostics from the last assemble() call
+    const std::vector<std::string>& errors() const { return errors_; }
+    
+    // Encode a single instruction word
+    static uint32_t encode(InstructionOpcode opcode, uint32_t dst = 0, uint32_t src1 = 0,
+                           uint32_t src2 = 0, uint32_t imm = 0);
+    
+private:
+    enum class Section { TEXT, DATA };
+    
+    // Parsed source statement
+    struct Statement {
+        uint32_t line;
+        Section section;
+        std::string mnemonic;
+        std::vector<std::string> operands;
+        uint64_t location;   // PC (text) or data offset (data)
+    };
+    
+    std::vector<std::string> errors_;
+    std::vector<Statement> statements_;
+    std::map<std::string, uint64_t> labels_;
+    std::string entry_label_;
+    uint32_t entry_line_;
+    
+    // Mnemonic table
+    std::map<std::string, InstructionOpcode> opcodes_;
+    
+    // Assembler passes
+    void first_pass(const std::string& source, Kernel& kernel);
+    void second_pass(Kernel& kernel);
+    void emit_instruction(const Statement& stmt, Kernel& kernel);
+    void emit_data(const Statement& stmt, Kernel& kernel);
+    
+    // Operand parsing
+    bool parse_register(const Statement& stmt, const std::string& text, uint32_t& reg);
+    bool parse_value(const Statement& stmt, const std::string& text, int64_t& value);
+    bool parse_address(const Statement& stmt, const std::string& text, uint32_t& base, uint32_t& offset);
+    bool expect_operands(const Statement& stmt, size_t count);
+    void error(uint32_t line, const std::string& message);
+};
+
+#endif // ASSEMBLER_H
@@ -0,0 +1,84 @@
+#include "decoupled_core.h"
+
+#include <algorithm>
+#include <chrono>
+
+DecoupledCore::DecoupledCore(sc_module_name name, GlobalMemory& memory, const DecouplingConfig& config)
+    : sc_module(name),
+      core_(memory),
+      config_(config),
+      offset_(SC_ZERO_TIME),
+      done_(false) {
+    core_.set_access_observer([this](InstructionOpcode opcode, uint64_t addr) { on_access(opcode, addr); });
+    SC_THREAD(run);
+}
+
+void DecoupledCore::run() {
+    auto host_start = std::chrono::steady_clock::now();
+    sc_time start = sc_time_stamp();
+
+    while (core_.step()) {
+        stats_.instructions++;
+        advance(1);
+        if (offset_ >= config_.quantum) {
+            sync(SyncReason::QUANTUM);
+        }
+    }
+    sync(SyncReason::HALT);
+
+    std::chrono::duration<double> host_time = std::chrono::steady_clock::now() - host_start;
+    stats_.host_seconds = host_time.count();
+    stats_.simulated_cycles = static_cast<uint64_t>((sc_time_stamp() - start) / config_.clock_period);
+    done_ = true;
+    finished_.notify();
+}
+
+void DecoupledCore::on_access(InstructionOpcode opcode, uint64_t addr) {
+    switch (opcode) {
+        case InstructionOpcode::MEM_LOAD:
+            if (shared(addr)) {
+                sync(SyncReason::SHARED_ACCESS);
+            }
+            advance(config_.load_latency);
+            break;
+
+        case InstructionOpcode::MEM_STORE:
+            if (shared(addr)) {
+                sync(SyncReason::SHARED_ACCESS);
+            }
+            advance(config_.store_latency);
+            break;
+
+        case InstructionOpcode::MEM_ATOMIC:
+            sync(SyncReason::ATOMIC);
+            advance(config_.atomic_latency);
+            break;
+
+        case InstructionOpcode::BARRIER:
+        case InstructionOpcode::SYNC:
+            sync(SyncReason::BARRIER);
+            break;
+
+        default:
+            break;
+    }
+}
+
+bool DecoupledCore::shared(uint64_t addr) const {
+    return std::any_of(shared_ranges_.begin(), shared_ranges_.end(),
+                       [addr](const std::pair<uint64_t, uint64_t>& range) {
+                           return addr >= range.first && addr < range.second;
+                       });
+}
+
+void DecoupledCore::sync(SyncReason reason) {
+    uint64_t skew = static_cast<uint64_t>(offset_ / config_.clock_period);
+    stats_.syncs++;
+    stats_.syncs_by_reason[static_cast<uint32_t>(reason)]++;
+    stats_.total_skew_cycles += skew;
+    stats_.max_skew_cycles = std::max(stats_.max_skew_cycles, skew);
+
+    // Hand the accumulated offset to the kernel
+    wait(offset_);
+    offset_ = SC_ZERO_TIME;
+}
@@ -0,0 +1,115 @@
+#ifndef DECOUPLED_CORE_H
+#define DECOUPLED_CORE_H
+
+#include <systemc.h>
+#include <vector>
+#include <utility>
+#include <cstdint>
+#include "functional_core.h"
+
+// Why a decoupled core synchronised with the SystemC kernel
+enum class SyncReason : uint8_t {
+    QUANTUM,         // Local time offset reached the quantum
+    SHARED_ACCESS,   // Load or store to memory other timed agents use
+    ATOMIC,
+    BARRIER,         // BARRIER or SYNC instruction
+    HALT             // End of the kernel
+};
+
+// Temporal decoupling configuration. Latencies are in core clock cycles on
+// top of the one cycle every instruction takes.
+struct DecouplingConfig {
+    sc_time clock_period = sc_time(1, SC_NS);
+    sc_time quantum = sc_time(1, SC_US);   // Run-ahead limit; SC_ZERO_TIME synchronises every instruction
+    uint32_t load_latency = 100;
+    uint32_t store_latency = 0;            // Stores are posted
+    uint32_t atomic_latency = 200;
+};
+
+// Speed and accuracy of a decoupled run
+struct DecouplingStats {
+    static const uint32_t NUM_REASONS = 5;
+
+    uint64_t instructions = 0;
+    uint64_t syncs = 0;                         // Kernel context switches (wait calls)
+    uint64_t syncs_by_reason[NUM_REASONS] = {};
+    uint64_t simulated_cycles = 0;
+    uint64_t max_skew_cycles = 0;               // Largest run-ahead at a sync
+    uint64_t total_skew_cycles = 0;
+    double host_seconds = 0.0;
+
+    uint64_t syncs_for(SyncReason reason) const { return syncs_by_reason[static_cast<uint32_t>(reason)]; }
+
+    // Speed: kernel context switches avoided and host throughput
+    double instructions_per_sync() const {
+        return syncs > 0 ? static_cast<double>(instructions) / syncs : 0.0;
+    }
+    double instructions_per_second() const {
+        return host_seconds > 0.0 ? instructions / host_seconds : 0.0;
+    }
+
+    // Accuracy: how far ahead of the kernel the core ran when it
+    // synchronised, i.e. how late it may observe other agents' events
+    double mean_skew_cycles() const {
+        return syncs > 0 ? static_cast<double>(total_skew_cycles) / syncs : 0.0;
+    }
+};
+
+// Temporally decoupled shader core
+//
+// Runs a FunctionalCore in one SC_THREAD that keeps a local time offset
+// ahead of the SystemC kernel instead of waiting on every clock edge.
+// Each instruction advances the offset by one cycle plus its memory
+// latency. The core calls wait() only when the offset reaches the quantum,
+// before atomics, BARRIER/SYNC, and loads or stores to shared ranges whose
+// data other timed agents produce or consume. Private loads never
+// synchronise; their latency is only annotated.
+//
+// A zero quantum synchronises after every instruction, which reproduces
+// the lock-step schedule; comparing a run against it gives the speed gained
+// and, through the skew statistics, the timing error taken on. Each core
+// keeps its own quantum: the TLM global quantum is process-wide.
+class DecoupledCore : public sc_module {
+public:
+    // Constructor
+    SC_HAS_PROCESS(DecoupledCore);
+    DecoupledCore(sc_module_name name, GlobalMemory& memory,
+                  const DecouplingConfig& config = DecouplingConfig());
+
+    // Functional state (load the program before simulation starts)
+    FunctionalCore& core() { return core_; }
+    const FunctionalCore& core() const { return core_; }
+
+    // Accesses to [start, end) synchronise first
+    void add_shared_range(uint64_t start, uint64_t end) { shared_ranges_.emplace_back(start, end); }
+
+    // Core time: kernel time plus the local offset
+    sc_time local_time() const { return sc_time_stamp() + offset_; }
+
+    // Notified when the program halts
+    const sc_event& finished() const { return finished_; }
+    bool done() const { return done_; }
+
+    // Configuration and statistics
+    const DecouplingConfig& config() const { return config_; }
+    const DecouplingStats& stats() const { return stats_; }
+
+    // Process
+    void run();
+
+private:
+    FunctionalCore core_;
+    DecouplingConfig config_;
+    std::vector<std::pair<uint64_t, uint64_t>> shared_ranges_;
+    sc_time offset_;
+    sc_event finished_;
+    bool done_;
+    DecouplingStats stats_;
+
+    void on_access(InstructionOpcode opcode, uint64_t addr);
+    bool shared(uint64_t addr) const;
+    void advance(uint32_t cycles) { offset_ += config_.clock_period * static_cast<double>(cycles); }
+    void sync(SyncReason reason);
+};
+
+#endif // DECOUPLED_CORE_H
@@ -4,6 +4,10 @@
 #include <systemc.h>
 #include "instruction_decoder.h"
 
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
 // Execution unit class
 class ExecutionUnit : public sc_module {
 public:
@@ -36,6 +40,10 @@ public:
     uint32_t execute_shl(uint32_t a, uint32_t b);
     uint32_t execute_shr(uint32_t a, uint32_t b);
     
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
 private:
     // Execution state
     uint32_t current_result_;
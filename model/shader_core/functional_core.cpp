@@ -0,0 +1,206 @@
+#include "functional_core.h"
+
+#include <stdexcept>
+
+FunctionalCore::FunctionalCore(GlobalMemory& memory, uint32_t num_registers)
+    : memory_(memory),
+      program_(nullptr),
+      program_words_(0),
+      registers_(num_registers, 0),
+      pc_(0),
+      halted_(true),
+      instructions_retired_(0),
+      block_start_pc_(0),
+      block_length_(0) {
+}
+
+void FunctionalCore::load_program(const std::vector<uint32_t>& program, uint32_t entry_pc) {
+    owned_program_ = program;
+    load_program(owned_program_.data(), owned_program_.size(), entry_pc);
+}
+
+void FunctionalCore::load_program(const uint32_t* code, uint64_t num_words, uint32_t entry_pc) {
+    program_ = code;
+    program_words_ = num_words;
+    call_stack_.clear();
+    pc_ = entry_pc;
+    halted_ = pc_ >= program_words_;
+    instructions_retired_ = 0;
+    block_start_pc_ = entry_pc;
+    block_length_ = 0;
+}
+
+void FunctionalCore::load_kernel(const MappedKernel& kernel) {
+    kernel.load_data(memory_);
+    load_program(kernel.code(), kernel.code_words(), kernel.entry_pc());
+}
+
+bool FunctionalCore::step() {
+    if (halted_) {
+        return false;
+    }
+    
+    using namespace instruction_format;
+    uint32_t word = program_[pc_];
+    uint32_t raw_opcode = opcode_field(word);
+    InstructionOpcode opcode = raw_opcode <= static_cast<uint32_t>(InstructionOpcode::NOP)
+                                   ? static_cast<InstructionOpcode>(raw_opcode)
+                                   : InstructionOpcode::NOP;
+    uint32_t dst = dst_field(word) % registers_.size();
+    uint32_t src1 = src1_field(word) % registers_.size();
+    uint32_t src2 = src2_field(word) % registers_.size();
+    uint32_t next_pc = pc_ + 1;
+    bool control_flow = false;
+    
+    switch (opcode) {
+        case InstructionOpcode::ALU_ADD:
+        case InstructionOpcode::ALU_SUB:
+        case InstructionOpcode::ALU_MUL:
+        case InstructionOpcode::ALU_DIV:
+        case InstructionOpcode::ALU_AND:
+        case InstructionOpcode::ALU_OR:
+        case InstructionOpcode::ALU_XOR:
+        case InstructionOpcode::ALU_NOT:
+        case InstructionOpcode::ALU_SHL:
+        case InstructionOpcode::ALU_SHR:
+            registers_[dst] = execute_alu(opcode, registers_[src1], registers_[src2]);
+            break;
+            
+        case InstructionOpcode::MEM_LOAD: {
+            uint64_t addr = static_cast<uint64_t>(registers_[src1]) + imm_field(word);
+            notify_access(opcode, addr);
+            registers_[dst] = load_word(addr);
+            break;
+        }
+            
+        case InstructionOpcode::MEM_STORE: {
+            uint64_t addr = static_cast<uint64_t>(registers_[src1]) + imm_field(word);
+            notify_access(opcode, addr);
+            store_word(addr, registers_[dst]);
+            break;
+        }
+            
+        case InstructionOpcode::MEM_ATOMIC: {
+            uint64_t addr = registers_[src1];
+            notify_access(opcode, addr);
+            uint32_t old_value = load_word(addr);
+            store_word(addr, old_value + registers_[src2]);
+            registers_[dst] = old_value;
+            break;
+        }
+        
+        case InstructionOpcode::BRANCH:
+            next_pc = pc_ + simm_field(word);
+            control_flow = true;
+            break;
+            
+        case InstructionOpcode::BRANCH_COND:
+            if (registers_[src1] != 0) {
+                next_pc = pc_ + simm_field(word);
+            }
+            control_flow = true;
+            break;
+            
+        case InstructionOpcode::JUMP:
+            next_pc = imm_field(word);
+            control_flow = true;
+            break;
+            
+        case InstructionOpcode::CALL:
+            call_stack_.push_back(pc_ + 1);
+            next_pc = imm_field(word);
+            control_flow = true;
+            break;
+            
+        case InstructionOpcode::RETURN:
+            if (call_stack_.empty()) {
+                next_pc = static_cast<uint32_t>(program_words_);
+            } else {
+                next_pc = call_stack_.back();
+                call_stack_.pop_back();
+            }
+            control_flow = true;
+            break;
+            
+        case InstructionOpcode::BARRIER:
+        case InstructionOpcode::SYNC:
+            notify_access(opcode, 0);
+            break;
+            
+        default:
+            // Tensor and NOP have no functional side effects here
+            break;
+    }
+    
+    instructions_retired_++;
+    block_length_++;
+    halted_ = next_pc >= program_words_;
+    if (control_flow || halted_) {
+        end_block(next_pc);
+    }
+    pc_ = next_pc;
+    return !halted_;
+}
+
+uint64_t FunctionalCore::run(uint64_t max_instructions) {
+    uint64_t executed = 0;
+    while (executed < max_instructions && !halted_) {
+        step();
+        executed++;
+    }
+    return executed;
+}
+
+uint32_t FunctionalCore::read_register(uint32_t reg) const {
+    return registers_.at(reg);
+}
+
+void FunctionalCore::write_register(uint32_t reg, uint32_t value) {
+    registers_.at(reg) = value;
+}
+
+void FunctionalCore::set_registers(const std::vector<uint32_t>& registers) {
+    if (registers.size() != registers_.size()) {
+        throw std::invalid_argument("Register count mismatch");
+    }
+    registers_ = registers;
+}
+
+uint32_t FunctionalCore::load_word(uint64_t addr) const {
+    uint8_t bytes[4];
+    memory_.read_block(addr, bytes, sizeof(bytes));
+    return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+           (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+void FunctionalCore::store_word(uint64_t addr, uint32_t data) {
+    uint8_t bytes[4] = {
+        static_cast<uint8_t>(data), static_cast<uint8_t>(data >> 8),
+        static_cast<uint8_t>(data >> 16), static_cast<uint8_t>(data >> 24)
+    };
+    memory_.write_block(addr, bytes, sizeof(bytes));
+}
+
+uint32_t FunctionalCore::execute_alu(InstructionOpcode opcode, uint32_t a, uint32_t b) const {
+    switch (opcode) {
+        case InstructionOpcode::ALU_ADD: return a + b;
+        case InstructionOpcode::ALU_SUB: return a - b;
+        case InstructionOpcode::ALU_MUL: return a * b;
+        case InstructionOpcode::ALU_DIV: return b != 0 ? a / b : 0xFFFFFFFF;
+        case InstructionOpcode::ALU_AND: return a & b;
+        case InstructionOpcode::ALU_OR:  return a | b;
+        case InstructionOpcode::ALU_XOR: return a ^ b;
+        case InstructionOpcode::ALU_NOT: return ~a;
+        case InstructionOpcode::ALU_SHL: return a << (b & 31);
+        case InstructionOpcode::ALU_SHR: return a >> (b & 31);
+        default: return 0;
+    }
+}
+
+void FunctionalCore::end_block(uint32_t next_pc) {
+    if (block_observer_ && block_length_ > 0) {
+        block_observer_(block_start_pc_, block_length_);
+    }
+    block_start_pc_ = next_pc;
+    block_length_ = 0;
+}
@@ -0,0 +1,101 @@
+#ifndef FUNCTIONAL_CORE_H
+#define FUNCTIONAL_CORE_H
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include "instruction_decoder.h"
+#include "kernel_image.h"
+#include "../memory_subsystem/global_memory.h"
+
+// Instruction-level functional model of the shader core ISA
+//
+// Executes instruction words without any timing, directly against a
+// GlobalMemory instance. Used to fast-forward kernels between detailed
+// simulation intervals and to profile basic-block behaviour.
+//
+// Semantics follow the ShaderCore instruction format:
+//   ALU ops        dst = src1 op src2
+//   MEM_LOAD       dst = mem32[src1 + imm]
+//   MEM_STORE      mem32[src1 + imm] = dst
+//   MEM_ATOMIC     dst = mem32[src1]; mem32[src1] += src2
+//   BRANCH         pc += simm
+//   BRANCH_COND    pc += simm if src1 != 0
+//   JUMP / CALL    pc = imm (CALL pushes the return address)
+//   RETURN         pops the return address, halts on an empty call stack
+// Tensor, barrier and sync operations retire without side effects (barrier
+// and sync are reported to the access observer).
+class FunctionalCore {
+public:
+    // Constructor
+    FunctionalCore(GlobalMemory& memory, uint32_t num_registers = 32);
+    
+    // Program loading (PC is a word index into the program). Registers and
+    // memory are left untouched so callers can initialize them beforehand.
+    void load_program(const std::vector<uint32_t>& program, uint32_t entry_pc = 0);
+    
+    // Execute a program in place without copying it (e.g. a memory-mapped
+    // kernel image); the caller keeps the code alive while the core runs
+    void load_program(const uint32_t* code, uint64_t num_words, uint32_t entry_pc = 0);
+    void load_kernel(const MappedKernel& kernel);
+    
+    // Execution
+    bool step();                                  // Returns false once halted
+    uint64_t run(uint64_t max_instructions);      // Returns instructions executed
+    
+    // Architectural state
+    uint32_t pc() const { return pc_; }
+    bool halted() const { return halted_; }
+    uint64_t instructions_retired() const { return instructions_retired_; }
+    uint32_t read_register(uint32_t reg) const;
+    void write_register(uint32_t reg, uint32_t value);
+    const std::vector<uint32_t>& registers() const { return registers_; }
+    void set_registers(const std::vector<uint32_t>& registers);
+    GlobalMemory& memory() { return memory_; }
+    
+    // Basic block observer, called when a block ends with its start PC and
+    // number of instructions. Blocks end at control flow and on halt.
+    using BlockObserver = std::function<void(uint32_t block_start_pc, uint32_t block_length)>;
+    void set_block_observer(BlockObserver observer) { block_observer_ = observer; }
+    
+    // Access observer, called before each memory, barrier and sync
+    // instruction takes effect with its opcode and effective address (0 for
+    // barrier and sync). Timed wrappers use it to charge latency and to
+    // synchronise before accesses other agents can observe.
+    using AccessObserver = std::function<void(InstructionOpcode opcode, uint64_t addr)>;
+    void set_access_observer(AccessObserver observer) { access_observer_ = observer; }
+    
+private:
+    GlobalMemory& memory_;
+    
+    // Architectural state
+    std::vector<uint32_t> owned_program_;
+    const uint32_t* program_;
+    uint64_t program_words_;
+    std::vector<uint32_t> registers_;
+    std::vector<uint32_t> call_stack_;
+    uint32_t pc_;
+    bool halted_;
+    uint64_t instructions_retired_;
+    
+    // Observers
+    AccessObserver access_observer_;
+    
+    // Basic block tracking
+    BlockObserver block_observer_;
+    uint32_t block_start_pc_;
+    uint32_t block_length_;
+    
+    // Helper methods
+    uint32_t load_word(uint64_t addr) const;
+    void store_word(uint64_t addr, uint32_t data);
+    uint32_t execute_alu(InstructionOpcode opcode, uint32_t a, uint32_t b) const;
+    void end_block(uint32_t next_pc);
+    void notify_access(InstructionOpcode opcode, uint64_t addr) {
+        if (access_observer_) {
+            access_observer_(opcode, addr);
+        }
+    }
+};
+
+#endif // FUNCTIONAL_CORE_H
@@ -5,6 +5,10 @@
 #include <queue>
 #include <cstdint>
 
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
 // Instruction buffer class
 class InstructionBuffer : public sc_module {
 public:
@@ -35,6 +39,10 @@ public:
     uint32_t size() const;
     uint32_t capacity() const;
     
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
 private:
     // Buffer storage
     std::queue<uint32_t> buffer_;
@@ -3,6 +3,7 @@
 
 #include <systemc.h>
 #include <cstdint>
+#include "instruction_format.h"
 
 // Instruction opcodes
 enum class InstructionOpcode {
@@ -90,18 +91,18 @@ public:
     void decode_process();
     
 private:
-    // Instruction format constants
-    static const uint32_t OPCODE_MASK = 0xFC000000;
-    static const uint32_t OPCODE_SHIFT = 26;
-    static const uint32_t REG_DST_MASK = 0x03E00000;
-    static const uint32_t REG_DST_SHIFT = 21;
-    static const uint32_t REG_SRC1_MASK = 0x001F0000;
-    static const uint32_t REG_SRC1_SHIFT = 16;
-    static const uint32_t REG_SRC2_MASK = 0x0000F800;
-    static const uint32_t REG_SRC2_SHIFT = 11;
-    static const uint32_t IMM_MASK = 0x0000FFFF;
-    static const uint32_t PRED_MASK = 0x03800000;
-    static const uint32_t PRED_SHIFT = 23;
+    // Instruction format constants (see instruction_format.h)
+    static const uint32_t OPCODE_MASK = instruction_format::OPCODE_MASK;
+    static const uint32_t OPCODE_SHIFT = instruction_format::OPCODE_SHIFT;
+    static const uint32_t REG_DST_MASK = instruction_format::REG_DST_MASK;
+    static const uint32_t REG_DST_SHIFT = instruction_format::REG_DST_SHIFT;
+    static const uint32_t REG_SRC1_MASK = instruction_format::REG_SRC1_MASK;
+    static const uint32_t REG_SRC1_SHIFT = instruction_format::REG_SRC1_SHIFT;
+    static const uint32_t REG_SRC2_MASK = instruction_format::REG_SRC2_MASK;
+    static const uint32_t REG_SRC2_SHIFT = instruction_format::REG_SRC2_SHIFT;
+    static const uint32_t IMM_MASK = instruction_format::IMM_MASK;
+    static const uint32_t PRED_MASK = instruction_format::PRED_MASK;
+    static const uint32_t PRED_SHIFT = instruction_format::PRED_SHIFT;
     
     // Helper methods
     InstructionOpcode decode_opcode(uint32_t raw_instr);
@@ -0,0 +1,35 @@
+#ifndef INSTRUCTION_FORMAT_H
+#define INSTRUCTION_FORMAT_H
+
+#include <cstdint>
+
+// 32-bit instruction word layout shared by the decoder and by tools that
+// encode or interpret instruction words outside the pipeline. The opcode
+// field holds the InstructionOpcode enumerator value.
+namespace instruction_format {
+
+static const uint32_t OPCODE_MASK = 0xFC000000;
+static const uint32_t OPCODE_SHIFT = 26;
+static const uint32_t REG_DST_MASK = 0x03E00000;
+static const uint32_t REG_DST_SHIFT = 21;
+static const uint32_t REG_SRC1_MASK = 0x001F0000;
+static const uint32_t REG_SRC1_SHIFT = 16;
+static const uint32_t REG_SRC2_MASK = 0x0000F800;
+static const uint32_t REG_SRC2_SHIFT = 11;
+static const uint32_t IMM_MASK = 0x0000FFFF;
+static const uint32_t PRED_MASK = 0x03800000;
+static const uint32_t PRED_SHIFT = 23;
+
+// Field extraction
+inline uint32_t opcode_field(uint32_t word) { return (word & OPCODE_MASK) >> OPCODE_SHIFT; }
+inline uint32_t dst_field(uint32_t word) { return (word & REG_DST_MASK) >> REG_DST_SHIFT; }
+inline uint32_t src1_field(uint32_t word) { return (word & REG_SRC1_MASK) >> REG_SRC1_SHIFT; }
+inline uint32_t src2_field(uint32_t word) { return (word & REG_SRC2_MASK) >> REG_SRC2_SHIFT; }
+inline uint32_t imm_field(uint32_t word) { return word & IMM_MASK; }
+
+// Sign-extended immediate (branch offsets)
+inline int32_t simm_field(uint32_t word) { return static_cast<int16_t>(word & IMM_MASK); }
+
+}  // namespace instruction_format
+
+#endif // INSTRUCTION_FORMAT_H
@@ -0,0 +1,200 @@
+#include "kernel_image.h"
+#include "../memory_subsystem/global_memory.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+uint64_t align_up(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void append_u32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+    }
+}
+
+uint32_t read_u32(const uint8_t* in) {
+    uint32_t value;
+    std::memcpy(&value, in, sizeof(value));
+    return value;
+}
+
+}  // namespace
+
+// Image writer
+
+void write_kernel_image(const Kernel& kernel, const std::string& path) {
+    // Metadata block; the kernel name is stored under the "name" key
+    std::map<std::string, std::string> metadata = kernel.metadata;
+    if (!kernel.name.empty()) {
+        metadata["name"] = kernel.name;
+    }
+    std::vector<uint8_t> meta_bytes;
+    append_u32(meta_bytes, static_cast<uint32_t>(metadata.size()));
+    for (const auto& entry : metadata) {
+        append_u32(meta_bytes, static_cast<uint32_t>(entry.first.size()));
+        meta_bytes.insert(meta_bytes.end(), entry.first.begin(), entry.first.end());
+        append_u32(meta_bytes, static_cast<uint32_t>(entry.second.size()));
+        meta_bytes.insert(meta_bytes.end(), entry.second.begin(), entry.second.end());
+    }
+    
+    kernel_format::Header header = {};
+    header.magic = kernel_format::MAGIC;
+    header.version = kernel_format::VERSION;
+    header.entry_pc = kernel.entry_pc;
+    header.code_offset = align_up(sizeof(header), kernel_format::SECTION_ALIGNMENT);
+    header.code_words = kernel.code.size();
+    header.data_offset = align_up(header.code_offset + kernel.code.size() * sizeof(uint32_t),
+                                  kernel_format::SECTION_ALIGNMENT);
+    header.data_size = kernel.data.size();
+    header.data_load_address = kernel.data_load_address;
+    header.metadata_offset = align_up(header.data_offset + kernel.data.size(),
+                                      kernel_format::SECTION_ALIGNMENT);
+    header.metadata_size = meta_bytes.size();
+    
+    std::vector<uint8_t> image(header.metadata_offset + meta_bytes.size(), 0);
+    std::memcpy(image.data(), &header, sizeof(header));
+    std::memcpy(image.data() + header.code_offset, kernel.code.data(),
+                kernel.code.size() * sizeof(uint32_t));
+    std::memcpy(image.data() + header.data_offset, kernel.data.data(), kernel.data.size());
+    std::memcpy(image.data() + header.metadata_offset, meta_bytes.data(), meta_bytes.size());
+    
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    if (!out) {
+        throw std::runtime_error("Cannot open kernel image for writing: " + path);
+    }
+    out.write(reinterpret_cast<const char*>(image.data()), image.size());
+    if (!out) {
+        throw std::runtime_error("Failed to write kernel image: " + path);
+    }
+}
+
+// MappedKernel implementation
+
+MappedKernel::MappedKernel(const std::string& path)
+    : mapping_(nullptr), mapping_size_(0), header_(), code_(nullptr), data_(nullptr) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Cannot open kernel image: " + path);
+    }
+    struct stat st;
+    if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(header_)) {
+        ::close(fd);
+        throw std::runtime_error("Kernel image too small: " + path);
+    }
+    mapping_size_ = st.st_size;
+    mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping_ == MAP_FAILED) {
+        mapping_ = nullptr;
+        throw std::runtime_error("Cannot map kernel image: " + path);
+    }
+    
+    const uint8_t* base = static_cast<const uint8_t*>(mapping_);
+    std::memcpy(&header_, base, sizeof(header_));
+    
+    // Validate before exposing any views into the mapping
+    bool valid = header_.magic == kernel_format::MAGIC &&
+                 header_.version == kernel_format::VERSION &&
+                 header_.code_offset % kernel_format::SECTION_ALIGNMENT == 0 &&
+                 header_.code_offset <= mapping_size_ &&
+                 header_.code_words <= (mapping_size_ - header_.code_offset) / sizeof(uint32_t) &&
+                 header_.data_offset <= mapping_size_ &&
+                 header_.data_size <= mapping_size_ - header_.data_offset &&
+                 header_.metadata_offset <= mapping_size_ &&
+                 header_.metadata_size <= mapping_size_ - header_.metadata_offset;
+    if (!valid) {
+        unmap();
+        throw std::runtime_error("Invalid kernel image: " + path);
+    }
+    code_ = reinterpret_cast<const uint32_t*>(base + header_.code_offset);
+    data_ = base + header_.data_offset;
+    
+    // Metadata is small; decode it eagerly
+    const uint8_t* meta = base + header_.metadata_offset;
+    const uint8_t* meta_end = meta + header_.metadata_size;
+    auto read_string = [&](std::string& value) {
+        if (meta_end - meta < 4) {
+            return false;
+        }
+        uint32_t length = read_u32(meta);
+        meta += 4;
+        if (static_cast<uint64_t>(meta_end - meta) < length) {
+            return false;
+        }
+        value.assign(reinterpret_cast<const char*>(meta), length);
+        meta += length;
+        return true;
+    };
+    if (header_.metadata_size >= 4) {
+        uint32_t count = read_u32(meta);
+        meta += 4;
+        for (uint32_t i = 0; i < count; i++) {
+            std::string key;
+            std::string value;
+            if (!read_string(key) || !read_string(value)) {
+                unmap();
+                throw std::runtime_error("Corrupt kernel metadata: " + path);
+            }
+            metadata_[key] = value;
+        }
+    }
+}
+
+MappedKernel::~MappedKernel() {
+    unmap();
+}
+
+MappedKernel::MappedKernel(MappedKernel&& other) noexcept
+    : mapping_(other.mapping_),
+      mapping_size_(other.mapping_size_),
+      header_(other.header_),
+      code_(other.code_),
+      data_(other.data_),
+      metadata_(std::move(other.metadata_)) {
+    other.mapping_ = nullptr;
+    other.mapping_size_ = 0;
+    other.code_ = nullptr;
+    other.data_ = nullptr;
+}
+
+MappedKernel& MappedKernel::operator=(MappedKernel&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        mapping_ = other.mapping_;
+        mapping_size_ = other.mapping_size_;
+        header_ = other.header_;
+        code_ = other.code_;
+        data_ = other.data_;
+        metadata_ = std::move(other.metadata_);
+        other.mapping_ = nullptr;
+        other.mapping_size_ = 0;
+        other.code_ = nullptr;
+        other.data_ = nullptr;
+    }
+    return *this;
+}
+
+std::string MappedKernel::name() const {
+    auto it = metadata_.find("name");
+    return it != metadata_.end() ? it->second : std::string();
+}
+
+void MappedKernel::load_data(GlobalMemory& memory) const {
+    memory.write_block(header_.data_load_address, data_, header_.data_size);
+}
+
+void MappedKernel::unmap() {
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, mapping_size_);
+        mapping_ = nullptr;
+    }
+}
@@ -0,0 +1,97 @@
+#ifndef KERNEL_IMAGE_H
+#define KERNEL_IMAGE_H
+
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Forward declarations
+class GlobalMemory;
+
+// Binary kernel container
+//
+// Layout (little-endian):
+//   Header         fixed-size, see kernel_format::Header
+//   Code section   instruction words, aligned to SECTION_ALIGNMENT
+//   Data section   constant data bytes, aligned to SECTION_ALIGNMENT
+//   Metadata       count followed by length-prefixed key/value strings
+//
+// Sections are aligned so that a memory-mapped image can be used in place
+// as the core's instruction memory.
+namespace kernel_format {
+
+static const uint32_t MAGIC = 0x4E4B5347;  // "GSKN"
+static const uint32_t VERSION = 1;
+static const uint64_t SECTION_ALIGNMENT = 64;
+
+struct Header {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_pc;
+    uint32_t reserved;
+    uint64_t code_offset;
+    uint64_t code_words;
+    uint64_t data_offset;
+    uint64_t data_size;
+    uint64_t data_load_address;
+    uint64_t metadata_offset;
+    uint64_t metadata_size;
+};
+
+}  // namespace kernel_format
+
+// In-memory kernel, as produced by the assembler
+struct Kernel {
+    std::string name;
+    std::vector<uint32_t> code;
+    std::vector<uint8_t> data;
+    uint64_t data_load_address = 0;
+    uint32_t entry_pc = 0;
+    std::map<std::string, std::string> metadata;
+};
+
+// Write a kernel image file (throws std::runtime_error on I/O failure)
+void write_kernel_image(const Kernel& kernel, const std::string& path);
+
+// Read-only memory-mapped kernel image
+//
+// The code and data sections are views into the mapping; nothing is copied
+// until load_data() places the data section in global memory.
+class MappedKernel {
+public:
+    // Constructor maps and validates the image (throws std::runtime_error)
+    explicit MappedKernel(const std::string& path);
+    ~MappedKernel();
+    
+    // Move-only
+    MappedKernel(MappedKernel&& other) noexcept;
+    MappedKernel& operator=(MappedKernel&& other) noexcept;
+    MappedKernel(const MappedKernel&) = delete;
+    MappedKernel& operator=(const MappedKernel&) = delete;
+    
+    // Sections
+    const uint32_t* code() const { return code_; }
+    uint64_t code_words() const { return header_.code_words; }
+    const uint8_t* data() const { return data_; }
+    uint64_t data_size() const { return header_.data_size; }
+    uint64_t data_load_address() const { return header_.data_load_address; }
+    uint32_t entry_pc() const { return header_.entry_pc; }
+    const std::map<std::string, std::string>& metadata() const { return metadata_; }
+    std::string name() const;
+    
+    // Copy the constant data section to its load address
+    void load_data(GlobalMemory& memory) const;
+    
+private:
+    void* mapping_;
+    size_t mapping_size_;
+    kernel_format::Header header_;
+    const uint32_t* code_;
+    const uint8_t* data_;
+    std::map<std::string, std::string> metadata_;
+    
+    void unmap();
+};
+
+#endif // KERNEL_IMAGE_H
@@ -5,6 +5,10 @@
 #include <vector>
 #include <cstdint>
 
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
 // Shader Register file class - renamed to avoid conflict with memory subsystem RegisterFile
 class ShaderRegisterFile : public sc_module {
 public:
@@ -38,6 +42,10 @@ public:
     // Register file info
     uint32_t size() const { return registers_.size(); }
     
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
 private:
     // Register storage
     std::vector<uint32_t> registers_;
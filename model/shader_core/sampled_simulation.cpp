@@ -0,0 +1,336 @@
+#include "sampled_simulation.h"
+#include "../common/checkpoint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace {
+
+// Deterministic projection coefficient in [-1, 1] for (block, dimension)
+double projection_coefficient(uint32_t block_start_pc, uint32_t dim) {
+    uint64_t x = (static_cast<uint64_t>(block_start_pc) << 32) | dim;
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return static_cast<double>(x >> 11) / static_cast<double>(1ULL << 52) - 1.0;
+}
+
+}  // namespace
+
+SampledSimulator::SampledSimulator(const SamplingConfig& config)
+    : config_(config),
+      total_instructions_(0),
+      num_clusters_(0) {
+}
+
+void SampledSimulator::profile(FunctionalCore& core, const std::vector<uint32_t>& program,
+                               uint64_t max_instructions) {
+    intervals_.clear();
+    bbvs_.clear();
+    samples_.clear();
+    num_clusters_ = 0;
+    
+    // Snapshot the starting state; profiling mutates registers and memory.
+    // save_state() leaves the incremental checkpoint baseline alone.
+    CheckpointWriter snapshot;
+    core.memory().save_state(snapshot);
+    initial_memory_ = snapshot.buffer();
+    initial_registers_ = core.registers();
+    
+    std::vector<double> current(config_.projection_dims, 0.0);
+    core.load_program(program);
+    core.set_block_observer([this, &current](uint32_t block_start_pc, uint32_t block_length) {
+        project_block(block_start_pc, block_length, current);
+    });
+    
+    uint64_t executed = 0;
+    while (!core.halted() && executed < max_instructions) {
+        uint64_t budget = std::min(config_.interval_length, max_instructions - executed);
+        uint64_t length = core.run(budget);
+        if (length == 0) {
+            break;
+        }
+        
+        // Normalize so intervals of different length are comparable
+        for (double& value : current) {
+            value /= static_cast<double>(length);
+        }
+        intervals_.push_back({intervals_.size(), executed, length, 0});
+        bbvs_.push_back(current);
+        current.assign(config_.projection_dims, 0.0);
+        executed += length;
+    }
+    
+    core.set_block_observer(nullptr);
+    total_instructions_ = executed;
+}
+
+const std::vector<SamplingInterval>& SampledSimulator::select() {
+    samples_.clear();
+    num_clusters_ = 0;
+    if (intervals_.empty()) {
+        return samples_;
+    }
+    
+    // Cluster for every candidate k and score with BIC. BIC is undefined
+    // once every interval could sit in its own cluster, so k stays below
+    // the interval count (a single interval is trivially one cluster).
+    uint32_t max_k = std::min<uint64_t>(config_.max_clusters, std::max<size_t>(intervals_.size() - 1, 1));
+    std::vector<std::vector<uint32_t>> assignments(max_k + 1);
+    std::vector<std::vector<std::vector<double>>> centroids(max_k + 1);
+    std::vector<double> scores(max_k + 1, -std::numeric_limits<double>::infinity());
+    double best = -std::numeric_limits<double>::infinity();
+    double worst = std::numeric_limits<double>::infinity();
+    for (uint32_t k = 1; k <= max_k; k++) {
+        double sse = kmeans(k, assignments[k], centroids[k]);
+        scores[k] = bic_score(k, assignments[k], sse);
+        if (std::isfinite(scores[k])) {
+            best = std::max(best, scores[k]);
+            worst = std::min(worst, scores[k]);
+        }
+    }
+    
+    // Smallest k whose score reaches the threshold fraction of the BIC range
+    uint32_t chosen = 1;
+    if (best >= worst) {
+        for (uint32_t k = 1; k <= max_k; k++) {
+            if (std::isfinite(scores[k]) && scores[k] >= worst + config_.bic_threshold * (best - worst)) {
+                chosen = k;
+                break;
+            }
+        }
+    }
+    num_clusters_ = chosen;
+    
+    // Pick the intervals closest to each centroid as representatives
+    std::vector<std::vector<uint64_t>> members(chosen);
+    for (size_t i = 0; i < intervals_.size(); i++) {
+        intervals_[i].cluster = assignments[chosen][i];
+        members[intervals_[i].cluster].push_back(i);
+    }
+    for (uint32_t c = 0; c < chosen; c++) {
+        const std::vector<double>& centroid = centroids[chosen][c];
+        std::sort(members[c].begin(), members[c].end(), [&](uint64_t a, uint64_t b) {
+            return distance_sq(bbvs_[a], centroid) < distance_sq(bbvs_[b], centroid);
+        });
+        size_t count = std::min<size_t>(config_.samples_per_cluster, members[c].size());
+        for (size_t i = 0; i < count; i++) {
+            samples_.push_back(intervals_[members[c][i]]);
+        }
+    }
+    std::sort(samples_.begin(), samples_.end(),
+              [](const SamplingInterval& a, const SamplingInterval& b) {
+                  return a.start_instruction < b.start_instruction;
+              });
+    return samples_;
+}
+
+void SampledSimulator::fast_forward(FunctionalCore& core, const std::vector<uint32_t>& program,
+                                    const PositionFn& at_sample) {
+    if (!initial_memory_.empty()) {
+        CheckpointReader snapshot(initial_memory_);
+        core.memory().restore_state(snapshot);
+        core.set_registers(initial_registers_);
+    }
+    core.load_program(program);
+    for (const SamplingInterval& sample : samples_) {
+        uint64_t warmup = std::min(config_.warmup_length, sample.start_instruction);
+        uint64_t target = sample.start_instruction - warmup;
+        if (target > core.instructions_retired()) {
+            core.run(target - core.instructions_retired());
+        }
+        at_sample(sample, core);
+    }
+}
+
+SampledSimulationResult SampledSimulator::estimate(const DetailedRunFn& run_detailed) const {
+    SampledSimulationResult result;
+    result.total_instructions = total_instructions_;
+    result.detailed_instructions = 0;
+    result.num_clusters = num_clusters_;
+    result.samples = samples_;
+    
+    // Per-cluster population statistics
+    std::vector<uint64_t> cluster_instructions(num_clusters_, 0);
+    std::vector<uint64_t> cluster_intervals(num_clusters_, 0);
+    for (const SamplingInterval& interval : intervals_) {
+        cluster_instructions[interval.cluster] += interval.length;
+        cluster_intervals[interval.cluster]++;
+    }
+    
+    // Detailed simulation of every sample
+    std::vector<std::vector<double>> cluster_cpi(num_clusters_);
+    for (const SamplingInterval& sample : samples_) {
+        uint64_t warmup = std::min(config_.warmup_length, sample.start_instruction);
+        uint64_t cycles = run_detailed(sample, warmup);
+        result.sample_cycles.push_back(cycles);
+        result.detailed_instructions += warmup + sample.length;
+        cluster_cpi[sample.cluster].push_back(static_cast<double>(cycles) / sample.length);
+    }
+    
+    // Stratified estimate: clusters are strata, intervals are sampling units
+    double estimate = 0.0;
+    double variance = 0.0;
+    double pooled_sum = 0.0;
+    uint64_t pooled_dof = 0;
+    std::vector<double> cluster_var(num_clusters_, -1.0);
+    for (uint32_t c = 0; c < num_clusters_; c++) {
+        const std::vector<double>& cpi = cluster_cpi[c];
+        if (cpi.empty()) {
+            continue;
+        }
+        double mean = 0.0;
+        for (double value : cpi) {
+            mean += value;
+        }
+        mean /= cpi.size();
+        estimate += mean * cluster_instructions[c];
+        
+        if (cpi.size() >= 2) {
+            double ss = 0.0;
+            for (double value : cpi) {
+                ss += (value - mean) * (value - mean);
+            }
+            cluster_var[c] = ss / (cpi.size() - 1);
+            pooled_sum += ss;
+            pooled_dof += cpi.size() - 1;
+        }
+    }
+    
+    // Clusters with a single sample borrow the pooled within-cluster variance
+    result.has_confidence_bounds = pooled_dof > 0;
+    double pooled_var = pooled_dof > 0 ? pooled_sum / pooled_dof : 0.0;
+    for (uint32_t c = 0; c < num_clusters_; c++) {
+        size_t n = cluster_cpi[c].size();
+        if (n == 0) {
+            continue;
+        }
+        double var = cluster_var[c] >= 0.0 ? cluster_var[c] : pooled_var;
+        double fpc = 1.0 - static_cast<double>(n) / cluster_intervals[c];
+        double weight = static_cast<double>(cluster_instructions[c]);
+        variance += weight * weight * fpc * var / n;
+    }
+    
+    double half_width = config_.confidence_z * std::sqrt(variance);
+    result.estimated_cycles = estimate;
+    result.lower_bound_cycles = std::max(0.0, estimate - half_width);
+    result.upper_bound_cycles = estimate + half_width;
+    return result;
+}
+
+void SampledSimulator::project_block(uint32_t block_start_pc, uint32_t block_length,
+                                     std::vector<double>& bbv) const {
+    for (uint32_t d = 0; d < bbv.size(); d++) {
+        bbv[d] += block_length * projection_coefficient(block_start_pc, d);
+    }
+}
+
+double SampledSimulator::kmeans(uint32_t k, std::vector<uint32_t>& assignment,
+                                std::vector<std::vector<double>>& centroids) const {
+    size_t n = bbvs_.size();
+    std::mt19937 rng(config_.random_seed + k);
+    
+    // k-means++ seeding
+    centroids.clear();
+    centroids.push_back(bbvs_[std::uniform_int_distribution<size_t>(0, n - 1)(rng)]);
+    std::vector<double> nearest(n, std::numeric_limits<double>::infinity());
+    while (centroids.size() < k) {
+        double total = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            nearest[i] = std::min(nearest[i], distance_sq(bbvs_[i], centroids.back()));
+            total += nearest[i];
+        }
+        size_t pick = 0;
+        if (total > 0.0) {
+            double r = std::uniform_real_distribution<double>(0.0, total)(rng);
+            while (pick + 1 < n && r > nearest[pick]) {
+                r -= nearest[pick];
+                pick++;
+            }
+        }
+        centroids.push_back(bbvs_[pick]);
+    }
+    
+    // Lloyd iterations
+    assignment.assign(n, 0);
+    double sse = 0.0;
+    for (uint32_t iter = 0; iter < config_.kmeans_iterations; iter++) {
+        bool changed = false;
+        sse = 0.0;
+        for (size_t i = 0; i < n; i++) {
+            uint32_t best = 0;
+            double best_dist = std::numeric_limits<double>::infinity();
+            for (uint32_t c = 0; c < k; c++) {
+                double dist = distance_sq(bbvs_[i], centroids[c]);
+                if (dist < best_dist) {
+                    best_dist = dist;
+                    best = c;
+                }
+            }
+            changed |= (iter == 0 || assignment[i] != best);
+            assignment[i] = best;
+            sse += best_dist;
+        }
+        if (!changed) {
+            break;
+        }
+        
+        std::vector<std::vector<double>> sums(k, std::vector<double>(config_.projection_dims, 0.0));
+        std::vector<size_t> counts(k, 0);
+        for (size_t i = 0; i < n; i++) {
+            for (uint32_t d = 0; d < config_.projection_dims; d++) {
+                sums[assignment[i]][d] += bbvs_[i][d];
+            }
+            counts[assignment[i]]++;
+        }
+        for (uint32_t c = 0; c < k; c++) {
+            if (counts[c] == 0) {
+                continue;  // Keep empty clusters at their previous position
+            }
+            for (uint32_t d = 0; d < config_.projection_dims; d++) {
+                centroids[c][d] = sums[c][d] / counts[c];
+            }
+        }
+    }
+    return sse;
+}
+
+double SampledSimulator::bic_score(uint32_t k, const std::vector<uint32_t>& assignment,
+                                   double sse) const {
+    // Spherical Gaussian BIC as used by X-means / SimPoint
+    double r = static_cast<double>(assignment.size());
+    double d = static_cast<double>(config_.projection_dims);
+    if (r <= k) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    double variance = std::max(sse / (r - k), 1e-12);
+    
+    std::vector<double> sizes(k, 0.0);
+    for (uint32_t c : assignment) {
+        sizes[c] += 1.0;
+    }
+    double log_likelihood = 0.0;
+    for (double rn : sizes) {
+        if (rn <= 0.0) {
+            continue;
+        }
+        log_likelihood += -rn / 2.0 * std::log(2.0 * M_PI)
+                        - rn * d / 2.0 * std::log(variance)
+                        - (rn - k) / 2.0
+                        + rn * std::log(rn) - rn * std::log(r);
+    }
+    double params = (k - 1) + k * d + 1;
+    return log_likelihood - params / 2.0 * std::log(r);
+}
+
+double SampledSimulator::distance_sq(const std::vector<double>& a, const std::vector<double>& b) {
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); i++) {
+        double diff = a[i] - b[i];
+        sum += diff * diff;
+    }
+    return sum;
+}
@@ -0,0 +1,110 @@
+#ifndef SAMPLED_SIMULATION_H
+#define SAMPLED_SIMULATION_H
+
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include "functional_core.h"
+
+// SimPoint-style sampled simulation
+//
+// 1. profile():      run the kernel functionally and collect a basic block
+//                    vector (BBV) per fixed-length interval
+// 2. select():       cluster the BBVs with k-means (k chosen by BIC) and pick
+//                    the intervals closest to each centroid as samples
+// 3. fast_forward(): restore the initial state and re-run functionally,
+//                    stopping at the warmup start of each sample so the caller
+//                    can position the detailed model (e.g. via a checkpoint)
+// 4. estimate():     combine detailed cycle counts of the samples into a
+//                    total cycle estimate with stratified confidence bounds
+
+// Sampling configuration
+struct SamplingConfig {
+    uint64_t interval_length = 100000;   // Instructions per interval
+    uint64_t warmup_length = 10000;      // Detailed warmup before each sample
+    uint32_t max_clusters = 10;          // Upper bound for k
+    uint32_t samples_per_cluster = 2;    // >= 2 needed for per-cluster variance
+    uint32_t projection_dims = 15;       // Random projection of BBVs
+    uint32_t kmeans_iterations = 100;
+    uint32_t random_seed = 42;
+    double bic_threshold = 0.9;          // Fraction of BIC range to accept k
+    double confidence_z = 1.96;          // 95% two-sided
+};
+
+// A simulation interval of the profiled kernel
+struct SamplingInterval {
+    uint64_t index;
+    uint64_t start_instruction;
+    uint64_t length;
+    uint32_t cluster;
+};
+
+// Result of a sampled simulation
+struct SampledSimulationResult {
+    double estimated_cycles;
+    double lower_bound_cycles;
+    double upper_bound_cycles;
+    bool has_confidence_bounds;          // False if no cluster had >= 2 samples
+    uint64_t total_instructions;
+    uint64_t detailed_instructions;      // Including warmup
+    uint32_t num_clusters;
+    std::vector<SamplingInterval> samples;
+    std::vector<uint64_t> sample_cycles;
+};
+
+class SampledSimulator {
+public:
+    // Detailed simulation of one sample: the callee runs warmup_instructions
+    // followed by interval.length instructions and returns the cycles spent
+    // in the interval proper (warmup excluded)
+    using DetailedRunFn = std::function<uint64_t(const SamplingInterval& interval,
+                                                 uint64_t warmup_instructions)>;
+    
+    // Called by fast_forward() when the functional core reaches the start of
+    // a sample's warmup window
+    using PositionFn = std::function<void(const SamplingInterval& interval,
+                                          const FunctionalCore& core)>;
+    
+    // Constructor
+    SampledSimulator(const SamplingConfig& config = SamplingConfig());
+    
+    // Sampling phases
+    void profile(FunctionalCore& core, const std::vector<uint32_t>& program,
+                 uint64_t max_instructions = UINT64_MAX);
+    const std::vector<SamplingInterval>& select();
+    void fast_forward(FunctionalCore& core, const std::vector<uint32_t>& program,
+                      const PositionFn& at_sample);
+    SampledSimulationResult estimate(const DetailedRunFn& run_detailed) const;
+    
+    // Profiling results
+    const std::vector<SamplingInterval>& intervals() const { return intervals_; }
+    const std::vector<SamplingInterval>& samples() const { return samples_; }
+    uint32_t num_clusters() const { return num_clusters_; }
+    uint64_t total_instructions() const { return total_instructions_; }
+    
+private:
+    SamplingConfig config_;
+    
+    // Initial architectural state captured by profile() so fast_forward()
+    // replays the kernel from the same starting point
+    std::vector<uint32_t> initial_registers_;
+    std::vector<uint8_t> initial_memory_;
+    
+    // Per-interval projected BBVs
+    std::vector<SamplingInterval> intervals_;
+    std::vector<std::vector<double>> bbvs_;
+    uint64_t total_instructions_;
+    
+    // Clustering results
+    uint32_t num_clusters_;
+    std::vector<SamplingInterval> samples_;
+    
+    // Helper methods
+    void project_block(uint32_t block_start_pc, uint32_t block_length, std::vector<double>& bbv) const;
+    double kmeans(uint32_t k, std::vector<uint32_t>& assignment,
+                  std::vector<std::vector<double>>& centroids) const;
+    double bic_score(uint32_t k, const std::vector<uint32_t>& assignment, double sse) const;
+    static double distance_sq(const std::vector<double>& a, const std::vector<double>& b);
+};
+
+#endif // SAMPLED_SIMULATION_H
@@ -0,0 +1,127 @@
+// Checkpoint save/restore for the shader core pipeline
+//
+// Only architectural and microarchitectural state is saved. Inter-module
+// signals are not; they settle on the first clock edge after restore.
+
+#include "shader_core.h"
+#include "../common/checkpoint.h"
+
+#include <queue>
+#include <stdexcept>
+
+// ShaderRegisterFile
+
+void ShaderRegisterFile::save_state(CheckpointWriter& writer) const {
+    writer.begin_section(checkpoint::SectionTag::SHADER_REGISTER_FILE);
+    writer.write_varint(registers_.size());
+    for (uint32_t value : registers_) {
+        writer.write_varint(value);
+    }
+    writer.end_section();
+}
+
+void ShaderRegisterFile::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::SHADER_REGISTER_FILE);
+    if (reader.read_varint() != registers_.size()) {
+        throw std::runtime_error("Checkpoint configuration mismatch in ShaderRegisterFile size");
+    }
+    for (uint32_t& value : registers_) {
+        value = static_cast<uint32_t>(reader.read_varint());
+    }
+    reader.end_section();
+}
+
+// InstructionBuffer
+
+void InstructionBuffer::save_state(CheckpointWriter& writer) const {
+    writer.begin_section(checkpoint::SectionTag::INSTRUCTION_BUFFER);
+    writer.write_varint(capacity_);
+    std::queue<uint32_t> buffer = buffer_;
+    writer.write_varint(buffer.size());
+    while (!buffer.empty()) {
+        writer.write_varint(buffer.front());
+        buffer.pop();
+    }
+    writer.write_bool(push_ready_);
+    writer.write_bool(pop_valid_);
+    writer.write_varint(pop_instruction_);
+    writer.end_section();
+}
+
+void InstructionBuffer::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::INSTRUCTION_BUFFER);
+    if (reader.read_varint() != capacity_) {
+        throw std::runtime_error("Checkpoint configuration mismatch in InstructionBuffer capacity");
+    }
+    buffer_ = std::queue<uint32_t>();
+    uint64_t count = reader.read_varint();
+    for (uint64_t i = 0; i < count; i++) {
+        buffer_.push(static_cast<uint32_t>(reader.read_varint()));
+    }
+    push_ready_ = reader.read_bool();
+    pop_valid_ = reader.read_bool();
+    pop_instruction_ = static_cast<uint32_t>(reader.read_varint());
+    reader.end_section();
+}
+
+// ExecutionUnit
+
+void ExecutionUnit::save_state(CheckpointWriter& writer) const {
+    writer.begin_section(checkpoint::SectionTag::EXECUTION_UNIT);
+    writer.write_varint(current_result_);
+    writer.write_bool(is_busy_);
+    writer.write_varint(execution_cycles_left_);
+    writer.end_section();
+}
+
+void ExecutionUnit::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::EXECUTION_UNIT);
+    current_result_ = static_cast<uint32_t>(reader.read_varint());
+    is_busy_ = reader.read_bool();
+    execution_cycles_left_ = static_cast<uint32_t>(reader.read_varint());
+    reader.end_section();
+}
+
+// ShaderCore
+
+void ShaderCore::save_state(CheckpointWriter& writer) const {
+    writer.begin_section(checkpoint::SectionTag::SHADER_CORE);
+    writer.write_varint(static_cast<uint64_t>(pc));
+    writer.write_bool(stall);
+    writer.end_section();
+
+    reg_file->save_state(writer);
+    instr_buffer->save_state(writer);
+    exec_unit->save_state(writer);
+    tensor_unit->save_state(writer);
+    mem_subsys->save_state(writer);
+}
+
+void ShaderCore::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::SHADER_CORE);
+    pc = reader.read_varint();
+    stall = reader.read_bool();
+    reader.end_section();
+
+    reg_file->restore_state(reader);
+    instr_buffer->restore_state(reader);
+    exec_unit->restore_state(reader);
+    tensor_unit->restore_state(reader);
+    mem_subsys->restore_state(reader);
+}
+
+void ShaderCore::save_checkpoint(const std::string& path, bool incremental) {
+    CheckpointWriter writer(incremental ? checkpoint::FLAG_INCREMENTAL : 0);
+    save_state(writer);
+    writer.save_to_file(path);
+    mem_subsys->global_memory->mark_checkpoint();
+}
+
+void ShaderCore::restore_checkpoint(const std::string& path) {
+    CheckpointReader reader = CheckpointReader::load_from_file(path);
+    restore_state(reader);
+    if (!reader.at_end()) {
+        throw std::runtime_error("Trailing data in shader core checkpoint: " + path);
+    }
+    mem_subsys->global_memory->mark_checkpoint();
+}
@@ -2,6 +2,7 @@
 #define SHADER_CORE_H
 
 #include <systemc.h>
+#include <string>
 #include "../tensor_unit/tensor_unit.h"
 #include "../memory_subsystem/memory_subsystem.h"
 #include "instruction_decoder.h"
@@ -50,6 +51,16 @@ public:
         sc_signal<TensorData>& input_b_sig,
         sc_signal<TensorData>& output_sig);
     
+    // Checkpointing. Captures PC, stall state, registers, instruction buffer,
+    // execution and tensor unit state and the complete memory hierarchy.
+    // Restore into a freshly elaborated core before starting simulation.
+    // save_checkpoint() and restore_checkpoint() also start the next
+    // incremental epoch.
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    void save_checkpoint(const std::string& path, bool incremental = false);
+    void restore_checkpoint(const std::string& path);
+    
 private:
     // Internal state
     sc_uint<32> pc;
@@ -5,6 +5,10 @@
 #include "tensor_data.h"
 #include <queue>
 
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
 // A buffer for storing and managing tensor data
 class TensorBuffer {
 public:
@@ -24,6 +28,10 @@ public:
     void update();
     void reset();
     
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
 private:
     size_t capacity_;
     std::queue<TensorData> buffer_;
@@ -0,0 +1,88 @@
+// Checkpoint save/restore for the tensor unit
+
+#include "tensor_unit.h"
+#include "../common/checkpoint.h"
+
+#include <queue>
+
+// TensorData
+//
+// Element arrays are stored as raw host-order bytes; checkpoints are not
+// portable across hosts of different endianness.
+
+void TensorData::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(dims_.size());
+    for (size_t dim : dims_) {
+        writer.write_varint(dim);
+    }
+    writer.write_varint(total_elements_);
+    writer.write_varint(static_cast<uint64_t>(precision_));
+
+    writer.write_varint(data_fp32_.size());
+    writer.write_bytes(reinterpret_cast<const uint8_t*>(data_fp32_.data()),
+                       data_fp32_.size() * sizeof(float));
+    writer.write_varint(data_fp16_.size());
+    writer.write_bytes(reinterpret_cast<const uint8_t*>(data_fp16_.data()),
+                       data_fp16_.size() * sizeof(fp16_t));
+    writer.write_byte_vector(data_fp8_);
+    writer.write_byte_vector(data_fp4_);
+}
+
+void TensorData::restore_state(CheckpointReader& reader) {
+    dims_.resize(reader.read_varint());
+    for (size_t& dim : dims_) {
+        dim = reader.read_varint();
+    }
+    total_elements_ = reader.read_varint();
+    precision_ = static_cast<Precision>(reader.read_varint());
+
+    data_fp32_.resize(reader.read_varint());
+    reader.read_bytes(reinterpret_cast<uint8_t*>(data_fp32_.data()),
+                      data_fp32_.size() * sizeof(float));
+    data_fp16_.resize(reader.read_varint());
+    reader.read_bytes(reinterpret_cast<uint8_t*>(data_fp16_.data()),
+                      data_fp16_.size() * sizeof(fp16_t));
+    data_fp8_ = reader.read_byte_vector();
+    data_fp4_ = reader.read_byte_vector();
+}
+
+// TensorBuffer
+
+void TensorBuffer::save_state(CheckpointWriter& writer) const {
+    writer.write_varint(capacity_);
+    std::queue<TensorData> buffer = buffer_;
+    writer.write_varint(buffer.size());
+    while (!buffer.empty()) {
+        buffer.front().save_state(writer);
+        buffer.pop();
+    }
+}
+
+void TensorBuffer::restore_state(CheckpointReader& reader) {
+    capacity_ = reader.read_varint();
+    buffer_ = std::queue<TensorData>();
+    uint64_t count = reader.read_varint();
+    for (uint64_t i = 0; i < count; i++) {
+        TensorData data;
+        data.restore_state(reader);
+        buffer_.push(data);
+    }
+}
+
+// TensorUnit
+
+void TensorUnit::save_state(CheckpointWriter& writer) const {
+    writer.begin_section(checkpoint::SectionTag::TENSOR_UNIT);
+    buffer_a.save_state(writer);
+    buffer_b.save_state(writer);
+    result_buffer.save_state(writer);
+    writer.end_section();
+}
+
+void TensorUnit::restore_state(CheckpointReader& reader) {
+    reader.begin_section(checkpoint::SectionTag::TENSOR_UNIT);
+    buffer_a.restore_state(reader);
+    buffer_b.restore_state(reader);
+    result_buffer.restore_state(reader);
+    reader.end_section();
+}
@@ -7,6 +7,8 @@
 
 // Forward declarations
 class TensorData;
+class CheckpointWriter;
+class CheckpointReader;
 
 // Different precision types for ML workloads
 using fp4_t = uint8_t; // 4-bit floating point (packed)
@@ -50,6 +52,10 @@ public:
     void resize(const std::vector<size_t>& dimensions);
     void change_precision(Precision new_precision);
     
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
     // SystemC conversion functions
     void operator = (const sc_in<TensorData>& port);
     void operator = (const sc_out<TensorData>& port);
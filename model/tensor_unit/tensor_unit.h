@@ -6,6 +6,10 @@
 #include "tensor_buffer.h"
 #include "tensor_opcode.h"
 
+// Forward declarations
+class CheckpointWriter;
+class CheckpointReader;
+
 class TensorUnit : public sc_module {
 public:
     // Ports
@@ -38,6 +42,10 @@ public:
     void attention_mechanism();
     void layer_normalization();
     
+    // Checkpointing
+    void save_state(CheckpointWriter& writer) const;
+    void restore_state(CheckpointReader& reader);
+    
 private:
     // Internal state and buffers
     TensorBuffer buffer_a;
@@ -0,0 +1,1205 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <unordered_map>
+#include <cstdio>
+#include <sstream>
+#include "../../model/memory_subsystem/cache_array.h"
+#include "../../model/memory_subsystem/replacement_policy.h"
+#include "../../model/memory_subsystem/mshr_file.h"
+#include "../../model/memory_subsystem/burst_payload.h"
+#include "../../model/memory_subsystem/memory_coalescer.h"
+#include "../../model/memory_subsystem/prefetcher.h"
+#include "../../model/memory_subsystem/transaction_queue.h"
+#include "../../model/memory_subsystem/concurrent_transaction_queue.h"
+#include "../../model/memory_subsystem/heavy_hitter_tracker.h"
+#include "../../model/memory_subsystem/memory_state.h"
+#include "../../model/memory_subsystem/shared_memory_banks.h"
+#include "../../model/memory_subsystem/atomic_unit.h"
+#include "../../model/memory_subsystem/coherence_directory.h"
+#include "../../model/memory_subsystem/write_policy.h"
+#include "../../model/memory_subsystem/memory_trace.h"
+#include "../../model/memory_subsystem/trace_replay.h"
+#include "../../model/memory_subsystem/cache_sweep.h"
+#include "../../model/memory_subsystem/address_translation.h"
+
+// Cyclic sweep over `blocks` distinct lines, repeated `passes` times
+static std::vector<uint64_t> cyclic_trace(uint32_t blocks, uint32_t passes, uint32_t line_size) {
+    std::vector<uint64_t> trace;
+    for (uint32_t pass = 0; pass < passes; pass++) {
+        for (uint32_t block = 0; block < blocks; block++) {
+            trace.push_back(static_cast<uint64_t>(block) * line_size);
+        }
+    }
+    return trace;
+}
+
+template <typename Policy>
+static ReplacementStats run_trace(const std::vector<uint64_t>& trace,
+                                  uint32_t num_sets, uint32_t associativity) {
+    ReplacementSimulator<Policy> sim(num_sets, associativity, 64);
+    for (uint64_t addr : trace) {
+        sim.access(addr);
+    }
+    return sim.stats();
+}
+
+TEST(ReplacementPolicyTest, LruEvictsLeastRecentlyUsed) {
+    LruPolicy lru(1, 4);
+    for (uint32_t way = 0; way < 4; way++) {
+        lru.on_fill(0, way);
+    }
+    lru.on_hit(0, 0);
+    EXPECT_EQ(lru.victim(0), 1u);
+    lru.on_hit(0, 1);
+    EXPECT_EQ(lru.victim(0), 2u);
+}
+
+TEST(ReplacementPolicyTest, TreePlruNeverEvictsMostRecentlyUsed) {
+    TreePlruPolicy plru(1, 8);
+    for (uint32_t way = 0; way < 8; way++) {
+        plru.on_fill(0, way);
+    }
+    for (uint32_t way = 0; way < 8; way++) {
+        plru.on_hit(0, way);
+        EXPECT_NE(plru.victim(0), way);
+    }
+    EXPECT_THROW(TreePlruPolicy(1, 6), std::invalid_argument);
+}
+
+TEST(ReplacementPolicyTest, RripResistsThrashing) {
+    // A working set one line larger than the cache thrashes LRU completely,
+    // while BRRIP's distant insertion keeps most of it resident
+    std::vector<uint64_t> trace = cyclic_trace(17, 64, 64);
+    ReplacementStats lru = run_trace<LruPolicy>(trace, 1, 16);
+    ReplacementStats brrip = run_trace<BrripPolicy>(trace, 1, 16);
+    
+    EXPECT_EQ(lru.hits, 0u);
+    EXPECT_GT(brrip.hits, trace.size() / 2);
+    EXPECT_EQ(lru.hits + lru.misses, trace.size());
+}
+
+TEST(ReplacementPolicyTest, DrripLeadersTrainPsel) {
+    std::vector<uint64_t> trace = cyclic_trace(128 * 17, 16, 64);
+    ReplacementSimulator<DrripPolicy> sim(128, 16, 64);
+    for (uint64_t addr : trace) {
+        sim.access(addr);
+    }
+    // Thrashing makes the SRRIP leaders miss more, steering followers to BRRIP
+    EXPECT_GT(sim.policy().srrip_leader_misses(), sim.policy().brrip_leader_misses());
+    EXPECT_GE(sim.policy().psel(), 1u << (RripPolicy::PSEL_BITS - 1));
+}
+
+TEST(ReplacementPolicyTest, DrripKeepsFollowersInSmallCaches) {
+    // With 16 sets, four lead for each policy and eight follow PSEL to
+    // BRRIP, so DRRIP hits more than an even split of SRRIP and BRRIP
+    std::vector<uint64_t> trace = cyclic_trace(16 * 17, 64, 64);
+    ReplacementStats srrip = run_trace<SrripPolicy>(trace, 16, 16);
+    ReplacementStats brrip = run_trace<BrripPolicy>(trace, 16, 16);
+    ReplacementSimulator<DrripPolicy> sim(16, 16, 64);
+    for (uint64_t addr : trace) {
+        sim.access(addr);
+    }
+    EXPECT_GT(sim.policy().psel(), 1u << (RripPolicy::PSEL_BITS - 1));
+    EXPECT_GT(sim.stats().hits, (srrip.hits + brrip.hits) / 2);
+    
+    // A single set has no leaders to train PSEL
+    ReplacementSimulator<DrripPolicy> single(1, 16, 64);
+    for (uint64_t addr : cyclic_trace(17, 64, 64)) {
+        single.access(addr);
+    }
+    EXPECT_EQ(single.policy().srrip_leader_misses(), 0u);
+    EXPECT_EQ(single.policy().brrip_leader_misses(), 0u);
+    EXPECT_EQ(single.policy().psel(), 1u << (RripPolicy::PSEL_BITS - 1));
+}
+
+TEST(ReplacementPolicyTest, RandomPolicyIsDeterministic) {
+    std::vector<uint64_t> trace = cyclic_trace(40, 8, 64);
+    ReplacementStats first = run_trace<RandomPolicy>(trace, 2, 8);
+    ReplacementStats second = run_trace<RandomPolicy>(trace, 2, 8);
+    EXPECT_EQ(first.misses, second.misses);
+    EXPECT_EQ(first.evictions, first.misses - 16);
+}
+
+TEST(CacheArrayTest, FindFillInvalidateAndClear) {
+    CacheArray array(4, 8, 64);
+    uint8_t line[64];
+    for (uint32_t i = 0; i < sizeof(line); i++) {
+        line[i] = static_cast<uint8_t>(i);
+    }
+    
+    // Ways fill in order and are found by tag within their own set only
+    for (uint32_t way = 0; way < 8; way++) {
+        EXPECT_EQ(array.find_invalid(2), static_cast<int32_t>(way));
+        array.fill(2, way, 0x100 + way, way == 5 ? line : nullptr);
+    }
+    EXPECT_EQ(array.find_invalid(2), -1);
+    EXPECT_EQ(array.find_invalid(1), 0);
+    EXPECT_EQ(array.find(2, 0x105), 5);
+    EXPECT_EQ(array.find(2, 0x107), 7);
+    EXPECT_EQ(array.find(1, 0x105), -1);
+    EXPECT_EQ(array.find(2, 0x200), -1);
+    EXPECT_EQ(array.valid_mask(2), 0xFFu);
+    EXPECT_EQ(std::memcmp(array.line_data(2, 5), line, sizeof(line)), 0);
+    EXPECT_EQ(array.line_data(2, 4)[63], 0);
+    
+    // Invalidation frees the way and resets its dirty bit and state; a
+    // refill always starts clean
+    array.set_dirty(2, 3, true);
+    array.set_state(2, 3, 2);
+    EXPECT_EQ(array.dirty_mask(2), 0x08u);
+    array.invalidate(2, 3);
+    EXPECT_FALSE(array.valid(2, 3));
+    EXPECT_FALSE(array.dirty(2, 3));
+    EXPECT_EQ(array.state(2, 3), 0);
+    EXPECT_EQ(array.find(2, 0x103), -1);
+    EXPECT_EQ(array.find_invalid(2), 3);
+    array.set_dirty(2, 6, true);
+    array.fill(2, 6, 0x300, nullptr);
+    EXPECT_FALSE(array.dirty(2, 6));
+    
+    // Invalid ways hold INVALID_TAG, which never matches a real lookup
+    array.clear();
+    EXPECT_EQ(array.valid_mask(2), 0u);
+    EXPECT_EQ(array.find(2, 0x105), -1);
+    EXPECT_EQ(array.tag(2, 5), CacheArray::INVALID_TAG);
+    
+    CacheArray tags_only(4, 8, 64, false);
+    EXPECT_FALSE(tags_only.stores_data());
+    tags_only.fill(0, 0, 0x42, line);
+    EXPECT_EQ(tags_only.find(0, 0x42), 0);
+}
+
+TEST(CacheArrayTest, AssociativityLimit) {
+    // Fully associative 64-way sets use every bit of the way masks
+    CacheArray array(1, CacheArray::MAX_ASSOCIATIVITY, 32, false);
+    for (uint32_t way = 0; way < CacheArray::MAX_ASSOCIATIVITY; way++) {
+        array.fill(0, way, way * 7, nullptr);
+    }
+    EXPECT_EQ(array.valid_mask(0), ~0ULL);
+    EXPECT_EQ(array.find_invalid(0), -1);
+    EXPECT_EQ(array.find(0, 63 * 7), 63);
+    array.invalidate(0, 63);
+    EXPECT_EQ(array.find_invalid(0), 63);
+    
+    EXPECT_THROW(CacheArray(1, CacheArray::MAX_ASSOCIATIVITY + 1, 32), std::invalid_argument);
+    EXPECT_THROW(CacheArray(1, 0, 32), std::invalid_argument);
+}
+
+TEST(MshrFileTest, SecondaryMissesMergeIntoInFlightFill) {
+    MshrFile mshrs(2, 4);
+    uint32_t id = 0;
+    uint32_t merged_id = 0;
+    
+    MemoryTransaction first(MemoryTransactionType::READ, 0x1000);
+    MemoryTransaction second(MemoryTransactionType::WRITE, 0x1008);
+    EXPECT_EQ(mshrs.allocate(0x1000, first, id), MshrFile::Outcome::PRIMARY);
+    EXPECT_EQ(mshrs.allocate(0x1000, second, merged_id), MshrFile::Outcome::SECONDARY);
+    EXPECT_EQ(merged_id, id);
+    EXPECT_EQ(mshrs.occupancy(), 1u);
+    
+    std::vector<MemoryTransaction> targets = mshrs.complete(id);
+    ASSERT_EQ(targets.size(), 2u);
+    EXPECT_EQ(targets[1].address(), 0x1008u);
+    EXPECT_TRUE(mshrs.is_empty());
+    EXPECT_EQ(mshrs.stats().primary_misses, 1u);
+    EXPECT_EQ(mshrs.stats().secondary_misses, 1u);
+}
+
+TEST(MshrFileTest, StallsWhenEntriesOrTargetsAreExhausted) {
+    MshrFile mshrs(2, 2);
+    uint32_t id = 0;
+    MemoryTransaction txn(MemoryTransactionType::READ, 0);
+    
+    EXPECT_EQ(mshrs.allocate(0x000, txn, id), MshrFile::Outcome::PRIMARY);
+    EXPECT_EQ(mshrs.allocate(0x040, txn, id), MshrFile::Outcome::PRIMARY);
+    EXPECT_EQ(mshrs.allocate(0x080, txn, id), MshrFile::Outcome::STALL_ENTRIES);
+    EXPECT_EQ(mshrs.allocate(0x040, txn, id), MshrFile::Outcome::SECONDARY);
+    EXPECT_EQ(mshrs.allocate(0x040, txn, id), MshrFile::Outcome::STALL_TARGETS);
+    EXPECT_EQ(mshrs.stats().entry_full_stalls, 1u);
+    EXPECT_EQ(mshrs.stats().target_full_stalls, 1u);
+    EXPECT_EQ(mshrs.stats().peak_occupancy, 2u);
+    
+    // Retiring a fill frees the entry for the stalled miss
+    mshrs.complete(0);
+    EXPECT_EQ(mshrs.allocate(0x080, txn, id), MshrFile::Outcome::PRIMARY);
+    EXPECT_EQ(id, 0u);
+}
+
+TEST(BurstPayloadTest, CopiesShareUntilWritten) {
+    uint64_t in_use = BurstPayload::pool_in_use();
+    {
+        BurstPayload line(128);
+        line.mutable_data()[0] = 0xAB;
+        
+        MemoryTransaction txn(MemoryTransactionType::WRITE, 0x2000, 128);
+        txn.set_payload(line);
+        MemoryTransaction copy = txn;
+        EXPECT_EQ(line.use_count(), 3u);
+        EXPECT_EQ(copy.payload().data(), line.data());
+        EXPECT_EQ(BurstPayload::pool_in_use(), in_use + 1);
+        
+        // Writing through one holder detaches it
+        copy.payload().mutable_data()[0] = 0xCD;
+        EXPECT_EQ(line.data()[0], 0xAB);
+        EXPECT_EQ(line.use_count(), 2u);
+        EXPECT_NE(copy.payload(), line);
+    }
+    EXPECT_EQ(BurstPayload::pool_in_use(), in_use);
+}
+
+TEST(BurstPayloadTest, ByteEnables) {
+    BurstPayload payload(96);
+    EXPECT_TRUE(payload.all_enabled());
+    payload.set_byte_enable(60, 8, false);
+    EXPECT_TRUE(payload.byte_enabled(59));
+    EXPECT_FALSE(payload.byte_enabled(63));
+    EXPECT_FALSE(payload.byte_enabled(67));
+    EXPECT_TRUE(payload.byte_enabled(68));
+    EXPECT_FALSE(payload.all_enabled());
+    EXPECT_THROW(BurstPayload(BurstPayload::MAX_BYTES + 1), std::invalid_argument);
+}
+
+// Warp access with lane i at base + i * stride
+static WarpMemoryAccess strided_access(MemoryTransactionType type, uint64_t base, uint64_t stride,
+                                       uint32_t size = 4, uint32_t active_mask = 0xFFFFFFFF) {
+    WarpMemoryAccess access;
+    access.type = type;
+    access.active_mask = active_mask;
+    access.access_size = size;
+    for (uint32_t lane = 0; lane < WarpMemoryAccess::MAX_LANES; lane++) {
+        access.addresses[lane] = base + lane * stride;
+        access.data[lane] = lane;
+    }
+    return access;
+}
+
+TEST(MemoryCoalescerTest, UnitStrideIsOneLine) {
+    MemoryCoalescer coalescer(128, 32);
+    const std::vector<CoalescedRequest>& requests =
+        coalescer.coalesce(strided_access(MemoryTransactionType::READ, 0x1000, 4));
+    ASSERT_EQ(requests.size(), 1u);
+    EXPECT_EQ(requests[0].sector_mask, 0xFu);
+    EXPECT_EQ(requests[0].lane_mask, 0xFFFFFFFFu);
+    EXPECT_DOUBLE_EQ(coalescer.stats().efficiency(), 1.0);
+}
+
+TEST(MemoryCoalescerTest, StridedAndMisalignedPatterns) {
+    MemoryCoalescer coalescer(128, 32);
+    
+    // One line per lane, one sector used per line
+    coalescer.coalesce(strided_access(MemoryTransactionType::READ, 0, 128));
+    EXPECT_EQ(coalescer.stats().requests, 32u);
+    EXPECT_DOUBLE_EQ(coalescer.stats().efficiency(), 4.0 / 32.0);
+    
+    // A misaligned unit-stride access straddles two lines
+    coalescer.reset_stats();
+    const std::vector<CoalescedRequest>& requests =
+        coalescer.coalesce(strided_access(MemoryTransactionType::READ, 0x102, 4));
+    ASSERT_EQ(requests.size(), 2u);
+    EXPECT_EQ(requests[0].sector_mask, 0xFu);
+    EXPECT_EQ(requests[1].sector_mask, 0x1u);
+    EXPECT_EQ(coalescer.stats().requests_per_instruction(), 2.0);
+}
+
+TEST(MemoryCoalescerTest, StoresCarryLaneDataAndAtomicsStaySeparate) {
+    MemoryCoalescer coalescer(128, 32);
+    std::vector<MemoryTransaction> stores =
+        coalescer.coalesce_to_transactions(strided_access(MemoryTransactionType::WRITE, 0x2000, 8), 10);
+    ASSERT_EQ(stores.size(), 2u);
+    EXPECT_EQ(stores[1].id(), 11u);
+    EXPECT_EQ(stores[1].payload().data()[8], 17);
+    EXPECT_TRUE(stores[0].payload().byte_enabled(0));
+    EXPECT_FALSE(stores[0].payload().byte_enabled(4));
+    
+    coalescer.coalesce(strided_access(MemoryTransactionType::ATOMIC_ADD, 0x3000, 0));
+    EXPECT_EQ(coalescer.stats().requests, 2u + 32u);
+}
+
+// Replays a trace through a 4-line fully associative LRU cache so prefetch
+// fills and evictions are reported like CacheL1 would
+static PrefetchStats run_prefetcher(const PrefetcherConfig& config, const std::vector<uint64_t>& trace,
+                                    uint64_t pc, double mshr_occupancy = 0.0) {
+    Prefetcher prefetcher(config);
+    ReplacementSimulator<LruPolicy> cache(1, 4, config.line_size);
+    std::vector<uint64_t> prefetches;
+    for (uint64_t addr : trace) {
+        bool hit = cache.access(addr);
+        prefetches.clear();
+        prefetcher.on_demand_access(pc, addr, hit, mshr_occupancy, prefetches);
+        for (uint64_t line_addr : prefetches) {
+            cache.access(line_addr);
+            prefetcher.on_prefetch_fill(line_addr);
+        }
+    }
+    return prefetcher.stats();
+}
+
+TEST(PrefetcherTest, StreamAndStridePrefetchersCoverSequentialTraffic) {
+    PrefetcherConfig config;
+    config.line_size = 64;
+    
+    config.type = PrefetcherType::STREAM;
+    PrefetchStats stream = run_prefetcher(config, cyclic_trace(256, 1, 64), 0);
+    EXPECT_GT(stream.coverage(), 0.9);
+    EXPECT_GT(stream.accuracy(), 0.9);
+    EXPECT_DOUBLE_EQ(stream.timeliness(), 1.0);
+    
+    // 256-byte stride from one PC skips three of every four lines
+    config.type = PrefetcherType::STRIDE;
+    PrefetchStats stride = run_prefetcher(config, cyclic_trace(256, 1, 256), 0x400);
+    EXPECT_GT(stride.coverage(), 0.9);
+    
+    config.type = PrefetcherType::NONE;
+    PrefetchStats none = run_prefetcher(config, cyclic_trace(256, 1, 64), 0);
+    EXPECT_EQ(none.issued, 0u);
+    EXPECT_EQ(none.uncovered_misses, 256u);
+}
+
+TEST(PrefetcherTest, MshrPressureSuppressesPrefetches) {
+    PrefetcherConfig config;
+    config.type = PrefetcherType::NEXT_LINE;
+    PrefetchStats stats = run_prefetcher(config, cyclic_trace(64, 1, 64), 0, 0.9);
+    EXPECT_EQ(stats.issued, 0u);
+    EXPECT_GT(stats.dropped, 0u);
+}
+
+// Transaction with an explicit ID
+static MemoryTransaction make_transaction(MemoryTransactionType type, uint64_t addr, uint32_t size, uint32_t id) {
+    MemoryTransaction txn(type, addr, size);
+    txn.set_id(id);
+    return txn;
+}
+
+TEST(TransactionQueueTest, OverlapQueriesFindRanges) {
+    TransactionQueue queue(8);
+    ASSERT_TRUE(queue.push(make_transaction(MemoryTransactionType::WRITE, 0x1000, 128, 1)));
+    ASSERT_TRUE(queue.push(make_transaction(MemoryTransactionType::READ, 0x1100, 4, 2)));
+    ASSERT_TRUE(queue.push(make_transaction(MemoryTransactionType::READ, 0x1070, 16, 3)));
+    
+    // Inside the 128-byte write, not at its start address
+    EXPECT_EQ(queue.get_conflicting_transactions(0x1040, 4), std::vector<uint32_t>({1}));
+    EXPECT_EQ(queue.get_conflicting_transactions(0x107c, 8), std::vector<uint32_t>({1, 3}));
+    EXPECT_FALSE(queue.has_address_conflict(0x1080, 0x80));
+    EXPECT_TRUE(queue.has_address_conflict(0x10ff, 2));
+    
+    // Removing the large write shrinks the search window
+    EXPECT_TRUE(queue.remove_transaction(1));
+    EXPECT_FALSE(queue.has_address_conflict(0x1040, 4));
+    EXPECT_FALSE(queue.has_transaction(1));
+}
+
+TEST(TransactionQueueTest, ReorderingAppliesToLaterPushes) {
+    TransactionQueue queue(8);
+    for (uint32_t id : {5, 1, 3}) {
+        queue.push(make_transaction(MemoryTransactionType::READ, 0x100 * (8 - id), 4, id));
+    }
+    MemoryTransaction txn;
+    queue.reorder_by_address();
+    queue.push(make_transaction(MemoryTransactionType::READ, 0x0, 4, 9));
+    std::vector<uint32_t> popped;
+    while (queue.pop(txn)) {
+        popped.push_back(txn.id());
+        if (popped.size() == 2) {
+            queue.reorder_by_id();
+        }
+    }
+    EXPECT_EQ(popped, std::vector<uint32_t>({9, 5, 1, 3}));
+}
+
+TEST(ConcurrentTransactionQueueTest, BackpressureAndLookup) {
+    ConcurrentTransactionQueue queue(4);
+    for (uint32_t id = 0; id < 3; id++) {
+        EXPECT_FALSE(queue.under_pressure());
+        ASSERT_TRUE(queue.push(make_transaction(MemoryTransactionType::READ, id * 64, 4, id)));
+    }
+    EXPECT_TRUE(queue.under_pressure());
+    ASSERT_TRUE(queue.push(make_transaction(MemoryTransactionType::READ, 0x100, 4, 3)));
+    EXPECT_FALSE(queue.push(make_transaction(MemoryTransactionType::READ, 0x140, 4, 4)));
+    EXPECT_EQ(queue.rejected_pushes(), 1u);
+    
+    MemoryTransaction txn;
+    ASSERT_TRUE(queue.pop(txn));
+    EXPECT_EQ(txn.id(), 0u);
+    EXPECT_FALSE(queue.has_transaction(0));
+    EXPECT_TRUE(queue.has_transaction(3));
+    EXPECT_TRUE(queue.push(make_transaction(MemoryTransactionType::READ, 0x140, 4, 4)));
+    EXPECT_TRUE(queue.has_transaction(4));
+    EXPECT_EQ(queue.size(), 4u);
+}
+
+TEST(ConcurrentTransactionQueueTest, ProducersAndConsumersOnHostThreads) {
+    const uint32_t producers = 4;
+    const uint32_t consumers = 2;
+    const uint32_t per_producer = 20000;
+    ConcurrentTransactionQueue queue(16);
+    std::vector<std::atomic<uint32_t>> seen(producers * per_producer);
+    std::atomic<uint32_t> consumed(0);
+    std::atomic<bool> payload_mismatch(false);
+    
+    std::vector<std::thread> threads;
+    for (uint32_t p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, p, per_producer]() {
+            for (uint32_t i = 0; i < per_producer; i++) {
+                uint32_t id = p * per_producer + i;
+                MemoryTransaction txn = make_transaction(MemoryTransactionType::WRITE, id * 64ULL, 8, id);
+                txn.set_payload(BurstPayload(reinterpret_cast<const uint8_t*>(&id), sizeof(id)));
+                while (!queue.push(txn)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (uint32_t c = 0; c < consumers; c++) {
+        threads.emplace_back([&]() {
+            MemoryTransaction txn;
+            while (consumed.load() < producers * per_producer) {
+                if (!queue.pop(txn)) {
+                    std::this_thread::yield();
+                    continue;
+                }
+                uint32_t tagged;
+                std::memcpy(&tagged, txn.payload().data(), sizeof(tagged));
+                if (tagged != txn.id() || txn.address() != txn.id() * 64ULL) {
+                    payload_mismatch = true;
+                }
+                seen[txn.id()]++;
+                consumed++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    
+    EXPECT_FALSE(payload_mismatch.load());
+    for (const std::atomic<uint32_t>& count : seen) {
+        ASSERT_EQ(count.load(), 1u);
+    }
+    EXPECT_TRUE(queue.is_empty());
+}
+
+TEST(HeavyHitterTrackerTest, FindsHotKeysWithBoundedError) {
+    HeavyHitterTracker tracker(16);
+    std::unordered_map<uint64_t, uint64_t> exact;
+    
+    // Four hot keys among a long tail of keys touched once
+    uint64_t time = 0;
+    for (uint64_t i = 0; i < 20000; i++) {
+        uint64_t key = (i % 5 != 0) ? i % 4 : 1000 + i;
+        tracker.record(key, time++);
+        exact[key]++;
+    }
+    EXPECT_EQ(tracker.size(), 16u);
+    EXPECT_EQ(tracker.total(), 20000u);
+    
+    std::vector<HeavyHitterTracker::Entry> top = tracker.top(4);
+    ASSERT_EQ(top.size(), 4u);
+    for (const HeavyHitterTracker::Entry& entry : top) {
+        EXPECT_LT(entry.key, 4u);
+        EXPECT_GE(entry.count, exact[entry.key]);
+        EXPECT_LE(entry.count - entry.error, exact[entry.key]);
+    }
+    for (size_t i = 1; i < top.size(); i++) {
+        EXPECT_GE(top[i - 1].count, top[i].count);
+    }
+    
+    // Every tracked count stays within its error bound
+    for (const HeavyHitterTracker::Entry& entry : tracker.top(16)) {
+        EXPECT_LE(entry.count - entry.error, exact[entry.key]);
+        EXPECT_GE(entry.count, exact[entry.key]);
+    }
+    
+    tracker.clear();
+    EXPECT_TRUE(tracker.top(4).empty());
+}
+
+TEST(MemoryStateTest, HotspotsFollowTrackedAccesses) {
+    MemoryState state;
+    for (uint32_t i = 0; i < 8; i++) {
+        state.track_read(0x1000 + i * 4, 4);
+    }
+    state.track_write(0x2000, 8);
+    state.track_write(0x1010, 4);
+    state.track_atomic(0x1020, 4);
+    EXPECT_EQ(state.total_reads(), 8u);
+    EXPECT_EQ(state.total_writes(), 2u);
+    EXPECT_EQ(state.total_atomics(), 1u);
+    
+    // Accesses are counted per 64-byte line
+    std::vector<MemoryState::HotspotInfo> hotspots = state.get_hotspots(2);
+    ASSERT_EQ(hotspots.size(), 2u);
+    EXPECT_EQ(hotspots[0].address, 0x1000u);
+    EXPECT_EQ(hotspots[0].access_count, 10u);
+    EXPECT_EQ(hotspots[0].count_error, 0u);
+    EXPECT_EQ(hotspots[1].address, 0x2000u);
+    EXPECT_EQ(hotspots[1].access_count, 1u);
+    
+    // An access spanning granules counts in each
+    state.configure_hotspots(16, 4096);
+    state.track_read(0x3FFC, 8);
+    hotspots = state.get_hotspots();
+    ASSERT_EQ(hotspots.size(), 2u);
+    EXPECT_EQ(hotspots[0].access_count, 1u);
+    EXPECT_EQ(hotspots[1].access_count, 1u);
+    EXPECT_EQ(hotspots[0].address + hotspots[1].address, 0x3000u + 0x4000u);
+}
+
+TEST(SharedMemoryBankTest, ConflictDegreeAndBroadcast) {
+    SharedMemoryBankModel banks;
+    EXPECT_EQ(banks.resolve(strided_access(MemoryTransactionType::READ, 0, 4)).conflict_degree(), 1u);
+    EXPECT_EQ(banks.resolve(strided_access(MemoryTransactionType::READ, 0, 8)).conflict_degree(), 2u);
+    EXPECT_EQ(banks.resolve(strided_access(MemoryTransactionType::READ, 0, 128)).conflict_degree(), 32u);
+    EXPECT_EQ(banks.resolve(strided_access(MemoryTransactionType::READ, 0, 128, 4, 0x0000FFFF)).conflict_degree(), 16u);
+    
+    // All lanes reading one word is a single broadcast; atomics serialise instead
+    WarpBankConflicts broadcast = banks.resolve(strided_access(MemoryTransactionType::READ, 0x40, 0));
+    EXPECT_EQ(broadcast.wavefronts, 1u);
+    EXPECT_EQ(broadcast.broadcast_words, 31u);
+    EXPECT_EQ(banks.resolve(strided_access(MemoryTransactionType::ATOMIC_ADD, 0x40, 0)).wavefronts, 32u);
+    
+    // Multicast: pairs of 16-bit lanes share words, 16 words in 16 banks
+    WarpBankConflicts pairs = banks.resolve(strided_access(MemoryTransactionType::READ, 0, 2, 2));
+    EXPECT_EQ(pairs.unique_words, 16u);
+    EXPECT_EQ(pairs.conflict_degree(), 1u);
+    
+    EXPECT_EQ(banks.stats().accesses, 7u);
+    EXPECT_EQ(banks.stats().conflicted_accesses, 4u);
+}
+
+TEST(SharedMemoryBankTest, WideBanksAndSwizzledTiles) {
+    SharedMemoryBankModel banks;
+    
+    // 8-byte loads need two wavefronts in 4-byte mode but are never conflicted
+    WarpBankConflicts doubles = banks.resolve(strided_access(MemoryTransactionType::READ, 0, 8, 8));
+    EXPECT_EQ(doubles.wavefronts, 2u);
+    EXPECT_EQ(doubles.conflict_degree(), 1u);
+    
+    // In 64-bit mode, a 4-byte stride-2 walk fits in 32 distinct bank words
+    banks.set_mode(SharedMemoryBankMode::EIGHT_BYTE);
+    EXPECT_EQ(banks.resolve(strided_access(MemoryTransactionType::READ, 0, 8)).conflict_degree(), 1u);
+    EXPECT_EQ(banks.resolve(strided_access(MemoryTransactionType::READ, 0, 4)).broadcast_words, 16u);
+    
+    // Column walk of a row-major 32x32 float tile: 32-way unless swizzled
+    banks.set_mode(SharedMemoryBankMode::FOUR_BYTE);
+    EXPECT_EQ(banks.resolve(strided_access(MemoryTransactionType::READ, 0, 128)).conflict_degree(), 32u);
+    banks.set_swizzle(SharedMemorySwizzle{5, 2, 5});
+    EXPECT_EQ(banks.resolve(strided_access(MemoryTransactionType::READ, 0, 128)).conflict_degree(), 1u);
+    EXPECT_EQ(banks.resolve(strided_access(MemoryTransactionType::READ, 0, 4)).conflict_degree(), 1u);
+}
+
+TEST(AtomicUnitTest, ExecutesInPlace) {
+    AtomicUnit unit;
+    uint8_t line[128] = {};
+    
+    MemoryTransaction add = make_transaction(MemoryTransactionType::ATOMIC_ADD, 0x1008, 4, 1);
+    add.set_data(5);
+    EXPECT_EQ(unit.execute(add, line), 0u);
+    EXPECT_EQ(unit.execute(add, line), 5u);
+    
+    // Signed comparison: -1 is below 10
+    MemoryTransaction min = make_transaction(MemoryTransactionType::ATOMIC_MIN, 0x1008, 4, 2);
+    min.set_data(0xFFFFFFFFu);
+    EXPECT_EQ(unit.execute(min, line), 10u);
+    uint32_t value;
+    std::memcpy(&value, line + 8, 4);
+    EXPECT_EQ(value, 0xFFFFFFFFu);
+    
+    // CAS: swap value in data(), compare value in an operand-sized payload
+    MemoryTransaction cas = make_transaction(MemoryTransactionType::ATOMIC_CAS, 0x1008, 4, 3);
+    cas.set_data(7);
+    EXPECT_THROW(unit.execute(cas, line), std::invalid_argument);
+    uint32_t compare = 0xFFFFFFFFu;
+    cas.set_payload(BurstPayload(reinterpret_cast<const uint8_t*>(&compare), 4));
+    EXPECT_EQ(unit.execute(cas, line), 0xFFFFFFFFu);
+    EXPECT_EQ(unit.execute(cas, line), 7u);
+    std::memcpy(&value, line + 8, 4);
+    EXPECT_EQ(value, 7u);
+    
+    EXPECT_EQ(AtomicUnit::apply(MemoryTransactionType::ATOMIC_MAX, 3, ~0ULL, 0, 8), 3u);
+    EXPECT_EQ(AtomicUnit::apply(MemoryTransactionType::ATOMIC_ADD, 0xFFFFFFFFu, 1, 0, 4), 0u);
+}
+
+TEST(AtomicUnitTest, ExecutesCoalescedWarpAtomics) {
+    MemoryCoalescer coalescer(128, 32);
+    AtomicUnit unit;
+    uint8_t line[128] = {};
+    
+    // Lane i adds i to its own word; every lane is its own transaction
+    std::vector<MemoryTransaction> adds =
+        coalescer.coalesce_to_transactions(strided_access(MemoryTransactionType::ATOMIC_ADD, 0x4000, 4), 0);
+    ASSERT_EQ(adds.size(), 32u);
+    for (const MemoryTransaction& add : adds) {
+        EXPECT_EQ(add.size(), 4u);
+        unit.execute(add, line);
+    }
+    for (uint32_t lane = 0; lane < 32; lane++) {
+        uint32_t value;
+        std::memcpy(&value, line + lane * 4, 4);
+        EXPECT_EQ(value, lane);
+    }
+    
+    // 8-byte CAS on 16 words: even lanes expect the current value and swap
+    WarpMemoryAccess cas = strided_access(MemoryTransactionType::ATOMIC_CAS, 0x4000, 8, 8, 0x0000FFFF);
+    for (uint32_t lane = 0; lane < 16; lane++) {
+        uint64_t current;
+        std::memcpy(&current, line + lane * 8, 8);
+        cas.compare[lane] = lane % 2 == 0 ? current : current + 1;
+        cas.data[lane] = 0x100000000ULL + lane;
+    }
+    std::vector<MemoryTransaction> swaps = coalescer.coalesce_to_transactions(cas, 32);
+    ASSERT_EQ(swaps.size(), 16u);
+    for (uint32_t lane = 0; lane < 16; lane++) {
+        uint64_t before;
+        std::memcpy(&before, line + lane * 8, 8);
+        EXPECT_EQ(swaps[lane].address(), 0x4000u + lane * 8);
+        EXPECT_EQ(unit.execute(swaps[lane], line), before);
+        uint64_t after;
+        std::memcpy(&after, line + lane * 8, 8);
+        EXPECT_EQ(after, lane % 2 == 0 ? 0x100000000ULL + lane : before);
+    }
+}
+
+TEST(AtomicUnitTest, SameAddressAtomicsSerialise) {
+    AtomicUnitConfig config;
+    AtomicUnit unit(config);
+    
+    // A warp of atomics to one counter serialises on the read-modify-write
+    uint64_t done = 0;
+    for (uint32_t lane = 0; lane < 32; lane++) {
+        done = unit.schedule(0x2000, 0);
+    }
+    EXPECT_EQ(done, 31u * config.same_address_interval + config.alu_latency);
+    EXPECT_EQ(unit.stats().same_address_stalls, 31u);
+    
+    // Spread over lines in different slices they issue in parallel
+    AtomicUnit spread(config);
+    for (uint32_t lane = 0; lane < 8; lane++) {
+        done = spread.schedule(0x2000 + lane * config.line_size, 0);
+    }
+    EXPECT_EQ(done, config.alu_latency);
+    EXPECT_EQ(spread.stats().stall_cycles, 0u);
+    
+    // Distinct words of one line share a slice ALU
+    done = spread.schedule(0x2008, 0);
+    EXPECT_EQ(spread.stats().slice_stalls, 1u);
+    EXPECT_EQ(done, config.slice_interval + config.alu_latency);
+    
+    // Offsets within one word overlap and serialise like the same address
+    done = spread.schedule(0x2004, 0);
+    EXPECT_EQ(spread.stats().same_address_stalls, 1u);
+    EXPECT_EQ(done, config.same_address_interval + config.alu_latency);
+    
+    std::vector<HeavyHitterTracker::Entry> hotspots = unit.contention_hotspots(1);
+    ASSERT_EQ(hotspots.size(), 1u);
+    EXPECT_EQ(hotspots[0].key, 0x2000u);
+    EXPECT_EQ(hotspots[0].count, 31u);
+}
+
+TEST(CoherenceDirectoryTest, MesiInvalidatesAndDowngrades) {
+    CoherenceConfig config;
+    config.num_cores = 4;
+    CoherenceDirectory directory(config);
+    
+    // First reader gets the line exclusive; a second reader downgrades it
+    EXPECT_EQ(directory.read(0, 0x1000).grant, CoherenceState::EXCLUSIVE);
+    CoherenceResult shared = directory.read(1, 0x1010);
+    EXPECT_EQ(shared.grant, CoherenceState::SHARED);
+    EXPECT_EQ(shared.downgrade_mask, 0x1u);
+    EXPECT_FALSE(shared.owner_data);
+    EXPECT_EQ(shared.latency, 4 * config.hop_latency);
+    EXPECT_EQ(directory.sharers(0x1000), 0x3u);
+    
+    // A writer invalidates both sharers, then a reader recalls its dirty line
+    CoherenceResult written = directory.write(2, 0x1000, 4);
+    EXPECT_EQ(written.grant, CoherenceState::MODIFIED);
+    EXPECT_EQ(written.invalidate_mask, 0x3u);
+    CoherenceResult recalled = directory.read(0, 0x1000);
+    EXPECT_TRUE(recalled.owner_data);
+    EXPECT_EQ(directory.state(0x1000), CoherenceState::SHARED);
+    
+    // A sharer's write is an upgrade; stores to an owned line stay local
+    CoherenceResult upgrade = directory.write(0, 0x1000, 4);
+    EXPECT_EQ(upgrade.invalidate_mask, 0x4u);
+    uint64_t messages = directory.stats().messages();
+    EXPECT_EQ(directory.write(0, 0x1008, 4).latency, 0u);
+    EXPECT_EQ(directory.stats().messages(), messages);
+    
+    // The inclusive L2 recalls the owner's copy when it evicts the line
+    EXPECT_EQ(directory.recall(0x1000), 0x1u);
+    EXPECT_EQ(directory.tracked_lines(), 0u);
+    
+    const CoherenceStats& stats = directory.stats();
+    EXPECT_EQ(stats.invalidations, 3u);
+    EXPECT_EQ(stats.downgrades, 2u);
+    EXPECT_EQ(stats.upgrades, 1u);
+    EXPECT_EQ(stats.owner_writebacks, 2u);
+    EXPECT_EQ(stats.back_invalidations, 1u);
+    EXPECT_THROW(directory.read(4, 0x1000), std::out_of_range);
+}
+
+// One producer writes a buffer that three consumers read after a barrier
+static CoherenceStats run_producer_consumer(CoherenceMode mode, uint32_t rounds) {
+    CoherenceConfig config;
+    config.mode = mode;
+    config.num_cores = 4;
+    CoherenceDirectory directory(config);
+    for (uint32_t round = 0; round < rounds; round++) {
+        for (uint64_t line = 0; line < 16; line++) {
+            for (uint64_t word = 0; word < config.line_size; word += 4) {
+                directory.write(0, line * config.line_size + word, 4);
+            }
+        }
+        for (uint32_t core = 0; core < 4; core++) {
+            directory.barrier(core);
+        }
+        for (uint32_t core = 1; core < 4; core++) {
+            for (uint64_t line = 0; line < 16; line++) {
+                directory.read(core, line * config.line_size);
+            }
+        }
+        for (uint32_t core = 0; core < 4; core++) {
+            directory.barrier(core);
+        }
+    }
+    return directory.stats();
+}
+
+TEST(CoherenceDirectoryTest, DirectoryAndRelaxedModesTradeTraffic) {
+    CoherenceStats mesi = run_producer_consumer(CoherenceMode::DIRECTORY, 4);
+    CoherenceStats relaxed = run_producer_consumer(CoherenceMode::RELAXED, 4);
+    
+    // MESI invalidates consumers and recalls the producer's dirty lines
+    EXPECT_EQ(mesi.invalidations, 3u * 16 * 3);
+    EXPECT_EQ(mesi.owner_writebacks, 16u * 4);
+    EXPECT_GT(mesi.coherence_latency, 0u);
+    EXPECT_EQ(mesi.self_invalidations, 0u);
+    
+    // Relaxed mode never waits on other L1s but writes every store through
+    // and refetches every consumer line after each barrier
+    EXPECT_EQ(relaxed.invalidations + relaxed.downgrades, 0u);
+    EXPECT_EQ(relaxed.coherence_latency, 0u);
+    EXPECT_EQ(relaxed.write_throughs, 4u * 16 * 32);
+    EXPECT_EQ(relaxed.self_invalidations, 4u * 16 * 3);
+    EXPECT_GT(relaxed.messages(), mesi.messages());
+    EXPECT_LT(relaxed.average_latency(), mesi.average_latency());
+}
+
+TEST(CoherenceDirectoryTest, DowngradeAndRecallWriteBackDirtyData) {
+    CoherenceConfig config;
+    config.num_cores = 2;
+    CoherenceDirectory directory(config);
+    
+    // Core 0's L1: one line at 0x2080, dirty after a store
+    CacheArray lines(4, 2, config.line_size);
+    CacheWritePolicy writes(WritePolicyConfig(), config.line_size);
+    std::vector<uint8_t> data(config.line_size, 0);
+    lines.fill(1, 0, 0x2080 / config.line_size, data.data());
+    EXPECT_EQ(directory.write(0, 0x2080, 4).grant, CoherenceState::MODIFIED);
+    lines.line_data(1, 0)[4] = 0x5A;
+    lines.set_dirty(1, 0, true);
+    
+    // Core 1's read downgrades core 0, whose dirty line goes back to L2
+    CoherenceResult shared = directory.read(1, 0x2080);
+    ASSERT_TRUE(shared.owner_data);
+    ASSERT_EQ(shared.downgrade_mask, 0x1u);
+    EXPECT_TRUE(writes.writeback_line(lines, 1, 0));
+    EXPECT_TRUE(lines.valid(1, 0));
+    EXPECT_FALSE(lines.dirty(1, 0));
+    ASSERT_TRUE(writes.has_write());
+    MemoryTransaction downgrade = writes.next_write();
+    EXPECT_EQ(downgrade.address(), 0x2080u);
+    EXPECT_EQ(downgrade.payload().data()[4], 0x5A);
+    
+    // A clean line has nothing to write back
+    EXPECT_FALSE(writes.writeback_line(lines, 1, 0));
+    EXPECT_FALSE(writes.has_write());
+    
+    // Core 0 writes again and the L2 evicts the line: the recall carries the new data
+    directory.write(0, 0x2080, 4);
+    lines.line_data(1, 0)[4] = 0xA5;
+    lines.set_dirty(1, 0, true);
+    ASSERT_EQ(directory.recall(0x2080) & 0x1u, 0x1u);
+    EXPECT_TRUE(writes.writeback_line(lines, 1, 0));
+    lines.invalidate(1, 0);
+    ASSERT_TRUE(writes.has_write());
+    EXPECT_EQ(writes.next_write().payload().data()[4], 0xA5);
+    EXPECT_EQ(writes.stats().writebacks, 2u);
+}
+
+static MemoryTransaction make_store(uint64_t addr, uint32_t size, uint64_t data) {
+    MemoryTransaction store(MemoryTransactionType::WRITE, addr, size);
+    store.set_data(data);
+    return store;
+}
+
+TEST(WriteCombiningBufferTest, MergesPartialStoresIntoLineWrites) {
+    WriteCombiningBuffer buffer(2, 64, 16);
+    std::vector<MemoryTransaction> drained;
+    uint8_t bytes[8] = {1, 2, 3, 4, 5, 6, 7, 8};
+    
+    // Eight 8-byte stores fill a line, which drains as one full-line write
+    for (uint32_t i = 0; i < 8; i++) {
+        buffer.write(0x1000 + i * 8, bytes, 8, i, drained);
+    }
+    ASSERT_EQ(drained.size(), 1u);
+    EXPECT_EQ(drained[0].address(), 0x1000u);
+    EXPECT_TRUE(drained[0].payload().all_enabled());
+    EXPECT_EQ(drained[0].payload().data()[9], 2);
+    
+    // A third line evicts the oldest partial line; an idle line times out
+    drained.clear();
+    buffer.write(0x2000, bytes, 4, 10, drained);
+    buffer.write(0x3000, bytes, 4, 20, drained);
+    buffer.write(0x4000, bytes, 4, 30, drained);
+    ASSERT_EQ(drained.size(), 1u);
+    EXPECT_EQ(drained[0].address(), 0x2000u);
+    EXPECT_TRUE(drained[0].payload().byte_enabled(3));
+    EXPECT_FALSE(drained[0].payload().byte_enabled(4));
+    buffer.tick(40, drained);
+    EXPECT_EQ(drained.size(), 2u);
+    EXPECT_EQ(buffer.occupancy(), 1u);
+    
+    const WriteCombiningStats& stats = buffer.stats();
+    EXPECT_EQ(stats.merged_stores, 7u);
+    EXPECT_EQ(stats.full_line_writes, 1u);
+    EXPECT_EQ(stats.partial_line_writes, 2u);
+    EXPECT_EQ(stats.capacity_drains, 1u);
+    EXPECT_EQ(stats.timeout_drains, 1u);
+}
+
+TEST(WritePolicyTest, PoliciesAndCombiningShapeWriteTraffic) {
+    // Write-back/write-allocate: a partial store miss fills, later stores stay local
+    CacheWritePolicy write_back(WritePolicyConfig(), 64);
+    WriteAction miss = write_back.store(make_store(0x100, 4, 1), false, 0);
+    EXPECT_TRUE(miss.fetch_line && miss.allocate && miss.mark_dirty);
+    WriteAction hit = write_back.store(make_store(0x104, 4, 2), true, 1);
+    EXPECT_TRUE(hit.update_line && hit.mark_dirty);
+    EXPECT_FALSE(write_back.has_write());
+    std::vector<uint8_t> line(64, 0);
+    write_back.writeback(0x100, line.data());
+    EXPECT_EQ(write_back.stats().downstream_bytes, 64u);
+    EXPECT_EQ(write_back.stats().fill_bytes, 64u);
+    
+    // Write-through/no-allocate sends every store as a partial write
+    WritePolicyConfig config;
+    config.hit = WriteHitPolicy::WRITE_THROUGH;
+    config.miss = WriteMissPolicy::NO_WRITE_ALLOCATE;
+    CacheWritePolicy streaming(config, 64);
+    for (uint64_t addr = 0; addr < 256; addr += 4) {
+        WriteAction action = streaming.store(make_store(addr, 4, addr), false, addr);
+        EXPECT_FALSE(action.allocate || action.update_line);
+    }
+    EXPECT_EQ(streaming.stats().downstream_writes, 64u);
+    EXPECT_EQ(streaming.stats().partial_line_writes, 64u);
+    
+    // A combining buffer turns the same stream into four full-line writes
+    config.combining_entries = 4;
+    CacheWritePolicy combined(config, 64);
+    for (uint64_t addr = 0; addr < 256; addr += 4) {
+        combined.store(make_store(addr, 4, addr), false, addr);
+    }
+    EXPECT_EQ(combined.stats().downstream_writes, 4u);
+    EXPECT_EQ(combined.stats().partial_line_writes, 0u);
+    EXPECT_DOUBLE_EQ(combined.stats().write_amplification(), 1.0);
+    MemoryTransaction first = combined.next_write();
+    EXPECT_EQ(first.size(), 64u);
+    EXPECT_EQ(first.payload().data()[4], 4);
+    
+    // A load to a buffered line drains it first
+    combined.store(make_store(0x400, 4, 7), false, 300);
+    EXPECT_TRUE(combined.load(0x404));
+    EXPECT_EQ(combined.stats().read_flushes, 1u);
+}
+
+TEST(MemoryTraceTest, DeltaEncodedRoundTrip) {
+    const std::string path = "cache_model_test.gmtr";
+    std::vector<TraceRecord> records;
+    for (uint64_t i = 0; i < 10000; i++) {
+        // A unit-stride stream from core 0 ...
+        TraceRecord record;
+        record.cycle = i;
+        record.address = 0x10000 + i * 4;
+        record.size = 4;
+        records.push_back(record);
+    }
+    for (uint64_t i = 0; i < 100; i++) {
+        // ... then scattered stores and atomics from other cores
+        TraceRecord record;
+        record.cycle = 20000 + i * 3;
+        record.type = i % 10 == 0 ? MemoryTransactionType::ATOMIC_ADD : MemoryTransactionType::WRITE;
+        record.address = (i * 0x9E3779B97F4A7C15ULL) >> 20;
+        record.size = i % 2 == 0 ? 4 : 128;
+        record.source = static_cast<uint32_t>(i % 7);
+        records.push_back(record);
+    }
+    
+    {
+        MemoryTraceWriter writer(path);
+        for (const TraceRecord& record : records) {
+            writer.append(record);
+        }
+        writer.close();
+        EXPECT_EQ(writer.records(), records.size());
+        // The strided stream collapses into a run; scattered records cost a few bytes
+        EXPECT_LT(writer.bytes(), 2000u);
+        EXPECT_THROW(writer.append(records[0]), std::logic_error);
+    }
+    
+    MemoryTraceReader reader(path);
+    TraceRecord record;
+    for (const TraceRecord& expected : records) {
+        ASSERT_TRUE(reader.next(record));
+        ASSERT_EQ(record, expected);
+    }
+    EXPECT_FALSE(reader.next(record));
+    reader.rewind();
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record, records[0]);
+    
+    // A copy shares the encoded trace but decodes with its own cursor
+    MemoryTraceReader cursor = reader;
+    ASSERT_TRUE(cursor.next(record));
+    EXPECT_EQ(record, records[1]);
+    EXPECT_EQ(cursor.position(), 2u);
+    EXPECT_EQ(reader.position(), 1u);
+    cursor.rewind();
+    ASSERT_TRUE(reader.next(record));
+    EXPECT_EQ(record, records[1]);
+    std::remove(path.c_str());
+    
+    EXPECT_THROW(MemoryTraceReader missing("no_such_trace.gmtr"), std::runtime_error);
+}
+
+TEST(TraceReplayTest, ReplayReproducesHierarchyStatistics) {
+    const std::string path = "cache_model_replay.gmtr";
+    {
+        // Two passes of 4-byte reads over 256 KB: four times the L1, an eighth of the L2
+        MemoryTraceWriter writer(path);
+        uint64_t cycle = 0;
+        for (uint32_t pass = 0; pass < 2; pass++) {
+            for (uint64_t addr = 0; addr < 256 * 1024; addr += 4) {
+                writer.append(cycle++, MemoryTransaction(MemoryTransactionType::READ, addr, 4));
+            }
+        }
+    }
+    
+    MemoryTraceReader reader(path);
+    TraceReplayer replayer;
+    EXPECT_EQ(replayer.replay(reader), 2u * 64 * 1024);
+    const TraceReplayStats& stats = replayer.stats();
+    EXPECT_EQ(stats.reads, 2u * 64 * 1024);
+    
+    // The first pass misses once per 64 B line and hits the other 15 reads.
+    // Only 1024 lines fit in the L1, so at least 3072 of the 4096 lines
+    // miss again in the second pass; LRU keeps none of them.
+    if (std::string(CacheReplacementPolicy::name()) == LruPolicy::name()) {
+        EXPECT_EQ(stats.l1.misses, 2u * 4096);
+    } else {
+        EXPECT_GE(stats.l1.misses, 4096u + 3072u);
+        EXPECT_LE(stats.l1.misses, 2u * 4096);
+    }
+    EXPECT_EQ(stats.l1.hits, stats.reads - stats.l1.misses);
+    EXPECT_EQ(stats.l2.misses, 2048u);                // Cold misses only; the L2 holds the array
+    EXPECT_EQ(stats.l2.hits, stats.l1.misses - 2048u);
+    EXPECT_EQ(stats.dram_reads, 2048u);
+    EXPECT_EQ(stats.dram_bytes, 2048u * 128);
+    EXPECT_GT(stats.accesses_per_second(), 0.0);
+    std::remove(path.c_str());
+    
+    // Dirty lines are written back on eviction and before an atomic
+    TraceReplayer dirty;
+    TraceRecord store;
+    store.type = MemoryTransactionType::WRITE;
+    store.size = 4;
+    dirty.access(store);
+    TraceRecord atomic = store;
+    atomic.type = MemoryTransactionType::ATOMIC_ADD;
+    dirty.access(atomic);
+    EXPECT_EQ(dirty.stats().l1_writebacks, 1u);
+    EXPECT_EQ(dirty.stats().atomics, 1u);
+    EXPECT_EQ(dirty.stats().l2.hits, 2u);
+}
+
+TEST(CacheSweepTest, SinglePassMatchesDirectSimulation) {
+    const std::string path = "cache_model_sweep.gmtr";
+    {
+        // Cyclic sweeps over working sets of 8 KB to 48 KB, then random reads
+        MemoryTraceWriter writer(path);
+        uint64_t cycle = 0;
+        for (uint64_t working_set : {8 * 1024, 24 * 1024, 48 * 1024}) {
+            for (uint32_t pass = 0; pass < 3; pass++) {
+                for (uint64_t addr = 0; addr < working_set; addr += 16) {
+                    writer.append(cycle++, MemoryTransaction(MemoryTransactionType::READ, addr, 4));
+                }
+            }
+        }
+        uint64_t x = 1;
+        for (uint32_t i = 0; i < 20000; i++) {
+            x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+            writer.append(cycle++, MemoryTransaction(MemoryTransactionType::READ, (x >> 33) % (64 * 1024), 4));
+        }
+    }
+    
+    CacheSweepConfig config;
+    config.sizes = {4 * 1024, 8 * 1024, 16 * 1024, 32 * 1024, 64 * 1024};
+    config.line_sizes = {64, 128};
+    config.associativities = {1, 2, 4, 8};
+    config.policies = {SweepPolicy::LRU, SweepPolicy::SRRIP, SweepPolicy::RANDOM};
+    config.threads = 2;
+    CacheSweep sweep(config);
+    sweep.run(path);
+    EXPECT_EQ(sweep.stats().configurations, 3u * 2 * 4 * 5);
+    EXPECT_EQ(sweep.stats().instances, 2u * 2 * 4 * 5);
+    EXPECT_GT(sweep.stats().stack_groups, 1u);
+    
+    // LRU miss rates never rise with size or associativity
+    for (uint32_t line_size : config.line_sizes) {
+        for (uint32_t associativity : config.associativities) {
+            std::vector<CacheSweepPoint> curve = sweep.curve(SweepPolicy::LRU, line_size, associativity);
+            ASSERT_EQ(curve.size(), 5u);
+            for (size_t i = 1; i < curve.size(); i++) {
+                EXPECT_LE(curve[i].misses, curve[i - 1].misses);
+            }
+        }
+        for (uint32_t size = 4 * 1024; size < 64 * 1024; size *= 2) {
+            // Same set count, twice the ways
+            for (uint32_t associativity = 1; associativity < 8; associativity *= 2) {
+                EXPECT_LE(sweep.point(SweepPolicy::LRU, size * 2, line_size, associativity * 2).misses,
+                          sweep.point(SweepPolicy::LRU, size, line_size, associativity).misses);
+            }
+        }
+    }
+    
+    // Stack distances give the same answer as simulating the cache directly
+    if (std::string(CacheReplacementPolicy::name()) == LruPolicy::name()) {
+        TraceReplayConfig replay;
+        replay.l1 = ReplayCacheConfig(16 * 1024, 64, 4);
+        TraceReplayer replayer(replay);
+        MemoryTraceReader reader(path);
+        replayer.replay(reader);
+        EXPECT_EQ(replayer.stats().l1.misses, sweep.point(SweepPolicy::LRU, 16 * 1024, 64, 4).misses);
+    }
+    
+    std::ostringstream csv;
+    sweep.write_csv(csv);
+    EXPECT_EQ(csv.str().find("policy,size_bytes,line_size,associativity"), 0u);
+    EXPECT_NE(csv.str().find("srrip,32768,128,8,"), std::string::npos);
+    std::remove(path.c_str());
+}
+
+TEST(AddressTranslationTest, TlbHierarchyAndPageWalks) {
+    AddressTranslationConfig config;
+    config.num_cores = 2;
+    config.l1 = {16, 16, 1};
+    config.l2 = {64, 4, 10};
+    config.walker.num_walkers = 2;
+    config.walker.memory_latency = 100;
+    config.walker.walk_cache_latency = 2;
+    AddressTranslation translation(config);
+    PageTable& table = translation.page_table();
+    table.map_range(0x10000000, 0x80000000, 64 * 1024, PageSize::SIZE_4KB);
+    table.map(0x20000000, 0x90000000, PageSize::SIZE_64KB);
+    table.map(0x40000000, 0xA0000000, PageSize::SIZE_2MB);
+    EXPECT_EQ(table.num_pages(), 18u);
+    EXPECT_THROW(table.map(0x40100000, 0xB0000000, PageSize::SIZE_4KB), std::invalid_argument);
+    EXPECT_THROW(table.map(0x20001000, 0xB0000000, PageSize::SIZE_64KB), std::invalid_argument);
+    
+    // Cold miss: four reads from the root, then L1 and L2 TLB hits
+    TranslationResult walk = translation.translate(0, 0x10000123, 1000);
+    EXPECT_EQ(walk.level, TranslationLevel::PAGE_WALK);
+    EXPECT_EQ(walk.physical_address, 0x80000123u);
+    EXPECT_EQ(walk.latency, 1u + 10 + 2 + 4 * 100);
+    TranslationResult l1_hit = translation.translate(0, 0x10000456, 2000);
+    EXPECT_EQ(l1_hit.level, TranslationLevel::L1_TLB);
+    EXPECT_EQ(l1_hit.latency, 1u);
+    TranslationResult l2_hit = translation.translate(1, 0x10000789, 2000);
+    EXPECT_EQ(l2_hit.level, TranslationLevel::L2_TLB);
+    EXPECT_EQ(l2_hit.physical_address, 0x80000789u);
+    EXPECT_EQ(l2_hit.latency, 11u);
+    
+    // The walk cache holds the upper levels: a neighbouring page reads only its leaf
+    EXPECT_EQ(translation.translate(0, 0x10001000, 3000).latency, 1u + 10 + 2 + 100);
+    EXPECT_EQ(translation.walker().walk_cache_hits(), 1u);
+    
+    // Large pages: one entry maps the whole page, 2 MB leaves sit one level up
+    TranslationResult big = translation.translate(0, 0x2000FFF0, 4000);
+    EXPECT_EQ(big.page_size, PageSize::SIZE_64KB);
+    EXPECT_EQ(translation.translate(0, 0x20000010, 5000).level, TranslationLevel::L1_TLB);
+    TranslationResult huge = translation.translate(0, 0x401FFFFC, 6000);
+    EXPECT_EQ(huge.page_size, PageSize::SIZE_2MB);
+    EXPECT_EQ(huge.physical_address, 0xA01FFFFCu);
+    EXPECT_EQ(huge.latency, 1u + 10 + 2 + 2 * 100);
+    EXPECT_EQ(translation.l1_reach(0), 2 * 4096u + 64 * 1024 + 2 * 1024 * 1024);
+    
+    // Hits on a page whose walk is still in flight wait for its fill
+    TranslationResult first = translation.translate(0, 0x10002000, 10000);
+    TranslationResult under_miss = translation.translate(1, 0x10002008, 10001);
+    EXPECT_EQ(under_miss.level, TranslationLevel::L2_TLB);
+    EXPECT_EQ(under_miss.ready, first.ready);
+    EXPECT_EQ(translation.translate(0, 0x10002010, 10002).ready, first.ready);
+    
+    // Two walkers: a third concurrent walk waits for one to free up
+    uint64_t done_a = translation.translate(0, 0x10003000, 20000).ready;
+    uint64_t done_b = translation.translate(0, 0x10004000, 20000).ready;
+    TranslationResult queued = translation.translate(0, 0x10005000, 20000);
+    EXPECT_EQ(queued.ready, std::min(done_a, done_b) + 2 + 100);
+    EXPECT_EQ(translation.stats().walker_stalls, 1u);
+    
+    // Shootdown and faults
+    translation.invalidate(0x10000000);
+    EXPECT_EQ(translation.translate(0, 0x10000000, 30000).level, TranslationLevel::PAGE_WALK);
+    EXPECT_THROW(translation.translate(0, 0x50000000, 30000), std::out_of_range);
+    
+    const TranslationStats& stats = translation.stats();
+    EXPECT_EQ(stats.l1_hits + stats.l1_misses, stats.translations);
+    EXPECT_EQ(stats.l2_hits + stats.l2_misses, stats.l1_misses);
+    EXPECT_EQ(stats.walks + stats.merged_walks + 1, stats.l2_misses);
+    EXPECT_EQ(translation.walk_latency().count(), stats.walks + stats.merged_walks);
+}
+
+TEST(AddressTranslationTest, LargePagesExtendTlbReach) {
+    // Strided sweep over a 32 MB tensor: far beyond the L2 TLB's 4 MB reach with 4 KB pages
+    const uint64_t tensor_bytes = 32ULL * 1024 * 1024;
+    uint64_t walks[NUM_PAGE_SIZES] = {};
+    double walk_latency[NUM_PAGE_SIZES] = {};
+    for (PageSize size : {PageSize::SIZE_4KB, PageSize::SIZE_64KB, PageSize::SIZE_2MB}) {
+        AddressTranslationConfig config;
+        config.num_cores = 4;
+        AddressTranslation translation(config);
+        translation.page_table().map_range(0x100000000ULL, 0x200000000ULL, tensor_bytes, size);
+        uint64_t cycle = 0;
+        for (uint32_t pass = 0; pass < 2; pass++) {
+            for (uint64_t offset = 0; offset < tensor_bytes; offset += 2048) {
+                uint32_t core = static_cast<uint32_t>((offset / 2048) % config.num_cores);
+                TranslationResult result = translation.translate(core, 0x100000000ULL + offset, cycle);
+                ASSERT_EQ(result.physical_address, 0x200000000ULL + offset);
+                cycle += 200;
+            }
+        }
+        walks[static_cast<uint32_t>(size)] = translation.stats().walks;
+        walk_latency[static_cast<uint32_t>(size)] = translation.stats().average_walk_latency();
+        EXPECT_EQ(translation.stats().walks_by_size[static_cast<uint32_t>(size)], translation.stats().walks);
+    }
+    
+    // Nearly every 4 KB page walks again on the second pass; 2 MB pages fit in the L2 TLB
+    EXPECT_GT(walks[0], 2 * tensor_bytes / 4096 * 15 / 16);
+    EXPECT_LT(walks[1], walks[0] / 8);
+    EXPECT_EQ(walks[2], tensor_bytes / (2 * 1024 * 1024));
+    EXPECT_GT(walk_latency[0], 0.0);
+}
+
+// SystemC main function with GoogleTest integration
+// This is the required entry point for SystemC applications
+int sc_main(int argc, char **argv) {
+    // Initialize GoogleTest
+    ::testing::InitGoogleTest(&argc, argv);
+    
+    // Run the tests
+    int result = RUN_ALL_TESTS();
+    
+    // Return test result
+    return result;
+}
@@ -0,0 +1,429 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include "../../model/common/checkpoint.h"
+#include "../../model/memory_subsystem/global_memory.h"
+#include "../../model/memory_subsystem/cache_array.h"
+#include "../../model/memory_subsystem/address_translation.h"
+#include "../../model/memory_subsystem/shared_memory_banks.h"
+#include "../../model/memory_subsystem/transaction_queue.h"
+#include "../../model/memory_subsystem/mshr_file.h"
+
+class CheckpointTestCase : public ::testing::Test {
+protected:
+    GlobalMemory* source;
+    GlobalMemory* target;
+    
+    void SetUp() override {
+        // Small memories keep the page scan cheap
+        source = new GlobalMemory("ckpt_source_mem", 1024 * 1024);
+        target = new GlobalMemory("ckpt_target_mem", 1024 * 1024);
+    }
+    
+    void TearDown() override {
+        delete source;
+        delete target;
+    }
+};
+
+TEST_F(CheckpointTestCase, PrimitiveRoundTrip) {
+    CheckpointWriter writer;
+    writer.begin_section(checkpoint::SectionTag::MEMORY_STATE);
+    writer.write_varint(0);
+    writer.write_varint(300);
+    writer.write_varint(0xFFFFFFFFFFFFFFFFULL);
+    writer.write_double(2.5);
+    writer.write_string("shader");
+    writer.end_section();
+    
+    CheckpointReader reader(writer.buffer());
+    reader.begin_section(checkpoint::SectionTag::MEMORY_STATE);
+    EXPECT_EQ(reader.read_varint(), 0u);
+    EXPECT_EQ(reader.read_varint(), 300u);
+    EXPECT_EQ(reader.read_varint(), 0xFFFFFFFFFFFFFFFFULL);
+    EXPECT_DOUBLE_EQ(reader.read_double(), 2.5);
+    EXPECT_EQ(reader.read_string(), "shader");
+    reader.end_section();
+    EXPECT_TRUE(reader.at_end());
+}
+
+TEST_F(CheckpointTestCase, SectionMismatchIsRejected) {
+    CheckpointWriter writer;
+    writer.begin_section(checkpoint::SectionTag::CACHE_L1);
+    writer.end_section();
+    
+    CheckpointReader reader(writer.buffer());
+    EXPECT_THROW(reader.begin_section(checkpoint::SectionTag::CACHE_L2), std::runtime_error);
+}
+
+TEST_F(CheckpointTestCase, GlobalMemoryIsSparse) {
+    source->write_byte(0x10, 0xAB);
+    source->write_byte(0x80000, 0xCD);
+    
+    CheckpointWriter writer;
+    source->save_state(writer);
+    
+    // Two touched pages out of 256; the checkpoint must not contain the rest
+    EXPECT_LT(writer.buffer().size(), 3u * 4096u);
+    
+    CheckpointReader reader(writer.buffer());
+    target->restore_state(reader);
+    EXPECT_EQ(target->read_byte(0x10), 0xAB);
+    EXPECT_EQ(target->read_byte(0x80000), 0xCD);
+    EXPECT_EQ(target->read_byte(0x11), 0x00);
+}
+
+TEST_F(CheckpointTestCase, GlobalMemoryPartialLastPage) {
+    // 2.5 checkpoint pages: the tail past the last full page is saved too
+    const uint64_t size = 10 * 1024;
+    GlobalMemory odd_source("ckpt_odd_source_mem", size);
+    GlobalMemory odd_target("ckpt_odd_target_mem", size);
+    odd_source.write_byte(0x10, 0x11);
+    odd_source.write_byte(0x2000, 0x22);
+    odd_source.write_byte(size - 1, 0x33);
+    
+    CheckpointWriter writer;
+    odd_source.save_state(writer);
+    CheckpointReader reader(writer.buffer());
+    odd_target.restore_state(reader);
+    EXPECT_TRUE(reader.at_end());
+    EXPECT_EQ(odd_target.read_byte(0x10), 0x11);
+    EXPECT_EQ(odd_target.read_byte(0x2000), 0x22);
+    EXPECT_EQ(odd_target.read_byte(size - 1), 0x33);
+    
+    // Clearing the tail is recorded incrementally
+    odd_source.mark_checkpoint();
+    odd_target.mark_checkpoint();
+    odd_source.write_byte(size - 1, 0x00);
+    odd_source.write_byte(0x2000, 0x00);
+    CheckpointWriter delta(checkpoint::FLAG_INCREMENTAL);
+    odd_source.save_state(delta);
+    CheckpointReader delta_reader(delta.buffer());
+    odd_target.restore_state(delta_reader);
+    EXPECT_EQ(odd_target.read_byte(0x10), 0x11);
+    EXPECT_EQ(odd_target.read_byte(0x2000), 0x00);
+    EXPECT_EQ(odd_target.read_byte(size - 1), 0x00);
+}
+
+TEST(SparseMemoryTest, AccessesBeyondEndThrowOnEveryBacking) {
+    const char* path = "sparse_memory_range_test.img";
+    std::remove(path);
+    for (SparseMemoryBacking backing : {SparseMemoryBacking::SPARSE_PAGES, SparseMemoryBacking::ANONYMOUS_MMAP,
+                                        SparseMemoryBacking::FILE_MMAP}) {
+        SparseMemoryConfig config;
+        config.backing = backing;
+        config.file_path = path;
+        // Not a page multiple: the last page extends past the end
+        SparseMemory memory(3 * 4096 + 100, config);
+        uint64_t end = memory.size();
+        uint8_t block[8] = {};
+        
+        memory.write_byte(end - 1, 0x7E);
+        EXPECT_EQ(memory.read_byte(end - 1), 0x7E);
+        EXPECT_THROW(memory.read_byte(end), std::out_of_range);
+        EXPECT_THROW(memory.write_byte(end, 1), std::out_of_range);
+        EXPECT_THROW(memory.read_block(end - 4, block, sizeof(block)), std::out_of_range);
+        EXPECT_THROW(memory.write_block(end - 4, block, sizeof(block)), std::out_of_range);
+        EXPECT_THROW(memory.fill(end - 4, 0xFF, sizeof(block)), std::out_of_range);
+        EXPECT_THROW(memory.write_block(~0ULL - 2, block, sizeof(block)), std::out_of_range);
+        EXPECT_THROW(memory.host_page(4), std::out_of_range);
+        EXPECT_EQ(memory.touched_pages(), std::vector<uint64_t>{3});
+    }
+    std::remove(path);
+}
+
+TEST(SparseMemoryTest, FileBackingTracksPreloadedPages) {
+    const char* path = "sparse_memory_preload_test.img";
+    std::remove(path);
+    SparseMemoryConfig config;
+    config.backing = SparseMemoryBacking::FILE_MMAP;
+    config.file_path = path;
+    {
+        SparseMemory image(16 * 4096, config);
+        image.write_byte(0x10, 0xAB);
+        image.write_byte(5 * 4096 + 7, 0xCD);
+    }
+    
+    // Reopening the image sees its non-zero pages as touched and dirty
+    {
+        SparseMemory preloaded(16 * 4096, config);
+        EXPECT_EQ(preloaded.touched_pages(), (std::vector<uint64_t>{0, 5}));
+        EXPECT_EQ(preloaded.dirty_pages(), (std::vector<uint64_t>{0, 5}));
+        EXPECT_EQ(preloaded.resident_bytes(), 2u * 4096u);
+        
+        preloaded.clear();
+        EXPECT_EQ(preloaded.read_byte(5 * 4096 + 7), 0);
+    }
+    
+    // clear() reached the preloaded contents
+    SparseMemory cleared(16 * 4096, config);
+    EXPECT_TRUE(cleared.touched_pages().empty());
+    std::remove(path);
+}
+
+TEST_F(CheckpointTestCase, GlobalMemoryIncremental) {
+    source->write_byte(0x10, 0x01);
+    source->write_byte(0x2000, 0x02);
+    
+    CheckpointWriter base;
+    source->save_state(base);
+    source->mark_checkpoint();
+    
+    // Modify one page and clear another
+    source->write_byte(0x10, 0x03);
+    source->write_byte(0x2000, 0x00);
+    
+    // Snapshots between checkpoints do not move the incremental baseline
+    CheckpointWriter snapshot(checkpoint::FLAG_INCREMENTAL);
+    source->save_state(snapshot);
+    CheckpointWriter delta(checkpoint::FLAG_INCREMENTAL);
+    source->save_state(delta);
+    EXPECT_EQ(snapshot.buffer(), delta.buffer());
+    EXPECT_LT(delta.buffer().size(), base.buffer().size());
+    
+    CheckpointReader base_reader(base.buffer());
+    target->restore_state(base_reader);
+    CheckpointReader delta_reader(delta.buffer());
+    target->restore_state(delta_reader);
+    
+    EXPECT_EQ(target->read_byte(0x10), 0x03);
+    EXPECT_EQ(target->read_byte(0x2000), 0x00);
+    
+    // A page rewritten with its old contents is still recorded
+    source->mark_checkpoint();
+    target->mark_checkpoint();
+    source->write_byte(0x10, 0x03);
+    CheckpointWriter rewrite(checkpoint::FLAG_INCREMENTAL);
+    source->save_state(rewrite);
+    CheckpointWriter unchanged(checkpoint::FLAG_INCREMENTAL);
+    target->save_state(unchanged);
+    EXPECT_GT(rewrite.buffer().size(), unchanged.buffer().size() + 4096u);
+}
+
+TEST_F(CheckpointTestCase, QueueAndMshrStateRoundTrip) {
+    // Pending transactions of the memory subsystem
+    TransactionQueue queue(8);
+    const uint64_t addresses[] = {0x3000, 0x1000, 0x2000};
+    for (uint32_t i = 0; i < 3; i++) {
+        MemoryTransaction txn(MemoryTransactionType::READ, addresses[i], 64);
+        txn.set_id(10 + i);
+        txn.set_source(i);
+        queue.push(txn);
+    }
+    queue.reorder_by_address();
+    CheckpointWriter queue_writer;
+    queue.save_state(queue_writer);
+    
+    TransactionQueue restored_queue(8);
+    CheckpointReader queue_reader(queue_writer.buffer());
+    restored_queue.restore_state(queue_reader);
+    EXPECT_EQ(restored_queue.size(), 3u);
+    EXPECT_EQ(restored_queue.get_conflicting_transactions(0x1020, 8), std::vector<uint32_t>{11});
+    MemoryTransaction first;
+    ASSERT_TRUE(restored_queue.pop(first));
+    EXPECT_EQ(first.address(), 0x1000u);
+    EXPECT_EQ(first.id(), 11u);
+    EXPECT_EQ(first.source(), 1u);
+    
+    // The capacity is configuration, not state
+    TransactionQueue smaller_queue(2);
+    CheckpointReader mismatch_reader(queue_writer.buffer());
+    EXPECT_THROW(smaller_queue.restore_state(mismatch_reader), std::runtime_error);
+    
+    // In-flight misses of a non-blocking cache
+    MshrFile mshrs(4, 2);
+    uint32_t primary = 0;
+    uint32_t secondary = 0;
+    ASSERT_EQ(mshrs.allocate(0x1000, MemoryTransaction(MemoryTransactionType::READ, 0x1000, 4), primary),
+              MshrFile::Outcome::PRIMARY);
+    ASSERT_EQ(mshrs.allocate(0x1000, MemoryTransaction(MemoryTransactionType::WRITE, 0x1008, 4), secondary),
+              MshrFile::Outcome::SECONDARY);
+    CheckpointWriter mshr_writer;
+    mshrs.save_state(mshr_writer);
+    
+    MshrFile restored_mshrs(4, 2);
+    CheckpointReader mshr_reader(mshr_writer.buffer());
+    restored_mshrs.restore_state(mshr_reader);
+    uint32_t found = 0;
+    ASSERT_TRUE(restored_mshrs.find(0x1000, found));
+    EXPECT_EQ(found, primary);
+    EXPECT_EQ(restored_mshrs.occupancy(), 1u);
+    EXPECT_EQ(restored_mshrs.stats().secondary_misses, 1u);
+    std::vector<MemoryTransaction> targets = restored_mshrs.complete(found);
+    ASSERT_EQ(targets.size(), 2u);
+    EXPECT_EQ(targets[1].type(), MemoryTransactionType::WRITE);
+    EXPECT_EQ(targets[1].address(), 0x1008u);
+    EXPECT_TRUE(restored_mshrs.is_empty());
+}
+
+TEST_F(CheckpointTestCase, DefaultSizeMemoryIsLazy) {
+    // A full 16 GB instance only allocates and checkpoints what is touched
+    GlobalMemory large("ckpt_large_mem");
+    EXPECT_EQ(large.resident_bytes(), 0u);
+    
+    large.write_byte(0x3FFFFFFF0ULL, 0x7E);
+    EXPECT_EQ(large.resident_bytes(), 4096u);
+    
+    CheckpointWriter writer;
+    large.save_state(writer);
+    EXPECT_LT(writer.buffer().size(), 2u * 4096u);
+}
+
+TEST_F(CheckpointTestCase, FileRoundTrip) {
+    source->write_byte(0x1234, 0x5A);
+    
+    const std::string path = "checkpoint_test.ckpt";
+    CheckpointWriter writer;
+    source->save_state(writer);
+    writer.save_to_file(path);
+    
+    CheckpointReader reader = CheckpointReader::load_from_file(path);
+    target->restore_state(reader);
+    EXPECT_EQ(target->read_byte(0x1234), 0x5A);
+    
+    std::remove(path.c_str());
+}
+
+// SystemC main function with GoogleTest integration
+// This is the required entry point for SystemC applications
+TEST_F(CheckpointTestCase, CacheArrayRoundTrip) {
+    CacheArray array(8, 4, 32);
+    uint8_t line[32];
+    for (uint32_t set = 0; set < 8; set += 3) {
+        for (uint32_t way = 0; way < 4; way += 2) {
+            std::memset(line, static_cast<int>(set * 4 + way), sizeof(line));
+            array.fill(set, way, (set << 8) | way, line);
+            array.set_state(set, way, static_cast<uint8_t>(way + 1));
+        }
+    }
+    array.set_dirty(3, 2, true);
+    
+    CheckpointWriter writer;
+    array.save_state(writer);
+    CacheArray restored(8, 4, 32);
+    restored.fill(1, 1, 0xDEAD, nullptr);
+    CheckpointReader reader(writer.buffer());
+    restored.restore_state(reader);
+    EXPECT_TRUE(reader.at_end());
+    
+    for (uint32_t set = 0; set < 8; set++) {
+        EXPECT_EQ(restored.valid_mask(set), array.valid_mask(set));
+        EXPECT_EQ(restored.dirty_mask(set), array.dirty_mask(set));
+        for (uint32_t way = 0; way < 4; way++) {
+            EXPECT_EQ(restored.tag(set, way), array.tag(set, way));
+            EXPECT_EQ(restored.state(set, way), array.state(set, way));
+            if (array.valid(set, way)) {
+                EXPECT_EQ(std::memcmp(restored.line_data(set, way), array.line_data(set, way), 32), 0);
+            }
+        }
+    }
+    EXPECT_EQ(restored.find(1, 0xDEAD), -1);
+    EXPECT_EQ(restored.find(6, 0x602), 2);
+    
+    // A different geometry is rejected
+    CacheArray other(8, 8, 32);
+    CheckpointReader mismatch(writer.buffer());
+    EXPECT_THROW(other.restore_state(mismatch), std::runtime_error);
+}
+
+TEST_F(CheckpointTestCase, SharedMemoryBankModelRoundTrip) {
+    // Column walk of a 32x32 float tile, conflict-free only when swizzled
+    WarpMemoryAccess column;
+    column.active_mask = 0xFFFFFFFF;
+    for (uint32_t lane = 0; lane < WarpMemoryAccess::MAX_LANES; lane++) {
+        column.addresses[lane] = lane * 128;
+    }
+    SharedMemoryBankModel banks;
+    banks.set_swizzle(SharedMemorySwizzle{5, 2, 5});
+    banks.resolve(column);
+    
+    CheckpointWriter writer;
+    banks.save_state(writer);
+    SharedMemoryBankModel restored;
+    restored.set_swizzle(SharedMemorySwizzle{5, 2, 5});
+    CheckpointReader reader(writer.buffer());
+    restored.restore_state(reader);
+    EXPECT_TRUE(reader.at_end());
+    EXPECT_EQ(restored.stats().accesses, 1u);
+    EXPECT_EQ(restored.stats().wavefronts, banks.stats().wavefronts);
+    EXPECT_EQ(restored.resolve(column).conflict_degree(), 1u);
+    
+    // A different layout would resolve conflicts differently
+    SharedMemoryBankModel unswizzled;
+    CheckpointReader swizzle_mismatch(writer.buffer());
+    EXPECT_THROW(unswizzled.restore_state(swizzle_mismatch), std::runtime_error);
+    SharedMemoryBankModel wide(32, SharedMemoryBankMode::EIGHT_BYTE);
+    wide.set_swizzle(SharedMemorySwizzle{5, 2, 5});
+    CheckpointReader mode_mismatch(writer.buffer());
+    EXPECT_THROW(wide.restore_state(mode_mismatch), std::runtime_error);
+}
+
+TEST_F(CheckpointTestCase, AddressTranslationRoundTrip) {
+    AddressTranslationConfig config;
+    config.num_cores = 2;
+    AddressTranslation translation(config);
+    translation.page_table().map_range(0x10000000, 0x40000000, 64 * 1024, PageSize::SIZE_4KB);
+    translation.page_table().map_range(0x20000000, 0x80000000, 4 * 1024 * 1024, PageSize::SIZE_2MB);
+    
+    // Warm both TLB levels and leave walks in flight at the checkpoint
+    uint64_t cycle = 0;
+    for (uint64_t page = 0; page < 16; page++) {
+        translation.translate(page & 1, 0x10000000 + page * 4096, cycle);
+        cycle += 50;
+    }
+    translation.translate(0, 0x20000000, cycle);
+    translation.translate(1, 0x20200000, cycle);
+    
+    CheckpointWriter writer;
+    translation.save_state(writer);
+    AddressTranslation restored(config);
+    CheckpointReader reader(writer.buffer());
+    restored.restore_state(reader);
+    EXPECT_TRUE(reader.at_end());
+    
+    EXPECT_EQ(restored.page_table().num_pages(PageSize::SIZE_4KB), 16u);
+    EXPECT_EQ(restored.page_table().num_pages(PageSize::SIZE_2MB), 2u);
+    EXPECT_EQ(restored.stats().translations, translation.stats().translations);
+    EXPECT_EQ(restored.stats().l2_misses, translation.stats().l2_misses);
+    EXPECT_EQ(restored.stats().page_table_reads, translation.stats().page_table_reads);
+    EXPECT_EQ(restored.stats().total_walk_latency, translation.stats().total_walk_latency);
+    EXPECT_EQ(restored.walk_latency().dump(), translation.walk_latency().dump());
+    EXPECT_EQ(restored.walker().walk_cache_hits(), translation.walker().walk_cache_hits());
+    EXPECT_EQ(restored.l1_reach(0), translation.l1_reach(0));
+    EXPECT_EQ(restored.l1_reach(1), translation.l1_reach(1));
+    EXPECT_EQ(restored.l2_reach(), translation.l2_reach());
+    
+    // Both continue identically: TLB hits, merges into in-flight walks and
+    // new walks alike
+    const uint64_t addresses[] = {0x10000000, 0x10001008, 0x20000040, 0x20200000, 0x20300000, 0x1000F000};
+    for (uint32_t core = 0; core < 2; core++) {
+        for (uint64_t vaddr : addresses) {
+            TranslationResult expected = translation.translate(core, vaddr, cycle + 1);
+            TranslationResult actual = restored.translate(core, vaddr, cycle + 1);
+            EXPECT_EQ(actual.physical_address, expected.physical_address);
+            EXPECT_EQ(actual.level, expected.level);
+            EXPECT_EQ(actual.ready, expected.ready);
+        }
+    }
+    EXPECT_EQ(restored.stats().l1_hits, translation.stats().l1_hits);
+    EXPECT_EQ(restored.stats().merged_walks, translation.stats().merged_walks);
+    EXPECT_EQ(restored.stats().walks, translation.stats().walks);
+    
+    // A different core count is rejected
+    AddressTranslationConfig wider = config;
+    wider.num_cores = 4;
+    AddressTranslation other(wider);
+    CheckpointReader mismatch(writer.buffer());
+    EXPECT_THROW(other.restore_state(mismatch), std::runtime_error);
+}
+
+int sc_main(int argc, char **argv) {
+    // Initialize GoogleTest
+    ::testing::InitGoogleTest(&argc, argv);
+    
+    // Run the tests
+    int result = RUN_ALL_TESTS();
+    
+    // Return test result
+    return result;
+}
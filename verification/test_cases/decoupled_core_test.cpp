@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include "../../model/shader_core/assembler.h"
+#include "../../model/shader_core/decoupled_core.h"
+
+// Sums n..1 with a private store per iteration, then publishes the sum to
+// a shared location after a barrier
+static const char* LOOP_SOURCE =
+    ".data\n"
+    ".org 0x1000\n"
+    "count: .word 50\n"
+    "one:   .word 1\n"
+    ".text\n"
+    "    xor r0, r0, r0\n"
+    "    ld  r1, [r0 + count]\n"
+    "    ld  r2, [r0 + one]\n"
+    "    xor r3, r3, r3\n"
+    "loop:\n"
+    "    add r3, r3, r1\n"
+    "    st  r3, [r0 + 0x2000]\n"
+    "    sub r1, r1, r2\n"
+    "    brc r1, loop\n"
+    "    barrier\n"
+    "    st  r3, [r0 + 0x3000]\n"
+    "    ret\n";
+
+static const uint64_t SHARED_START = 0x3000;
+static const uint64_t SHARED_END = 0x3100;
+
+// The same program on a lock-step core (zero quantum) and a decoupled one,
+// each with its own memory. Processes exist only after elaboration, so the
+// testbench is built and simulated once in sc_main.
+struct DecouplingTestbench {
+    GlobalMemory lockstep_memory;
+    GlobalMemory decoupled_memory;
+    DecoupledCore lockstep;
+    DecoupledCore decoupled;
+
+    static DecouplingConfig lockstep_config() {
+        DecouplingConfig config;
+        config.quantum = SC_ZERO_TIME;
+        return config;
+    }
+
+    DecouplingTestbench()
+        : lockstep_memory("lockstep_mem", 1024 * 1024),
+          decoupled_memory("decoupled_mem", 1024 * 1024),
+          lockstep("lockstep_core", lockstep_memory, lockstep_config()),
+          decoupled("decoupled_core", decoupled_memory) {
+        Assembler assembler;
+        Kernel kernel;
+        assembler.assemble(LOOP_SOURCE, kernel);
+        for (DecoupledCore* core : {&lockstep, &decoupled}) {
+            GlobalMemory& memory = core == &lockstep ? lockstep_memory : decoupled_memory;
+            for (size_t i = 0; i < kernel.data.size(); i++) {
+                memory.write_byte(kernel.data_load_address + i, kernel.data[i]);
+            }
+            core->core().load_program(kernel.code, kernel.entry_pc);
+            core->add_shared_range(SHARED_START, SHARED_END);
+        }
+    }
+};
+
+static DecouplingTestbench* bench = nullptr;
+
+TEST(DecoupledCoreTest, MatchesLockStepResultsAndTime) {
+    ASSERT_TRUE(bench->lockstep.done());
+    ASSERT_TRUE(bench->decoupled.done());
+
+    EXPECT_EQ(bench->decoupled.core().read_register(3), 1275u);
+    EXPECT_EQ(bench->decoupled.core().read_register(3), bench->lockstep.core().read_register(3));
+    EXPECT_EQ(bench->decoupled_memory.read_byte(SHARED_START), bench->lockstep_memory.read_byte(SHARED_START));
+
+    // Annotated latencies add up to the same simulated time either way
+    const DecouplingStats& lockstep = bench->lockstep.stats();
+    const DecouplingStats& decoupled = bench->decoupled.stats();
+    EXPECT_EQ(decoupled.instructions, lockstep.instructions);
+    EXPECT_EQ(decoupled.simulated_cycles, lockstep.simulated_cycles);
+    EXPECT_GT(decoupled.simulated_cycles, decoupled.instructions);
+}
+
+TEST(DecoupledCoreTest, SynchronisesOnlyWhenNeeded) {
+    const DecouplingStats& lockstep = bench->lockstep.stats();
+    const DecouplingStats& decoupled = bench->decoupled.stats();
+
+    // Lock-step hands control to the kernel after every instruction
+    EXPECT_GE(lockstep.syncs, lockstep.instructions);
+    EXPECT_EQ(lockstep.max_skew_cycles, 1 + bench->lockstep.config().load_latency);
+
+    // The decoupled core runs ahead through private loads and stores and
+    // synchronises at the barrier, the shared store and quantum boundaries
+    EXPECT_LT(decoupled.syncs * 10, lockstep.syncs);
+    EXPECT_EQ(decoupled.syncs_for(SyncReason::BARRIER), 1u);
+    EXPECT_EQ(decoupled.syncs_for(SyncReason::SHARED_ACCESS), 1u);
+    EXPECT_EQ(decoupled.syncs_for(SyncReason::HALT), 1u);
+    EXPECT_GT(decoupled.instructions_per_sync(), 10.0);
+    EXPECT_GT(decoupled.max_skew_cycles, lockstep.max_skew_cycles);
+}
+
+// SystemC main function with GoogleTest integration
+// This is the required entry point for SystemC applications
+int sc_main(int argc, char **argv) {
+    // Elaborate and run both cores to completion
+    DecouplingTestbench testbench;
+    bench = &testbench;
+    sc_start();
+
+    // Initialize GoogleTest
+    ::testing::InitGoogleTest(&argc, argv);
+
+    // Run the tests
+    int result = RUN_ALL_TESTS();
+
+    // Return test result
+    return result;
+}
@@ -0,0 +1,103 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include "../../model/shader_core/assembler.h"
+#include "../../model/shader_core/functional_core.h"
+#include "../../model/shader_core/kernel_image.h"
+
+class KernelLoaderTestCase : public ::testing::Test {
+protected:
+    Assembler assembler;
+    Kernel kernel;
+    const std::string image_path = "kernel_loader_test.gskn";
+    
+    void TearDown() override {
+        std::remove(image_path.c_str());
+    }
+};
+
+TEST_F(KernelLoaderTestCase, EncodingMatchesDecoderFields) {
+    ASSERT_TRUE(assembler.assemble("add r1, r2, r3\nld r4, [r5 + 0x40]\n", kernel));
+    ASSERT_EQ(kernel.code.size(), 2u);
+    
+    EXPECT_EQ(kernel.code[0], Assembler::encode(InstructionOpcode::ALU_ADD, 1, 2, 3));
+    EXPECT_EQ(instruction_format::opcode_field(kernel.code[1]),
+              static_cast<uint32_t>(InstructionOpcode::MEM_LOAD));
+    EXPECT_EQ(instruction_format::dst_field(kernel.code[1]), 4u);
+    EXPECT_EQ(instruction_format::src1_field(kernel.code[1]), 5u);
+    EXPECT_EQ(instruction_format::imm_field(kernel.code[1]), 0x40u);
+}
+
+TEST_F(KernelLoaderTestCase, BranchesAreRelative) {
+    ASSERT_TRUE(assembler.assemble("top:\n nop\n brc r1, top\n br end\n nop\nend:\n ret\n", kernel));
+    EXPECT_EQ(instruction_format::simm_field(kernel.code[1]), -1);
+    EXPECT_EQ(instruction_format::simm_field(kernel.code[2]), 2);
+}
+
+TEST_F(KernelLoaderTestCase, ReportsErrorsWithLineNumbers) {
+    EXPECT_FALSE(assembler.assemble("add r1, r2\nfrobnicate r1\nbr nowhere\n", kernel));
+    ASSERT_EQ(assembler.errors().size(), 3u);
+    EXPECT_NE(assembler.errors()[0].find("line 2"), std::string::npos);
+}
+
+TEST_F(KernelLoaderTestCase, MappedImageRunsInPlace) {
+    const char* source =
+        ".kernel dot4\n"
+        ".meta target edge\n"
+        ".entry start\n"
+        ".data\n"
+        ".org 0x1000\n"
+        "values: .word 1, 2, 3, 4\n"
+        ".text\n"
+        "start:\n"
+        "    xor r1, r1, r1\n"
+        "    ld  r2, [r1 + values]\n"
+        "    ld  r3, [r1 + 0x1004]\n"
+        "    ld  r4, [r1 + 0x1008]\n"
+        "    ld  r5, [r1 + 0x100c]\n"
+        "    add r6, r2, r3\n"
+        "    add r6, r6, r4\n"
+        "    add r6, r6, r5\n"
+        "    st  r6, [r1 + 0x2000]\n"
+        "    ret\n";
+    ASSERT_TRUE(assembler.assemble(source, kernel));
+    write_kernel_image(kernel, image_path);
+    
+    MappedKernel mapped(image_path);
+    EXPECT_EQ(mapped.name(), "dot4");
+    EXPECT_EQ(mapped.metadata().at("target"), "edge");
+    EXPECT_EQ(mapped.code_words(), kernel.code.size());
+    EXPECT_EQ(mapped.data_load_address(), 0x1000u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(mapped.code()) % kernel_format::SECTION_ALIGNMENT, 0u);
+    
+    GlobalMemory memory("kernel_loader_mem", 1024 * 1024);
+    FunctionalCore core(memory);
+    core.load_kernel(mapped);
+    core.run(100);
+    
+    EXPECT_TRUE(core.halted());
+    EXPECT_EQ(core.read_register(6), 10u);
+    EXPECT_EQ(memory.read_byte(0x2000), 10);
+}
+
+TEST_F(KernelLoaderTestCase, RejectsCorruptImage) {
+    FILE* file = std::fopen(image_path.c_str(), "wb");
+    ASSERT_NE(file, nullptr);
+    const char garbage[128] = "not a kernel";
+    std::fwrite(garbage, 1, sizeof(garbage), file);
+    std::fclose(file);
+    
+    EXPECT_THROW(MappedKernel mapped(image_path), std::runtime_error);
+}
+
+// SystemC main function with GoogleTest integration
+// This is the required entry point for SystemC applications
+int sc_main(int argc, char **argv) {
+    // Initialize GoogleTest
+    ::testing::InitGoogleTest(&argc, argv);
+    
+    // Run the tests
+    int result = RUN_ALL_TESTS();
+    
+    // Return test result
+    return result;
+}
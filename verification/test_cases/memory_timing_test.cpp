@@ -0,0 +1,260 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include "../../model/common/checkpoint.h"
+#include "../../model/memory_subsystem/dram_controller.h"
+#include "../../model/memory_subsystem/latency_histogram.h"
+
+class DramTimingTestCase : public ::testing::Test {
+protected:
+    DramTimingConfig config;
+    std::vector<DramCompletion> completed;
+    
+    // Issue requests as queue space allows and run until all complete
+    uint64_t run(DramSystem& dram, const std::vector<uint64_t>& addrs, bool is_write = false) {
+        size_t next = 0;
+        uint64_t start = dram.cycle();
+        while (next < addrs.size() || !dram.is_idle()) {
+            while (next < addrs.size() && dram.enqueue(static_cast<uint32_t>(next), addrs[next], 64, is_write)) {
+                next++;
+            }
+            dram.tick(completed);
+        }
+        return dram.cycle() - start;
+    }
+};
+
+TEST_F(DramTimingTestCase, ClosedBankReadLatency) {
+    DramSystem dram(8, config);
+    run(dram, {0x0});
+    ASSERT_EQ(completed.size(), 1u);
+    EXPECT_EQ(completed[0].latency, config.tRCD + config.tCL + config.tBURST);
+    EXPECT_EQ(dram.stats().row_misses, 1u);
+}
+
+TEST_F(DramTimingTestCase, RowBufferLocalityIsVisible) {
+    // Sequential bursts stay in one open row; a row-sized stride through one
+    // bank conflicts on every access
+    std::vector<uint64_t> sequential;
+    std::vector<uint64_t> conflicting;
+    DramSystem probe(1, config);
+    for (uint32_t i = 0; i < 16; i++) {
+        sequential.push_back(i * config.burst_size);
+    }
+    uint64_t row_stride = static_cast<uint64_t>(config.row_size) * config.pseudo_channels *
+                          config.bank_groups * config.banks_per_group;
+    for (uint32_t i = 0; i < 16; i++) {
+        conflicting.push_back(i * row_stride);
+        EXPECT_EQ(probe.decode(conflicting.back()).bank, 0u);
+    }
+    
+    DramSystem local(1, config);
+    uint64_t local_cycles = run(local, sequential);
+    DramSystem thrash(1, config);
+    uint64_t thrash_cycles = run(thrash, conflicting);
+    
+    EXPECT_EQ(local.stats().row_hits, 15u);
+    EXPECT_EQ(thrash.stats().row_hits, 0u);
+    EXPECT_EQ(thrash.stats().row_conflicts, 15u);
+    EXPECT_GT(thrash_cycles, 4 * local_cycles);
+    EXPECT_LT(local.stats().average_read_latency(), thrash.stats().average_read_latency());
+}
+
+TEST_F(DramTimingTestCase, RefreshBlocksAllBanks) {
+    DramSystem dram(1, config);
+    std::vector<DramCompletion> none;
+    for (uint32_t i = 0; i <= 3 * config.tREFI; i++) {
+        dram.tick(none);
+    }
+    EXPECT_EQ(dram.stats().refreshes, 3u * config.pseudo_channels);
+}
+
+TEST_F(DramTimingTestCase, WritesDrainAndForwardToReads) {
+    DramSystem dram(1, config);
+    ASSERT_TRUE(dram.enqueue(1000, 0x1000, 64, true));
+    ASSERT_TRUE(dram.enqueue(1001, 0x1000, 64, false));
+    
+    // Enough writes to one pseudo-channel to cross the high watermark
+    std::vector<uint64_t> writes;
+    uint32_t bursts_per_row = config.row_size / config.burst_size;
+    for (uint32_t i = 0; i < config.write_high_watermark; i++) {
+        writes.push_back(0x100000 + (i / bursts_per_row) * config.row_size * config.pseudo_channels +
+                         (i % bursts_per_row) * config.burst_size);
+    }
+    run(dram, writes, true);
+    
+    DramStats stats = dram.stats();
+    EXPECT_EQ(stats.write_forwards, 1u);
+    EXPECT_EQ(stats.writes, config.write_high_watermark + 1u);
+    EXPECT_GE(stats.write_drains, 1u);
+}
+
+TEST(AddressMappingTest, SchemesAndSpecs) {
+    AddressMapping slice = AddressMapping::bit_slice(6, 3);
+    EXPECT_EQ(slice.num_indices(), 8u);
+    EXPECT_EQ(slice.index(5ULL << 6), 5u);
+    EXPECT_EQ(slice.index(1ULL << 9), 0u);
+    
+    // Folding bits 9+ into the index separates addresses that only differ there
+    AddressMapping folded = AddressMapping::xor_fold(6, 3, 12);
+    EXPECT_EQ(folded.index(1ULL << 9), 1u);
+    EXPECT_EQ(folded.index((1ULL << 9) | (1ULL << 6)), 0u);
+    
+    EXPECT_EQ(AddressMapping::permutation({7, 6}).index(1ULL << 7), 1u);
+    EXPECT_EQ(AddressMapping::modulo(6, 3).index(4ULL << 6), 1u);
+    
+    for (const char* spec : {"slice:6:3", "bits:7,6,12", "xor:6:3:12", "xor:6:3:11", "mod:6:3"}) {
+        EXPECT_EQ(AddressMapping::parse(spec).to_string(), spec);
+    }
+    
+    // The spec reproduces the mapping when the folded range is not a
+    // whole number of index widths
+    AddressMapping uneven = AddressMapping::xor_fold(6, 3, 11);
+    AddressMapping reparsed = AddressMapping::parse(uneven.to_string());
+    for (uint64_t bit = 0; bit < 16; bit++) {
+        EXPECT_EQ(reparsed.index(1ULL << bit), uneven.index(1ULL << bit));
+    }
+    EXPECT_THROW(AddressMapping::parse("xor:6"), std::invalid_argument);
+    EXPECT_THROW(AddressMapping::parse("slice:6:x"), std::invalid_argument);
+}
+
+TEST_F(DramTimingTestCase, XorChannelMappingSpreadsStrides) {
+    // A stride of channels * pseudo-channels * row size camps on one
+    // pseudo-channel under the default slicing
+    std::vector<uint64_t> addrs;
+    for (uint64_t i = 0; i < 64; i++) {
+        addrs.push_back(i * 8 * 2 * config.row_size);
+    }
+    
+    DramSystem sliced(8, config);
+    run(sliced, addrs);
+    EXPECT_EQ(sliced.channel_load().counts()[0], 64u);
+    EXPECT_DOUBLE_EQ(sliced.channel_load().max_over_mean(), 8.0);
+    
+    DramSystem hashed(8, config);
+    hashed.set_channel_mapping(AddressMapping::parse("xor:10:4:34"));
+    completed.clear();
+    run(hashed, addrs);
+    EXPECT_EQ(completed.size(), addrs.size());
+    EXPECT_DOUBLE_EQ(hashed.channel_load().max_over_mean(), 1.0);
+    EXPECT_LT(hashed.cycle(), sliced.cycle());
+    
+    EXPECT_THROW(hashed.set_channel_mapping(AddressMapping::bit_slice(10, 3)), std::invalid_argument);
+    
+    // Checkpoints carry the mapping and the per-channel load
+    CheckpointWriter writer;
+    hashed.save_state(writer);
+    DramSystem restored(8, config);
+    restored.set_channel_mapping(AddressMapping::parse("xor:10:4:34"));
+    CheckpointReader reader(writer.buffer());
+    restored.restore_state(reader);
+    EXPECT_TRUE(reader.at_end());
+    EXPECT_EQ(restored.channel_load().counts(), hashed.channel_load().counts());
+    EXPECT_EQ(restored.channel_load().total(), addrs.size());
+    
+    DramSystem default_mapped(8, config);
+    CheckpointReader mismatch(writer.buffer());
+    EXPECT_THROW(default_mapped.restore_state(mismatch), std::runtime_error);
+}
+
+TEST(LatencyHistogramTest, PercentilesMergeAndDump) {
+    LatencyHistogram fast;
+    LatencyHistogram slow;
+    for (uint64_t latency = 1; latency <= 1000; latency++) {
+        fast.record(latency);
+    }
+    slow.record(1000000, 10);
+    
+    // Within the 2^-5 relative error of the default precision
+    EXPECT_NEAR(fast.value_at_percentile(50.0), 500.0, 500.0 / 32);
+    EXPECT_NEAR(fast.value_at_percentile(99.0), 990.0, 990.0 / 32);
+    EXPECT_EQ(fast.value_at_percentile(100.0), 1000u);
+    EXPECT_EQ(fast.min(), 1u);
+    
+    fast.merge(slow);
+    LatencySummary summary = fast.summary();
+    EXPECT_EQ(summary.count, 1010u);
+    EXPECT_LT(summary.p90, 1000u);
+    EXPECT_EQ(summary.p999, 1000000u);
+    EXPECT_EQ(summary.max, 1000000u);
+    
+    std::vector<uint8_t> dump = fast.dump();
+    EXPECT_LT(dump.size(), 2048u);
+    LatencyHistogram loaded = LatencyHistogram::load(dump);
+    EXPECT_EQ(loaded.dump(), dump);
+    EXPECT_EQ(loaded.value_at_percentile(99.0), fast.value_at_percentile(99.0));
+    EXPECT_DOUBLE_EQ(loaded.mean(), fast.mean());
+    
+    EXPECT_THROW(fast.merge(LatencyHistogram(4)), std::invalid_argument);
+}
+
+TEST(LatencyHistogramTest, RejectsPrecisionMismatch) {
+    EXPECT_THROW(LatencyHistogram(0), std::invalid_argument);
+    EXPECT_THROW(LatencyHistogram(17), std::invalid_argument);
+    EXPECT_THROW(LatencyHistogram(40), std::invalid_argument);
+    
+    // A profile takes its precision from the dump
+    MemoryLatencyProfile fine(8);
+    fine.record(MemoryLevel::L2, MemoryTransactionType::READ, 300);
+    MemoryLatencyProfile loaded = MemoryLatencyProfile::load(fine.dump());
+    EXPECT_EQ(loaded.precision_bits(), 8u);
+    EXPECT_EQ(loaded.dump(), fine.dump());
+    
+    // Empty profiles differ only in their precision fields; splicing the
+    // first histogram of one into the other mixes precisions
+    std::vector<uint8_t> coarse = MemoryLatencyProfile(4).dump();
+    std::vector<uint8_t> mixed = MemoryLatencyProfile(5).dump();
+    ASSERT_EQ(coarse.size(), mixed.size());
+    size_t first_difference = 0;
+    while (coarse[first_difference] == mixed[first_difference]) {
+        first_difference++;
+    }
+    mixed[first_difference] = coarse[first_difference];
+    EXPECT_THROW(MemoryLatencyProfile::load(mixed), std::runtime_error);
+    
+    // Checkpoints only restore into histograms of the same precision
+    CheckpointWriter writer;
+    fine.save_state(writer);
+    fine.histogram(MemoryLevel::L2, MemoryTransactionType::READ).save_state(writer);
+    CheckpointReader reader(writer.buffer());
+    MemoryLatencyProfile profile;
+    EXPECT_THROW(profile.restore_state(reader), std::runtime_error);
+    LatencyHistogram histogram;
+    EXPECT_THROW(histogram.restore_state(reader), std::runtime_error);
+}
+
+TEST_F(DramTimingTestCase, LatencyProfileTracksTailPerLevel) {
+    DramSystem dram(8, config);
+    std::vector<uint64_t> addrs;
+    for (uint64_t i = 0; i < 64; i++) {
+        addrs.push_back(i * 16 * config.row_size);   // Row conflicts in one bank
+    }
+    run(dram, addrs);
+    const LatencyHistogram& reads = dram.read_latency();
+    EXPECT_EQ(reads.count(), addrs.size());
+    EXPECT_EQ(reads.min(), config.tRCD + config.tCL + config.tBURST);
+    EXPECT_GT(reads.value_at_percentile(99.0), 4 * reads.value_at_percentile(1.0));
+    
+    MemoryLatencyProfile profile;
+    profile.record(MemoryLevel::L2, MemoryTransactionType::READ, 40);
+    profile.record(MemoryLevel::L2, MemoryTransactionType::ATOMIC_ADD, 90);
+    profile.record(MemoryLevel::DRAM, MemoryTransactionType::READ, reads.max());
+    MemoryLatencyProfile other = MemoryLatencyProfile::load(profile.dump());
+    other.merge(profile);
+    EXPECT_EQ(other.level(MemoryLevel::L2).count(), 4u);
+    EXPECT_EQ(other.histogram(MemoryLevel::L2, MemoryTransactionType::ATOMIC_ADD).max(), 90u);
+    EXPECT_EQ(other.level(MemoryLevel::DRAM).max(), reads.max());
+    EXPECT_EQ(other.level(MemoryLevel::L1).count(), 0u);
+}
+
+// SystemC main function with GoogleTest integration
+// This is the required entry point for SystemC applications
+int sc_main(int argc, char **argv) {
+    // Initialize GoogleTest
+    ::testing::InitGoogleTest(&argc, argv);
+    
+    // Run the tests
+    int result = RUN_ALL_TESTS();
+    
+    // Return test result
+    return result;
+}
@@ -0,0 +1,209 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <vector>
+#include "../../model/common/checkpoint.h"
+#include "../../model/shader_core/assembler.h"
+#include "../../model/shader_core/sampled_simulation.h"
+
+// Two phases with distinct basic blocks: a 3-instruction store loop run r1
+// times, then a 4-instruction ALU loop run r6 times
+static const char* PHASED_SOURCE =
+    ".text\n"
+    "phase_a:\n"
+    "    sub r1, r1, r2\n"
+    "    st  r1, [r0 + 0x1000]\n"
+    "    brc r1, phase_a\n"
+    "phase_b:\n"
+    "    add r4, r4, r2\n"
+    "    mul r5, r4, r4\n"
+    "    sub r6, r6, r2\n"
+    "    brc r6, phase_b\n"
+    "    ret\n";
+
+// Both phases retire 12000 instructions; intervals of a multiple of 12
+// instructions never straddle a block
+static const uint32_t PHASE_A_ITERATIONS = 4000;
+static const uint32_t PHASE_B_ITERATIONS = 3000;
+static const uint64_t PHASE_LENGTH = 12000;
+static const uint64_t PROFILE_LENGTH = 2 * PHASE_LENGTH;
+
+class SampledSimulationTestCase : public ::testing::Test {
+protected:
+    GlobalMemory* memory;
+    FunctionalCore* core;
+    std::vector<uint32_t> program;
+
+    void SetUp() override {
+        memory = new GlobalMemory("memory", 1024 * 1024);
+        core = new FunctionalCore(*memory);
+        Assembler assembler;
+        Kernel kernel;
+        ASSERT_TRUE(assembler.assemble(PHASED_SOURCE, kernel));
+        program = kernel.code;
+        core->write_register(1, PHASE_A_ITERATIONS);
+        core->write_register(2, 1);
+        core->write_register(6, PHASE_B_ITERATIONS);
+    }
+
+    void TearDown() override {
+        delete core;
+        delete memory;
+    }
+
+    static SamplingConfig config(uint64_t interval_length) {
+        SamplingConfig config;
+        config.interval_length = interval_length;
+        config.warmup_length = 120;
+        return config;
+    }
+};
+
+TEST_F(SampledSimulationTestCase, FunctionalExecution) {
+    std::vector<std::pair<uint32_t, uint32_t>> blocks;
+    core->set_block_observer([&blocks](uint32_t start_pc, uint32_t length) {
+        blocks.emplace_back(start_pc, length);
+    });
+    core->write_register(1, 3);
+    core->write_register(6, 2);
+    core->load_program(program);
+    core->run(UINT64_MAX);
+
+    EXPECT_TRUE(core->halted());
+    EXPECT_EQ(core->instructions_retired(), 3u * 3 + 2 * 4 + 1);
+    EXPECT_EQ(core->read_register(1), 0u);
+    EXPECT_EQ(core->read_register(4), 2u);
+    EXPECT_EQ(core->read_register(5), 4u);
+    EXPECT_EQ(memory->read_byte(0x1000), 0u);
+
+    // Blocks end at every branch (taken or not) and at the final return
+    std::vector<std::pair<uint32_t, uint32_t>> expected = {
+        {0, 3}, {0, 3}, {0, 3}, {3, 4}, {3, 4}, {7, 1}
+    };
+    EXPECT_EQ(blocks, expected);
+}
+
+TEST_F(SampledSimulationTestCase, CollectsOneBbvPerInterval) {
+    SampledSimulator simulator(config(1200));
+    simulator.profile(*core, program);
+
+    // 20 full intervals plus the final return
+    const std::vector<SamplingInterval>& intervals = simulator.intervals();
+    ASSERT_EQ(intervals.size(), 21u);
+    EXPECT_EQ(simulator.total_instructions(), PROFILE_LENGTH + 1);
+    uint64_t start = 0;
+    for (size_t i = 0; i < intervals.size(); i++) {
+        EXPECT_EQ(intervals[i].index, i);
+        EXPECT_EQ(intervals[i].start_instruction, start);
+        start += intervals[i].length;
+    }
+    EXPECT_EQ(intervals.back().length, 1u);
+
+    // The instruction limit truncates profiling at an interval boundary
+    SampledSimulator truncated(config(1200));
+    core->write_register(1, PHASE_A_ITERATIONS);
+    core->write_register(6, PHASE_B_ITERATIONS);
+    truncated.profile(*core, program, PROFILE_LENGTH);
+    EXPECT_EQ(truncated.intervals().size(), 20u);
+    EXPECT_EQ(truncated.total_instructions(), PROFILE_LENGTH);
+}
+
+TEST_F(SampledSimulationTestCase, SelectsOneClusterPerPhase) {
+    SampledSimulator simulator(config(1200));
+    simulator.profile(*core, program, PROFILE_LENGTH);
+    const std::vector<SamplingInterval>& samples = simulator.select();
+
+    EXPECT_EQ(simulator.num_clusters(), 2u);
+    ASSERT_EQ(samples.size(), 4u);
+    for (const SamplingInterval& interval : simulator.intervals()) {
+        bool phase_a = interval.start_instruction < PHASE_LENGTH;
+        EXPECT_EQ(interval.cluster, simulator.intervals()[phase_a ? 0 : 19].cluster);
+    }
+    EXPECT_NE(simulator.intervals()[0].cluster, simulator.intervals()[19].cluster);
+}
+
+TEST_F(SampledSimulationTestCase, SelectsFewerClustersThanIntervals) {
+    // Fewer intervals than max_clusters must not give each its own cluster
+    SampledSimulator simulator(config(6000));
+    simulator.profile(*core, program, PROFILE_LENGTH);
+    ASSERT_EQ(simulator.intervals().size(), 4u);
+    simulator.select();
+    EXPECT_EQ(simulator.num_clusters(), 2u);
+
+    // A single interval is a single cluster
+    SampledSimulator single(config(PROFILE_LENGTH));
+    core->write_register(1, PHASE_A_ITERATIONS);
+    core->write_register(6, PHASE_B_ITERATIONS);
+    single.profile(*core, program, PROFILE_LENGTH);
+    ASSERT_EQ(single.intervals().size(), 1u);
+    EXPECT_EQ(single.select().size(), 1u);
+    EXPECT_EQ(single.num_clusters(), 1u);
+}
+
+TEST_F(SampledSimulationTestCase, FastForwardReplaysFromInitialState) {
+    // A write made after the last checkpoint must survive profiling's
+    // snapshot of the initial state
+    memory->mark_checkpoint();
+    memory->write_byte(0x8000, 0x5A);
+
+    SampledSimulator simulator(config(1200));
+    simulator.profile(*core, program, PROFILE_LENGTH);
+    simulator.select();
+
+    CheckpointWriter delta(checkpoint::FLAG_INCREMENTAL);
+    memory->save_state(delta);
+    GlobalMemory replica("replica", 1024 * 1024);
+    CheckpointReader reader(delta.buffer());
+    replica.restore_state(reader);
+    EXPECT_EQ(replica.read_byte(0x8000), 0x5A);
+
+    // Each sample is reached at the start of its warmup window
+    size_t visited = 0;
+    simulator.fast_forward(*core, program, [&](const SamplingInterval& sample, const FunctionalCore& position) {
+        uint64_t warmup = std::min<uint64_t>(120, sample.start_instruction);
+        EXPECT_EQ(position.instructions_retired(), sample.start_instruction - warmup);
+        if (sample.start_instruction < PHASE_LENGTH) {
+            EXPECT_EQ(position.read_register(1), PHASE_A_ITERATIONS - position.instructions_retired() / 3);
+        }
+        visited++;
+    });
+    EXPECT_EQ(visited, simulator.samples().size());
+}
+
+TEST_F(SampledSimulationTestCase, WeightedCpiEstimate) {
+    SampledSimulator simulator(config(1200));
+    simulator.profile(*core, program, PROFILE_LENGTH);
+    simulator.select();
+
+    // Phase A runs at CPI 2 and phase B at CPI 5
+    auto phase_cpi = [](const SamplingInterval& interval) -> uint64_t {
+        return interval.start_instruction < PHASE_LENGTH ? 2 : 5;
+    };
+    SampledSimulationResult result = simulator.estimate([&](const SamplingInterval& interval, uint64_t) {
+        return interval.length * phase_cpi(interval);
+    });
+
+    EXPECT_DOUBLE_EQ(result.estimated_cycles, PHASE_LENGTH * 2.0 + PHASE_LENGTH * 5.0);
+    EXPECT_TRUE(result.has_confidence_bounds);
+    EXPECT_DOUBLE_EQ(result.lower_bound_cycles, result.estimated_cycles);
+    EXPECT_DOUBLE_EQ(result.upper_bound_cycles, result.estimated_cycles);
+    EXPECT_EQ(result.total_instructions, PROFILE_LENGTH);
+    ASSERT_EQ(result.sample_cycles.size(), result.samples.size());
+
+    uint64_t detailed = 0;
+    for (const SamplingInterval& sample : result.samples) {
+        detailed += std::min<uint64_t>(120, sample.start_instruction) + sample.length;
+    }
+    EXPECT_EQ(result.detailed_instructions, detailed);
+
+    // Within-cluster variation widens the bounds around the estimate
+    SampledSimulationResult noisy = simulator.estimate([&](const SamplingInterval& interval, uint64_t) {
+        return interval.length * phase_cpi(interval) + interval.index * 10;
+    });
+    EXPECT_LT(noisy.lower_bound_cycles, noisy.estimated_cycles);
+    EXPECT_GT(noisy.upper_bound_cycles, noisy.estimated_cycles);
+}
+
+int sc_main(int argc, char* argv[]) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <stdexcept>
+#include "../../model/memory_subsystem/global_memory.h"
+#include "../../model/memory_subsystem/shared_memory.h"
+#include "../../model/memory_subsystem/memory_tlm.h"
+
+// Loosely-timed paths from initiators to global and shared memory. Sockets
+// bind at elaboration, so the testbench is built once in sc_main.
+struct TlmTestbench {
+    GlobalMemory memory;
+    TlmMemoryTarget target;
+    TlmMemoryInitiator initiator;
+
+    // Shared memory keeps its signal ports; TLM accesses bypass them
+    sc_signal<bool> clk;
+    sc_signal<bool> reset;
+    sc_signal<MemoryTransaction> shared_txn;
+    sc_signal<MemoryResponse> shared_resp;
+    SharedMemory shared_memory;
+    TlmMemoryTarget shared_target;
+    TlmMemoryInitiator shared_initiator;
+
+    TlmTestbench()
+        : memory("tlm_global_mem", 64 * 1024 * 1024),
+          target("tlm_global_target", memory),
+          initiator("tlm_initiator"),
+          shared_memory("tlm_shared_mem"),
+          shared_target("tlm_shared_target", shared_memory),
+          shared_initiator("tlm_shared_initiator") {
+        initiator.socket.bind(target.socket);
+        shared_memory.clk(clk);
+        shared_memory.reset(reset);
+        shared_memory.transaction(shared_txn);
+        shared_memory.response(shared_resp);
+        shared_initiator.socket.bind(shared_target.socket);
+    }
+};
+
+static TlmTestbench* bench = nullptr;
+
+TEST(TlmMemoryTest, TransportAnnotatesDelayAndGrantsDmi) {
+    TlmMemoryInitiator& initiator = bench->initiator;
+    initiator.reset_stats();
+
+    // The first access is a transport; the target annotates its latency and allows DMI
+    uint32_t value = 0xDEADBEEF;
+    sc_time delay = SC_ZERO_TIME;
+    initiator.write(0x1000, reinterpret_cast<const uint8_t*>(&value), 4, delay);
+    EXPECT_EQ(delay, bench->target.timing().write_latency);
+    EXPECT_EQ(bench->memory.read_byte(0x1000), 0xEF);
+    EXPECT_EQ(initiator.stats().transports, 1u);
+    EXPECT_EQ(initiator.stats().dmi_regions, 1u);
+
+    // Later accesses to the same page go straight to host memory
+    uint32_t read_back = 0;
+    delay = SC_ZERO_TIME;
+    initiator.read(0x1000, reinterpret_cast<uint8_t*>(&read_back), 4, delay);
+    EXPECT_EQ(read_back, value);
+    EXPECT_EQ(delay, bench->target.timing().read_latency);
+    EXPECT_EQ(initiator.stats().dmi_accesses, 1u);
+    EXPECT_EQ(initiator.stats().transports, 1u);
+
+    // Accesses beyond the end of memory are address errors
+    EXPECT_THROW(initiator.read(64 * 1024 * 1024 - 2, reinterpret_cast<uint8_t*>(&read_back), 4, delay),
+                 std::runtime_error);
+    EXPECT_EQ(bench->target.stats().address_errors, 1u);
+}
+
+TEST(TlmMemoryTest, InvalidatedDmiIsReacquired) {
+    TlmMemoryInitiator& initiator = bench->initiator;
+    uint32_t value = 42;
+    sc_time delay = SC_ZERO_TIME;
+    initiator.write(0x20000, reinterpret_cast<const uint8_t*>(&value), 4, delay);
+    ASSERT_GT(initiator.dmi_region_count(), 0u);
+
+    // Revoking DMI (as a checkpoint restore does) drops every cached region
+    bench->target.invalidate_dmi();
+    EXPECT_EQ(initiator.dmi_region_count(), 0u);
+
+    initiator.reset_stats();
+    uint32_t read_back = 0;
+    initiator.read(0x20000, reinterpret_cast<uint8_t*>(&read_back), 4, delay);
+    EXPECT_EQ(read_back, value);
+    EXPECT_EQ(initiator.stats().transports, 1u);
+    EXPECT_EQ(initiator.dmi_region_count(), 1u);
+}
+
+TEST(TlmMemoryTest, SharedMemoryIsOneDmiRegion) {
+    TlmMemoryInitiator& initiator = bench->shared_initiator;
+    uint32_t value = 0x12345678;
+    sc_time delay = SC_ZERO_TIME;
+    initiator.write(0x100, reinterpret_cast<const uint8_t*>(&value), 4, delay);
+    EXPECT_EQ(initiator.stats().transports, 1u);
+    EXPECT_EQ(initiator.stats().dmi_regions, 1u);
+
+    uint8_t bytes[4] = {};
+    bench->shared_memory.tlm_read(0x100, bytes, 4);
+    EXPECT_EQ(bytes[0], 0x78);
+    EXPECT_EQ(bytes[3], 0x12);
+
+    // The region granted by the first access covers the whole memory
+    uint32_t far_value = 7;
+    uint32_t read_back = 0;
+    uint32_t last_word = bench->shared_memory.size() - 4;
+    initiator.write(last_word, reinterpret_cast<const uint8_t*>(&far_value), 4, delay);
+    initiator.read(last_word, reinterpret_cast<uint8_t*>(&read_back), 4, delay);
+    EXPECT_EQ(read_back, far_value);
+    EXPECT_EQ(initiator.stats().transports, 1u);
+    EXPECT_EQ(initiator.stats().dmi_accesses, 2u);
+
+    EXPECT_THROW(initiator.read(bench->shared_memory.size(), reinterpret_cast<uint8_t*>(&read_back), 4, delay),
+                 std::runtime_error);
+    EXPECT_EQ(bench->shared_target.stats().address_errors, 1u);
+}
+
+TEST(TlmMemoryTest, ByteEnablesMaskWrites) {
+    uint8_t data[8] = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88};
+    uint8_t enables[2] = {TLM_BYTE_ENABLED, 0x00};
+    tlm::tlm_generic_payload trans;
+    trans.set_command(tlm::TLM_WRITE_COMMAND);
+    trans.set_address(0x3000);
+    trans.set_data_ptr(data);
+    trans.set_data_length(sizeof(data));
+    trans.set_streaming_width(sizeof(data));
+    trans.set_byte_enable_ptr(enables);
+    trans.set_byte_enable_length(sizeof(enables));
+    sc_time delay = SC_ZERO_TIME;
+
+    // The enable pattern repeats over the data: even bytes only
+    bench->initiator.socket->b_transport(trans, delay);
+    EXPECT_EQ(trans.get_response_status(), tlm::TLM_OK_RESPONSE);
+    EXPECT_EQ(bench->memory.read_byte(0x3000), 0x11);
+    EXPECT_EQ(bench->memory.read_byte(0x3001), 0x00);
+    EXPECT_EQ(bench->memory.read_byte(0x3006), 0x77);
+    EXPECT_EQ(bench->memory.read_byte(0x3007), 0x00);
+
+    // An enable pointer without a length is rejected, not divided by
+    trans.set_address(0x3100);
+    trans.set_byte_enable_length(0);
+    bench->initiator.socket->b_transport(trans, delay);
+    EXPECT_EQ(trans.get_response_status(), tlm::TLM_BYTE_ENABLE_ERROR_RESPONSE);
+    EXPECT_EQ(bench->memory.read_byte(0x3100), 0x00);
+}
+
+// SystemC main function with GoogleTest integration
+// This is the required entry point for SystemC applications
+int sc_main(int argc, char **argv) {
+    // Elaborate the testbench before the tests use its sockets
+    TlmTestbench testbench;
+    bench = &testbench;
+    sc_start(SC_ZERO_TIME);
+
+    // Initialize GoogleTest
+    ::testing::InitGoogleTest(&argc, argv);
+
+    // Run the tests
+    int result = RUN_ALL_TESTS();
+
+    // Return test result
+    return result;
+}